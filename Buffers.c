@@ -0,0 +1,225 @@
+/*------------------------------------------------------------------------
+* This Information is proprietary to Phase Dynamics Inc, Richardson, Texas
+* and MAY NOT be copied by any method or incorporated into another program
+* without the express written consent of Phase Dynamics Inc. This information
+* or any portion thereof remains the property of Phase Dynamics Inc.
+* The information contained herein is believed to be accurate and Phase
+* Dynamics Inc assumes no responsibility or liability for its use in any way
+* and conveys no license or title under any patent or copyright and makes
+* no representation or warranty that this Information is free from patent
+* or copyright infringement.
+*
+* Copyright (c) 2018 Phase Dynamics Inc. ALL RIGHTS RESERVED.
+*------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------
+* Buffers.c
+*-------------------------------------------------------------------------
+* Byte FIFOs shared between one producer and one consumer (e.g. Uart_ISR
+* and Modbus_RX). head and tail run freely and are masked on access; head
+* is only ever written by the consumer and tail only by the producer, so
+* neither side has to disable interrupts. The producer fills the bytes
+* before it moves tail, so the consumer never sees a partial write, and
+* the consumer is done with them before it moves head. head and tail are
+* volatile, but the bytes are not: RING_BARRIER() keeps the compiler from
+* moving the byte accesses past the volatile store (or ahead of the
+* volatile load) that orders them.
+*------------------------------------------------------------------------*/
+
+#include "Globals.h"
+
+void
+Ring_Init(RING* r)
+{ // only while neither side is running
+	r->head = 0;
+	r->tail = 0;
+}
+
+inline Uint32
+Ring_Count(const RING* r)
+{
+	return r->tail - r->head;
+}
+
+inline Uint32
+Ring_Space(const RING* r)
+{
+	return RING_SIZE - (r->tail - r->head);
+}
+
+/***************************************************************************
+ * Ring_Put() - producer
+ * @return	- 0=success, 1=buffer full (byte dropped)
+ ***************************************************************************/
+inline int
+Ring_Put(RING* r, Uint8 in_byte)
+{
+	Uint32 tail = r->tail;
+
+	if (tail - r->head >= RING_SIZE)
+		return 1;
+
+	RING_BARRIER();
+	r->buff[tail & RING_MASK] = in_byte;
+	RING_BARRIER();
+	r->tail = tail + 1;
+	return 0;
+}
+
+/***************************************************************************
+ * Ring_Get() - consumer
+ * @return	- 0=success, 1=buffer empty
+ ***************************************************************************/
+inline int
+Ring_Get(RING* r, Uint8* out_byte)
+{
+	Uint32 head = r->head;
+
+	if (head == r->tail)
+		return 1;
+
+	RING_BARRIER();
+	*out_byte = r->buff[head & RING_MASK];
+	RING_BARRIER();
+	r->head = head + 1;
+	return 0;
+}
+
+/***************************************************************************
+ * Ring_Write() - producer, bulk
+ * @return	- number of bytes written (less than len if the ring fills up)
+ ***************************************************************************/
+Uint32
+Ring_Write(RING* r, const Uint8* src, Uint32 len)
+{
+	Uint32 tail = r->tail;
+	Uint32 idx, first;
+
+	if (len > RING_SIZE - (tail - r->head))
+		len = RING_SIZE - (tail - r->head);
+
+	idx = tail & RING_MASK;
+	first = RING_SIZE - idx;
+	if (first > len)
+		first = len;
+
+	RING_BARRIER();
+	memcpy(&r->buff[idx], src, first);
+	memcpy(&r->buff[0], src + first, len - first);
+
+	RING_BARRIER();
+	r->tail = tail + len;
+	return len;
+}
+
+/***************************************************************************
+ * Ring_Peek() - consumer, copies without removing
+ * @param offset	- bytes to skip from the head
+ * @return			- number of bytes copied
+ ***************************************************************************/
+Uint32
+Ring_Peek(const RING* r, Uint32 offset, Uint8* dst, Uint32 len)
+{
+	Uint32 n = r->tail - r->head;
+	Uint32 idx, first;
+
+	if (offset >= n)
+		return 0;
+	if (len > n - offset)
+		len = n - offset;
+
+	RING_BARRIER();
+
+	idx = (r->head + offset) & RING_MASK;
+	first = RING_SIZE - idx;
+	if (first > len)
+		first = len;
+
+	memcpy(dst, &r->buff[idx], first);
+	memcpy(dst + first, &r->buff[0], len - first);
+
+	return len;
+}
+
+/***************************************************************************
+ * Ring_Read() - consumer, bulk
+ * @return	- number of bytes removed
+ ***************************************************************************/
+Uint32
+Ring_Read(RING* r, Uint8* dst, Uint32 len)
+{
+	len = Ring_Peek(r, 0, dst, len);
+	RING_BARRIER();
+	r->head += len;
+	return len;
+}
+
+/***************************************************************************
+ * Ring_Read_Span() - consumer
+ * @param p	- set to the oldest byte in the ring
+ * @return	- number of bytes that can be read at *p without wrapping;
+ * 			  follow with Ring_Consume()
+ ***************************************************************************/
+Uint32
+Ring_Read_Span(const RING* r, Uint8** p)
+{
+	Uint32 n = r->tail - r->head;
+	Uint32 idx = r->head & RING_MASK;
+
+	RING_BARRIER();
+	*p = (Uint8*)&r->buff[idx];
+	return (n < RING_SIZE - idx) ? n : RING_SIZE - idx;
+}
+
+void
+Ring_Consume(RING* r, Uint32 len)
+{
+	Uint32 n = r->tail - r->head;
+
+	RING_BARRIER();	// the caller is done reading the span
+	r->head += (len < n) ? len : n;
+}
+
+/***************************************************************************
+ * Ring_Write_Span() - producer
+ * @param p	- set to the first free byte in the ring
+ * @return	- number of bytes that can be written at *p without wrapping;
+ * 			  follow with Ring_Commit()
+ ***************************************************************************/
+Uint32
+Ring_Write_Span(RING* r, Uint8** p)
+{
+	Uint32 space = RING_SIZE - (r->tail - r->head);
+	Uint32 idx = r->tail & RING_MASK;
+
+	RING_BARRIER();
+	*p = &r->buff[idx];
+	return (space < RING_SIZE - idx) ? space : RING_SIZE - idx;
+}
+
+void
+Ring_Commit(RING* r, Uint32 len)
+{
+	Uint32 space = RING_SIZE - (r->tail - r->head);
+
+	RING_BARRIER();	// the caller's writes to the span land first
+	r->tail += (len < space) ? len : space;
+}
+
+/***************************************************************************
+ * Ring_Rewind() - producer, takes back bytes it has put
+ * @param tail	- an earlier value of r->tail; everything put since is
+ * 				  dropped. The consumer must not have been told about them.
+ ***************************************************************************/
+void
+Ring_Rewind(RING* r, Uint32 tail)
+{
+	if (r->tail - tail <= r->tail - r->head)
+		r->tail = tail;
+}
+
+void
+Ring_Flush(RING* r)
+{ // consumer: drop everything received so far
+	r->head = r->tail;
+}
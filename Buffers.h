@@ -8,16 +8,24 @@
 
 #define MAX_BFR_SIZE	(1024)
 #define MAX_BFR_SIZE_F	(60)
+#define RING_SIZE		(MAX_BFR_SIZE)	// must be a power of two
+#define RING_MASK		(RING_SIZE-1)
 
-// unsigned integer buffer type
+// compiler barrier: no memory access is moved across it. Between the bytes
+// and the head/tail store that hands them over (see: Buffers.c); the
+// C6748 is a single in-order core, so nothing more than this is needed.
+#if defined(__GNUC__)
+#define RING_BARRIER()	__asm__ __volatile__("" ::: "memory")
+#else
+#define RING_BARRIER()	__asm(" NOP")	// cl6x does not move loads or stores across an asm statement
+#endif
+
+// byte buffer type -- single producer, single consumer (see: Buffers.c)
 typedef struct { //circular FIFO buffer
-			int		head;
-			int		tail;
-			int		n;
-			Uint16		gseed;
-			Uint16		crc16;
-			unsigned int	buff[MAX_BFR_SIZE];
-		} BFR;
+			volatile Uint32	head;	// written by the consumer only
+			volatile Uint32	tail;	// written by the producer only
+			Uint8			buff[RING_SIZE];
+		} RING;
 
 // double - floating point buffer type
 typedef struct { //circular FIFO buffer
@@ -27,4 +35,19 @@ typedef struct { //circular FIFO buffer
 			double		buff[MAX_BFR_SIZE_F];
 		} FP_BFR;
 
+void	Ring_Init(RING* r);
+Uint32	Ring_Count(const RING* r);
+Uint32	Ring_Space(const RING* r);
+int		Ring_Put(RING* r, Uint8 in_byte);
+int		Ring_Get(RING* r, Uint8* out_byte);
+Uint32	Ring_Write(RING* r, const Uint8* src, Uint32 len);
+Uint32	Ring_Read(RING* r, Uint8* dst, Uint32 len);
+Uint32	Ring_Peek(const RING* r, Uint32 offset, Uint8* dst, Uint32 len);
+Uint32	Ring_Read_Span(const RING* r, Uint8** p);
+void	Ring_Consume(RING* r, Uint32 len);
+Uint32	Ring_Write_Span(RING* r, Uint8** p);
+void	Ring_Commit(RING* r, Uint32 len);
+void	Ring_Rewind(RING* r, Uint32 tail);
+void	Ring_Flush(RING* r);
+
 #endif /* BUFFERS_H_ */
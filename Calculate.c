@@ -25,7 +25,9 @@
 * the counter of hardware timer 1 and divide by the sample period of 500ms
 * (and multiply back the 80x frequency divider) to arrive at our oscillator
 * frequency. This frequency, along with many other values and measurements,
-* is used to calculate the watercut.
+* is used to calculate the watercut. With REG_FREQ_MODE set to
+* FREQ_MODE_RECIPROCAL the counter runs free instead, and each gate of
+* REG_FREQ_GATE_MS ends on a timestamped edge (Freq_Reciprocal_Gate).
 *-------------------------------------------------------------------------
 * HISTORY:
 *       Apr-13-2018 : David Skew : Created
@@ -38,6 +40,7 @@
 
 #include "Globals.h"
 #include "Utils.h"
+#include "nandwriter.h"
 
 #define CALCULATE_H
 
@@ -46,19 +49,101 @@
 static double WC_RAW_AVG = 0;
 static int CAL_RTC_SEC, CAL_RTC_MIN, CAL_RTC_HR, CAL_RTC_DAY, CAL_RTC_MON, CAL_RTC_YR;
 
+static Uint32 FREQ_EDGE_CNT;			// counter at the edge that ended the last reciprocal gate
+static Uint32 FREQ_EDGE_TS;				// timestamp of that edge
+static BOOL   FREQ_EDGE_OK = FALSE;		// FREQ_EDGE_CNT/TS start the current gate
+
+/***************************************************************************
+ * Freq_Reciprocal_Gate() - __HWI__, end of a FREQ_MODE_RECIPROCAL gate
+ * Waits for the next edge out of the 80x divider and timestamps it. The
+ * pulses since the edge that ended the last gate, over the time between
+ * the two edges, give the frequency to the resolution of the timestamp
+ * instead of one pulse per gate, whatever the gate length. The counter
+ * is never stopped, so this edge also starts the next gate.
+ * @return	- TRUE if a new reading was published
+ ***************************************************************************/
+static BOOL
+Freq_Reciprocal_Gate(void)
+{
+	Types_FreqHz	ts_freq;
+	Uint32			cnt, ts, start_cnt, start_ts, wait;
+	BOOL			published;
+	UInt			key;
+
+	Timestamp_getFreq(&ts_freq);
+	wait = (ts_freq.lo / 1000000) * FREQ_EDGE_WAIT_US;
+
+	// nothing may run between an edge and its timestamp
+	key = Hwi_disable();
+	start_cnt = tmr3Regs->TIM12;
+	start_ts = Timestamp_get32();
+	do
+	{
+		cnt = tmr3Regs->TIM12;
+		ts = Timestamp_get32();
+	} while ((cnt == start_cnt) && (ts - start_ts < wait));
+	Hwi_restore(key);
+	// no edge in time: the gate ends on the last read, to within one pulse
+
+	published = FREQ_EDGE_OK;
+	if (published)
+	{
+		FREQ_PULSE_COUNT_LO = cnt - FREQ_EDGE_CNT;	// TIM12 wraps after minutes, gates are <= 1 s
+		FREQ_PULSE_COUNT_HI = 0;
+		FREQ_TS_ELAPSED 	= ts - FREQ_EDGE_TS;
+		FREQ_U_SEC_ELAPSED 	= FREQ_TS_ELAPSED / (ts_freq.lo / 1000000);
+	}
+
+	FREQ_EDGE_CNT = cnt;
+	FREQ_EDGE_TS = ts;
+	FREQ_EDGE_OK = TRUE;
+
+	return published;
+}
+
 //// This is a __HWI__ called by Count_Freq_Pulses_Clock.
-//// Currently, it's called once every 0.5 seconds.
+//// It's called once every 0.5 seconds, or every REG_FREQ_GATE_MS in FREQ_MODE_RECIPROCAL.
 void Count_Freq_Pulses(Uint32 u_sec_elapsed)
 {
+	static Uint32 usb_us = 0;
+	static Uint8 prev_mode = FREQ_MODE_COUNT;
+	Uint32 gate_ms;
+	BOOL back_to_count;
+
+	back_to_count = (prev_mode == FREQ_MODE_RECIPROCAL) && (REG_FREQ_MODE != FREQ_MODE_RECIPROCAL);
+	prev_mode = (REG_FREQ_MODE == FREQ_MODE_RECIPROCAL) ? FREQ_MODE_RECIPROCAL : FREQ_MODE_COUNT;
+
+	gate_ms = REG_FREQ_GATE_MS;
+	if (gate_ms < FREQ_GATE_MIN_MS) gate_ms = FREQ_GATE_MIN_MS;
+	if (gate_ms > FREQ_GATE_MAX_MS) gate_ms = FREQ_GATE_MAX_MS;
+
 	///
-	/// handle usb tasks 
+	/// handle usb tasks, every 0.5 seconds whatever the gate
 	///
-	if (!isPdiUpgradeMode)
+	usb_us += (REG_FREQ_MODE == FREQ_MODE_RECIPROCAL) ? gate_ms*1000 : u_sec_elapsed;
+	if (usb_us >= FREQ_COUNT_GATE_US)
 	{
-   			 if (isLogData) Swi_post(Swi_logData);
-   		else if (isDownloadCsv) Swi_post(Swi_downloadCsv);
-   		else if (isScanCsvFiles) Swi_post(Swi_scanCsvFiles);
-		else if (isUploadCsv) Swi_post(Swi_uploadCsv);
+		usb_us = 0;
+		if (!isPdiUpgradeMode)
+		{
+				 if (isLogData) Swi_post(Swi_logData);
+			else if (isDownloadCsv) Swi_post(Swi_downloadCsv);
+			else if (isScanCsvFiles) Swi_post(Swi_scanCsvFiles);
+			else if (isUploadCsv) Swi_post(Swi_uploadCsv);
+		}
+	}
+
+	if (REG_FREQ_MODE == FREQ_MODE_RECIPROCAL)
+	{
+		///
+		/// counter keeps running; restart the gate timer
+		///
+		Timer_stop(counterTimerHandle);
+		Timer_setPeriodMicroSecs(counterTimerHandle, gate_ms*1000);
+		Timer_start(counterTimerHandle);
+
+		if (Freq_Reciprocal_Gate()) Swi_post(Swi_Poll);
+		return;
 	}
 
 	///
@@ -70,13 +155,20 @@ void Count_Freq_Pulses(Uint32 u_sec_elapsed)
     /// stop counter timer
 	///
     Timer_stop(counterTimerHandle); 
+    Timer_setPeriodMicroSecs(counterTimerHandle, FREQ_COUNT_GATE_US); // back from FREQ_MODE_RECIPROCAL
 
 	///
-    /// udUate global variables
+    /// udUate global variables -- unless the counter holds everything since
+    /// FREQ_MODE_RECIPROCAL began; that gate only restarts counting
 	///
-    FREQ_PULSE_COUNT_LO = tmr3Regs->TIM12; //store counter value to global var (lower)
-    FREQ_PULSE_COUNT_HI = tmr3Regs->TIM34; //store counter value to global var (upper)
-    FREQ_U_SEC_ELAPSED = u_sec_elapsed;
+    if (!back_to_count)
+    {
+        FREQ_PULSE_COUNT_LO = tmr3Regs->TIM12; //store counter value to global var (lower)
+        FREQ_PULSE_COUNT_HI = tmr3Regs->TIM34; //store counter value to global var (upper)
+        FREQ_U_SEC_ELAPSED = u_sec_elapsed;
+        FREQ_TS_ELAPSED = 0;
+    }
+    FREQ_EDGE_OK = FALSE;
 
 	///
     /// reset counter value to zero (upper & lower)
@@ -97,7 +189,7 @@ void Count_Freq_Pulses(Uint32 u_sec_elapsed)
 	/// 
     /// followed by Swi_Poll below
 	/// 
-    Swi_post(Swi_Poll);
+    if (!back_to_count) Swi_post(Swi_Poll);
 }
 
 
@@ -179,6 +271,27 @@ void Poll(void)
 
 		VAR_NaN(&REG_WATERCUT);
 	}
+
+	///
+	/// in-memory history for Modbus file record reads
+	///
+	History_Record(CAL_RTC_SEC, CAL_RTC_MIN, CAL_RTC_HR, CAL_RTC_DAY, CAL_RTC_MON, CAL_RTC_YR);
+
+	///
+	/// re-publish the SCADA mirror block, then re-encode the float registers for Modbus reads
+	///
+	MB_Mirror_Refresh();
+	MB_Float_Cache_Refresh();
+
+	///
+	/// stamp the registers that changed for report-by-exception reads
+	///
+	MB_Change_Scan();
+
+	///
+	/// push a record to the cal sw if it armed the sample stream
+	///
+	MB_Stream_Sample();
 }
 
 
@@ -186,6 +299,7 @@ Uint8 Read_Freq(void)
 {
 	int key;
 	double freq;
+	Types_FreqHz ts_freq;
 
 	///
 	/// check errors
@@ -214,7 +328,13 @@ Uint8 Read_Freq(void)
 	///
 	/// #pulses divided by #microseconds
 	///
-	freq = ((double)FREQ_PULSE_COUNT_LO) / ((double)FREQ_U_SEC_ELAPSED); 
+	if (FREQ_TS_ELAPSED != 0)
+	{	// reciprocal: time between the edges that bound the pulses
+		Timestamp_getFreq(&ts_freq);
+		freq = ((double)FREQ_PULSE_COUNT_LO * (double)ts_freq.lo) / ((double)FREQ_TS_ELAPSED * 1000000.0);
+	}
+	else
+		freq = ((double)FREQ_PULSE_COUNT_LO) / ((double)FREQ_U_SEC_ELAPSED); 
 
 	///
 	/// oscillator board uses 80x divider
@@ -529,7 +649,7 @@ void Capture_Sample(void)
         STREAM_WATERCUT_AVG[(int)REG_STREAM.calc_val-1] = REG_WATERCUT_AVG.calc_val;
         STREAM_SAMPLES[(int)REG_STREAM.calc_val-1] = num_samples;
         sprintf(STREAM_TIMESTAMP[(int)REG_STREAM.calc_val-1],"%.2u:%.2u %.2u/%.2u/20%.2u",CAL_RTC_HR,CAL_RTC_MIN,CAL_RTC_MON,CAL_RTC_DAY,CAL_RTC_YR);
-        Swi_post(Swi_writeNand);
+        requestNandWrite();
     }
 
     ///
@@ -624,7 +744,7 @@ void Calibrate_Oil(void)
         REG_OIL_SAMPLE.calc_val = 0;
     }   
  
-    Swi_post(Swi_writeNand);
+    requestNandWrite();
 }
 
 
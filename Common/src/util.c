@@ -73,8 +73,8 @@ extern __FAR__ Uint32 EXTERNAL_RAM_START, EXTERNAL_RAM_END;
 /************************************************************
 * Local Function Declarations                               *
 ************************************************************/
-#if (0)
 static Uint32 LOCAL_reflectNum(Uint32 inVal, Uint32 num);
+#if (0)
 static Uint8 LOCAL_CalcBitWiseParity(Uint8 val, Uint8 mask);
 #endif
 
@@ -194,7 +194,6 @@ void UTIL_waitLoopAccurate (Uint32 loopcnt)
 #endif
 }
 
-#if (0)
 // CRC-32 routine (relflected, init xor val = 0xFFFFFFFF, final xor val = 0xFFFFFFFF)
 Uint32 UTIL_calcCRC32(Uint32* lutCRC, Uint8 *data, Uint32 size, Uint32 currCRC)
 {
@@ -243,6 +242,7 @@ void UTIL_buildCRC32Table(Uint32* lutCRC, Uint32 poly)
   }
 }
 
+#if (0)
 // CRC-16 routine (relflected, init xor val = 0xFFFF, final xor val = 0xFFFF)
 Uint16 UTIL_calcCRC16(Uint16* lutCRC, Uint8 *data, Uint32 size, Uint16 currCRC)
 {
@@ -338,7 +338,6 @@ Uint32 UTIL_hammingECC(Uint8 *data, Uint16 cnt)
 /***********************************************************
 * Local Function Definitions                               *
 ***********************************************************/
-#if (0) 
 static Uint32 LOCAL_reflectNum(Uint32 inVal, Uint32 num)
 {
   Uint32 i,outVal = 0x0;
@@ -351,6 +350,8 @@ static Uint32 LOCAL_reflectNum(Uint32 inVal, Uint32 num)
   return outVal;
 }
 
+#if (0) 
+
 
 static Uint8 LOCAL_calcBitWiseParity(Uint32* bits, Bool isEven, Uint16 chunkSizeInBits, Uint16 lengthInBits)
 {
@@ -45,6 +45,7 @@ void resetGlobalVars(void)
 	STAT_CMD 		                    = 0;
 	STAT_RETRY 		                    = 0;
 	STAT_CURRENT 	                    = 0;	// hold current stat kind
+	memset(&MB_STAT, 0, sizeof(MB_STAT));
 
     COIL_AVGTEMP_RESET.val              = FALSE;
 	COIL_AO_TRIM_MODE.val               = FALSE; 
@@ -577,6 +578,21 @@ void initializeAllRegisters(void)
 	FCT_RELAY_MODE 			= 0; // WATERCUT
 
     REG_USB_TRY             = 10; // (REGPERM_FCT)
+
+	// mirror block: the live measurements, then diagnostics
+	for (i=0;i<MB_MIRROR_SLOTS;i++) REG_MIRROR_SRC[i] = 0;
+	REG_MIRROR_SRC[0] = 3;
+	REG_MIRROR_SRC[1] = 5;
+	REG_MIRROR_SRC[2] = 19;
+	REG_MIRROR_SRC[3] = 23;
+	REG_MIRROR_SRC[4] = 25;
+	REG_MIRROR_SRC[5] = 29;
+	REG_MIRROR_SRC[6] = 33;
+	REG_MIRROR_SRC[7] = 61;
+	REG_MIRROR_SRC[8] = 233;	// REG_DIAGNOSTICS
+	REG_MB_SENTINEL			= 0xFFFF;	// two of them read back as a float NaN
+	REG_FREQ_MODE			= FREQ_MODE_COUNT;
+	REG_FREQ_GATE_MS		= 500;
     REG_SN_PIPE             = 0; // (REGPERM_FCT)
 	REG_ANALYZER_MODE 	    = ANA_MODE_MID;
 	REG_AO_DAMPEN			= FCT_AO_DAMPEN;
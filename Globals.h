@@ -85,6 +85,7 @@
 #include "Units.h"
 #include "Buffers.h"
 #include "ModbusRTU.h"
+#include "ModbusTCP.h"
 
 #ifdef  GLOBAL_VARS
 #define _EXTERN
@@ -119,6 +120,14 @@
 #define PDI_RAZOR_PROFILE 			"pdi_razor_profile"
 #define PDI_RAZOR_FIRMWARE 			"0:pdi_razor_firmware.ais"
 #define PDI_RAZOR_FIRMWARE_DONE 	"0:pdi_razor_firmware.done"
+#define HIST_RECORDS				4096	// in-memory history depth (see: History_Record)
+#define HIST_WORDS					16		// 16-bit words per history record
+#define FREQ_MODE_COUNT				0		// pulses counted over a fixed 500 ms gate
+#define FREQ_MODE_RECIPROCAL		1		// pulses over the time between timestamped edges
+#define FREQ_COUNT_GATE_US			500000	// FREQ_MODE_COUNT gate (counterTimerHandle period)
+#define FREQ_GATE_MIN_MS			50		// REG_FREQ_GATE_MS limits
+#define FREQ_GATE_MAX_MS			1000
+#define FREQ_EDGE_WAIT_US			20		// longest wait for the edge that ends a reciprocal gate
 
 //////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////
@@ -195,7 +204,11 @@ _EXTERN void unloadUsbDriver(void);
 _EXTERN void Init_Data_Buffer(void);
 _EXTERN void Init_Data_Buffer(void);
 _EXTERN void initializeAllRegisters(void);
+_EXTERN void setDemoValues(void);
 _EXTERN void Read_RTC(int* p_sec, int* p_min, int* p_hr, int* p_day, int* p_mon, int* p_yr);
+_EXTERN void History_Record(int sec, int min, int hr, int day, int mon, int yr);
+_EXTERN Uint32 History_Seq(void);
+_EXTERN BOOL History_Read(Uint32 slot, Uint32 word, Uint32 n, Uint8* dst);
 _EXTERN void reloadFactoryDefault(void);
 _EXTERN void storeUserDataToFactoryDefault(void);
 _EXTERN void _c_int00(void);
@@ -238,6 +251,7 @@ typedef struct
 	_EXTERN Uint32 	 FREQ_PULSE_COUNT_LO;
 	_EXTERN Uint32 	 FREQ_PULSE_COUNT_HI;
 	_EXTERN Uint32 	 FREQ_U_SEC_ELAPSED; 	// microseconds - time elapsed since last frequency pulse reading
+	_EXTERN Uint32 	 FREQ_TS_ELAPSED; 		// FREQ_MODE_RECIPROCAL: timestamp counts between the gate's edges; 0 otherwise
 	_EXTERN DATA_BFR DATALOG;
 	
 ////////////////////////////////////////////////////////////
@@ -269,8 +283,8 @@ typedef struct
 	_EXTERN Uint8	I2C_BUTTON_BACK;
 	_EXTERN Uint8	I2C_BUTTON_VALUE;
 	_EXTERN Uint8	I2C_BUTTON_ENTER;
-	_EXTERN BFR 	I2C_TXBUF;
-	_EXTERN BFR 	I2C_RXBUF;
+	_EXTERN RING	I2C_TXBUF;
+	_EXTERN RING	I2C_RXBUF;
  
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
@@ -280,18 +294,25 @@ typedef struct
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
 
-	_EXTERN BFR 	UART_TXBUF;
-	_EXTERN BFR 	UART_RXBUF;
+	_EXTERN RING	UART_TXBUF;
+	_EXTERN RING	UART_RXBUF;
+	_EXTERN MODBUS_FRAME_LIST MB_FRAME_LIST;	// complete RTU frames waiting in UART_RXBUF
 	_EXTERN UERROR	UART_ERROR_CNT;
 	_EXTERN Uint8	MB_TX_IN_PROGRESS;
+	_EXTERN Uint32	MB_TX_BUILD_CYCLES;	// timestamp counts spent building the last response
 	_EXTERN Uint8	THROW_ERROR;
-	_EXTERN Uint16	WDOG_BYTES_TO_REMOVE;
 	_EXTERN MODBUS_PACKET_LIST MB_PKT_LIST;
 	_EXTERN Uint32	STAT_SUCCESS;
 	_EXTERN Uint32	STAT_PKT;
 	_EXTERN Uint32	STAT_CMD;
 	_EXTERN Uint32	STAT_RETRY;
 	_EXTERN Uint8 	STAT_CURRENT;
+	_EXTERN MB_STATS MB_STAT;
+	_EXTERN double	MB_MIRROR[MB_MIRROR_SLOTS];	// 501 - 563, refreshed by Poll()
+	_EXTERN Uint32	NAND_PENDING;	// configuration changes not yet in NAND (see requestNandWrite)
+	_EXTERN Uint32	NAND_CFG_STATUS;	// NAND_CFG_*
+	_EXTERN Uint32	NAND_COMMIT_MS;	// duration of the last writeNand()
+	_EXTERN COIL	COIL_CFG_COMMIT;	// set to commit pending changes now
 
 ///////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////
@@ -772,6 +793,18 @@ typedef struct
 
 #pragma DATA_SECTION(REG_USB_TRY,"CFG")
 	_EXTERN far int REG_USB_TRY;
+
+#pragma DATA_SECTION(REG_MIRROR_SRC,"CFG")			// 241 - 272
+	_EXTERN far int REG_MIRROR_SRC[MB_MIRROR_SLOTS];	// registers mirrored at 501 - 563; 0 = unused
+
+#pragma DATA_SECTION(REG_MB_SENTINEL,"CFG")			// 280
+	_EXTERN far int REG_MB_SENTINEL;	// unmapped registers in a cross-table read
+
+#pragma DATA_SECTION(REG_FREQ_MODE,"CFG")			// 281
+	_EXTERN far int REG_FREQ_MODE;		// FREQ_MODE_*
+
+#pragma DATA_SECTION(REG_FREQ_GATE_MS,"CFG")		// 282
+	_EXTERN far int REG_FREQ_GATE_MS;	// FREQ_MODE_RECIPROCAL gate, FREQ_GATE_MIN_MS - FREQ_GATE_MAX_MS
  
     _EXTERN far int TMP_RTC_SEC;        // RTC read-only: seconds
     _EXTERN far int TMP_RTC_MIN;        // RTC read-only: minutes
@@ -974,3 +974,105 @@ BOOL uploadCsv(void)
 
 	return TRUE;
 }
+
+
+/***************************************************************************
+ * In-memory history of the logged columns, kept whether or not a USB stick
+ * is present and served to Modbus masters with Read File Record (0x14).
+ * Record n (n = 0, 1, ... since boot) lives in HIST[n % HIST_RECORDS], as
+ * HIST_WORDS 16-bit words, MSW first:
+ *   0-1   n
+ *   2-3   RTC: yr<<26 | mon<<22 | day<<17 | hr<<12 | min<<6 | sec
+ *   4-5   DIAGNOSTICS
+ *   6-15  watercut, raw watercut, temperature, frequency, RP (IEEE floats)
+ ***************************************************************************/
+#pragma DATA_SECTION(HIST,"DDR")
+static Uint16 HIST[HIST_RECORDS][HIST_WORDS];
+static volatile Uint32 HIST_SEQ = 0;	// records written so far
+
+static inline void
+History_Put32(Uint16* w, Uint32 val)
+{
+	w[0] = val >> 16;
+	w[1] = val & 0xFFFF;
+}
+
+static inline void
+History_PutFloat(Uint16* w, double val)
+{
+	float f = (float)val;
+	History_Put32(w, *(Uint32*)&f);
+}
+
+/***************************************************************************
+ * History_Record() - called from Poll() with the time it just read
+ * Adds a record every REG_LOGGING_PERIOD seconds, the same rate as the
+ * USB log.
+ ***************************************************************************/
+void
+History_Record(int sec, int min, int hr, int day, int mon, int yr)
+{
+	static int prev_sec = -1;
+	static int sec_counter = 0;
+	Uint16 rec[HIST_WORDS];
+	Uint32 seq;
+	UInt key;
+
+	if (sec == prev_sec) return;
+	prev_sec = sec;
+
+	if (++sec_counter < REG_LOGGING_PERIOD) return;
+	sec_counter = 0;
+
+	seq = HIST_SEQ;
+
+	History_Put32(&rec[0], seq);
+	History_Put32(&rec[2], ((Uint32)yr << 26) | ((Uint32)mon << 22) | ((Uint32)day << 17)
+							| ((Uint32)hr << 12) | ((Uint32)min << 6) | (Uint32)sec);
+	History_Put32(&rec[4], (Uint32)DIAGNOSTICS);
+	History_PutFloat(&rec[6],  REG_WATERCUT.calc_val);
+	History_PutFloat(&rec[8],  REG_WATERCUT_RAW);
+	History_PutFloat(&rec[10], REG_TEMP_USER.calc_val);
+	History_PutFloat(&rec[12], REG_FREQ.calc_val);
+	History_PutFloat(&rec[14], REG_OIL_RP);
+
+	// Modbus reads the history from a higher priority swi
+	key = Swi_disable();
+	memcpy(HIST[seq % HIST_RECORDS], rec, sizeof(rec));
+	HIST_SEQ = seq + 1;
+	Swi_restore(key);
+}
+
+Uint32
+History_Seq(void)
+{ // records written so far; the newest is History_Seq()-1
+	return HIST_SEQ;
+}
+
+/***************************************************************************
+ * History_Read()
+ * @param slot	- HIST row, 0 to HIST_RECORDS-1
+ * @param word	- first word within the row
+ * @param n		- number of words; may run on into the following rows
+ * @param dst	- gets 2*n bytes, MSB first
+ * @return		- FALSE if the words run past the end of HIST
+ ***************************************************************************/
+BOOL
+History_Read(Uint32 slot, Uint32 word, Uint32 n, Uint8* dst)
+{
+	const Uint16* w;
+	Uint32 i;
+
+	word += slot * HIST_WORDS;
+	if (word + n > (Uint32)HIST_RECORDS * HIST_WORDS)
+		return FALSE;
+
+	w = &HIST[0][0] + word;
+	for (i=0;i<n;i++)
+	{
+		*dst++ = w[i] >> 8;
+		*dst++ = w[i] & 0xFF;
+	}
+
+	return TRUE;
+}
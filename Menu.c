@@ -644,7 +644,7 @@ onFxnEnterPressed(const int currentId, const double max, const double min, VAR *
 Uint16 
 mnuHomescreenWaterCut(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_HOMESCREEN_WTC;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_HOMESCREEN_WTC;
 
     static BOOL isDisplayLogo = TRUE;
 
@@ -676,7 +676,7 @@ mnuHomescreenWaterCut(const Uint16 input)
 Uint16 
 mnuHomescreenFrequency(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_HOMESCREEN_FREQ;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_HOMESCREEN_FREQ;
 	sprintf(lcdLine1, "%12.3f Mhz", Round_N(REG_FREQ.calc_val,3));
 	updateDisplay(FREQUENCY, lcdLine1);
 
@@ -691,7 +691,7 @@ mnuHomescreenFrequency(const Uint16 input)
 Uint16
 mnuHomescreenReflectedPower(const Uint16 input)
 {	
-	if (I2C_TXBUF.n > 0) return MNU_HOMESCREEN_RP;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_HOMESCREEN_RP;
     sprintf(lcdLine1, "%15.3fV", Round_N(REG_OIL_RP,3));
 	updateDisplay(REFLECTEDPOWER, lcdLine1);
 
@@ -706,7 +706,7 @@ mnuHomescreenReflectedPower(const Uint16 input)
 Uint16
 mnuHomescreenPhaseThreshold(const Uint16 input)
 {	
-	if (I2C_TXBUF.n > 0) return MNU_HOMESCREEN_PT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_HOMESCREEN_PT;
     sprintf(lcdLine1, "%15.3fV", Round_N(REG_OIL_PT,3));
 	updateDisplay(PHASETHRESHOLD, lcdLine1);
 
@@ -720,7 +720,7 @@ mnuHomescreenPhaseThreshold(const Uint16 input)
 Uint16
 mnuHomescreenAvgTemp(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_HOMESCREEN_AVT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_HOMESCREEN_AVT;
 	static BOOL isEntered = FALSE;
     if (isMessage) { return notifyMessageAndExit(MNU_HOMESCREEN_AVT,MNU_HOMESCREEN_AVT); }
 
@@ -752,7 +752,7 @@ mnuHomescreenAvgTemp(const Uint16 input)
 Uint16
 mnuHomescreenDensity(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_HOMESCREEN_DST;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_HOMESCREEN_DST;
 
 	static Uint8 index;
 	char linedp [MAX_LCD_WIDTH];
@@ -787,7 +787,7 @@ mnuHomescreenDensity(const Uint16 input)
 Uint16
 mnuHomescreenDiagnostics(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_HOMESCREEN_DGN;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_HOMESCREEN_DGN;
 	static Uint8 i = 0;	
 	static Uint8 index = 0;
 	static Uint8 errors[MAX_ERRORS];
@@ -825,7 +825,7 @@ mnuHomescreenDiagnostics(const Uint16 input)
 Uint16
 fxnHomescreenDiagnostics(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_HOMESCREEN_DGN;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_HOMESCREEN_DGN;
 	static Uint8 i = 0;	
 	static Uint8 index = 0;
 	static Uint8 errors[MAX_ERRORS];
@@ -853,7 +853,7 @@ fxnHomescreenDiagnostics(const Uint16 input)
 Uint16
 mnuHomescreenSerialNumber(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_HOMESCREEN_SRN;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_HOMESCREEN_SRN;
 	sprintf(lcdLine1, "%16u",(Uint16)REG_SN_PIPE);
  	updateDisplay(SERIALNUMBER, lcdLine1);
 
@@ -869,7 +869,7 @@ mnuHomescreenSerialNumber(const Uint16 input)
 Uint16 
 mnuOperation(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_OPERATION;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_OPERATION;
 	if (isUpdateDisplay) updateDisplay(OPERATION, BLANK); 
 
 	switch (input)	{
@@ -885,7 +885,7 @@ mnuOperation(const Uint16 input)
 Uint16 
 mnuConfig(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG;
 	if (isUpdateDisplay) updateDisplay(CONFIGURATION, BLANK); 
 
 	switch (input)	{
@@ -901,7 +901,7 @@ mnuConfig(const Uint16 input)
 Uint16 
 mnuSecurityInfo(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO;
 	if (isUpdateDisplay) updateDisplay(SECURITYINFO, BLANK); 
 
 	switch (input)	
@@ -918,7 +918,7 @@ mnuSecurityInfo(const Uint16 input)
 Uint16 
 mnuOperation_Stream(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_OPERATION_STREAM;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_OPERATION_STREAM;
 
     displayMnu(STREAM, REG_STREAM.calc_val, 0);
 
@@ -936,7 +936,7 @@ mnuOperation_Stream(const Uint16 input)
 Uint16 
 fxnOperation_Stream(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_OPERATION_STREAM;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_OPERATION_STREAM;
 
     if (isMessage) { return notifyMessageAndExit(FXN_OPERATION_STREAM, MNU_OPERATION_STREAM); }
 
@@ -956,7 +956,7 @@ fxnOperation_Stream(const Uint16 input)
 Uint16 
 mnuOperation_OilAdjust(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_OPERATION_OILADJUST;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_OPERATION_OILADJUST;
 
     displayMnu(OILADJUST, REG_OIL_ADJUST.calc_val, 2);
 	 
@@ -974,7 +974,7 @@ mnuOperation_OilAdjust(const Uint16 input)
 Uint16 
 fxnOperation_OilAdjust(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_OPERATION_OILADJUST;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_OPERATION_OILADJUST;
 
     if (isMessage) { return notifyMessageAndExit(FXN_OPERATION_OILADJUST, MNU_OPERATION_OILADJUST); }
 
@@ -994,7 +994,7 @@ fxnOperation_OilAdjust(const Uint16 input)
 Uint16 
 mnuOperation_OilCapture(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_OPERATION_OILCAPTURE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_OPERATION_OILCAPTURE;
 
     COIL_BEGIN_OIL_CAP.val = FALSE;
 	(isUpdateDisplay) ? updateDisplay(OILCAPTURE, BLANK) : blinkLcdLine1(STEP_START, BLANK);
@@ -1013,7 +1013,7 @@ mnuOperation_OilCapture(const Uint16 input)
 Uint16 
 fxnOperation_OilCapture(const Uint16 input)
 {
-    if (I2C_TXBUF.n > 0) return FXN_OPERATION_OILCAPTURE;
+    if (Ring_Count(&I2C_TXBUF) > 0) return FXN_OPERATION_OILCAPTURE;
 
     static unsigned int blinks = 0; 
 
@@ -1063,7 +1063,7 @@ fxnOperation_OilCapture(const Uint16 input)
 Uint16 
 mnuOperation_Sample(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_OPERATION_SAMPLE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_OPERATION_SAMPLE;
 
 	if (isUpdateDisplay) updateDisplay(SAMPLE, BLANK); 
 
@@ -1081,7 +1081,7 @@ mnuOperation_Sample(const Uint16 input)
 Uint16 
 fxnOperation_Sample_Stream(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_OPERATION_SAMPLE_STREAM;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_OPERATION_SAMPLE_STREAM;
 
     if (isMessage) { return notifyMessageAndExit(FXN_OPERATION_SAMPLE_STREAM, MNU_OPERATION_SAMPLE); }
 
@@ -1103,7 +1103,7 @@ fxnOperation_Sample_Stream(const Uint16 input)
 Uint16 
 fxnOperation_Sample_Timestamp(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_OPERATION_SAMPLE_TIMESTAMP;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_OPERATION_SAMPLE_TIMESTAMP;
 
     if (isMessage) { return notifyMessageAndExit(FXN_OPERATION_SAMPLE_TIMESTAMP, MNU_OPERATION_SAMPLE); }
 
@@ -1121,7 +1121,7 @@ fxnOperation_Sample_Timestamp(const Uint16 input)
 Uint16 
 fxnOperation_Sample_Value(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_OPERATION_SAMPLE_VALUE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_OPERATION_SAMPLE_VALUE;
 
     if (isMessage) { return notifyMessageAndExit(FXN_OPERATION_SAMPLE_VALUE, MNU_OPERATION_SAMPLE); }
 
@@ -1140,7 +1140,7 @@ fxnOperation_Sample_Value(const Uint16 input)
 Uint16 
 mnuConfig_Analyzer(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER;
 	if (isUpdateDisplay) updateDisplay(CFG_ANALYZER, BLANK); 
 
 	switch (input)	
@@ -1157,7 +1157,7 @@ mnuConfig_Analyzer(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_ProcsAvg(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_PROCSAVG;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_PROCSAVG;
 
 	sprintf(lcdLine1,"%8.0f Samples", REG_PROC_AVGING.calc_val);
 
@@ -1177,7 +1177,7 @@ mnuConfig_Analyzer_ProcsAvg(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_ProcsAvg(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_PROCSAVG;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_PROCSAVG;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_PROCSAVG, MNU_CFG_ANALYZER_PROCSAVG); }
 
@@ -1197,7 +1197,7 @@ fxnConfig_Analyzer_ProcsAvg(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_TempUnit(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_TEMPUNIT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_TEMPUNIT;
 
     (REG_TEMPERATURE.unit == u_temp_C) ? sprintf(lcdLine1,"%15cC", DEGREE_CHAR) : sprintf(lcdLine1,"%15cF", DEGREE_CHAR);
 
@@ -1217,7 +1217,7 @@ mnuConfig_Analyzer_TempUnit(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_TempUnit(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_TEMPUNIT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_TEMPUNIT;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_TEMPUNIT, MNU_CFG_ANALYZER_TEMPUNIT); }
 
 	static BOOL isCelsius = TRUE;
@@ -1248,7 +1248,7 @@ fxnConfig_Analyzer_TempUnit(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_TempAdj(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_TEMPADJ;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_TEMPADJ;
 
 	(REG_TEMPERATURE.unit == u_temp_C) ? sprintf(lcdLine1,"%14.1f%cC", REG_TEMP_ADJUST.val, LCD_DEGREE) : sprintf(lcdLine1,"%14.1f%cF", REG_TEMP_ADJUST.val, LCD_DEGREE);
 
@@ -1268,7 +1268,7 @@ mnuConfig_Analyzer_TempAdj(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_TempAdj(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_TEMPADJ;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_TEMPADJ;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_TEMPADJ, MNU_CFG_ANALYZER_TEMPADJ); }
 
@@ -1288,7 +1288,7 @@ fxnConfig_Analyzer_TempAdj(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_OilP0(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_OILP0;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_OILP0;
 
     displayMnu(CFG_ANALYZER_OILP0, REG_OIL_P0.calc_val, 4);
 
@@ -1306,7 +1306,7 @@ mnuConfig_Analyzer_OilP0(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_OilP0(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_OILP0;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_OILP0;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_OILP0, MNU_CFG_ANALYZER_OILP0); }
 
@@ -1326,7 +1326,7 @@ fxnConfig_Analyzer_OilP0(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_OilP1(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_OILP1;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_OILP1;
 
     displayMnu(CFG_ANALYZER_OILP1, REG_OIL_P1.calc_val, 4);
 
@@ -1344,7 +1344,7 @@ mnuConfig_Analyzer_OilP1(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_OilP1(const Uint16 input)
 {
-    if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_OILP1;
+    if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_OILP1;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_OILP1, MNU_CFG_ANALYZER_OILP1); }
 
@@ -1363,7 +1363,7 @@ fxnConfig_Analyzer_OilP1(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_OilIndex(const Uint16 input)
 {
-    if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_OILINDEX;
+    if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_OILINDEX;
 
     sprintf(lcdLine1, "%12.3f Mhz", Round_N(REG_OIL_INDEX.calc_val,3));
 
@@ -1383,7 +1383,7 @@ mnuConfig_Analyzer_OilIndex(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_OilIndex(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_OILINDEX;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_OILINDEX;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_OILINDEX, MNU_CFG_ANALYZER_OILINDEX); }
 
@@ -1403,7 +1403,7 @@ fxnConfig_Analyzer_OilIndex(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_OilFreqLow(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_OILFREQLOW;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_OILFREQLOW;
 
     sprintf(lcdLine1, "%12.3f Mhz", Round_N(REG_OIL_FREQ_LOW.calc_val,3));
 
@@ -1423,7 +1423,7 @@ mnuConfig_Analyzer_OilFreqLow(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_OilFreqLow(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_OILFREQLOW;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_OILFREQLOW;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_OILFREQLOW, MNU_CFG_ANALYZER_OILFREQLOW); }
 
@@ -1443,7 +1443,7 @@ fxnConfig_Analyzer_OilFreqLow(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_OilFreqHi(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_OILFREQHI;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_OILFREQHI;
 
 	sprintf(lcdLine1, "%12.3f Mhz", Round_N(REG_OIL_FREQ_HIGH.calc_val,3));
 
@@ -1463,7 +1463,7 @@ mnuConfig_Analyzer_OilFreqHi(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_OilFreqHi(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_OILFREQHI;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_OILFREQHI;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_OILFREQHI, MNU_CFG_ANALYZER_OILFREQHI); }
 
@@ -1483,7 +1483,7 @@ fxnConfig_Analyzer_OilFreqHi(const Uint16 input)
 Uint16
 mnuConfig_Analyzer_PhaseHold(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_ANALYZER_PHASEHOLD;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_ANALYZER_PHASEHOLD;
     
     displayMnu(CFG_ANALYZER_PHASEHOLD,(double)REG_PHASE_HOLD_CYCLES, 0);
 
@@ -1501,7 +1501,7 @@ mnuConfig_Analyzer_PhaseHold(const Uint16 input)
 Uint16
 fxnConfig_Analyzer_PhaseHold(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_ANALYZER_PHASEHOLD;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_ANALYZER_PHASEHOLD;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_ANALYZER_PHASEHOLD, MNU_CFG_ANALYZER_PHASEHOLD); }
 
@@ -1521,7 +1521,7 @@ fxnConfig_Analyzer_PhaseHold(const Uint16 input)
 Uint16 
 mnuConfig_AvgTemp(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AVGTEMP;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AVGTEMP;
 	(REG_TEMPERATURE.unit == u_temp_C) ? sprintf(lcdLine1,"%14.1f%cC", REG_TEMP_AVG.val, LCD_DEGREE) : sprintf(lcdLine1,"%14.1f%cF", REG_TEMP_AVG.val, LCD_DEGREE);
 	(isUpdateDisplay) ? updateDisplay(CFG_AVGTEMP, lcdLine1) : displayLcd(lcdLine1,LCD1);
 
@@ -1539,7 +1539,7 @@ mnuConfig_AvgTemp(const Uint16 input)
 Uint16 
 mnuConfig_AvgTemp_Mode(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AVGTEMP_MODE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AVGTEMP_MODE;
 
     if (isUpdateDisplay) (COIL_AVGTEMP_MODE.val) ? updateDisplay(CFG_AVGTEMP_MODE,TWENTYFOURHR) : updateDisplay(CFG_AVGTEMP_MODE,ONDEMAND);
 		
@@ -1557,7 +1557,7 @@ mnuConfig_AvgTemp_Mode(const Uint16 input)
 Uint16 
 fxnConfig_AvgTemp_Mode(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AVGTEMP_MODE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AVGTEMP_MODE;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_AVGTEMP_MODE, MNU_CFG_AVGTEMP_MODE); }
 
 	static Uint8 index = 0;
@@ -1583,7 +1583,7 @@ fxnConfig_AvgTemp_Mode(const Uint16 input)
 Uint16 
 mnuConfig_AvgTemp_AvgReset(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AVGTEMP_AVGRESET;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AVGTEMP_AVGRESET;
 
 	if (isUpdateDisplay) updateDisplay(CFG_AVGTEMP_AVGRESET, BLANK); 
 
@@ -1601,7 +1601,7 @@ mnuConfig_AvgTemp_AvgReset(const Uint16 input)
 Uint16 
 fxnConfig_AvgTemp_AvgReset(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AVGTEMP_AVGRESET;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AVGTEMP_AVGRESET;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_AVGTEMP_AVGRESET, MNU_CFG_AVGTEMP_AVGRESET); }
 
 	static BOOL isEntered = FALSE;
@@ -1631,7 +1631,7 @@ fxnConfig_AvgTemp_AvgReset(const Uint16 input)
 Uint16 
 mnuConfig_DataLogger(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DATALOGGER;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DATALOGGER;
 	(isUpdateDisplay) ? updateDisplay(CFG_DATALOGGER, BLANK) : displayLcd(BLANK, LCD1);
 
 	switch (input)	
@@ -1648,7 +1648,7 @@ mnuConfig_DataLogger(const Uint16 input)
 Uint16 
 mnuConfig_DataLogger_EnableLogger(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DATALOGGER_ENABLELOGGER;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DATALOGGER_ENABLELOGGER;
 	if (isUpdateDisplay) (isLogData) ? updateDisplay(CFG_DATALOGGER_ENABLELOGGER, ENABLED) : updateDisplay(CFG_DATALOGGER_ENABLELOGGER, DISABLED);
 
     /// update status
@@ -1668,7 +1668,7 @@ mnuConfig_DataLogger_EnableLogger(const Uint16 input)
 Uint16 
 fxnConfig_DataLogger_EnableLogger(const Uint16 input)
 {
-    if (I2C_TXBUF.n > 0) return FXN_CFG_DATALOGGER_ENABLELOGGER;
+    if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DATALOGGER_ENABLELOGGER;
     static BOOL isEnabled = FALSE;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DATALOGGER_ENABLELOGGER, MNU_CFG_DATALOGGER_ENABLELOGGER); }
 
@@ -1710,7 +1710,7 @@ fxnConfig_DataLogger_EnableLogger(const Uint16 input)
 Uint16 
 mnuConfig_DataLogger_Period(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DATALOGGER_PERIOD;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DATALOGGER_PERIOD;
 	sprintf(lcdLine1, "%11d Secs", REG_LOGGING_PERIOD);
 	if (isUpdateDisplay) updateDisplay(CFG_DATALOGGER_PERIOD, lcdLine1);
 
@@ -1728,7 +1728,7 @@ mnuConfig_DataLogger_Period(const Uint16 input)
 Uint16 
 fxnConfig_DataLogger_Period(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DATALOGGER_PERIOD;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DATALOGGER_PERIOD;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DATALOGGER_PERIOD, MNU_CFG_DATALOGGER_PERIOD); }
     displayFxn(CFG_DATALOGGER_PERIOD, REG_LOGGING_PERIOD, 0);
 
@@ -1746,7 +1746,7 @@ fxnConfig_DataLogger_Period(const Uint16 input)
 Uint16 
 mnuConfig_AnalogOutput(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO;
 	sprintf(lcdLine1, "%13.2f mA", Round_N(REG_AO_OUTPUT,1));
 	if (isUpdateDisplay) updateDisplay(CFG_AO, lcdLine1); 
 	displayLcd(lcdLine1,LCD1);
@@ -1764,7 +1764,7 @@ mnuConfig_AnalogOutput(const Uint16 input)
 Uint16 
 mnuConfig_AO_LRV(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO_LRV;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO_LRV;
 	sprintf(lcdLine1, "%15.2f%%", REG_AO_LRV.calc_val);
 	if (isUpdateDisplay) updateDisplay(CFG_AO_LRV, lcdLine1);
 	
@@ -1782,7 +1782,7 @@ mnuConfig_AO_LRV(const Uint16 input)
 Uint16 
 fxnConfig_AO_LRV(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AO_LRV;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AO_LRV;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_AO_LRV, MNU_CFG_AO_LRV); }
     displayFxn(CFG_AO_LRV, REG_AO_LRV.calc_val, 2);
 
@@ -1800,7 +1800,7 @@ fxnConfig_AO_LRV(const Uint16 input)
 Uint16 
 mnuConfig_AO_URV(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO_URV;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO_URV;
 	sprintf(lcdLine1, "%15.2f%%", REG_AO_URV.calc_val);
 	if (isUpdateDisplay) updateDisplay(CFG_AO_URV, lcdLine1);
 	
@@ -1818,7 +1818,7 @@ mnuConfig_AO_URV(const Uint16 input)
 Uint16 
 fxnConfig_AO_URV(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AO_URV;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AO_URV;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_AO_URV, MNU_CFG_AO_URV); }
     displayFxn(CFG_AO_URV, REG_AO_URV.calc_val, 2);
 
@@ -1836,7 +1836,7 @@ fxnConfig_AO_URV(const Uint16 input)
 Uint16 
 mnuConfig_AO_Dampening(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO_DAMPENING;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO_DAMPENING;
     sprintf(lcdLine1, "%11d Secs", REG_AO_DAMPEN);
 	if (isUpdateDisplay) updateDisplay(CFG_AO_DAMPENING, lcdLine1);
 
@@ -1854,7 +1854,7 @@ mnuConfig_AO_Dampening(const Uint16 input)
 Uint16 
 fxnConfig_AO_Dampening(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AO_DAMPENING;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AO_DAMPENING;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_AO_DAMPENING, MNU_CFG_AO_DAMPENING); }
     displayFxn(CFG_AO_DAMPENING, (double)REG_AO_DAMPEN, 0);
 
@@ -1872,7 +1872,7 @@ fxnConfig_AO_Dampening(const Uint16 input)
 Uint16 
 mnuConfig_AO_Alarm(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO_ALARM;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO_ALARM;
     sprintf(lcdLine1, errorMode[REG_AO_ALARM_MODE]);
     (isUpdateDisplay) ? updateDisplay(CFG_AO_ALARM, lcdLine1) : displayLcd(lcdLine1, LCD1);
 
@@ -1890,7 +1890,7 @@ mnuConfig_AO_Alarm(const Uint16 input)
 Uint16 
 fxnConfig_AO_Alarm(const Uint16 input)
 {	
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AO_ALARM;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AO_ALARM;
 
 	static Uint8 index;
 
@@ -1918,7 +1918,7 @@ fxnConfig_AO_Alarm(const Uint16 input)
 Uint16 
 mnuConfig_AO_TrimLo(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO_TRIMLO;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO_TRIMLO;
 
     static double manualValLoPrev = 0;      // holds current manual output value
 	static Uint8 aoModeLoPrev 	= 0;        // holds current MANUAL mode status
@@ -1963,7 +1963,7 @@ mnuConfig_AO_TrimLo(const Uint16 input)
 Uint16
 fxnConfig_AO_TrimLo(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AO_TRIMLO;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AO_TRIMLO;
 
     static double manualValLoFxnPrev = 0;    // holds current manual output value
 	static Uint8 aoModeLoFxnPrev 	= 0;    // holds current MANUAL mode status
@@ -2004,7 +2004,7 @@ fxnConfig_AO_TrimLo(const Uint16 input)
 Uint16 
 mnuConfig_AO_TrimHi(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO_TRIMHI;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO_TRIMHI;
 
     static double manualValHiPrev = 0;    // holds current manual output value
 	static Uint8 aoModeHiPrev 	= 0;    // holds current MANUAL mode status
@@ -2049,7 +2049,7 @@ mnuConfig_AO_TrimHi(const Uint16 input)
 Uint16 
 fxnConfig_AO_TrimHi(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AO_TRIMHI;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AO_TRIMHI;
 
     static double manualValHiFxnPrev = 0;    // holds current manual output value
 	static Uint8 aoModeHiFxnPrev 	= 0;    // holds current MANUAL mode status
@@ -2090,7 +2090,7 @@ fxnConfig_AO_TrimHi(const Uint16 input)
 Uint16 
 mnuConfig_AO_Mode(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO_MODE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO_MODE;
 
     strcpy(lcdLine1, aoMode[REG_AO_MODE]);
 
@@ -2112,7 +2112,7 @@ mnuConfig_AO_Mode(const Uint16 input)
 Uint16 
 fxnConfig_AO_Mode(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AO_MODE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AO_MODE;
 
 	static Uint8 index;
 
@@ -2140,7 +2140,7 @@ fxnConfig_AO_Mode(const Uint16 input)
 Uint16 
 mnuConfig_AO_AoValue(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_AO_AOVALUE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_AO_AOVALUE;
 
     sprintf(lcdLine1, "%13.2f mA", REG_AO_MANUAL_VAL);
 
@@ -2160,7 +2160,7 @@ mnuConfig_AO_AoValue(const Uint16 input)
 Uint16 
 fxnConfig_AO_AoValue(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_AO_AOVALUE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_AO_AOVALUE;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_AO_AOVALUE, MNU_CFG_AO_AOVALUE); }
 
@@ -2180,7 +2180,7 @@ fxnConfig_AO_AoValue(const Uint16 input)
 Uint16 
 mnuConfig_Comm(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_COMM;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_COMM;
 	(isUpdateDisplay) ? updateDisplay(CFG_COMM, BLANK) : displayLcd(BLANK,LCD1);
 
 	switch (input)	
@@ -2197,7 +2197,7 @@ mnuConfig_Comm(const Uint16 input)
 Uint16 
 mnuConfig_Comm_SlaveAddr(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_COMM_SLAVEADDR;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_COMM_SLAVEADDR;
 
     sprintf(lcdLine1, "%16d", REG_SLAVE_ADDRESS);
 
@@ -2217,7 +2217,7 @@ mnuConfig_Comm_SlaveAddr(const Uint16 input)
 Uint16 
 fxnConfig_Comm_SlaveAddr(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_COMM_SLAVEADDR;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_COMM_SLAVEADDR;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_COMM_SLAVEADDR, MNU_CFG_COMM_SLAVEADDR); }
     
@@ -2237,7 +2237,7 @@ fxnConfig_Comm_SlaveAddr(const Uint16 input)
 Uint16 
 mnuConfig_Comm_BaudRate(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_COMM_BAUDRATE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_COMM_BAUDRATE;
 
 	sprintf(lcdLine1, "%12d BPS", (Uint32)REG_BAUD_RATE.calc_val);
 
@@ -2257,7 +2257,7 @@ mnuConfig_Comm_BaudRate(const Uint16 input)
 Uint16 
 fxnConfig_Comm_BaudRate(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_COMM_BAUDRATE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_COMM_BAUDRATE;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_COMM_BAUDRATE, MNU_CFG_COMM_BAUDRATE); }
 
 	static Uint8 index;
@@ -2287,7 +2287,7 @@ fxnConfig_Comm_BaudRate(const Uint16 input)
 Uint16 
 mnuConfig_Comm_Parity(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_COMM_PARITY;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_COMM_PARITY;
 
 	if (isUpdateDisplay) (COIL_PARITY.val) ? updateDisplay(CFG_COMM_PARITY, EVEN) : updateDisplay(CFG_COMM_PARITY, NONE);
 
@@ -2305,7 +2305,7 @@ mnuConfig_Comm_Parity(const Uint16 input)
 Uint16 
 fxnConfig_Comm_Parity(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_COMM_PARITY;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_COMM_PARITY;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_COMM_PARITY, MNU_CFG_COMM_PARITY); }
 
 	static BOOL isEnabled = TRUE;
@@ -2330,7 +2330,7 @@ fxnConfig_Comm_Parity(const Uint16 input)
 Uint16 
 mnuConfig_Comm_Statistics(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_COMM_STATISTICS;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_COMM_STATISTICS;
 
          if (REG_STATISTICS == 0) sprintf(lcdLine1, "Success:%8d",STAT_SUCCESS);
     else if (REG_STATISTICS == 1) sprintf(lcdLine1, "Inv Pkt:%8d",STAT_PKT);
@@ -2361,7 +2361,7 @@ mnuConfig_Comm_Statistics(const Uint16 input)
 Uint16 
 fxnConfig_Comm_Statistics(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_COMM_STATISTICS;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_COMM_STATISTICS;
     
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_COMM_STATISTICS, MNU_CFG_COMM_STATISTICS); }
 
@@ -2391,7 +2391,7 @@ fxnConfig_Comm_Statistics(const Uint16 input)
 Uint16 
 mnuConfig_Relay(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_RELAY;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_RELAY;
 
     (COIL_RELAY[0].val) ? sprintf(lcdLine1, RELAY_ON) : sprintf(lcdLine1, RELAY_OFF);
     (isUpdateDisplay) ? updateDisplay(CFG_RELAY, lcdLine1) : displayLcd(lcdLine1, LCD1);
@@ -2410,7 +2410,7 @@ mnuConfig_Relay(const Uint16 input)
 Uint16 
 mnuConfig_Relay_Delay(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_RELAY_DELAY;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_RELAY_DELAY;
 
     sprintf(lcdLine1, "%11d Secs", REG_RELAY_DELAY);
 
@@ -2430,7 +2430,7 @@ mnuConfig_Relay_Delay(const Uint16 input)
 Uint16 
 fxnConfig_Relay_Delay(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_RELAY_DELAY;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_RELAY_DELAY;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_RELAY_DELAY, MNU_CFG_RELAY_DELAY); }
 
@@ -2450,7 +2450,7 @@ fxnConfig_Relay_Delay(const Uint16 input)
 Uint16 
 mnuConfig_Relay_Mode(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_RELAY_MODE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_RELAY_MODE;
 
     sprintf(lcdLine1, relayMode[REG_RELAY_MODE]);
 
@@ -2475,7 +2475,7 @@ mnuConfig_Relay_Mode(const Uint16 input)
 Uint16 
 fxnConfig_Relay_Mode(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_RELAY_MODE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_RELAY_MODE;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_RELAY_MODE, MNU_CFG_RELAY_MODE); }
 
@@ -2502,7 +2502,7 @@ fxnConfig_Relay_Mode(const Uint16 input)
 Uint16 
 mnuConfig_Relay_ActWhile(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_RELAY_ACTWHILE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_RELAY_ACTWHILE;
 
 	sprintf(lcdLine1, phaseMode[COIL_ACT_RELAY_OIL.val]);
 
@@ -2522,7 +2522,7 @@ mnuConfig_Relay_ActWhile(const Uint16 input)
 Uint16 
 fxnConfig_Relay_ActWhile(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_RELAY_ACTWHILE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_RELAY_ACTWHILE;
 
     static Uint8 index;
 
@@ -2550,7 +2550,7 @@ fxnConfig_Relay_ActWhile(const Uint16 input)
 Uint16 
 mnuConfig_Relay_RelayStatus(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_RELAY_RELAYSTATUS;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_RELAY_RELAYSTATUS;
 
 	sprintf(lcdLine1, statusMode[COIL_RELAY_MANUAL.val]);
 
@@ -2570,7 +2570,7 @@ mnuConfig_Relay_RelayStatus(const Uint16 input)
 Uint16 
 fxnConfig_Relay_RelayStatus(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_RELAY_RELAYSTATUS;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_RELAY_RELAYSTATUS;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_RELAY_RELAYSTATUS, MNU_CFG_RELAY_RELAYSTATUS); }
 
 	const char * statusMode[2] = {RELAY_OFF, RELAY_ON}; 
@@ -2597,7 +2597,7 @@ fxnConfig_Relay_RelayStatus(const Uint16 input)
 Uint16 
 mnuConfig_Relay_SetPoint(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_RELAY_SETPOINT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_RELAY_SETPOINT;
 	  
     sprintf(lcdLine1, "%15.1f%%", Round_N(REG_RELAY_SETPOINT.calc_val,1));
 
@@ -2617,7 +2617,7 @@ mnuConfig_Relay_SetPoint(const Uint16 input)
 Uint16 
 fxnConfig_Relay_SetPoint(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_RELAY_SETPOINT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_RELAY_SETPOINT;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_RELAY_SETPOINT, MNU_CFG_RELAY_SETPOINT); }
     
@@ -2637,7 +2637,7 @@ fxnConfig_Relay_SetPoint(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR;
 	sprintf(lcdLine1, densityMode[REG_OIL_DENS_CORR_MODE]);
 	if (isUpdateDisplay) 
     {
@@ -2663,7 +2663,7 @@ mnuConfig_DnsCorr(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_CorrEnable(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_CORRENABLE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_CORRENABLE;
 
 	sprintf(lcdLine1, densityMode[REG_OIL_DENS_CORR_MODE]);
 
@@ -2692,7 +2692,7 @@ mnuConfig_DnsCorr_CorrEnable(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_CorrEnable(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_CORRENABLE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_CORRENABLE;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_CORRENABLE, MNU_CFG_DNSCORR_CORRENABLE); }
 
@@ -2720,7 +2720,7 @@ fxnConfig_DnsCorr_CorrEnable(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_DispUnit(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_DISPUNIT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_DISPUNIT;
 
 	static Uint8 index;
 
@@ -2749,7 +2749,7 @@ mnuConfig_DnsCorr_DispUnit(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_DispUnit(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_DISPUNIT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_DISPUNIT;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_DISPUNIT, MNU_CFG_DNSCORR_DISPUNIT); }
 
 	static Uint8 index;
@@ -2787,7 +2787,7 @@ fxnConfig_DnsCorr_DispUnit(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_CoefD0(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_COEFD0;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_COEFD0;
     
 	displayMnu(CFG_DNSCORR_COEFD0, REG_DENSITY_D0.calc_val, 4);
 
@@ -2805,7 +2805,7 @@ mnuConfig_DnsCorr_CoefD0(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_CoefD0(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_COEFD0;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_COEFD0;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_COEFD0, MNU_CFG_DNSCORR_COEFD0); }
 
@@ -2825,7 +2825,7 @@ fxnConfig_DnsCorr_CoefD0(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_CoefD1(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_COEFD1;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_COEFD1;
     
 	displayMnu(CFG_DNSCORR_COEFD1, REG_DENSITY_D1.calc_val, 4);
 
@@ -2843,7 +2843,7 @@ mnuConfig_DnsCorr_CoefD1(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_CoefD1(const Uint16 input)
 {	
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_COEFD1;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_COEFD1;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_COEFD1, MNU_CFG_DNSCORR_COEFD1); }
 
@@ -2863,7 +2863,7 @@ fxnConfig_DnsCorr_CoefD1(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_CoefD2(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_COEFD2;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_COEFD2;
 
     displayMnu(CFG_DNSCORR_COEFD2, REG_DENSITY_D2.calc_val, 4);
 
@@ -2881,7 +2881,7 @@ mnuConfig_DnsCorr_CoefD2(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_CoefD2(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_COEFD2; 
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_COEFD2; 
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_COEFD2, MNU_CFG_DNSCORR_COEFD2); }
 
@@ -2901,7 +2901,7 @@ fxnConfig_DnsCorr_CoefD2(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_CoefD3(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_COEFD3;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_COEFD3;
 
     displayMnu(CFG_DNSCORR_COEFD3, REG_DENSITY_D3.calc_val, 4);
 
@@ -2919,7 +2919,7 @@ mnuConfig_DnsCorr_CoefD3(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_CoefD3(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_COEFD3;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_COEFD3;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_COEFD3, MNU_CFG_DNSCORR_COEFD3); }
 
@@ -2939,7 +2939,7 @@ fxnConfig_DnsCorr_CoefD3(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_InputUnit(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_INPUTUNIT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_INPUTUNIT;
 
 	static Uint8 index;
 
@@ -2972,7 +2972,7 @@ mnuConfig_DnsCorr_InputUnit(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_InputUnit(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_INPUTUNIT;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_INPUTUNIT;
 
 	double tempDensityVal = 0;
 	double tempLrvVal = 0;
@@ -3022,7 +3022,7 @@ fxnConfig_DnsCorr_InputUnit(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_Manual(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_MANUAL;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_MANUAL;
     
 	displayMnu(CFG_DNSCORR_MANUAL, REG_OIL_DENSITY_MANUAL, 2);
 
@@ -3040,7 +3040,7 @@ mnuConfig_DnsCorr_Manual(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_Manual(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_MANUAL;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_MANUAL;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_MANUAL, MNU_CFG_DNSCORR_MANUAL); }
 
@@ -3060,7 +3060,7 @@ fxnConfig_DnsCorr_Manual(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_AiLrv(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_AILRV;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_AILRV;
 	sprintf(lcdLine1,"%16.2f", REG_OIL_DENSITY_AI_LRV.calc_val);
     if (isUpdateDisplay) updateDisplay(CFG_DNSCORR_AILRV, lcdLine1);
 
@@ -3080,7 +3080,7 @@ mnuConfig_DnsCorr_AiLrv(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_AiLrv(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_AILRV;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_AILRV;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_AILRV, MNU_CFG_DNSCORR_AILRV); }
 
@@ -3100,7 +3100,7 @@ fxnConfig_DnsCorr_AiLrv(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_AiUrv(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_AIURV;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_AIURV;
 	 sprintf(lcdLine1,"%16.2f", REG_OIL_DENSITY_AI_URV.calc_val);
     if (isUpdateDisplay) updateDisplay(CFG_DNSCORR_AIURV, lcdLine1);
 
@@ -3118,7 +3118,7 @@ mnuConfig_DnsCorr_AiUrv(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_AiUrv(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_AIURV;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_AIURV;
 
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_AIURV, MNU_CFG_DNSCORR_AIURV); }
 
@@ -3138,7 +3138,7 @@ fxnConfig_DnsCorr_AiUrv(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_Ai_TrimLo(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_AI_TRIMLO;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_AI_TRIMLO;
 
     COIL_AI_TRIM_MODE.val = FALSE;
 
@@ -3161,7 +3161,7 @@ mnuConfig_DnsCorr_Ai_TrimLo(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_Ai_TrimLo(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_AI_TRIMLO;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_AI_TRIMLO;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_AI_TRIMLO, MNU_CFG_DNSCORR_AI_TRIMLO); }
 
 	sprintf(lcdLine1, "%14.4fmA", REG_AI_MEASURE);
@@ -3186,7 +3186,7 @@ fxnConfig_DnsCorr_Ai_TrimLo(const Uint16 input)
 Uint16 
 mnuConfig_DnsCorr_Ai_TrimHi(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_CFG_DNSCORR_AI_TRIMHI;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_CFG_DNSCORR_AI_TRIMHI;
 
     COIL_AI_TRIM_MODE.val = FALSE;
 
@@ -3210,7 +3210,7 @@ mnuConfig_DnsCorr_Ai_TrimHi(const Uint16 input)
 Uint16 
 fxnConfig_DnsCorr_Ai_TrimHi(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_CFG_DNSCORR_AI_TRIMHI;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_CFG_DNSCORR_AI_TRIMHI;
     if (isMessage) { return notifyMessageAndExit(FXN_CFG_DNSCORR_AI_TRIMHI, MNU_CFG_DNSCORR_AI_TRIMHI); }
 
 	sprintf(lcdLine1, "%14.4fmA", REG_AI_MEASURE);
@@ -3235,7 +3235,7 @@ fxnConfig_DnsCorr_Ai_TrimHi(const Uint16 input)
 Uint16 
 mnuSecurityInfo_Info(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_INFO;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_INFO;
 
    	(isUpdateDisplay) ? updateDisplay(SECURITYINFO_INFO,BLANK) : displayLcd(BLANK, LCD1);
 
@@ -3253,7 +3253,7 @@ mnuSecurityInfo_Info(const Uint16 input)
 Uint16 
 fxnSecurityInfo_SN(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_SN;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_SN;
 
     sprintf(lcdLine1,"%16u",(Uint16) REG_SN_PIPE);
 
@@ -3272,7 +3272,7 @@ fxnSecurityInfo_SN(const Uint16 input)
 Uint16 
 fxnSecurityInfo_MC(const Uint16 input)
 {
-    if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_MC;
+    if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_MC;
 
 	if (isUpdateDisplay)
 	{
@@ -3303,7 +3303,7 @@ fxnSecurityInfo_MC(const Uint16 input)
 Uint16 
 fxnSecurityInfo_FW(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_FW;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_FW;
 
     sprintf(lcdLine1, "%16s", FIRMWARE_VERSION);
 
@@ -3321,7 +3321,7 @@ fxnSecurityInfo_FW(const Uint16 input)
 Uint16 
 fxnSecurityInfo_HW(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_HW;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_HW;
 
     sprintf(lcdLine1, "%16s", HARDWARE_VERSION);
 
@@ -3340,7 +3340,7 @@ fxnSecurityInfo_HW(const Uint16 input)
 Uint16 
 mnuSecurityInfo_TimeAndDate(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_TIMEANDDATE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_TIMEANDDATE;
     static int tmp_sec, tmp_min, tmp_hr, tmp_day, tmp_mon, tmp_yr;
     Read_RTC(&tmp_sec, &tmp_min, &tmp_hr, &tmp_day, &tmp_mon, &tmp_yr);
     sprintf(lcdLine1,"%02d:%02d %02d/%02d/20%02d",tmp_hr,tmp_min,tmp_mon,tmp_day,tmp_yr);
@@ -3361,7 +3361,7 @@ mnuSecurityInfo_TimeAndDate(const Uint16 input)
 Uint16 
 fxnSecurityInfo_TimeAndDate(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_TIMEANDDATE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_TIMEANDDATE;
     if (isMessage) { return notifyMessageAndExit(FXN_SECURITYINFO_TIMEANDDATE, MNU_SECURITYINFO_TIMEANDDATE); }
 
     char hh[2], mn[2], mm[2], dd[2], yy[2];
@@ -3436,7 +3436,7 @@ fxnSecurityInfo_TimeAndDate(const Uint16 input)
 Uint16 
 mnuSecurityInfo_AccessTech(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_ACCESSTECH;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_ACCESSTECH;
 
 	if (isUpdateDisplay) 
 	{
@@ -3470,7 +3470,7 @@ mnuSecurityInfo_AccessTech(const Uint16 input)
 Uint16 
 fxnSecurityInfo_AccessTech(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_ACCESSTECH;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_ACCESSTECH;
 
     if (isMessage) { return notifyMessageAndExit(FXN_SECURITYINFO_ACCESSTECH, MNU_SECURITYINFO_ACCESSTECH); }
 
@@ -3526,7 +3526,7 @@ fxnSecurityInfo_AccessTech(const Uint16 input)
 Uint16 
 mnuSecurityInfo_Diagnostics(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_DIAGNOSTICS;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_DIAGNOSTICS;
 	static Uint8 i = 0;	
 	static Uint8 index = 0;
 	static Uint8 errors[MAX_ERRORS];
@@ -3568,7 +3568,7 @@ mnuSecurityInfo_Diagnostics(const Uint16 input)
 Uint16 
 fxnSecurityInfo_Diagnostics(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_DIAGNOSTICS;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_DIAGNOSTICS;
     
 	static Uint8 i = 0;						// error index
 	static Uint8 index = 0;					// General index
@@ -3597,7 +3597,7 @@ fxnSecurityInfo_Diagnostics(const Uint16 input)
 Uint16 
 mnuSecurityInfo_ChangePassword(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_CHANGEPASSWORD;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_CHANGEPASSWORD;
 
    	if (isUpdateDisplay) updateDisplay(SECURITYINFO_CHANGEPASSWORD, BLANK);
 
@@ -3615,7 +3615,7 @@ mnuSecurityInfo_ChangePassword(const Uint16 input)
 Uint16 
 fxnSecurityInfo_ChangePassword(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_CHANGEPASSWORD;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_CHANGEPASSWORD;
 
     if (isMessage) { return notifyMessageAndExit(FXN_SECURITYINFO_CHANGEPASSWORD, MNU_SECURITYINFO_CHANGEPASSWORD); }
 
@@ -3635,7 +3635,7 @@ fxnSecurityInfo_ChangePassword(const Uint16 input)
 Uint16 
 mnuSecurityInfo_Restart(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_RESTART;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_RESTART;
    	if (isUpdateDisplay) updateDisplay(SECURITYINFO_RESTART, BLANK);
 
 	switch (input)	
@@ -3652,7 +3652,7 @@ mnuSecurityInfo_Restart(const Uint16 input)
 Uint16 
 fxnSecurityInfo_Restart(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_RESTART;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_RESTART;
 
     if (isMessage) { return notifyMessageAndExit(FXN_SECURITYINFO_RESTART, MNU_SECURITYINFO_RESTART); }
 	static BOOL isEntered = FALSE;
@@ -3682,7 +3682,7 @@ fxnSecurityInfo_Restart(const Uint16 input)
 Uint16 
 mnuSecurityInfo_FactReset(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_FACTRESET;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_FACTRESET;
 
 	if (isUpdateDisplay) updateDisplay(SECURITYINFO_FACTRESET, BLANK);
 
@@ -3700,7 +3700,7 @@ mnuSecurityInfo_FactReset(const Uint16 input)
 Uint16 
 fxnSecurityInfo_FactReset(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_FACTRESET;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_FACTRESET;
 
     if (isMessage) { return notifyMessageAndExit(FXN_SECURITYINFO_FACTRESET, MNU_SECURITYINFO_FACTRESET); }
 
@@ -3734,7 +3734,7 @@ fxnSecurityInfo_FactReset(const Uint16 input)
 Uint16 
 mnuSecurityInfo_Profile(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_PROFILE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_PROFILE;
 
 	if (isUpdateDisplay) updateDisplay(SECURITYINFO_PROFILE, BLANK);
 
@@ -3752,7 +3752,7 @@ mnuSecurityInfo_Profile(const Uint16 input)
 Uint16 
 fxnSecurityInfo_Profile(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_PROFILE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_PROFILE;
 
     if (isMessage) { return notifyMessageAndExit(FXN_SECURITYINFO_PROFILE, MNU_SECURITYINFO_PROFILE); }
 
@@ -3845,7 +3845,7 @@ fxnSecurityInfo_Profile(const Uint16 input)
 Uint16 
 mnuSecurityInfo_TechMode(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return MNU_SECURITYINFO_TECHMODE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return MNU_SECURITYINFO_TECHMODE;
 
 	if (isUpdateDisplay) updateDisplay(SECURITYINFO_TECHMODE, BLANK);
 
@@ -3863,7 +3863,7 @@ mnuSecurityInfo_TechMode(const Uint16 input)
 Uint16 
 fxnSecurityInfo_TechMode(const Uint16 input)
 {
-	if (I2C_TXBUF.n > 0) return FXN_SECURITYINFO_TECHMODE;
+	if (Ring_Count(&I2C_TXBUF) > 0) return FXN_SECURITYINFO_TECHMODE;
     if (isMessage) { return notifyMessageAndExit(FXN_SECURITYINFO_TECHMODE, MNU_SECURITYINFO_TECHMODE); }
 	static int i;
 	static double d;
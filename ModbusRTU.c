@@ -31,6 +31,7 @@
 #include "Pinmux.h"
 #include "Globals.h"
 #include "ModbusTables.h"
+#include "nandwriter.h"
 #include <ti/csl/cslr_syscfg.h>
 #include <ti/csl/src/ip/syscfg/V0/cslr_syscfg.h>
 
@@ -39,6 +40,7 @@ extern BOOL updateVars(const int id,double val);
 
 ///// EXTENDED REGISTERS /////
 #define SPECIAL_OFFSET 60000
+#define EXT_REG_TYPE(t) (((t) == REGTYPE_CHAR) ? REG_TYPE_INTEGER : REG_TYPE_FLOAT) // character arrays take one register per element, like an integer
 #define REMAINDER      10000 // used to be 2000
 #define MIN_MB_INT     201
 #define MAX_MB_INT     300
@@ -47,6 +49,85 @@ extern BOOL updateVars(const int id,double val);
 #define MIN_MB_LONGINT 301
 #define MAX_MB_LONGINT 400
 
+///// DIRECT-INDEX REGISTER LOOKUP /////
+#define MB_IDX_NONE         0xFF  // register not in table
+#define MB_IDX_FLOAT_SIZE   801   // 1-200, 501-563, 701-800
+#define MB_IDX_INT_SIZE     501   // 201-300, 401-500
+#define MB_IDX_LONGINT_SIZE 401   // 301-400
+#define MB_IDX_COIL_SIZE    1000  // 1-999 (anything above falls back to a scan)
+
+static Uint8 MB_IDX_FLOAT[MB_IDX_FLOAT_SIZE];
+static Uint8 MB_IDX_INT[MB_IDX_INT_SIZE];
+static Uint8 MB_IDX_LONGINT[MB_IDX_LONGINT_SIZE];
+static Uint8 MB_IDX_COIL[MB_IDX_COIL_SIZE];
+
+// the indexes hold a Uint8 row, so every table (terminator included) must fit
+// below MB_IDX_NONE; a table that grows past that fails to compile here
+#define MB_IDX_ROWS_OK(tbl)	(sizeof(tbl)/sizeof(tbl[0]) <= MB_IDX_NONE ? 1 : -1)
+typedef char MB_IDX_FLOAT_ROWS_OK[MB_IDX_ROWS_OK(MB_TBL_FLOAT)];
+typedef char MB_IDX_INT_ROWS_OK[MB_IDX_ROWS_OK(MB_TBL_INT)];
+typedef char MB_IDX_LONGINT_ROWS_OK[MB_IDX_ROWS_OK(MB_TBL_LONGINT)];
+typedef char MB_IDX_COIL_ROWS_OK[MB_IDX_ROWS_OK(MB_TBL_COIL)];
+
+///// PRE-ENCODED FLOAT REGISTERS /////
+#define MB_FLT_CACHE_REGS   400   // float registers 1,3,...,799 -> slot (reg-1)/2
+
+static Uint8 MB_FLT_CACHE[2][4][MB_FLT_CACHE_REGS*4];	// [image][byte order][slot*4]
+static Uint8 MB_FLT_CACHE_OK[MB_FLT_CACHE_REGS];		// slot holds a readable register
+static volatile Uint8 MB_FLT_CACHE_READY = FALSE;		// cleared by any write until the next refresh
+static volatile Uint32 MB_FLT_CACHE_SEQ = 0;			// images published; readers use image SEQ & 1
+static volatile Uint32 MB_FLT_CACHE_WGEN = 0;			// writes so far
+
+// a write may have changed a cached register; read the table until the next refresh
+static inline void
+MB_Float_Cache_Dirty(void)
+{
+	MB_FLT_CACHE_WGEN++;
+	MB_FLT_CACHE_READY = FALSE;
+}
+
+static inline Uint32 MB_Float_Image(Uint32 data_type, const double* mbtable_ptr_dbl);
+static BOOL MB_Float_Cache_Put(const MB_PKT* mb_pkt_ptr);
+static BOOL MB_Float_Cache_Get(Uint16 reg, Uint32* v);
+
+///// CRC-16 (POLY 0xA001) /////
+#define MB_CRC_UPDATE(crc,b) (((crc) >> 8) ^ MB_CRC_TABLE[((crc) ^ (b)) & 0xFF])
+
+static const Uint16 MB_CRC_TABLE[256] = {
+	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+};
+
 void 
 delayInt(Uint32 count)
 {//note: this in not an inline fxn because we actually WANT the overhead
@@ -55,79 +136,443 @@ delayInt(Uint32 count)
 }
 
 /***************************************************************************
- * BfrPut()
- * @param buffer	- FIFO buffer in which to Put
- * @param in_byte	- byte to put in buffer
- * @return			- 0=success, 1=buffer overwrite
+ * Response frames are built here, CRC included, and handed whole to the
+ * transmit driver with MB_TX_Send(), so a half-built or abandoned frame is
+ * never seen by the line and the encoders do not need to mask interrupt 5.
+ * Each request remembers the driver (and tag) of the transport it came in
+ * on, so RTU and other transports (see ModbusTCP.c) can share the parser,
+ * the tables and the MB_SendPacket_* encoders.
+ ***************************************************************************/
+static Uint8	MB_TX_FRAME[MB_FRAME_SIZE];
+static Uint16	MB_TX_FRAME_N;
+static Uint32	MB_TX_BEGIN_TS;		// timestamp of the last MB_TX_Begin()
+static Uint32	MB_TX_RX_TS;		// timestamp of the request being answered
+static Uint32	MB_TX_TAG;			// driver tag of the request being answered
+static Uint32	MB_TS_PER_US = 1;	// timestamp counts per microsecond
+
+static void MB_TX_Uart_Send(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n);
+
+static const MB_TX_DRIVER MB_TX_UART = { MB_TX_Uart_Send, NULL };
+static const MB_TX_DRIVER* MB_TX_DRV = &MB_TX_UART;		// serial line
+static const MB_TX_DRIVER* MB_TX_REQ_DRV = &MB_TX_UART;	// transport of the request being answered
+static Uint8 MB_TX_LONG_ADDR = FALSE;						// that request used the 0xFA + serial number address
+
+/***************************************************************************
+ * MB_TX_Begin()
+ * @param pkt	- request being answered, or NULL to answer the one that
+ * 				  was being parsed or sent already (exceptions)
+ ***************************************************************************/
+static inline void
+MB_TX_Begin(const MB_PKT* pkt)
+{
+	MB_TX_FRAME_N = 0;
+	MB_TX_BEGIN_TS = Timestamp_get32();
+
+	if (pkt != NULL)
+	{
+		MB_TX_RX_TS 	= pkt->rx_ts;
+		MB_TX_REQ_DRV 	= pkt->tx_drv;
+		MB_TX_TAG 		= pkt->tx_tag;
+		MB_TX_LONG_ADDR	= pkt->long_address;
+	}
+}
+
+static inline void
+MB_TX_Put(Uint8 out_byte)
+{
+	if (MB_TX_FRAME_N < MB_FRAME_SIZE)
+		MB_TX_FRAME[MB_TX_FRAME_N++] = out_byte;
+}
+
+// remove everything we just added to the TX frame
+static inline void
+MB_TX_Discard(void)
+{
+	MB_TX_FRAME_N = 0;
+}
+
+static void
+MB_TX_Put_CRC(void)
+{
+	Uint16 CRC;
+
+	CRC = Calc_CRC(MB_TX_FRAME, MB_TX_FRAME_N);
+	MB_TX_Put(CRC & 0xFF);	// LSB
+	MB_TX_Put(CRC >> 8);	// MSB
+}
+
+/***************************************************************************
+ * MB_Stat_Turnaround() - adds one response to MB_STAT
+ * @param fxn	- function code as sent (MSB set for an exception)
+ * @param us	- last request byte to first response byte
+ ***************************************************************************/
+static void
+MB_Stat_Turnaround(Uint8 fxn, Uint32 us)
+{
+	Uint8 fxn_class, bin;
+
+	switch (fxn & 0x7F)
+	{
+		case 0x01: case 0x02: case 0x03: case 0x04:
+			fxn_class = MB_LAT_READ;
+			break;
+		case 0x05: case 0x06: case 0x0F: case 0x10:
+			fxn_class = MB_LAT_WRITE;
+			break;
+		case 0x17:
+			fxn_class = MB_LAT_READ_WRITE;
+			break;
+		default:
+			fxn_class = MB_LAT_OTHER;
+	}
+
+	for (bin=0;(bin<MB_LAT_BINS-1) && (us >= ((Uint32)MB_LAT_BIN0_US << bin));bin++);
+
+	MB_STAT.responses++;
+	MB_STAT.lat_hist[fxn_class][bin]++;
+	MB_STAT.lat_last_us = us;
+	if (us > MB_STAT.lat_max_us)
+		MB_STAT.lat_max_us = us;
+}
+
+static void
+MB_TX_Send(void)
+{
+	Uint8 fxn;
+
+	MB_TX_BUILD_CYCLES = Timestamp_get32() - MB_TX_BEGIN_TS;
+	MB_TX_IN_PROGRESS = TRUE;
+
+	// function code follows the slave address or the 0xFA + SN prefix
+	fxn = (MB_TX_FRAME[0] == 0xFA) ? MB_TX_FRAME[1 + LONG_OFFSET] : MB_TX_FRAME[1];
+
+	MB_TX_REQ_DRV->send(MB_TX_REQ_DRV->ctx, MB_TX_TAG, MB_TX_FRAME, MB_TX_FRAME_N);
+	MB_TX_FRAME_N = 0;
+
+	// the driver has the first byte on the line by now
+	MB_Stat_Turnaround(fxn, (Timestamp_get32() - MB_TX_RX_TS) / MB_TS_PER_US);
+}
+
+/***************************************************************************
+ * MB_TX_Set_Driver()
+ * @param drv	- transmit driver to hand serial line responses to; NULL
+ * 				  restores the UART driver
+ * The driver owns the line from send() until it clears MB_TX_IN_PROGRESS.
  ***************************************************************************/
-inline int 
-BfrPut(volatile BFR* buffer, Uint8 in_byte)
+void
+MB_TX_Set_Driver(const MB_TX_DRIVER* drv)
+{
+	MB_TX_DRV = (drv == NULL) ? &MB_TX_UART : drv;
+}
+
+/***************************************************************************
+ * MB_TX_Uart_Send() - UART2 transmit driver
+ * Queues the frame on UART_TXBUF and loads the first FIFO-full straight
+ * away; Uart_ISR() loads the rest a FIFO-full per THR empty interrupt.
+ ***************************************************************************/
+static void
+MB_TX_Uart_Send(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n)
 {
 	Uint32 key;
 
-	key = Hwi_disableInterrupt(5);
-	buffer->buff[buffer->tail] = in_byte; //write byte at tail
+	Ring_Write(&UART_TXBUF, frame, n);
+
+	if ( CSL_FEXT(uartRegs->IER,UART_IER_ETBEI) != 1) //if disabled
+		CSL_FINST(uartRegs->IER,UART_IER_ETBEI,ENABLE);	//enable TX buffer empty interrupt
+
+	key = Hwi_disableInterrupt(5); //////////////////////////////////////////////
+	Uart_ISR(); // prime the pump
+	Hwi_restoreInterrupt(5,key); ////////////////////////////////////////////////
+}
+
+/***************************************************************************
+ * RTU framing. Uart_ISR() stamps every received byte with Timestamp_get32()
+ * and MB_RX_Frame_Byte() splits the stream on the gaps between them; the
+ * 150us clock tick is far too coarse for t1.5 at the higher baud rates.
+ * MB_Frame_Clock only catches the end of the last frame, when no further
+ * byte arrives to measure the gap with. Finished frames are queued on
+ * MB_FRAME_LIST for Modbus_RX().
+ * On a party line most frames are for other slaves. Those are recognised
+ * from the address (or the 0xFA + serial number prefix) and their bytes
+ * are dropped here, still timed so that the next frame is found, without
+ * ever posting Swi_Modbus_RX.
+ ***************************************************************************/
+static Uint8		MB_RX_IS_OPEN;	// bytes received since the last frame was closed
+static Uint8		MB_RX_DROP;		// open frame is for another slave
+static Uint8		MB_RX_FIRST;	// first byte of the open frame
+static Uint32		MB_RX_POS;		// bytes in the open frame
+static Uint16		MB_RX_CRC;		// running CRC of the open frame
+static Uint32		MB_RX_LAST_TS;	// timestamp of the last byte received
+static MB_RX_FRAME	MB_RX_OPEN;		// frame being received
+static MB_RX_FRAME	MB_RX_CUR;		// frame being parsed by Modbus_RX
+static Uint32		MB_T15_CYCLES;	// t1.5 in timestamp counts
+static Uint32		MB_T35_CYCLES;	// t3.5 in timestamp counts
+static Uint32		MB_TURN_CYCLES;	// 3.5 character times: least silence before a response
+static Uint32		MB_TICK_CYCLES;	// timestamp counts per Clock tick
+static Uint32		MB_TX_END_TS;	// timestamp the line was seen idle after the last response
+
+/***************************************************************************
+ * MB_Set_Frame_Timing()
+ * @param baudrate	- UART baud rate
+ * t1.5 and t3.5 follow the character time at every rate so that a master
+ * leaving only the minimum gap between frames is still split correctly
+ * (see MB_RX_Frame_Byte). Above 19200 baud the unconditional t3.5 is held
+ * at the fixed 1.75ms the standard calls for. That is only how long we
+ * wait before deciding a frame has ended; responses still go out 3.5
+ * character times after the request (see MB_Schedule).
+ ***************************************************************************/
+static void
+MB_Set_Frame_Timing(Uint32 baudrate)
+{
+	Types_FreqHz freq;
+	Uint32 char_cycles, t35_min;
+
+	Timestamp_getFreq(&freq);
+	char_cycles = (freq.lo / baudrate) * UART_CHAR_BITS;
+	t35_min		= (freq.lo / 1000000) * MB_T35_MIN_US;
+	MB_TS_PER_US = freq.lo / 1000000;
+
+	MB_T15_CYCLES = (char_cycles * 3) / 2;
+	MB_T35_CYCLES = (char_cycles * 7) / 2;
+	MB_TURN_CYCLES = MB_T35_CYCLES;
+	MB_TICK_CYCLES = MB_TS_PER_US * Clock_tickPeriod;
+	if ((baudrate > 19200) && (MB_T35_CYCLES < t35_min))
+		MB_T35_CYCLES = t35_min;
+
+	// poll for the end of the frame every t1.5 (rounded up, plus the partial tick)
+	Clock_stop(MB_Frame_Clock);
+	Clock_setTimeout(MB_Frame_Clock, MB_T15_CYCLES / ((freq.lo / 1000000) * Clock_tickPeriod) + 2);
+}
 
-	//increment tail
-	buffer->tail++;
-	if ((buffer->tail)>=MAX_BFR_SIZE)
-		buffer->tail -= MAX_BFR_SIZE;
+/***************************************************************************
+ * Response scheduling. Requests are answered in the order they were
+ * queued on MB_PKT_LIST, each by the MB_SendPacket_* for its reg_type,
+ * which MB_Dispatch() runs from MB_Start_Clock_Response as soon as the
+ * line has been quiet for 3.5 character times after both the request and
+ * our last response.
+ * MB_Schedule() is run whenever that can change: a request is queued, the
+ * head is discarded, or a response has left the line. A sender that finds
+ * the line busy just returns; it is scheduled again once the line is free.
+ ***************************************************************************/
+/***************************************************************************
+ * MB_Schedule() - arms MB_Dispatch() for the request at the head of
+ * MB_PKT_LIST, unless a response is still going out
+ * The clock fires on the first tick at or after the turnaround, so at most
+ * one tick late rather than a fixed number of ticks after the request.
+ * Requests from other transports (ModbusTCP.c) don't wait for the line.
+ ***************************************************************************/
+void
+MB_Schedule(void)
+{
+	Uint32	key, from, elapsed, wait;
+	MB_PKT*	pkt;
 
-	buffer->n++; //inc number of buffer elements
-	if ((buffer->n) < MAX_BFR_SIZE)
+	key = Swi_disable(); /////////////////////////////////////////////////////
+	if ((MB_TX_IN_PROGRESS == TRUE) || (MB_PKT_LIST.n <= 0))
 	{
-		Hwi_restoreInterrupt(5,key);
-		return 0; // no buffer overwrite happened
+		Swi_restore(key);
+		return;
 	}
-	else
-	{	//buffer overwrite
-		buffer->n = MAX_BFR_SIZE; //we're still at max capacity
-		Hwi_restoreInterrupt(5,key);
-		return ERROR_VAL;
+
+	pkt = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	wait = 0;
+	if (pkt->tx_drv == MB_TX_DRV)
+	{
+		from = pkt->rx_ts;
+		if ((Int32)(MB_TX_END_TS - from) > 0)
+			from = MB_TX_END_TS;
+
+		elapsed = Timestamp_get32() - from;
+		if (elapsed < MB_TURN_CYCLES)
+			wait = MB_TURN_CYCLES - elapsed;
 	}
+
+	// the first tick can come straight away, hence the extra one
+	Clock_stop(MB_Start_Clock_Response);
+	Clock_setTimeout(MB_Start_Clock_Response, (wait + MB_TICK_CYCLES - 1) / MB_TICK_CYCLES + 1);
+	Clock_start(MB_Start_Clock_Response);
+	Swi_restore(key); ////////////////////////////////////////////////////////
 }
 
 /***************************************************************************
- * BfrGet()
- * @param buffer	- FIFO buffer from which to Get
- * @return			- returns next byte from FIFO buffer,
- * 					  zero if buffer is empty
+ * MB_Dispatch() -- MB_Start_Clock_Response
+ * Answers the request at the head of MB_PKT_LIST.
  ***************************************************************************/
-inline Uint8 
-BfrGet(volatile BFR* buffer)
+void
+MB_Dispatch(void)
 {
-	Uint8 out_byte;
-	Uint32 key;
+	if ((MB_TX_IN_PROGRESS == TRUE) || (MB_PKT_LIST.n <= 0))
+		return; // MB_Schedule() runs again once the line is free
 
-	key = Hwi_disableInterrupt(5);
-	if (buffer->n <= 0) //if buffer empty
+	switch (MB_PKT_LIST.BFR[MB_PKT_LIST.head].reg_type)
 	{
-		Hwi_restoreInterrupt(5,key);
-		buffer->n = 0;
-		buffer->head = buffer->tail;
-		return 0;
+		case REG_TYPE_COIL:			MB_SendPacket_Coil();			break;
+		case REG_TYPE_INTEGER:		MB_SendPacket_Int16();			break;
+		case REG_TYPE_LONG_INT:		MB_SendPacket_LongInt();		break;
+		case REG_TYPE_GET_SAMPLE:	MB_SendPacket_Sample();			break;
+		case REG_TYPE_FORCE_SN:		MB_SendPacket_ForceSlaveAddr();	break;
+		case REG_TYPE_FILE:			MB_SendPacket_File();			break;
+		case REG_TYPE_FILE_WR:		MB_SendPacket_FileWrite();		break;
+		case REG_TYPE_STREAM:		MB_SendPacket_Stream();			break;
+		case REG_TYPE_CHANGES:		MB_SendPacket_Changes();		break;
+		case REG_TYPE_BUSY:			MB_SendPacket_Busy();			break;
+		case REG_TYPE_DIAG:			MB_SendPacket_Diag();			break;
+		case REG_TYPE_MIXED:		MB_SendPacket_Mixed();			break;
+		default:					MB_SendPacket_Float();
+	}
+}
+
+
+static void
+MB_RX_Frame_Reset(void)
+{
+	MB_RX_IS_OPEN = FALSE;
+	MB_FRAME_LIST.head = 0;
+	MB_FRAME_LIST.tail = 0;
+}
+
+/***************************************************************************
+ * MB_RX_Close_Frame() - queues the open frame for Modbus_RX
+ * If Modbus_RX has fallen so far behind that the list is full, the bytes
+ * are added to the newest queued frame, which is marked bad so that both
+ * are dropped together.
+ ***************************************************************************/
+static void
+MB_RX_Close_Frame(void)
+{
+	MB_RX_FRAME* frame;
+	Uint32 tail = MB_FRAME_LIST.tail;
+
+	if (!MB_RX_IS_OPEN)
+		return;
+
+	MB_RX_IS_OPEN = FALSE;
+	MB_RX_OPEN.end_ts = MB_RX_LAST_TS;
+
+	if (MB_RX_DROP)
+	{ //nothing was kept
+		MB_STAT.foreign++;
+		return;
+	}
+
+	if (tail - MB_FRAME_LIST.head >= MB_RX_FRAMES)
+	{
+		frame = &MB_FRAME_LIST.BFR[(tail - 1) & (MB_RX_FRAMES - 1)];
+		frame->end 		= MB_RX_OPEN.end;
+		frame->end_ts	= MB_RX_LAST_TS;
+		frame->is_bad 	= TRUE;
+		return;
 	}
 
-	out_byte = buffer->buff[buffer->head]; //read byte at tail
+	MB_FRAME_LIST.BFR[tail & (MB_RX_FRAMES - 1)] = MB_RX_OPEN;
+	MB_FRAME_LIST.tail = tail + 1;
+
+	Swi_post(Swi_Modbus_RX);
+}
 
-	//increment head
-	buffer->head++;
-	if ((buffer->head) >= MAX_BFR_SIZE)
-		buffer->head -= MAX_BFR_SIZE;
+/***************************************************************************
+ * MB_RX_Is_Foreign()
+ * @param rx_byte	- byte MB_RX_POS of the open frame
+ * @return			- TRUE once the frame is known to be for another slave
+ * Decided on the first byte, or on bytes 1-4 after a 0xFA long address
+ * prefix; anything later is left to the parser.
+ ***************************************************************************/
+static inline BOOL
+MB_RX_Is_Foreign(Uint8 rx_byte)
+{
+	if (MB_RX_POS == 0)
+		return (rx_byte != 0xFA) && (rx_byte != (Uint8)REG_SLAVE_ADDRESS) && (rx_byte != 0x00);
 
-	buffer->n--; //dec number of buffer elements
+	if ((MB_RX_FIRST != 0xFA) || (MB_RX_POS > 4))
+		return FALSE;
 
-	Hwi_restoreInterrupt(5,key);
-	return out_byte;
+	// serial number follows MSB first
+	return (rx_byte != (Uint8)((Uint32)REG_SN_PIPE >> (8 * (4 - MB_RX_POS)))) ? TRUE : FALSE;
 }
 
-void 
-Clear_Buffer(BFR* buffer)
+/***************************************************************************
+ * MB_RX_Frame_Byte() - one received byte, from Uart_ISR
+ * @param now	- Timestamp_get32() when the byte was read
+ * A gap longer than t3.5 always ends the open frame. A gap longer than
+ * t1.5 ends it only if the bytes so far carry a good CRC, which is what
+ * splits back-to-back frames from a fast master. Any other t1.5 gap is
+ * left for the CRC to judge, because some masters (mdbus.exe) pause
+ * inside long writes for longer than the standard allows.
+ ***************************************************************************/
+static inline void
+MB_RX_Frame_Byte(Uint8 rx_byte, Uint32 now)
+{
+	Uint32 gap;
+
+	if (MB_RX_IS_OPEN)
+	{
+		gap = now - MB_RX_LAST_TS;
+		if ( (gap > MB_T35_CYCLES) || ((gap > MB_T15_CYCLES) && (MB_RX_CRC == 0)) )
+			MB_RX_Close_Frame();
+	}
+
+	if (!MB_RX_IS_OPEN)
+	{ //first byte of a new frame
+		MB_RX_IS_OPEN		= TRUE;
+		MB_RX_CRC 			= 0xFFFF;
+		MB_RX_OPEN.start 	= UART_RXBUF.tail;
+		MB_RX_OPEN.crc_end 	= UART_RXBUF.tail;
+		MB_RX_OPEN.is_bad 	= FALSE;
+		MB_RX_DROP			= FALSE;
+		MB_RX_FIRST			= rx_byte;
+		MB_RX_POS			= 0;
+	}
+
+	// the CRC is still needed to find the end of a foreign frame
+	MB_RX_CRC = MB_CRC_UPDATE(MB_RX_CRC, rx_byte);
+	MB_RX_LAST_TS = now;
+
+	if (MB_RX_DROP)
+		return;
+
+	if (MB_RX_Is_Foreign(rx_byte))
+	{
+		MB_RX_DROP = TRUE;
+		Ring_Rewind(&UART_RXBUF, MB_RX_OPEN.start);
+		return;
+	}
+	MB_RX_POS++;
+
+	if (Ring_Put(&UART_RXBUF, rx_byte) != 0)
+	{ //overrun
+		if (!MB_RX_OPEN.is_bad) MB_STAT.overrun++;
+		MB_RX_OPEN.is_bad = TRUE;
+	}
+
+	MB_RX_OPEN.end = UART_RXBUF.tail;
+	if (MB_RX_CRC == 0) //a frame with a good CRC may end here
+		MB_RX_OPEN.crc_end = UART_RXBUF.tail;
+}
+
+/****************************************************************************
+ * MB_Frame_Timeout() -- clock module function								*
+ *  Started by Uart_ISR after every burst of received bytes. Closes the		*
+ *  open frame once the line has been silent long enough, otherwise polls	*
+ *  again.																	*
+ ****************************************************************************/
+void
+MB_Frame_Timeout(void)
 {
-	buffer->head	= 0;
-	buffer->tail	= 0;
-	buffer->n		= 0;
-	buffer->gseed	= GSEED_DEFAULT;
+	Uint32 key, gap;
+
+	key = Hwi_disableInterrupt(5); //////////////////////////////////////////////
+
+	if (MB_RX_IS_OPEN)
+	{
+		gap = Timestamp_get32() - MB_RX_LAST_TS;
+		if ( (gap > MB_T35_CYCLES) || ((gap > MB_T15_CYCLES) && (MB_RX_CRC == 0)) )
+			MB_RX_Close_Frame();
+		else
+			Clock_start(MB_Frame_Clock);
+	}
+
+	Hwi_restoreInterrupt(5,key); ////////////////////////////////////////////////
 }
 
 void 
@@ -139,6 +584,19 @@ Reset_Uart_Error_Count(void)
 	UART_ERROR_CNT.RXFIFOE = 0;
 }
 
+inline void
+Update_Uart_Error_Cnt(Uint8 line_status)
+{ // line_status = LSR
+	if (line_status & 0x02)
+		UART_ERROR_CNT.OE++;
+	if (line_status & 0x04)
+		UART_ERROR_CNT.PE++;
+	if (line_status & 0x08)
+		UART_ERROR_CNT.FE++;
+	if (line_status & 0x80)
+		UART_ERROR_CNT.RXFIFOE++;
+}
+
 /*********************************************************************************
  * Init_PinMux()	- Initialize pin muxing on the SYSCFG module
  *
@@ -232,8 +690,7 @@ void
 Config_Uart(Uint32 baudrate, Uint8 parity)
 {
 	Uint16 	divisor; //UART divisor value for setting baud rate
-	Uint16	clock_start_val, clock_end_val; // number of clock ticks to begin/end transmission with
-	Uint16	watchdog_val;
+	Uint16	clock_end_val; // number of clock ticks to end transmission with
 	BOOL	isBaudrate;
 
 	//disable transmitter and receiver
@@ -262,57 +719,41 @@ Config_Uart(Uint32 baudrate, Uint8 parity)
 	  switch (baudrate){ //pg.1435  // MB_Baudrate_Clock_Module.xlsx
 	   	  	  case 2400:
 	   	  		divisor = 3906;
-	   	  		clock_start_val	= 96; //character times at this baudrate = ~4.32
 				clock_end_val	= 96;
-				watchdog_val 	= 48; // ~2.16 character times
 	   	  		break;
 
 	  	  	  case 4800:
 	  	  		divisor = 1953;
-	   	  		clock_start_val	= 48; //character times at this baudrate = ~4.32
 				clock_end_val	= 48;
-				watchdog_val 	= 24; // ~2.16 character times
 	  	  		break;
 
 	  	  	  case 9600:
 	  	  		divisor = 977;
-	  	  		clock_start_val	= 24; //character times at this baudrate = ~4.32
 				clock_end_val	= 24;
-				watchdog_val 	= 12; // ~2.16 character times
 	  	  		break;
 
 	  	  	  case 19200:
 	  	  		divisor = 488;
-	   	  		clock_start_val	= 12; //character times at this baudrate = ~4.32
 				clock_end_val	= 12;
-				watchdog_val 	=  6; // ~2.16 character times
 	  	  		break;
 
 	  	  	  case 38400:
 	  	  		divisor = 244;
-	   	  		clock_start_val	=  6; //character times at this baudrate = ~4.32
 				clock_end_val	=  6;
-				watchdog_val 	=  3; // ~2.16 character times
 	  	  		break;
 
 	  	  	  case 57600:
 	  	  		divisor = 163;
-	   	  		clock_start_val	=  4; //character times at this baudrate = ~4.32
 				clock_end_val	=  4;
-				watchdog_val 	=  2; // ~2.16 character times
 	  	  		break;
 
 	  	  	  case 115200:
 	  	  		divisor = 81;
-	   	  		clock_start_val	=  2; //character times at this baudrate = ~4.32
 				clock_end_val	=  2;
-				watchdog_val 	=  1; // ~2.16 character times
   	  		  	break;
 
 	  	  	  default: // default to 9600 baud
-	   	  		clock_start_val	= 14; // ~4.32 character times
 				clock_end_val	= 14;
-				watchdog_val 	= 12; // ~2.16 character times
 	  	  		divisor = 977;
 	  	  		isBaudrate = TRUE;
 	  }
@@ -320,16 +761,9 @@ Config_Uart(Uint32 baudrate, Uint8 parity)
 	  if (isBaudrate) VAR_Update(&REG_BAUD_RATE, 9600.0, 0);
 	  else VAR_Update(&REG_BAUD_RATE, baudrate, 0);
 
-	Clock_setTimeout(MB_Start_Clock_Int16,	clock_start_val);
-	Clock_setTimeout(MB_Start_Clock_LongInt,clock_start_val);
-	Clock_setTimeout(MB_Start_Clock_Float,	clock_start_val);
-	Clock_setTimeout(MB_Start_Clock_Coil,	clock_start_val);
 	Clock_setTimeout(MB_End_Clock,	        clock_end_val);
 
-	///Note:	watchdog_val is multiplied because mdbus.exe does not send the bytes fast
-	///			enough in a long write command to comply with the Modbus standard of a less than
-	///			1.5 character times silent period. Multiplier (of 12) was determined experimentally.
-	Clock_setTimeout(MB_Watchdog_Timeout_Clock,	watchdog_val);
+	MB_Set_Frame_Timing(isBaudrate ? 9600 : baudrate);
 
 	//divisor latch
 	CSL_FINS(uartRegs->DLL,UART_DLL_DLL,divisor & 0xFF);	// LSB
@@ -367,8 +801,9 @@ Config_Uart(Uint32 baudrate, Uint8 parity)
 	}
 
 	//initialize UART buffers
-	Clear_Buffer(&UART_TXBUF);
-	Clear_Buffer(&UART_RXBUF);
+	Ring_Init(&UART_TXBUF);
+	Ring_Init(&UART_RXBUF);
+	MB_RX_Frame_Reset();
 
 	Reset_Uart_Error_Count();
 
@@ -409,8 +844,10 @@ Init_Uart(void)
   CSL_FINS(uartRegs->DLH,UART_DLH_DLH,0x03); 				// ~9595.701 baud
 
   //initialize UART buffers
-  Clear_Buffer(&UART_TXBUF);
-  Clear_Buffer(&UART_RXBUF);
+  Ring_Init(&UART_TXBUF);
+  Ring_Init(&UART_RXBUF);
+  MB_RX_Frame_Reset();
+  MB_Set_Frame_Timing(9600);
 
   Reset_Uart_Error_Count();
 
@@ -444,8 +881,11 @@ Init_Modbus(void)
 		MB_PKT_LIST.BFR[i].reg_type		= 0;
 	}
 
-	WDOG_BYTES_TO_REMOVE = 0;
 	MB_TX_IN_PROGRESS = FALSE;
+
+	COIL_Initialize(&COIL_CFG_COMMIT, FALSE, Swi_writeNand); // requestNandWrite() first, then commit
+
+	Init_MB_Tbl_Index();
 }
 
 void 
@@ -466,46 +906,70 @@ Init_PSC(void)
   while ( CSL_FEXT(psc1Regs->MDSTAT[CSL_PSC_GPIO], PSC_MDSTAT_STATE) != CSL_PSC_MDSTAT_STATE_ENABLE );
 }
 
-unsigned int 
-Calc_CRC(unsigned int* s, unsigned int n,unsigned int wrap_count)
+/***************************************************************************
+ * Calc_CRC()
+ * @param s	- first byte of the message
+ * @param n	- number of bytes
+ * @return	- Modbus CRC-16 of the message
+ * Table-driven; gives the same result as the old bit-by-bit loop.
+ ***************************************************************************/
+Uint16 
+Calc_CRC(const Uint8* s, Uint32 n)
 {
-	int i,j;
-	unsigned int t;
-	unsigned int CRC;
-	Uint32 key;
-
-	key = Hwi_disableInterrupt(5);
+	Uint32 j;
+	Uint16 CRC;
 
 	CRC = 0xFFFF;
 
 	#pragma MUST_ITERATE(2) //optimization
 	for(j=0;j<n;j++)
-	{
-		//handle buffer wrap around -- efficient but not pretty
-		if ((j >= wrap_count) && (wrap_count > 0))
-			t = s[j-MAX_BFR_SIZE];
-		else
-			t = s[j];
+		CRC = MB_CRC_UPDATE(CRC, s[j]);
 
-		CRC ^= (t & 0xFF);
+	return CRC;
+}
 
-		for (i=0;i<8;i++)
-		{
-			if (CRC & 0x01) //if LSB is set
-			{
-				CRC >>= 1;	//shift right
-				CRC ^= 0xA001; //XOR with 0xA001
-			}
-			else
-			{
-				CRC >>= 1;
-			}
-		}
+/***************************************************************************
+ * MB_RX_CRC_Is_Good()
+ * @param frame	- the frame, starting at the head of UART_RXBUF
+ * @param n		- number of bytes covered by the CRC
+ * @return		- TRUE if the two bytes that follow hold the matching CRC
+ * MB_RX_Frame_Byte() keeps a running CRC of each frame as it arrives and
+ * records where the residue last came out to zero. If that is where this
+ * message ends, the frame is good without touching its bytes again;
+ * otherwise fall back to recomputing it. The caller counts the outcome in
+ * MB_STAT (served, crc_err).
+ ***************************************************************************/
+static BOOL
+MB_RX_CRC_Is_Good(const Uint8* frame, Uint32 n)
+{
+	if (MB_RX_CUR.crc_end == MB_RX_CUR.start + n + 2)
+		return TRUE;
 
-	}
+	// the CRC of a message followed by its own CRC (LSB first) is zero
+	return (Calc_CRC(frame, n + 2) == 0);
+}
 
-	Hwi_restoreInterrupt(5,key);
-	return CRC;
+/***************************************************************************
+ * MB_RX_Frame()
+ * @param n	- number of bytes in the frame
+ * @return	- the bytes at the head of UART_RXBUF as one linear array
+ * Points straight into the ring unless the frame wraps around its end, in
+ * which case it is copied out first.
+ ***************************************************************************/
+static Uint8*
+MB_RX_Frame(Uint32 n)
+{
+	static Uint8 frame[MB_FRAME_SIZE];
+	Uint8* span;
+
+	if (n > MB_FRAME_SIZE)
+		n = MB_FRAME_SIZE;
+
+	if (Ring_Read_Span(&UART_RXBUF, &span) >= n)
+		return span;
+
+	Ring_Peek(&UART_RXBUF, 0, frame, n);
+	return frame;
 }
 
 /****************************************************************************
@@ -523,9 +987,9 @@ Uart_ISR(void)
 	Uint8 line_status 		= 0;
 	Uint8 RX_data			= 0;
 	Uint8 all_INTs_cleared 	= FALSE;
-	Uint8 swi_post_needed	= FALSE;
+	Uint8 tx_burst[UART_FIFO_SIZE];
 
-	int i;
+	Uint32 i, n;
 
 	while(!all_INTs_cleared) //loop until we clear all pending interrupts
 	{
@@ -537,23 +1001,20 @@ Uart_ISR(void)
 		/// note: we have to manually check this because reading IIR (as above)
 		/// automatically clears (!) any THR_EMPTY interrupts that are pending
 		//read LSR for empty TX EMPTY status
-		if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) && (UART_TXBUF.n > 0) )
+		if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) && (Ring_Count(&UART_TXBUF) > 0) )
 		{
 			CSL_FINS(gpioRegs->BANK[0].OUT_DATA,GPIO_OUT_DATA_OUT9,1);
-			for (i=0;i<UART_FIFO_SIZE-1;i++)
-			{
-				if (UART_TXBUF.n > 0) //transfer from SW TX buffer to HW TX FIFO
-					CSL_FINS(uartRegs->THR,UART_THR_DATA,BfrGet(&UART_TXBUF));
-				else
-					break;
-			}
-			if (UART_TXBUF.n <= 0)
+			//transfer from SW TX buffer to HW TX FIFO
+			n = Ring_Read(&UART_TXBUF, tx_burst, UART_FIFO_SIZE); //FIFO is empty, fill it
+			for (i=0;i<n;i++)
+				CSL_FINS(uartRegs->THR,UART_THR_DATA,tx_burst[i]);
+			if (Ring_Count(&UART_TXBUF) == 0)
 				Clock_start(MB_End_Clock);
 				//MB_TX_IN_PROGRESS = FALSE;
 
 		}
 
-		if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) && (UART_TXBUF.n <= 0) )
+		if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) && (Ring_Count(&UART_TXBUF) == 0) )
 		{
 			CSL_FINS(gpioRegs->BANK[0].OUT_DATA,GPIO_OUT_DATA_OUT9,0);
 		}
@@ -563,17 +1024,14 @@ Uart_ISR(void)
 			case TX_FIFO_EMPTY_INT:
 			/// TX FIFO EMPTY -- This code is rarely reached because reading IIR (as above)
 			/// automatically clears (!) any THR_EMPTY interrupts that are pending
-				if (UART_TXBUF.n > 0) //more bytes to send
+				if (Ring_Count(&UART_TXBUF) > 0) //more bytes to send
 				{
-					for (i=0;i<UART_FIFO_SIZE-1;i++)
-					{
-						if (UART_TXBUF.n > 0) //transfer from SW TX buffer to HW TX FIFO
-							CSL_FINS(uartRegs->THR,UART_THR_DATA,BfrGet(&UART_TXBUF));
-						else
-							break;
-					}
+					//transfer from SW TX buffer to HW TX FIFO
+					n = Ring_Read(&UART_TXBUF, tx_burst, UART_FIFO_SIZE); //FIFO is empty, fill it
+					for (i=0;i<n;i++)
+						CSL_FINS(uartRegs->THR,UART_THR_DATA,tx_burst[i]);
 
-					if (UART_TXBUF.n <= 0)
+					if (Ring_Count(&UART_TXBUF) == 0)
 					{
 						Clock_start(MB_End_Clock);
 					}
@@ -589,23 +1047,21 @@ Uart_ISR(void)
 				while(line_status & 0x1) //loop until RBR is empty
 				{
 					RX_data = CSL_FEXT(uartRegs->RBR,UART_RBR_DATA); //get data from RX buffer register
-					BfrPut(&UART_RXBUF,RX_data);
-
-					if (Clock_isActive(MB_Watchdog_Timeout_Clock))
-					{
-						Clock_stop(MB_Watchdog_Timeout_Clock);
-					}
+					MB_RX_Frame_Byte(RX_data, Timestamp_get32());
 					line_status = CSL_FEXTR(uartRegs->LSR,7,0);
 				}
-				if (UART_RXBUF.n >= 1) //need at least 8 bytes for valid frame
-					swi_post_needed = TRUE;
+				Clock_start(MB_Frame_Clock); //look for the end of the frame
 
 				break;
 
 			case LINE_STATUS_INT:
 				delayInt(0x1); //in place of NOPS
 				line_status = CSL_FEXTR(uartRegs->LSR,7,0);
-//				Update_Uart_Error_Cnt(line_status); //add errors to error count stats
+				Update_Uart_Error_Cnt(line_status); //add errors to error count stats
+				if (line_status & 0x02) //OE
+					MB_STAT.overrun++;
+				if (MB_RX_IS_OPEN)
+					MB_RX_OPEN.is_bad = TRUE;
 
 				// reset UART -- hopefully to recover from failure/infinite loop
 				CSL_FINST(uartRegs->PWREMU_MGMT,UART_PWREMU_MGMT_UTRST,RESET);
@@ -628,17 +1084,14 @@ Uart_ISR(void)
 		/// Note:	Keeping UART ISR in a while loop until the modbus tx buffer is empty was a STUPID idea.
 		///			The real solution is to remove as many Hwi_disable's as possible and set a high
 		///			priority for UART ISR.
-//		if (UART_TXBUF.n > 0)
+//		if (Ring_Count(&UART_TXBUF) > 0)
 //			all_INTs_cleared = FALSE; //testing this... force to wait until SW TX buffer is emptied
 	}
 
-	if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) && (UART_TXBUF.n <= 0) )
+	if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) && (Ring_Count(&UART_TXBUF) == 0) )
 	{
 		CSL_FINS(gpioRegs->BANK[0].OUT_DATA,GPIO_OUT_DATA_OUT9,0);
 	}
-
-	if (swi_post_needed)
-		Swi_post(Swi_Modbus_RX); //note: needs to be HIGH priority
 }
 
 /****************************************************************
@@ -653,11 +1106,22 @@ Create_MB_Pkt(MODBUS_PACKET_LIST* pkt_list, Uint8 sl, Uint8 fx, Uint16 st, Uint1
 	Uint16	special_offset;
 	MB_PKT*	pkt;
 
-	if(pkt_list->n >= MAX_MB_BFR-1)
+	if ((pkt_list->n >= MAX_MB_BFR - MB_BUSY_SLOTS) && (reg_t != REG_TYPE_BUSY))
+	{ // full: answer Server Busy from a reserved slot rather than drop the request
+		if (bc || (Create_MB_Pkt(pkt_list, sl, fx, 0, 0, 0, REG_TYPE_BUSY, qu, 0, bc, lng_addr, 0) == (MB_PKT*)0))
+			MB_STAT.queue_drop++;
+		else
+			MB_STAT.queue_busy++;
+		return (MB_PKT*)0;
+	}
+
+	if (pkt_list->n >= MAX_MB_BFR)
 		return (MB_PKT*)0;
 
 	key = Hwi_disableInterrupt(5); //////////////////////////////////////////////
 	pkt_list->n++;
+	if (pkt_list->n > MB_STAT.queue_max)
+		MB_STAT.queue_max = pkt_list->n;
 
 	pkt = &pkt_list->BFR[pkt_list->tail]; // add modbus packet to buffer tail
 
@@ -677,11 +1141,16 @@ Create_MB_Pkt(MODBUS_PACKET_LIST* pkt_list, Uint8 sl, Uint8 fx, Uint16 st, Uint1
 	pkt->vtune			= vt;
 	pkt->long_address	= lng_addr;
 	pkt->is_broadcast	= bc;
+	pkt->rx_ts			= MB_RX_CUR.end_ts;
+	pkt->tx_drv			= MB_TX_REQ_DRV;
+	pkt->tx_tag			= MB_TX_TAG;
 
 	//initialize
 	pkt->is_longint		= FALSE;
 	pkt->byte_order		= MB_BYTE_ORDER_ABCD;
 	pkt->is_special_reg = FALSE;
+	pkt->wr_start_reg	= 0;
+	pkt->wr_num_regs	= 0;
 
 	special_offset = reg_offset - (reg_offset % 10000);
 	if (special_offset > 0)
@@ -719,6 +1188,8 @@ Create_MB_Pkt(MODBUS_PACKET_LIST* pkt_list, Uint8 sl, Uint8 fx, Uint16 st, Uint1
 			pkt->byte_cnt = pkt->num_regs * 2; // 2 bytes per register
 		else if ( (pkt->reg_type == REG_TYPE_LONG_INT) || (pkt->reg_type == REG_TYPE_FLOAT) || (pkt->reg_type == REG_TYPE_GET_SAMPLE) )
 			pkt->byte_cnt = pkt->num_regs * 4; // 4 bytes per register
+		else if (pkt->reg_type == REG_TYPE_MIXED)
+			pkt->byte_cnt = pkt->num_regs * 2; // num_regs counts 16-bit registers
 	}
 	///write mode
 	else if (pkt->query_rw == MB_WRITE_QRY)
@@ -754,6 +1225,9 @@ Discard_MB_Pkt_Head(MODBUS_PACKET_LIST* pkt_list)
 	if (pkt_list->head >= MAX_MB_BFR) //buffer wrap-around
 		pkt_list->head -= MAX_MB_BFR;
 	Hwi_restoreInterrupt(5,key); /////////////////////////////////////////////////
+
+	if (pkt_list == &MB_PKT_LIST)
+		MB_Schedule(); // arm the sender for the new head
 }
 
 void 
@@ -777,36 +1251,140 @@ Discard_MB_Pkt_Tail(MODBUS_PACKET_LIST* pkt_list)
 	Hwi_restoreInterrupt(5,key); /////////////////////////////////////////////////
 }
 
-void 
-Modbus_RX(void)
+/***************************************************************************
+ * MB_RX_Reg_Type() - which table a (1-based) register address falls in
+ * @param reg			- register address; any float offset is stripped
+ * @param reg_offset	- set to the stripped float offset (0 otherwise)
+ * @return				- REG_TYPE_INTEGER, REG_TYPE_LONG_INT or REG_TYPE_FLOAT
+ ***************************************************************************/
+static Uint8
+MB_RX_Reg_Type(Uint16* reg, Uint16* reg_offset)
+{
+	*reg_offset = 0;	// register offset only applies to float table
+
+	if ( ((*reg >= MIN_MB_INT) && (*reg < MAX_MB_INT))
+		|| ((*reg >= MIN_FCT_INT) && (*reg < MAX_FCT_INT)) )
+		return REG_TYPE_INTEGER;
+
+	if ( (*reg >= MIN_MB_LONGINT) && (*reg < MAX_MB_LONGINT) )
+		return REG_TYPE_LONG_INT;
+
+	*reg_offset = *reg - (*reg % REMAINDER);
+	*reg		= *reg - *reg_offset;
+	return REG_TYPE_FLOAT;
+}
+
+/***************************************************************************
+ * MB_RX_Is_Mixed() - does a 0x03/0x04 read leave the table it starts in,
+ * or touch an extended character array?
+ * @param reg	- first (1-based) register address, offset included
+ * @param n		- number of 16-bit registers read
+ * Characters take one register each (see MB_Tbl_Resolve), so a read of a
+ * single one still counts its registers in 16-bit words, as
+ * MB_SendPacket_Mixed() does. Reads longer than MB_MIXED_MAX_REGS stay
+ * with the single-table handlers.
+ ***************************************************************************/
+static BOOL
+MB_RX_Is_Mixed(Uint16 reg, Uint16 n)
+{
+	Uint16	i, r, offset, first_offset;
+	Uint8	first_type, data_type, prot;
+	double*	ptr;
+
+	if ((n == 0) || (n > MB_MIXED_MAX_REGS) || ((Uint32)reg + n - 1 > 0xFFFF))
+		return FALSE;
+
+	for (i=0;(i<n) && (reg + i > SPECIAL_OFFSET);i++)
+	{
+		if ((MB_Tbl_Search_Extended(reg + i - SPECIAL_OFFSET, &ptr, &data_type, &prot) != -1) && (data_type == REGTYPE_CHAR))
+			return TRUE;
+	}
+
+	if (n < 2)
+		return FALSE;
+
+	r = reg;
+	first_type = MB_RX_Reg_Type(&r, &first_offset);
+
+	for (i=1;i<n;i++)
+	{
+		r = reg + i;
+		if ((MB_RX_Reg_Type(&r, &offset) != first_type) || (offset != first_offset))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/***************************************************************************
+ * MB_RX_Copy_Regs() - copies register data from a query into mb_pkt,
+ * 					   converting floats to ABCD byte order
+ ***************************************************************************/
+static void
+MB_RX_Copy_Regs(MB_PKT* mb_pkt, const Uint8* src, Uint16 n)
+{
+	Uint16 i;
+
+	if (mb_pkt->reg_type != REG_TYPE_FLOAT)
+	{	// AB / ABCD as sent
+		memcpy(mb_pkt->data, src, n);
+		return;
+	}
+
+	for (i=0;i+3<n;i+=4)
+	{
+		if (mb_pkt->byte_order == MB_BYTE_ORDER_CDAB)
+		{	// CDAB -> ABCD
+			mb_pkt->data[i+2] = src[i+0];
+			mb_pkt->data[i+3] = src[i+1];
+			mb_pkt->data[i+0] = src[i+2];
+			mb_pkt->data[i+1] = src[i+3];
+		}
+		else if (mb_pkt->byte_order == MB_BYTE_ORDER_DCBA)
+		{	// DCBA -> ABCD
+			mb_pkt->data[i+3] = src[i+0];
+			mb_pkt->data[i+2] = src[i+1];
+			mb_pkt->data[i+1] = src[i+2];
+			mb_pkt->data[i+0] = src[i+3];
+		}
+		else if (mb_pkt->byte_order == MB_BYTE_ORDER_BADC)
+		{	// BADC -> ABCD
+			mb_pkt->data[i+1] = src[i+0];
+			mb_pkt->data[i+0] = src[i+1];
+			mb_pkt->data[i+3] = src[i+2];
+			mb_pkt->data[i+2] = src[i+3];
+		}
+		else
+		{	// ABCD -> ABCD
+			memcpy(&mb_pkt->data[i], &src[i], 4);
+		}
+	}
+}
+
+/***************************************************************************
+ * MB_RX_Parse()
+ * @param uart_pkt_ptr	- the frame as one linear array
+ * @param rx_n			- number of bytes in the frame
+ * Queues the request in the frame on MB_PKT_LIST. The frame is removed
+ * from UART_RXBUF by Modbus_RX() afterwards whatever happens here.
+ ***************************************************************************/
+static void
+MB_RX_Parse(Uint8* restrict uart_pkt_ptr, Uint32 rx_n)
 {
 	Uint8	slave, fxn, using_int_offset, using_longint_offset, register_type, is_broadcast;
 	Uint8	bytecnt_is_good, vtune, is_long_addr, la_offset; // <- long address: offset
 	Uint16	start_reg, num_regs, reg_offset, num_data_bytes, i;
-	Uint32	calc_CRC, msg_CRC, pipe_SN, la_SN; // <- long address: pipe serial number (used instead of slave number)
-	Uint32	key, key2;
+	Uint16	wr_start_reg, wr_num_regs, wr_reg_offset; // <- 0x17 only
+	Uint16	file_rec_n;	// <- 0x14 only
+	Uint32	file_resp_n;
+	Uint32	file_i, file_len; // <- 0x15 only: wider than any record length can push them
+	Uint32	pipe_SN, la_SN; // <- long address: pipe serial number (used instead of slave number)
 
 	// number of bytes in the message (can be for query OR response) not counting CRC bytes
 	Uint32	msg_num_bytes;
 
 	//optimization - restrict qualifier
 	MB_PKT* restrict mb_pkt; 				//modbus packet pointer -- points to a packet in the modbus packet list
-	unsigned int* restrict uart_pkt_ptr; 	//UART RX pointer -- points to the head of RXBUF
-
-	//disable SWIs
-	key = Hwi_disableInterrupt(5);
-
-	if(UART_RXBUF.n < 8)
-	{// not enough data in RXBUF for a complete modbus frame
-		WDOG_BYTES_TO_REMOVE = UART_RXBUF.n;
-		Clock_start(MB_Watchdog_Timeout_Clock); //message incomplete, start watchdog
-		Hwi_restoreInterrupt(5,key);
-		return;
-	}
-	else
-		Clock_stop(MB_Watchdog_Timeout_Clock); //stop watchdog
-
-	uart_pkt_ptr = &UART_RXBUF.buff[UART_RXBUF.head];
 
 	if ( (uart_pkt_ptr[0] & 0xFF) == 0xFA )
 	{ // long address mode
@@ -822,6 +1400,7 @@ Modbus_RX(void)
 	slave	= uart_pkt_ptr[0+la_offset];
 	fxn		= uart_pkt_ptr[1+la_offset];
 	vtune	= 0;
+	MB_TX_LONG_ADDR = is_long_addr;	// exceptions sent while parsing are addressed the same way
 
 /// NEED TO TEST THAT EVERYTHING BEHAVES ON A PARTY LINE
 	if (is_long_addr)
@@ -836,8 +1415,6 @@ Modbus_RX(void)
 
 		if ( la_SN != (Uint32)REG_SN_PIPE )
 		{ //wrong pipe serial number
-			Clear_Buffer(&UART_RXBUF);
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
 	}
@@ -845,8 +1422,6 @@ Modbus_RX(void)
 	{
 		if ( (slave != REG_SLAVE_ADDRESS) && (slave != 0x00) ) // ignore frames sent to other slave addresses
 		{	//wrong slave address
-			Clear_Buffer(&UART_RXBUF);
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
 	}
@@ -867,26 +1442,20 @@ Modbus_RX(void)
 
 			if (is_broadcast)
 			{	// read functions not applicable for broadcast packets
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 
 			msg_num_bytes = 6;
 
 			//query CRC
-			calc_CRC = Calc_CRC(uart_pkt_ptr, msg_num_bytes + la_offset,0);
-			msg_CRC = uart_pkt_ptr[msg_num_bytes + la_offset];			//LSB is first
-			msg_CRC |= uart_pkt_ptr[msg_num_bytes+1 + la_offset] << 8; 	//MSB is second
-
-			if(calc_CRC != msg_CRC)
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
 			{//CRC mismatch
 				STAT_CURRENT = 1;
 				STAT_PKT++;
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
+				MB_STAT.crc_err++;
 				return;
 			}
+			MB_STAT.served++;
 
 			start_reg = uart_pkt_ptr[2 + la_offset] << 8;	//MSB
 			start_reg |= uart_pkt_ptr[3 + la_offset];		//LSB
@@ -933,7 +1502,13 @@ Modbus_RX(void)
 				}
 				else //normal modbus table selection mode
 				{
-                    if (using_int_offset) register_type = REG_TYPE_INTEGER;
+					if (MB_RX_Is_Mixed(start_reg + reg_offset, num_regs))
+					{	// runs across tables: served register by register, num_regs stays in words
+						start_reg += reg_offset;
+						reg_offset = 0;
+						register_type = REG_TYPE_MIXED;
+					}
+                    else if (using_int_offset) register_type = REG_TYPE_INTEGER;
                     else if (using_longint_offset) 
                     {
 						num_regs /= 2; // two 16-bit fields = 1 long int register
@@ -947,38 +1522,14 @@ Modbus_RX(void)
 				}
 			}
 			else
-				register_type = NULL;
+				register_type = 0;
 
 			//create MB packet info
 			Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, num_regs, 0, register_type, MB_READ_QRY, vtune, is_broadcast, is_long_addr, reg_offset);
 
-			key2 = Hwi_disableInterrupt(5);	////////
-			//remove data from RX buffer
-			UART_RXBUF.n 	-= msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			UART_RXBUF.head += msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			if (UART_RXBUF.n < 0) // this shouldn't happen
-				Clear_Buffer(&UART_RXBUF);
-			else if (UART_RXBUF.head >= MAX_BFR_SIZE)
-				UART_RXBUF.head -= MAX_BFR_SIZE;	//wrap around
-
-			Hwi_restoreInterrupt(5,key2);		////////
-
-			//start the clock (timer) to call MB_SendPacket after silence period
-			if (register_type == REG_TYPE_COIL)
-					Clock_start(MB_Start_Clock_Coil);
-			else if (register_type == REG_TYPE_INTEGER)
-					Clock_start(MB_Start_Clock_Int16);
-            else if (register_type == REG_TYPE_LONG_INT)
-					Clock_start(MB_Start_Clock_LongInt);
-			else if ((register_type == REG_TYPE_FLOAT) || (register_type == REG_TYPE_NO_OFFSET_FLOAT))
-					Clock_start(MB_Start_Clock_Float);
-			else
-			{	//something went wrong
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
-				return;
-			}
-			Hwi_restoreInterrupt(5,key);
+
+			//call MB_SendPacket after silence period
+			MB_Schedule();
 			break;
 
 		/// write functions ///
@@ -986,18 +1537,14 @@ Modbus_RX(void)
 			msg_num_bytes = 6; // number of bytes in query (not counting CRC)
 
 			//query CRC
-			calc_CRC = Calc_CRC(uart_pkt_ptr, msg_num_bytes + la_offset,0);
-			msg_CRC = uart_pkt_ptr[msg_num_bytes + la_offset];			//LSB is first
-			msg_CRC |= uart_pkt_ptr[msg_num_bytes+1 + la_offset] << 8; 	//MSB is second
-
-			if(calc_CRC != msg_CRC)
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
 			{//CRC mismatch
 				STAT_CURRENT = 1;
 				STAT_PKT++;
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
+				MB_STAT.crc_err++;
 				return;
 			}
+			MB_STAT.served++;
 
 			start_reg = uart_pkt_ptr[2 + la_offset] << 8;	//MSB
 			start_reg |= uart_pkt_ptr[3 + la_offset];		//LSB
@@ -1008,6 +1555,7 @@ Modbus_RX(void)
 			//create MB packet info
 			mb_pkt = Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, 1, 0, register_type,
 									 MB_WRITE_QRY, vtune, is_broadcast, is_long_addr, reg_offset);
+			if (mb_pkt == (MB_PKT*)0) return; // packet list is full
 
 			if ( (uart_pkt_ptr[4 + la_offset] == 0xFF) && (uart_pkt_ptr[5 + la_offset] == 0x00) ) //set coil
 				mb_pkt->data[0] = TRUE;
@@ -1016,42 +1564,24 @@ Modbus_RX(void)
 			else // not a valid coil value
 			{	///need to send an exception response
 				Discard_MB_Pkt_Tail(&MB_PKT_LIST);
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 			msg_num_bytes = 6; // number of bytes in response
-            /////////////////////////////////////
-			key2 = Hwi_disableInterrupt(5);	
-			//remove data from RX buffer
-			UART_RXBUF.n 	-= msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			UART_RXBUF.head += msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			if (UART_RXBUF.n < 0) // this shouldn't happen
-				Clear_Buffer(&UART_RXBUF);
-			else if (UART_RXBUF.head >= MAX_BFR_SIZE)
-				UART_RXBUF.head -= MAX_BFR_SIZE;	//wrap around
-
-			Hwi_restoreInterrupt(5,key2);		
-            /////////////////////////////////////
-			Clock_start(MB_Start_Clock_Coil);
-			Hwi_restoreInterrupt(5,key);
+			MB_Schedule();
 			break;
 
 		case 0x06: //write to single holding register
 			msg_num_bytes = 6; // number of bytes in query (not counting CRC)
 
 			//query CRC
-			calc_CRC = Calc_CRC(uart_pkt_ptr, msg_num_bytes + la_offset,0);
-			msg_CRC = uart_pkt_ptr[msg_num_bytes + la_offset];			//LSB is first
-			msg_CRC |= uart_pkt_ptr[msg_num_bytes+1 + la_offset] << 8; 	//MSB is second
-
-			if(calc_CRC != msg_CRC)
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
 			{//CRC mismatch
 				STAT_CURRENT = 1;
 				STAT_PKT++;
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
+				MB_STAT.crc_err++;
 				return;
 			}
+			MB_STAT.served++;
 
 			//starting register
 			start_reg = uart_pkt_ptr[2 + la_offset] << 8;	//MSB
@@ -1063,26 +1593,14 @@ Modbus_RX(void)
 			//create MB packet info
 			mb_pkt = Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, 1, 0, register_type,
 									MB_WRITE_QRY, vtune, is_broadcast, is_long_addr, reg_offset);
+			if (mb_pkt == (MB_PKT*)0) return; // packet list is full
 			mb_pkt->data[0] = uart_pkt_ptr[4 + la_offset];	//MSB
 			mb_pkt->data[1] = uart_pkt_ptr[5 + la_offset];	//LSB (int16)
 
 
 			msg_num_bytes = 6; // number of bytes in response
 
-        	/////////////////////////////////////
-			key2 = Hwi_disableInterrupt(5);
-			//remove data from RX buffer
-			UART_RXBUF.n 	-= msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			UART_RXBUF.head += msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			if (UART_RXBUF.n < 0) // this shouldn't happen
-				Clear_Buffer(&UART_RXBUF);
-			else if (UART_RXBUF.head >= MAX_BFR_SIZE)
-				UART_RXBUF.head -= MAX_BFR_SIZE;	//wrap around
-
-			Hwi_restoreInterrupt(5,key2);		
-            /////////////////////////////////////
-			Clock_start(MB_Start_Clock_Int16);
-			Hwi_restoreInterrupt(5,key);
+			MB_Schedule();
 
 			break;
 
@@ -1092,29 +1610,22 @@ Modbus_RX(void)
 			num_data_bytes = uart_pkt_ptr[6+la_offset]; // DKOH JUN 3
 			msg_num_bytes = 7 + num_data_bytes; // number of bytes in query (not counting CRC)
 
-			if(UART_RXBUF.n < msg_num_bytes + 2 + la_offset) // CRC -> add 2 bytes
-			{//not yet finished receiving data
-				WDOG_BYTES_TO_REMOVE = UART_RXBUF.n;
-				Clock_start(MB_Watchdog_Timeout_Clock); //message incomplete, start watchdog
-				Hwi_restoreInterrupt(5,key);
+			if(rx_n < msg_num_bytes + 2 + la_offset) // CRC -> add 2 bytes
+			{//frame ended early
+				STAT_CURRENT = 3;
+				STAT_RETRY++;
 				return;
 			}
-			else if (Clock_isActive(MB_Watchdog_Timeout_Clock))
-				Clock_stop(MB_Watchdog_Timeout_Clock);//stop watchdog, we have the bytes we need
 
 			//query CRC
-			calc_CRC = Calc_CRC(uart_pkt_ptr, msg_num_bytes + la_offset,0);
-			msg_CRC  = uart_pkt_ptr[msg_num_bytes + la_offset];			//LSB is first
-			msg_CRC |= uart_pkt_ptr[msg_num_bytes+1 + la_offset] << 8; 	//MSB is second
-
-			if(calc_CRC != msg_CRC)
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
 			{//CRC mismatch
 				STAT_CURRENT = 1;
 				STAT_PKT++;
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
+				MB_STAT.crc_err++;
 				return;
 			}
+			MB_STAT.served++;
 
 			start_reg = uart_pkt_ptr[2 + la_offset] << 8;	//MSB
 			start_reg |= uart_pkt_ptr[3 + la_offset];		//LSB
@@ -1149,9 +1660,7 @@ Modbus_RX(void)
 			// (correct number of bytes		#bytes < 2^8                #bytes > 0      )
 			if ( (!bytecnt_is_good) || (num_data_bytes > 255) || (num_data_bytes == 0) )
 			{//bad query
-				Clear_Buffer(&UART_RXBUF);
 				MB_SendException(slave, fxn, MB_EXCEP_BAD_VALUE);
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 
@@ -1170,6 +1679,12 @@ Modbus_RX(void)
 			//create MB packet info
 			mb_pkt = Create_MB_Pkt	(&MB_PKT_LIST, slave, fxn, start_reg, num_regs, 0, register_type,
 										 MB_READ_QRY, vtune, is_broadcast, is_long_addr, reg_offset);
+			if (mb_pkt == (MB_PKT*)0) return; // packet list is full
+
+			// every 16-bit register is written, so an odd count still reaches
+			// the last character of an extended string (see MB_SendPacket_Float)
+			if (register_type == REG_TYPE_FLOAT)
+				mb_pkt->byte_cnt = num_data_bytes;
 
 			/// Copy data bytes to memory ///
 			if (using_int_offset)
@@ -1224,53 +1739,321 @@ Modbus_RX(void)
 				} // end for-loop
 			}
 
-			key2 = Hwi_disableInterrupt(5);	/////////////////////////////////////
-			//remove data from RX buffer
-			UART_RXBUF.n 	-= msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			UART_RXBUF.head += msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			if (UART_RXBUF.n < 0) // this shouldn't happen
-				Clear_Buffer(&UART_RXBUF);
-			else if (UART_RXBUF.head >= MAX_BFR_SIZE)
-				UART_RXBUF.head -= MAX_BFR_SIZE;	//wrap around
 
-			Hwi_restoreInterrupt(5,key2);		/////////////////////////////////////
+			MB_Schedule();
+
 
-			if (using_int_offset) Clock_start(MB_Start_Clock_Int16);
-			else if(using_longint_offset) Clock_start(MB_Start_Clock_LongInt);
-			else Clock_start(MB_Start_Clock_Float);
-				
-			Hwi_restoreInterrupt(5,key);
-	
 		    break;
 
-		/// calibrate functions (non-standard) ///
-		case MB_CMD_PDI_ANALYZER_SAMPLE: // mb_cmd_pdi_analyzer_sample = 66
-			if (is_broadcast)
-			{	// read functions not applicable for broadcast packets
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
+		case 0x0F: //write multiple coils
+			num_data_bytes = uart_pkt_ptr[6+la_offset];
+			msg_num_bytes = 7 + num_data_bytes; // number of bytes in query (not counting CRC)
+
+			if(rx_n < msg_num_bytes + 2 + la_offset) // CRC -> add 2 bytes
+			{//frame ended early
+				STAT_CURRENT = 3;
+				STAT_RETRY++;
 				return;
 			}
 
-			msg_num_bytes = 7;
-
-			//	Third byte specifies vtune, which is currently meaningless
+			//query CRC
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
+			{//CRC mismatch
+				STAT_CURRENT = 1;
+				STAT_PKT++;
+				MB_STAT.crc_err++;
+				return;
+			}
+			MB_STAT.served++;
+
+			start_reg = uart_pkt_ptr[2 + la_offset] << 8;	//MSB
+			start_reg |= uart_pkt_ptr[3 + la_offset];		//LSB
+			start_reg++; //convert from 0-based to 1-based
+
+			num_regs = uart_pkt_ptr[4 + la_offset] << 8;	//MSB
+			num_regs |= uart_pkt_ptr[5 + la_offset];		//LSB
+
+			// one bit per coil, last byte padded with zeros
+			if ( (num_regs == 0) || (num_regs > 0x7B0) || (num_data_bytes != (num_regs + 7) / 8) )
+			{//bad query
+				MB_SendException(slave, fxn, MB_EXCEP_BAD_VALUE);
+				return;
+			}
+
+			//create MB packet info
+			mb_pkt = Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, num_regs, 0, REG_TYPE_COIL,
+									 MB_WRITE_QRY, vtune, is_broadcast, is_long_addr, reg_offset);
+			if (mb_pkt == (MB_PKT*)0) return; // packet list is full
+
+			memcpy(mb_pkt->data, &uart_pkt_ptr[7 + la_offset], num_data_bytes);
+
+			MB_Schedule();
+			break;
+
+		case 0x17: //read/write multiple registers (write is done first)
+			if (is_broadcast)
+			{	// read functions not applicable for broadcast packets
+				return;
+			}
+
+			num_data_bytes = uart_pkt_ptr[10+la_offset];
+			msg_num_bytes = 11 + num_data_bytes; // number of bytes in query (not counting CRC)
+
+			if(rx_n < msg_num_bytes + 2 + la_offset) // CRC -> add 2 bytes
+			{//frame ended early
+				STAT_CURRENT = 3;
+				STAT_RETRY++;
+				return;
+			}
+
+			//query CRC
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
+			{//CRC mismatch
+				STAT_CURRENT = 1;
+				STAT_PKT++;
+				MB_STAT.crc_err++;
+				return;
+			}
+			MB_STAT.served++;
+
+			start_reg = uart_pkt_ptr[2 + la_offset] << 8;	//MSB
+			start_reg |= uart_pkt_ptr[3 + la_offset];		//LSB
+			start_reg++; //convert from 0-based to 1-based
+
+			num_regs = uart_pkt_ptr[4 + la_offset] << 8;	//MSB
+			num_regs |= uart_pkt_ptr[5 + la_offset];		//LSB
+
+			wr_start_reg = uart_pkt_ptr[6 + la_offset] << 8;	//MSB
+			wr_start_reg |= uart_pkt_ptr[7 + la_offset];		//LSB
+			wr_start_reg++; //convert from 0-based to 1-based
+
+			wr_num_regs = uart_pkt_ptr[8 + la_offset] << 8;	//MSB
+			wr_num_regs |= uart_pkt_ptr[9 + la_offset];		//LSB
+
+			if ( (num_regs == 0) || (num_regs > 0x7D) || (wr_num_regs == 0) || (wr_num_regs > 0x79)
+				|| (num_data_bytes != wr_num_regs*2) )
+			{//bad query
+				MB_SendException(slave, fxn, MB_EXCEP_BAD_VALUE);
+				return;
+			}
+
+			// both halves have to land in the same table with the same byte order
+			register_type = MB_RX_Reg_Type(&start_reg, &reg_offset);
+			if ( (MB_RX_Reg_Type(&wr_start_reg, &wr_reg_offset) != register_type) || (wr_reg_offset != reg_offset) )
+			{
+				MB_SendException(slave, fxn, MB_EXCEP_BAD_ADDRESS);
+				return;
+			}
+
+			if (register_type != REG_TYPE_INTEGER)
+			{
+				num_regs /= 2; // two 16-bit fields = 1 float/long int register
+				wr_num_regs /= 2;
+			}
+
+			//create MB packet info -- byte_cnt is that of the read
+			mb_pkt = Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, num_regs, 0, register_type,
+									 MB_READ_QRY, vtune, is_broadcast, is_long_addr, reg_offset);
+			if (mb_pkt == (MB_PKT*)0) return; // packet list is full
+
+			mb_pkt->wr_start_reg = wr_start_reg;
+			mb_pkt->wr_num_regs	 = wr_num_regs;
+
+			MB_RX_Copy_Regs(mb_pkt, &uart_pkt_ptr[11 + la_offset], num_data_bytes);
+
+			MB_Schedule();
+
+			break;
+
+		case 0x14: //read file record
+			if (is_broadcast)
+			{	// read functions not applicable for broadcast packets
+				return;
+			}
+
+			num_data_bytes = uart_pkt_ptr[2+la_offset];
+			msg_num_bytes = 3 + num_data_bytes; // number of bytes in query (not counting CRC)
+
+			if(rx_n < msg_num_bytes + 2 + la_offset) // CRC -> add 2 bytes
+			{//frame ended early
+				STAT_CURRENT = 3;
+				STAT_RETRY++;
+				return;
+			}
+
+			//query CRC
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
+			{//CRC mismatch
+				STAT_CURRENT = 1;
+				STAT_PKT++;
+				MB_STAT.crc_err++;
+				return;
+			}
+			MB_STAT.served++;
+
+			// 7 bytes per sub-request
+			if ( (num_data_bytes < 7) || (num_data_bytes > 0xF5) || ((num_data_bytes % 7) != 0) )
+			{//bad query
+				MB_SendException(slave, fxn, MB_EXCEP_BAD_VALUE);
+				return;
+			}
+
+			// each sub-response: length, reference type, 2 bytes per record
+			file_resp_n = 0;
+			for (i=0;i<num_data_bytes;i+=7)
+			{
+				file_rec_n = (uart_pkt_ptr[i+8 + la_offset] << 8) | uart_pkt_ptr[i+9 + la_offset];
+				if (file_rec_n > MB_FILE_MAX_RECS)
+					break;
+				file_resp_n += 2 + 2*file_rec_n;
+			}
+
+			if ( (i < num_data_bytes) || (file_resp_n > 251) ) // PDU: function + length + sub-responses
+			{//response would not fit
+				MB_SendException(slave, fxn, MB_EXCEP_BAD_VALUE);
+				return;
+			}
+
+			//create MB packet info -- num_regs is the number of sub-requests
+			mb_pkt = Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, 0, num_data_bytes / 7, 0, REG_TYPE_FILE,
+									 MB_READ_QRY, vtune, is_broadcast, is_long_addr, reg_offset);
+			if (mb_pkt == (MB_PKT*)0) return; // packet list is full
+
+			mb_pkt->byte_cnt = file_resp_n;
+			memcpy(mb_pkt->data, &uart_pkt_ptr[3 + la_offset], num_data_bytes);
+
+			MB_Schedule();
+			break;
+
+		case 0x15: //write file record
+			if (is_broadcast)
+			{	// every chunk needs its answer
+				return;
+			}
+
+			num_data_bytes = uart_pkt_ptr[2+la_offset];
+			msg_num_bytes = 3 + num_data_bytes; // number of bytes in query (not counting CRC)
+
+			if(rx_n < msg_num_bytes + 2 + la_offset) // CRC -> add 2 bytes
+			{//frame ended early
+				STAT_CURRENT = 3;
+				STAT_RETRY++;
+				return;
+			}
+
+			//query CRC
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
+			{//CRC mismatch
+				STAT_CURRENT = 1;
+				STAT_PKT++;
+				MB_STAT.crc_err++;
+				return;
+			}
+			MB_STAT.served++;
+
+			// sub-requests: reference type, file, record number, record length, record data
+			for (file_i=0;file_i + 7 <= num_data_bytes;file_i+=7 + 2*file_len)
+			{
+				file_len = (uart_pkt_ptr[file_i+8 + la_offset] << 8) | uart_pkt_ptr[file_i+9 + la_offset];
+				if (file_len > (num_data_bytes - file_i - 7) / 2)
+					break; // record data runs past the request
+			}
+
+			if ( (num_data_bytes < 9) || (num_data_bytes > 0xFB) || (file_i != num_data_bytes) )
+			{//bad query
+				MB_SendException(slave, fxn, MB_EXCEP_BAD_VALUE);
+				return;
+			}
+
+			mb_pkt = Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, 0, 0, 0, REG_TYPE_FILE_WR,
+									 MB_WRITE_QRY, 0, is_broadcast, is_long_addr, reg_offset);
+			if (mb_pkt == (MB_PKT*)0) return; // packet list is full
+
+			mb_pkt->byte_cnt = num_data_bytes;
+			memcpy(mb_pkt->data, &uart_pkt_ptr[3 + la_offset], num_data_bytes);
+
+			MB_Schedule();
+			break;
+
+		case 0x08: //diagnostics
+			if (is_broadcast)
+			{	// not applicable for broadcast packets
+				return;
+			}
+
+			// sub-function and data; return query data may carry any amount of data
+			msg_num_bytes = rx_n - 2 - la_offset;
+
+			if ( (rx_n < (Uint32)8 + la_offset) || ((msg_num_bytes & 1) != 0) )
+			{//frame ended early
+				STAT_CURRENT = 3;
+				STAT_RETRY++;
+				return;
+			}
+
+			//query CRC
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
+			{//CRC mismatch
+				STAT_CURRENT = 1;
+				STAT_PKT++;
+				MB_STAT.crc_err++;
+				return;
+			}
+			MB_STAT.served++;
+
+			start_reg = (uart_pkt_ptr[2+la_offset] << 8) | uart_pkt_ptr[3+la_offset];	// sub-function
+			num_regs  = (uart_pkt_ptr[4+la_offset] << 8) | uart_pkt_ptr[5+la_offset];	// data
+
+			switch (start_reg)
+			{
+				case MB_DIAG_QUERY_DATA: case MB_DIAG_RESTART: case MB_DIAG_CLEAR:
+				case MB_DIAG_BUS_MSG: case MB_DIAG_BUS_ERR: case MB_DIAG_EXCEP:
+				case MB_DIAG_SRV_MSG: case MB_DIAG_NO_RESP: case MB_DIAG_OVERRUN:
+				case MB_DIAG_CLEAR_OVERRUN:
+					break;
+				default:
+					MB_SendException(slave, fxn, MB_EXCEP_BAD_FXN);
+					return;
+			}
+
+			if ( (start_reg != MB_DIAG_QUERY_DATA) && (msg_num_bytes != 6) )
+			{//the other sub-functions take exactly one data word
+				MB_SendException(slave, fxn, MB_EXCEP_BAD_VALUE);
+				return;
+			}
+
+			mb_pkt = Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, num_regs, 0, REG_TYPE_DIAG,
+									 MB_READ_QRY, 0, is_broadcast, is_long_addr, reg_offset);
+			if (mb_pkt == (MB_PKT*)0) return; // packet list is full
+
+			mb_pkt->byte_cnt = msg_num_bytes - 4;
+			memcpy(mb_pkt->data, &uart_pkt_ptr[4 + la_offset], mb_pkt->byte_cnt);
+
+			MB_Schedule();
+			break;
+
+		/// calibrate functions (non-standard) ///
+		case MB_CMD_PDI_ANALYZER_SAMPLE: // mb_cmd_pdi_analyzer_sample = 66
+			if (is_broadcast)
+			{	// read functions not applicable for broadcast packets
+				return;
+			}
+
+			msg_num_bytes = 7;
+
+			//	Third byte specifies vtune, which is currently meaningless
 			//	for the Razor, but must be parroted back to PC nonetheless
 			vtune	= uart_pkt_ptr[2+la_offset] & 0x03; // this is the vtune the cal sw thinks it's selecting
 
 			//query CRC
-			calc_CRC = Calc_CRC(uart_pkt_ptr, msg_num_bytes + la_offset,0);
-			msg_CRC = uart_pkt_ptr[msg_num_bytes + la_offset];			//LSB is first
-			msg_CRC |= uart_pkt_ptr[msg_num_bytes+1 + la_offset] << 8; 	//MSB is second
-
-			if(calc_CRC != msg_CRC)
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
 			{//CRC mismatch
 				STAT_CURRENT = 1;
 				STAT_PKT++;
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
+				MB_STAT.crc_err++;
 				return;
 			}
+			MB_STAT.served++;
 
 			register_type = REG_TYPE_GET_SAMPLE;
 
@@ -1278,38 +2061,84 @@ Modbus_RX(void)
 			Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, 0, 34, 0, register_type,
 							 MB_READ_QRY, vtune, is_broadcast, is_long_addr, reg_offset);
 
-			key2 = Hwi_disableInterrupt(5);	////////
-			//remove data from RX buffer
-			UART_RXBUF.n 	-= msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			UART_RXBUF.head += msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-			if (UART_RXBUF.n < 0) // this shouldn't happen
-				Clear_Buffer(&UART_RXBUF);
-			else if (UART_RXBUF.head >= MAX_BFR_SIZE)
-				UART_RXBUF.head -= MAX_BFR_SIZE;	//wrap around
 
-			Hwi_restoreInterrupt(5,key2);		////////
+			//call MB_SendPacket after silence period
+			MB_Schedule();
+
+			break;
+
+		case MB_CMD_PDI_CHANGES: // 65
+			if (is_broadcast)
+			{	// read functions not applicable for broadcast packets
+				return;
+			}
+
+			// sequence number the master last synced to, MSB first
+			msg_num_bytes = 6;
+
+			//query CRC
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
+			{//CRC mismatch
+				STAT_CURRENT = 1;
+				STAT_PKT++;
+				MB_STAT.crc_err++;
+				return;
+			}
+			MB_STAT.served++;
+
+			start_reg = (uart_pkt_ptr[2+la_offset] << 8) | uart_pkt_ptr[3+la_offset];
+			num_regs  = (uart_pkt_ptr[4+la_offset] << 8) | uart_pkt_ptr[5+la_offset];
+
+			Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, num_regs, 0, REG_TYPE_CHANGES,
+							 MB_READ_QRY, 0, is_broadcast, is_long_addr, reg_offset);
+
+			//call MB_SendPacket after silence period
+			MB_Schedule();
+
+			break;
+
+		case MB_CMD_PDI_SAMPLE_STREAM: // 67
+			if (is_broadcast)
+			{	// the stream goes back to one master
+				return;
+			}
+
+			// record count, MSB first: 0 = stop, 0xFFFFFFFF = until stopped
+			msg_num_bytes = 6;
+
+			//query CRC
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
+			{//CRC mismatch
+				STAT_CURRENT = 1;
+				STAT_PKT++;
+				MB_STAT.crc_err++;
+				return;
+			}
+			MB_STAT.served++;
+
+			start_reg = (uart_pkt_ptr[2+la_offset] << 8) | uart_pkt_ptr[3+la_offset];
+			num_regs  = (uart_pkt_ptr[4+la_offset] << 8) | uart_pkt_ptr[5+la_offset];
+
+			Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, num_regs, 0, REG_TYPE_STREAM,
+							 MB_WRITE_QRY, 0, is_broadcast, is_long_addr, reg_offset);
 
-			//start the clock (timer) to call MB_SendPacket after silence period
-			Clock_start(MB_Start_Clock_Sample);
+			//call MB_SendPacket after silence period
+			MB_Schedule();
 
-			Hwi_restoreInterrupt(5,key);
 			break;
 
 		case MB_CMD_PDI_FORCE_SLAVE_PIPE: //68
 			msg_num_bytes = 7;
 
 			//query CRC
-			calc_CRC = Calc_CRC(uart_pkt_ptr, msg_num_bytes + la_offset,0);
-			msg_CRC = uart_pkt_ptr[msg_num_bytes + la_offset];			//LSB is first
-			msg_CRC |= uart_pkt_ptr[msg_num_bytes+1 + la_offset] << 8; 	//MSB is second
-			if(calc_CRC != msg_CRC)
+			if (!MB_RX_CRC_Is_Good(uart_pkt_ptr, msg_num_bytes + la_offset))
 			{//CRC mismatch
 				STAT_CURRENT = 1;
 				STAT_PKT++;
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
+				MB_STAT.crc_err++;
 				return;
 			}
+			MB_STAT.served++;
 
 			//check that the cal sw has the correct pipe SN
 			pipe_SN  = uart_pkt_ptr[3 + la_offset];
@@ -1327,26 +2156,15 @@ Modbus_RX(void)
 
 				mb_pkt = Create_MB_Pkt(&MB_PKT_LIST, slave, fxn, start_reg, 0, 0, REG_TYPE_FORCE_SN,
 											 MB_WRITE_QRY, 0, is_broadcast, is_long_addr, reg_offset);
+				if (mb_pkt == (MB_PKT*)0) return; // packet list is full
 
-				key2 = Hwi_disableInterrupt(5);	////////
-				//remove data from RX buffer
-				UART_RXBUF.n 	-= msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-				UART_RXBUF.head += msg_num_bytes + 2 + la_offset; //CRC is 2 bytes
-				if (UART_RXBUF.n < 0) // this shouldn't happen
-					Clear_Buffer(&UART_RXBUF);
-				else if (UART_RXBUF.head >= MAX_BFR_SIZE)
-					UART_RXBUF.head -= MAX_BFR_SIZE;	//wrap around
-				Hwi_restoreInterrupt(5,key2);		////////
-
-				//start the clock (timer) to call MB_SendPacket after silence period
-				Clock_start(MB_Start_Clock_ForceSlaveAddr);
-				Hwi_restoreInterrupt(5,key);
+
+				//call MB_SendPacket after silence period
+				MB_Schedule();
 				break;
 			}
 			else
 			{
-				Clear_Buffer(&UART_RXBUF);
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 ///////////////////////////////////////////////////////////////////////
@@ -1354,94 +2172,260 @@ Modbus_RX(void)
 		default: //bad frame
 			STAT_CURRENT = 2;
 			STAT_CMD++;
-			Clear_Buffer(&UART_RXBUF);
-			Hwi_restoreInterrupt(5,key);
 			return;
 	}
 }
 
-void MB_SendPacket_Int16(void)
+/***************************************************************************
+ * Modbus_RX() -- Swi_Modbus_RX
+ *  Posted when a frame is queued on MB_FRAME_LIST. Parses every waiting
+ *  frame and removes it from UART_RXBUF.
+ ***************************************************************************/
+void 
+Modbus_RX(void)
 {
-	Uint32 	key,CRC, msg_num_bytes, wrap_count;
-	Uint16 	i, regs_written, start_reg_no_offset;
-	Uint8	la_offset, data_type, prot; //protection status
-	Int8	rtn;
-	double* mbtable_ptr_dbl = NULL;
-	REGSWI* mbtable_ptr_rsw = NULL;
-	int*	mbtable_ptr_int = NULL;
-	VAR*	mbtable_ptr_var = NULL;
-	int 	mbtable_val, old_tail, old_n;
-	MB_PKT*	mb_pkt_ptr;
+	Uint32 rx_n;
 
-	// if TX is busy, come back later
-	if (MB_TX_IN_PROGRESS == TRUE)
+	while (MB_FRAME_LIST.head != MB_FRAME_LIST.tail)
 	{
-		Clock_start(MB_Start_Clock_Int16);
-		return;
-	}
+		MB_RX_CUR = MB_FRAME_LIST.BFR[MB_FRAME_LIST.head & (MB_RX_FRAMES - 1)];
+		rx_n = MB_RX_CUR.end - UART_RXBUF.head;
+		MB_STAT.frames++;
+
+		// answer on the serial line, for exceptions sent from the parser
+		MB_TX_RX_TS 	= MB_RX_CUR.end_ts;
+		MB_TX_REQ_DRV 	= MB_TX_DRV;
+		MB_TX_TAG 		= 0;
+
+		if (MB_RX_CUR.is_bad)
+		{//overrun or line error
+			STAT_CURRENT = 1;
+			STAT_PKT++;
+		}
+		else if (rx_n < 8)
+		{//too short for any query
+			STAT_CURRENT = 3;
+			STAT_RETRY++;
+		}
+		else
+			MB_RX_Parse(MB_RX_Frame(rx_n), rx_n);
 
-	if (UART_TXBUF.n > 0)
-	{
-		Clock_start(MB_Start_Clock_Int16);
-		return;
+		Ring_Consume(&UART_RXBUF, rx_n);
+		MB_FRAME_LIST.head++;
 	}
+}
 
-	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+/***************************************************************************
+ * MB_RX_Submit() - a request from a transport other than the serial line
+ * @param frame	- the request as an RTU frame: slave, PDU, CRC
+ * @param n		- number of bytes in the frame
+ * @param drv	- driver the response is handed to
+ * @param tag	- handed back to drv->send() with the response
+ * The request goes through the same parser and queue as one received on
+ * UART2. Swi_Modbus_RX is held off for the duration so that the two do
+ * not parse at the same time.
+ ***************************************************************************/
+void
+MB_RX_Submit(const Uint8* frame, Uint32 n, const MB_TX_DRIVER* drv, Uint32 tag)
+{
+	UInt key;
 
-	if ((COIL_MB_AUX_SELECT_MODE.val == FALSE) && (mb_pkt_ptr->start_reg > 40000)) //remove offset if there is one
-		start_reg_no_offset = mb_pkt_ptr->start_reg - 40000;
-	else
-		start_reg_no_offset = mb_pkt_ptr->start_reg;
+	key = Swi_disable(); ////////////////////////////////////////////////////////
 
-	key = Hwi_disableInterrupt(5); ////
-	old_tail	= UART_TXBUF.tail;
-	old_n		= UART_TXBUF.n;
+	MB_RX_CUR.start 	= 0;
+	MB_RX_CUR.crc_end 	= 0;	// no running CRC; MB_RX_CRC_Is_Good() computes it
+	MB_RX_CUR.end_ts 	= Timestamp_get32();
+	MB_RX_CUR.is_bad 	= FALSE;
+	MB_STAT.frames++;
 
-	///create the modbus frame
-	if (mb_pkt_ptr->long_address)
-	{
-		BfrPut(&UART_TXBUF,(Uint8)0xFA);
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+	MB_TX_RX_TS 	= MB_RX_CUR.end_ts;
+	MB_TX_REQ_DRV 	= drv;
+	MB_TX_TAG 		= tag;
+
+	if ((n < 8) || (n > MB_FRAME_SIZE))
+	{//too short for any query
+		STAT_CURRENT = 3;
+		STAT_RETRY++;
 	}
-    else
-    {
-        BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS); 
-    }
-	//BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS); // DKOH
-	BfrPut(&UART_TXBUF,mb_pkt_ptr->fxn);
+	else
+		MB_RX_Parse((Uint8*)frame, n);
 
-	////////////////////////////////////////////
-	/// READ REGISTER
-	////////////////////////////////////////////
+	Swi_restore(key); ///////////////////////////////////////////////////////////
+}
+
+/***************************************************************************
+ * MB_Write_Regs() - write half of function 0x17
+ * @param mb_pkt_ptr	- wr_start_reg/wr_num_regs and the (ABCD) data
+ * @return				- 0=success, otherwise the exception code to send
+ * Every register is checked before any is written, so a refused request
+ * leaves the tables untouched.
+ ***************************************************************************/
+static Uint8
+MB_Write_Regs(const MB_PKT* mb_pkt_ptr)
+{
+	Uint16	i, n, pass, reg, size;
+	Uint8	data_type, prot; //protection status
+	Int8	rtn;
+	Uint32	val;
+	double	dbl_val;
+	double*	mbtable_ptr_dbl;
+
+	size = (mb_pkt_ptr->reg_type == REG_TYPE_INTEGER) ? 2 : 4;	// data bytes per register
 
-	if ( (mb_pkt_ptr->fxn == 0x3) || (mb_pkt_ptr->fxn == 0x4) ) //read register(s)
+	for (pass=0;pass<2;pass++)
 	{
-		BfrPut(&UART_TXBUF,mb_pkt_ptr->byte_cnt);
+		if (pass == 1) MB_Float_Cache_Dirty();
 
-		for (i=0;i<mb_pkt_ptr->byte_cnt/2;i++)
+		// i counts data bytes; a character of an extended string takes one 16-bit register
+		for (i=0,reg=mb_pkt_ptr->wr_start_reg;i<mb_pkt_ptr->wr_num_regs*size;i+=n,reg+=n/2)
 		{
-			rtn = MB_Tbl_Search_IntRegs(start_reg_no_offset+i,&mbtable_ptr_dbl,&data_type,&prot);
+			mbtable_ptr_dbl = NULL;
+
+			if (mb_pkt_ptr->reg_type == REG_TYPE_INTEGER)
+				rtn = MB_Tbl_Search_IntRegs(reg,&mbtable_ptr_dbl,&data_type,&prot);
+			else if (mb_pkt_ptr->reg_type == REG_TYPE_LONG_INT)
+				rtn = MB_Tbl_Search_LongIntRegs(reg,&mbtable_ptr_dbl,&data_type,&prot);
+			else if (!mb_pkt_ptr->is_special_reg)
+				rtn = MB_Tbl_Search_FloatRegs(reg,&mbtable_ptr_dbl,&data_type,&prot);
+			else	//extended tables
+				rtn = MB_Tbl_Search_Extended(reg,&mbtable_ptr_dbl,&data_type,&prot);
+
+			if ((rtn == -1) || (mbtable_ptr_dbl == (double*)NULL))
+				return MB_EXCEP_BAD_ADDRESS;
+
+			n = (data_type == REGTYPE_CHAR) ? 2 : size;
+			if (i + n > mb_pkt_ptr->wr_num_regs*size)
+				return MB_EXCEP_BAD_ADDRESS;	// a float cut in half, after an odd number of characters
+
+			if (isNoPermission(prot,MB_WRITE_QRY))
+				return MB_EXCEP_BAD_VALUE;
+
+			if (pass == 0) continue;
+
+			if (n == 2)
+			{
+				val  = mb_pkt_ptr->data[i] << 8;		//MSB
+				val |= mb_pkt_ptr->data[i+1];			//LSB
+				dbl_val = (double) val;
+			}
+			else
+			{
+				val  = mb_pkt_ptr->data[i]   << 24;	//MSB
+				val |= mb_pkt_ptr->data[i+1] << 16;
+				val |= mb_pkt_ptr->data[i+2] << 8;
+				val |= mb_pkt_ptr->data[i+3];			//LSB
+				dbl_val = (mb_pkt_ptr->reg_type == REG_TYPE_FLOAT) ? (double)*(float*)&val : (double)*(int*)&val;
+			}
+
+			///// WRITE TO MODBUS TABLE -- same conversions as 0x06/0x10 /////
+			if ((mb_pkt_ptr->reg_type == REG_TYPE_LONG_INT) || (data_type == REGTYPE_LONGINT))
+				*(int*)mbtable_ptr_dbl = *(int*)&val;	//SIGNED 32-bit integer
+			else if (data_type == REGTYPE_DBL)
+				*mbtable_ptr_dbl = dbl_val;
+			else if (data_type == REGTYPE_SWI)
+			{
+				((REGSWI*)mbtable_ptr_dbl)->val = dbl_val;
+				if (((REGSWI*)mbtable_ptr_dbl)->swi != (Swi_Handle)NULL)
+					Swi_post(((REGSWI*)mbtable_ptr_dbl)->swi);
+			}
+			else if (data_type == REGTYPE_INT)
+				*(int*)mbtable_ptr_dbl = (int)dbl_val;
+			else if (data_type == REGTYPE_CHAR)
+				*(char*)mbtable_ptr_dbl = (char)val;	//the LSB, as MB_SendPacket_Float() reads it
+			else if (data_type == REGTYPE_VAR)
+			{
+				VAR_Update((VAR*)mbtable_ptr_dbl, dbl_val, 0);	//write to VAR
+				if (((VAR*)mbtable_ptr_dbl)->swi != (Swi_Handle)NULL)	// post any VAR-related SWI "AFTER" VAR_Update()
+					Swi_post(((VAR*)mbtable_ptr_dbl)->swi);
+			}
+		}
+	}
+
+	// update nand flash
+	requestNandWrite();
+
+	return 0;
+}
+
+void MB_SendPacket_Int16(void)
+{
+	Uint8	excep;
+	Uint16 	i, regs_written, start_reg_no_offset;
+	Uint8	data_type, prot; //protection status
+	Int8	rtn;
+	double* mbtable_ptr_dbl = NULL;
+	REGSWI* mbtable_ptr_rsw = NULL;
+	int*	mbtable_ptr_int = NULL;
+	VAR*	mbtable_ptr_var = NULL;
+	int 	mbtable_val;
+	MB_PKT*	mb_pkt_ptr;
+
+	// if TX is busy, MB_Schedule() runs again once the line is free
+	if ((MB_TX_IN_PROGRESS == TRUE) || (Ring_Count(&UART_TXBUF) > 0))
+		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	if ((COIL_MB_AUX_SELECT_MODE.val == FALSE) && (mb_pkt_ptr->start_reg > 40000)) //remove offset if there is one
+		start_reg_no_offset = mb_pkt_ptr->start_reg - 40000;
+	else
+		start_reg_no_offset = mb_pkt_ptr->start_reg;
+
+	MB_TX_Begin(mb_pkt_ptr);
+
+	///create the modbus frame
+	if (mb_pkt_ptr->long_address)
+	{
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+	}
+    else
+    {
+        MB_TX_Put(REG_SLAVE_ADDRESS); 
+    }
+	//MB_TX_Put(REG_SLAVE_ADDRESS); // DKOH
+	MB_TX_Put(mb_pkt_ptr->fxn);
+
+	////////////////////////////////////////////
+	/// READ REGISTER
+	////////////////////////////////////////////
+
+	if ( (mb_pkt_ptr->fxn == 0x3) || (mb_pkt_ptr->fxn == 0x4) || (mb_pkt_ptr->fxn == 0x17) ) //read register(s)
+	{
+		if (mb_pkt_ptr->fxn == 0x17) //read/write multiple registers: write first
+		{
+			excep = MB_Write_Regs(mb_pkt_ptr);
+			if (excep != 0)
+			{
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
+				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, excep);
+				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+				return;
+			}
+		}
+
+		MB_TX_Put(mb_pkt_ptr->byte_cnt);
+
+		for (i=0;i<mb_pkt_ptr->byte_cnt/2;i++)
+		{
+			rtn = MB_Tbl_Search_IntRegs(start_reg_no_offset+i,&mbtable_ptr_dbl,&data_type,&prot);
 
 			if (isNoPermission(prot, MB_READ_QRY)) 	//crosscheck R/W permission of register with lock status
 			{
-				UART_TXBUF.n 	= old_n; 			//remove everything we just added to the TX buffer
-				UART_TXBUF.tail	= old_tail;
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST); 	//discard the packet at the head of the list
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 
 			if ((rtn == -1) || (mbtable_ptr_dbl == (double*)NULL))
 			{ //register not found
-				UART_TXBUF.n 	= old_n; //remove everything we just added to the TX buffer
-				UART_TXBUF.tail	= old_tail;
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 
@@ -1456,19 +2440,15 @@ void MB_SendPacket_Int16(void)
 				mbtable_val = (int) Round_N(((VAR*)mbtable_ptr_dbl)->val,0);
 			else
 			{
-				// Something went wrong, remove everything we just added to the TX buffer
+				// Something went wrong, remove everything we just added to the TX frame
 				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-				UART_TXBUF.n 	= old_n;
-				UART_TXBUF.tail	= old_tail;
-				Hwi_restoreInterrupt(5,key);
+				MB_TX_Discard();
 				return;
 			}
 
-			BfrPut(&UART_TXBUF,mbtable_val >> 8);	// MSB
-			BfrPut(&UART_TXBUF,mbtable_val & 0xFF);	// LSB
+			MB_TX_Put(mbtable_val >> 8);	// MSB
+			MB_TX_Put(mbtable_val & 0xFF);	// LSB
 		}
-
-		msg_num_bytes = 3 + mb_pkt_ptr->byte_cnt; 	// slave byte + fxn byte + bytecnt byte + data bytes
 	}
 
 	/////////////////////////////////////////////////
@@ -1477,26 +2457,24 @@ void MB_SendPacket_Int16(void)
 
 	else if (mb_pkt_ptr->fxn == 0x6)
 	{
+		MB_Float_Cache_Dirty();
+
 		rtn = MB_Tbl_Search_IntRegs(start_reg_no_offset,&mbtable_ptr_dbl,&data_type,&prot);
 
-		if ((rtn == -1) || (mbtable_ptr_dbl == (double*)NULL)) // Register not found, remove everything we just added to TX buffer
+		if ((rtn == -1) || (mbtable_ptr_dbl == (double*)NULL)) // Register not found, remove everything we just added to TX frame
 		{
-			UART_TXBUF.n 	= old_n;
-			UART_TXBUF.tail	= old_tail;
+			MB_TX_Discard();
 
 			MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 			Discard_MB_Pkt_Head(&MB_PKT_LIST); 					//discard the packet at the head of the list
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
 
         if (isNoPermission(prot,MB_WRITE_QRY)) //crosscheck R/W permission of register with lock status
     	{
-			UART_TXBUF.n 	= old_n; //remove everything we just added to the TX buffer
-			UART_TXBUF.tail	= old_tail;
+			MB_TX_Discard(); 	//remove everything we just added to the TX frame
     		MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
 			Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
 
@@ -1512,7 +2490,7 @@ void MB_SendPacket_Int16(void)
 			*mbtable_ptr_dbl = (double) mbtable_val;	//write to the double
             
             // update nand flash
-            Swi_post(Swi_writeNand);
+            requestNandWrite();
         }
 		else if (data_type == REGTYPE_SWI)
 		{
@@ -1527,7 +2505,7 @@ void MB_SendPacket_Int16(void)
 			*mbtable_ptr_int = mbtable_val;				//write to the integer
 
             // update nand flash
-            Swi_post(Swi_writeNand);
+            requestNandWrite();
 		}
 		else if (data_type == REGTYPE_VAR)
 		{
@@ -1538,18 +2516,16 @@ void MB_SendPacket_Int16(void)
 			if (mbtable_ptr_var->swi != (Swi_Handle)NULL) Swi_post(mbtable_ptr_var->swi);
             
             // update nand flash
-            Swi_post(Swi_writeNand);
+            requestNandWrite();
 		}
 
 		// send starting register -- note: need to use 0-based addressing
-		BfrPut(&UART_TXBUF,(mb_pkt_ptr->start_reg-1) >> 8);		// MSB
-		BfrPut(&UART_TXBUF,(mb_pkt_ptr->start_reg-1) & 0xFF);	// LSB
+		MB_TX_Put((mb_pkt_ptr->start_reg-1) >> 8);		// MSB
+		MB_TX_Put((mb_pkt_ptr->start_reg-1) & 0xFF);	// LSB
 
 		//send data bytes
-		BfrPut(&UART_TXBUF,mb_pkt_ptr->data[0]);	// MSB
-		BfrPut(&UART_TXBUF,mb_pkt_ptr->data[1]);	// LSB
-
-		msg_num_bytes = 6; // slave byte + fxn byte + 2 address bytes + 2 data bytes
+		MB_TX_Put(mb_pkt_ptr->data[0]);	// MSB
+		MB_TX_Put(mb_pkt_ptr->data[1]);	// LSB
 	}
 
 	///////////////////////////////////////////////////////
@@ -1558,11 +2534,13 @@ void MB_SendPacket_Int16(void)
 
 	else if (mb_pkt_ptr->fxn == 0x10)
 	{
+		MB_Float_Cache_Dirty();
+
 		regs_written = 0;
 
 		// send starting register -- note: need to use 0-based addressing
-		BfrPut(&UART_TXBUF,(mb_pkt_ptr->start_reg-1) >> 8);		// MSB
-		BfrPut(&UART_TXBUF,(mb_pkt_ptr->start_reg-1) & 0xFF);	// LSB
+		MB_TX_Put((mb_pkt_ptr->start_reg-1) >> 8);		// MSB
+		MB_TX_Put((mb_pkt_ptr->start_reg-1) & 0xFF);	// LSB
 
 		for (i=0;i<mb_pkt_ptr->num_regs;i++)
 		{
@@ -1604,12 +2582,10 @@ void MB_SendPacket_Int16(void)
 			}
 			else
 			{
-				// Illegal data address, remove everything we just added to the TX buffer
-				UART_TXBUF.n 	= old_n;
-				UART_TXBUF.tail	= old_tail;
+				// Illegal data address, remove everything we just added to the TX frame
+				MB_TX_Discard();
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 		}
@@ -1618,67 +2594,40 @@ void MB_SendPacket_Int16(void)
 		if (regs_written == mb_pkt_ptr->num_regs)
 		{
 			//send number of registers written
-			BfrPut(&UART_TXBUF,regs_written >> 8); 		// MSB
-			BfrPut(&UART_TXBUF,regs_written & 0xFF); 	// LSB
+			MB_TX_Put(regs_written >> 8); 		// MSB
+			MB_TX_Put(regs_written & 0xFF); 	// LSB
 		}
 		else
 		{
-			UART_TXBUF.n 	= old_n;					// Failed, remove everything we just added to the TX buffer
-			UART_TXBUF.tail	= old_tail;
+			MB_TX_Discard(); 	// Failed, remove everything we just added to the TX frame
 			MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 			Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
-
-		msg_num_bytes = 6; // slave byte + fxn byte + 2 address bytes + 2 data bytes
 	}
 	///////////// BAD MB FXN /////////////
 	else
 	{
-		// Something went wrong, remove everything we just added to the TX buffer
-		UART_TXBUF.n 	= old_n;
-		UART_TXBUF.tail	= old_tail;
+		// Something went wrong, remove everything we just added to the TX frame
+		MB_TX_Discard();
 
 		MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_FXN);
 		Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-		Hwi_restoreInterrupt(5,key);
 		return;
 	}
 	
-	/// check if long_addr
-	if (mb_pkt_ptr->long_address) la_offset = LONG_OFFSET;
-	else la_offset = 0;
 
 	// calculate & send CRC
-	if (UART_TXBUF.tail < old_tail) // if there was a buffer wrap around
-	{
-		wrap_count = MAX_BFR_SIZE - UART_TXBUF.head;
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,wrap_count);
-	}
-	else
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,0);
-
-	BfrPut(&UART_TXBUF, CRC & 0xFF);	// LSB
-	BfrPut(&UART_TXBUF, CRC >> 8);		// MSB
+	MB_TX_Put_CRC();
 	Discard_MB_Pkt_Head(&MB_PKT_LIST); 	//discard the packet at the head of the list
 
 	if (mb_pkt_ptr->is_broadcast == TRUE) // don't respond to broadcasts
 	{
-		//remove everything we just added to the TX buffer
-		UART_TXBUF.n 	= old_n;
-		UART_TXBUF.tail	= old_tail;
+		MB_STAT.no_resp++;
+		MB_TX_Discard();
 	}
 	else
-	{
-		MB_TX_IN_PROGRESS = TRUE;
-
-		if ( CSL_FEXT(uartRegs->IER,UART_IER_ETBEI) != 1) //if disabled
-			CSL_FINST(uartRegs->IER,UART_IER_ETBEI,ENABLE);	//enable TX buffer empty interrupt
-		Hwi_restoreInterrupt(5,key); ////
-
-		Uart_ISR(); // prime the pump
-	}
+		MB_TX_Send();
 
 	STAT_CURRENT = 0;
 	STAT_SUCCESS++;
@@ -1687,42 +2636,36 @@ void MB_SendPacket_Int16(void)
 void 
 MB_SendPacket_Coil(void)
 {
-	Uint32 	key,CRC, msg_num_bytes, wrap_count;
-	Uint16 	data_byte, modulo_bits;
+	Uint16 	data_byte;
 	Uint16  i, j, offset_cnt;
-	Int8	la_offset, rtn;
+	Int8	rtn;
 	Uint8	coil_val, data_type, prot; //protection status
 	COIL* 	mbtable_ptr = NULL;
-	int		old_tail, old_n;
 	MB_PKT*	mb_pkt_ptr;
 
+	// if TX is busy, MB_Schedule() runs again once the line is free
 	if (MB_TX_IN_PROGRESS == TRUE)
-	{
-		Clock_start(MB_Start_Clock_Coil);
 		return;
-	}
 
 	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
 
-	key = Hwi_disableInterrupt(5);
-	old_tail	= UART_TXBUF.tail;
-	old_n		= UART_TXBUF.n;
+	MB_TX_Begin(mb_pkt_ptr);
 
 	/// create the modbus frame
 	if (mb_pkt_ptr->long_address)
 	{
-		BfrPut(&UART_TXBUF,(Uint8)0xFA);
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
 	}
     else
     {
-        BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS);
+        MB_TX_Put(REG_SLAVE_ADDRESS);
     }
-	//BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS); // DKOH
-	BfrPut(&UART_TXBUF,mb_pkt_ptr->fxn);
+	//MB_TX_Put(REG_SLAVE_ADDRESS); // DKOH
+	MB_TX_Put(mb_pkt_ptr->fxn);
 
     /////////////////////////////////////////////////
 	/// READ COIL
@@ -1730,11 +2673,9 @@ MB_SendPacket_Coil(void)
 
     if ((mb_pkt_ptr->fxn == 1) || (mb_pkt_ptr->fxn == 2)) //read coil
 	{//read coil
-		BfrPut(&UART_TXBUF,mb_pkt_ptr->byte_cnt);
+		MB_TX_Put(mb_pkt_ptr->byte_cnt);
 
 		// we pack all coils (i.e. bits) into a minimum number of bytes
-		// modulo_bits is the number of bits left over that don't completely fill a byte (bits < 8)
-		modulo_bits	= mb_pkt_ptr->num_regs % 8;
 		offset_cnt = 0;
 
 		//generate data byte(s)
@@ -1743,44 +2684,38 @@ MB_SendPacket_Coil(void)
 			data_byte = 0;
 			for(i=1;i<=8;i++)
 			{
+				//special case: last byte only partially filled with coils
+				//(stop before looking up coils past the request, which need not exist)
+				if (offset_cnt >= mb_pkt_ptr->num_regs) break;
+
 				coil_val = 0;
 				rtn = MB_Tbl_Search_CoilRegs(mb_pkt_ptr->start_reg + offset_cnt,&mbtable_ptr,&data_type,&prot);
 				offset_cnt++;
 
-                /// coil not found && we haven't overshot the number of coils
-				if ( (rtn == -1) || (mbtable_ptr == (COIL*)NULL) && (offset_cnt <= mb_pkt_ptr->num_regs) || (data_type != REGTYPE_COIL) )
+                /// coil not found
+				if ( (rtn == -1) || (data_type != REGTYPE_COIL) )
 				{ 
 					MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_SLAVE_FAIL);
 					Discard_MB_Pkt_Head(&MB_PKT_LIST); // discard the packet at the head of the list
-					Hwi_restoreInterrupt(5,key);
 					return;
 				}
 
                 /// checking access permission
                 if (isNoPermission(prot,MB_READ_QRY))
     	        {
-			        UART_TXBUF.n 	= old_n; // remove everything we just added to the TX buffer
-			        UART_TXBUF.tail	= old_tail;
+			        MB_TX_Discard(); 	// remove everything we just added to the TX frame
     		        MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
 			        Discard_MB_Pkt_Head(&MB_PKT_LIST); // discard the packet at the head of the list
-			        Hwi_restoreInterrupt(5,key);
 			        return;
 		        }
 
-				//special case: last byte only partially filled with coils
-				if ( (j==mb_pkt_ptr->byte_cnt) && (i > modulo_bits) ) break;
-				else
-				{ //full byte worth of coils
-					coil_val = mbtable_ptr->val & 0x1; 	//get coil value
-					coil_val = coil_val << (i-1);		//shift left as needed
-					data_byte |= coil_val;			// OR with data_byte
-				}
+				coil_val = mbtable_ptr->val & 0x1; 	//get coil value
+				coil_val = coil_val << (i-1);		//shift left as needed
+				data_byte |= coil_val;			// OR with data_byte
 
 			}
-			BfrPut(&UART_TXBUF,data_byte);	// send data_byte
+			MB_TX_Put(data_byte);	// send data_byte
 		}
-
-		msg_num_bytes = 3 + mb_pkt_ptr->byte_cnt; // address byte + fxn byte + bytecnt byte + data bytes
 	}
 
     /////////////////////////////////////////////////
@@ -1789,34 +2724,32 @@ MB_SendPacket_Coil(void)
 
     else if (mb_pkt_ptr->fxn == 5) //write coil
 	{//write coil
+		MB_Float_Cache_Dirty();
+
 		rtn = MB_Tbl_Search_CoilRegs(mb_pkt_ptr->start_reg,&mbtable_ptr,&data_type,&prot);
 
 		if ( (rtn == -1) || (mbtable_ptr == (COIL*)NULL) || (data_type != REGTYPE_COIL) )
 		{
-			//COIL not found, remove everything we just added to the TX buffer
-			UART_TXBUF.n 	= old_n;
-			UART_TXBUF.tail	= old_tail;
+			//COIL not found, remove everything we just added to the TX frame
+			MB_TX_Discard();
 
 			MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 			Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
 
        /// checking access permission
        if (isNoPermission(prot,MB_WRITE_QRY))
        {
-            UART_TXBUF.n 	= old_n; // remove everything we just added to the TX buffer
-	        UART_TXBUF.tail	= old_tail;
+            MB_TX_Discard(); 	// remove everything we just added to the TX frame
    	        MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
 	        Discard_MB_Pkt_Head(&MB_PKT_LIST); // discard the packet at the head of the list
-	        Hwi_restoreInterrupt(5,key);
 	        return;
         }
 
    		/// send the coil address -- note: need to convert back to zero-based addressing
-		BfrPut(&UART_TXBUF,(mb_pkt_ptr->start_reg-1) >> 8);		//MSB
-		BfrPut(&UART_TXBUF,(mb_pkt_ptr->start_reg-1) & 0xFF);	//LSB
+		MB_TX_Put((mb_pkt_ptr->start_reg-1) >> 8);		//MSB
+		MB_TX_Put((mb_pkt_ptr->start_reg-1) & 0xFF);	//LSB
 
 		/// WRITE TO MODBUS TABLE
 		if (mb_pkt_ptr->data[0] == TRUE)  	// if we are setting the coil
@@ -1826,10 +2759,10 @@ MB_SendPacket_Coil(void)
 				mbtable_ptr->val = TRUE; 		// set the coil
 
                 // update nand flash
-                Swi_post(Swi_writeNand);
+                requestNandWrite();
             }
-			BfrPut(&UART_TXBUF,0xFF);
-			BfrPut(&UART_TXBUF,0x00);
+			MB_TX_Put(0xFF);
+			MB_TX_Put(0x00);
 		}
 		else if (mb_pkt_ptr->data[0] == FALSE)	//if we are resetting the coil
 		{
@@ -1838,73 +2771,98 @@ MB_SendPacket_Coil(void)
 				mbtable_ptr->val = FALSE;			// reset the coil
 
                 // update nand flash
-                Swi_post(Swi_writeNand);
+                requestNandWrite();
             }
 
-			BfrPut(&UART_TXBUF,0x00);
-			BfrPut(&UART_TXBUF,0x00);
+			MB_TX_Put(0x00);
+			MB_TX_Put(0x00);
 		}
 		else
 		{
-			//remove everything we just added to the TX buffer
-			UART_TXBUF.n 	= old_n;
-			UART_TXBUF.tail	= old_tail;
+			//remove everything we just added to the TX frame
+			MB_TX_Discard();
 
 			MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_SLAVE_FAIL);
 			Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
 
 		//post the relevant SWI, if any
 		if (mbtable_ptr->swi != (Swi_Handle)NULL) Swi_post(mbtable_ptr->swi);// post any COIL-related SWI
+	}
+
+    /////////////////////////////////////////////////
+	/// WRITE MULTIPLE COILS
+	/////////////////////////////////////////////////
+
+    else if (mb_pkt_ptr->fxn == 0x0F) //write multiple coils
+	{
+		MB_Float_Cache_Dirty();
+
+		/// check every coil before writing any of them
+		for (i=0;i<mb_pkt_ptr->num_regs;i++)
+		{
+			rtn = MB_Tbl_Search_CoilRegs(mb_pkt_ptr->start_reg + i,&mbtable_ptr,&data_type,&prot);
+
+			if ( (rtn == -1) || (mbtable_ptr == (COIL*)NULL) || (data_type != REGTYPE_COIL) )
+			{
+				MB_TX_Discard();
+				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
+				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+				return;
+			}
+
+			if (isNoPermission(prot,MB_WRITE_QRY))
+			{
+				MB_TX_Discard();
+				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
+				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+				return;
+			}
+		}
+
+		/// WRITE TO MODBUS TABLE -- coils are packed LSB first
+		for (i=0;i<mb_pkt_ptr->num_regs;i++)
+		{
+			MB_Tbl_Search_CoilRegs(mb_pkt_ptr->start_reg + i,&mbtable_ptr,&data_type,&prot);
+			coil_val = (mb_pkt_ptr->data[i >> 3] >> (i & 7)) & 0x1;
+
+			if (mbtable_ptr->val != coil_val)
+			{
+				mbtable_ptr->val = coil_val;
+				requestNandWrite();
+			}
 
-		msg_num_bytes = 6; // slave byte + fxn byte + 2 address bytes + 2 data bytes
+			if (mbtable_ptr->swi != (Swi_Handle)NULL) Swi_post(mbtable_ptr->swi);// post any COIL-related SWI
+		}
+
+		/// echo the starting address (zero-based) and the quantity of coils
+		MB_TX_Put((mb_pkt_ptr->start_reg-1) >> 8);		//MSB
+		MB_TX_Put((mb_pkt_ptr->start_reg-1) & 0xFF);	//LSB
+		MB_TX_Put(mb_pkt_ptr->num_regs >> 8);			//MSB
+		MB_TX_Put(mb_pkt_ptr->num_regs & 0xFF);			//LSB
 	}
 	else
 	{
-		// Something went wrong, remove everything we just added to the TX buffer
-		UART_TXBUF.n 	= old_n;
-		UART_TXBUF.tail	= old_tail;
+		// Something went wrong, remove everything we just added to the TX frame
+		MB_TX_Discard();
 		MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_FXN);
 		Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-		Hwi_restoreInterrupt(5,key);
 		return;
 	}
 	
-	/// check if long_addr
-	if (mb_pkt_ptr->long_address) la_offset = LONG_OFFSET;
-	else la_offset = 0;
-
-	if (UART_TXBUF.tail < old_tail) // if there was a buffer wrap around
-	{
-		wrap_count = MAX_BFR_SIZE - UART_TXBUF.head;
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,wrap_count);
-	}
-	else
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,0);
 
-
-	BfrPut(&UART_TXBUF, CRC & 0xFF);	// LSB
-	BfrPut(&UART_TXBUF, CRC >> 8);		// MSB
+	// calculate & send CRC
+	MB_TX_Put_CRC();
 	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
 
 	if (mb_pkt_ptr->is_broadcast == TRUE) // don't respond to broadcasts
 	{
-		//remove everything we just added to the TX buffer
-		UART_TXBUF.n 	= old_n;
-		UART_TXBUF.tail	= old_tail;
+		MB_STAT.no_resp++;
+		MB_TX_Discard();
 	}
 	else
-	{
-		MB_TX_IN_PROGRESS = TRUE;
-		Hwi_restoreInterrupt(5,key); ////
-
-		if ( CSL_FEXT(uartRegs->IER,UART_IER_ETBEI) != 1) //if disabled
-			CSL_FINST(uartRegs->IER,UART_IER_ETBEI,ENABLE);	//enable TX buffer empty interrupt
-
-		Uart_ISR(); // prime the pump
-	}
+		MB_TX_Send();
 
 	STAT_CURRENT = 0;
 	STAT_SUCCESS++;
@@ -1914,55 +2872,63 @@ MB_SendPacket_Coil(void)
 void 
 MB_SendPacket_LongInt(void)
 {
-	Uint32 	key,CRC, msg_num_bytes, wrap_count, mbtable_val;
+	Uint8	excep;
+	Uint32 	mbtable_val;
 	Uint16 	i, regs_written, st_reg;
 	Uint8	data_type, prot; //protection status
-	Int8	la_offset, rtn;
+	Int8	rtn;
 	double* mbtable_ptr_dbl = NULL;
 	REGSWI*	mbtable_ptr_rsw = NULL;
 	double	dbl_val;
 	int*	mbtable_ptr_int = NULL;
 	VAR*	mbtable_ptr_var = NULL;
 	float	float_val;
-	int		old_tail, old_n;
 	MB_PKT*	mb_pkt_ptr;
 
+	// if TX is busy, MB_Schedule() runs again once the line is free
 	if (MB_TX_IN_PROGRESS == TRUE)
-	{
-		Clock_start(MB_Start_Clock_LongInt);
 		return;
-	}
 
 	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
 
-	key = Hwi_disableInterrupt(5); ////
-	old_tail	= UART_TXBUF.tail;
-	old_n		= UART_TXBUF.n;
+	MB_TX_Begin(mb_pkt_ptr);
 
 	///create the modbus frame
 	if (mb_pkt_ptr->long_address)
 	{
 		// Do we need to worry about byte order here? ABCD for now.
-		BfrPut(&UART_TXBUF,(Uint8)0xFA);
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
 	}
     else
     {
-	    BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS);
+	    MB_TX_Put(REG_SLAVE_ADDRESS);
     }
-	//BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS); // DKOH
-	BfrPut(&UART_TXBUF,mb_pkt_ptr->fxn);
+	//MB_TX_Put(REG_SLAVE_ADDRESS); // DKOH
+	MB_TX_Put(mb_pkt_ptr->fxn);
 
 	////////////////////////////////////////////
 	//// READ REGISTER
 	////////////////////////////////////////////
 
-	if (  (mb_pkt_ptr->fxn == 0x3)	|| (mb_pkt_ptr->fxn == 0x4) )
+	if (  (mb_pkt_ptr->fxn == 0x3)	|| (mb_pkt_ptr->fxn == 0x4) || (mb_pkt_ptr->fxn == 0x17) )
 	{ 
-		BfrPut(&UART_TXBUF,mb_pkt_ptr->byte_cnt); //send byte count
+		if (mb_pkt_ptr->fxn == 0x17) //read/write multiple registers: write first
+		{
+			excep = MB_Write_Regs(mb_pkt_ptr);
+			if (excep != 0)
+			{
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
+				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, excep);
+				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+				return;
+			}
+		}
+
+		MB_TX_Put(mb_pkt_ptr->byte_cnt); //send byte count
 
 		for (i=0;i<mb_pkt_ptr->byte_cnt/4;i++)
 		{
@@ -1970,34 +2936,28 @@ MB_SendPacket_LongInt(void)
 
 			if (isNoPermission(prot, MB_READ_QRY)) //crosscheck R/W permission of register with lock status
 			{
-				UART_TXBUF.n 	= old_n; //remove everything we just added to the TX buffer
-				UART_TXBUF.tail	= old_tail;
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 
 			if ((rtn == -1) || (mbtable_ptr_dbl == (double*)NULL))			// illegal data address, clean TX buffer
 			{
-				UART_TXBUF.n 	= old_n; 
-				UART_TXBUF.tail	= old_tail;
+				MB_TX_Discard();
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST);
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 
             mbtable_ptr_int = (int*) mbtable_ptr_dbl; 		// cast variable pointer to int*
 			mbtable_val 	= (Uint32)(*mbtable_ptr_int);	// dereference and cast the value as Uint32
 
-            BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 24) & 0xFF));// MSB
-			BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 16) & 0xFF));
-			BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 8) & 0xFF));
-			BfrPut(&UART_TXBUF,(Uint8)(mbtable_val  &  0xFF));		// LSB
+            MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));// MSB
+			MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
+			MB_TX_Put((Uint8)((mbtable_val >> 8) & 0xFF));
+			MB_TX_Put((Uint8)(mbtable_val  &  0xFF));		// LSB
 		}
-
-		msg_num_bytes = 3 + mb_pkt_ptr->byte_cnt; // address byte + fxn byte + bytecnt byte + data bytes
 	}
 
 
@@ -2007,13 +2967,15 @@ MB_SendPacket_LongInt(void)
 
 	else if (mb_pkt_ptr->fxn == 0x10)
 	{ 
+		MB_Float_Cache_Dirty();
+
 		// write registers
 		regs_written = 0;
 		st_reg = mb_pkt_ptr->start_reg;
 
 		// send starting register -- note: need to use 0-based addressing
-		BfrPut(&UART_TXBUF,(st_reg-1) >> 8);	// MSB
-		BfrPut(&UART_TXBUF,(st_reg-1) & 0xFF);	// LSB
+		MB_TX_Put((st_reg-1) >> 8);	// MSB
+		MB_TX_Put((st_reg-1) & 0xFF);	// LSB
 
 		for (i=0;i<mb_pkt_ptr->byte_cnt/4;i++)
 		{
@@ -2023,11 +2985,9 @@ MB_SendPacket_LongInt(void)
 			{
 				if (isNoPermission(prot,MB_WRITE_QRY)) //crosscheck R/W permission of register with lock status
 				{
-					UART_TXBUF.n 	= old_n; //remove everything we just added to the TX buffer
-					UART_TXBUF.tail	= old_tail;
+					MB_TX_Discard(); 	//remove everything we just added to the TX frame
 					MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
 					Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-					Hwi_restoreInterrupt(5,key);
 					return;
 				}
 
@@ -2044,17 +3004,15 @@ MB_SendPacket_LongInt(void)
 				*mbtable_ptr_int = *(int*)&mbtable_val; 		//read in value as SIGNED 32-bit integer
                
                 // update nand flash
-                Swi_post(Swi_writeNand); 
+                requestNandWrite(); 
 	
 				regs_written++;
 			}
 			else
 			{
-				UART_TXBUF.n 	= old_n; //remove everything we just added to the TX buffer
-				UART_TXBUF.tail	= old_tail;
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 		}
@@ -2063,53 +3021,30 @@ MB_SendPacket_LongInt(void)
 		if (regs_written == mb_pkt_ptr->num_regs)
 		{
 			//send number of registers written
-			BfrPut(&UART_TXBUF,regs_written*2 >> 8); 	// MSB
-			BfrPut(&UART_TXBUF,regs_written*2 & 0xFF); 	// LSB
+			MB_TX_Put(regs_written*2 >> 8); 	// MSB
+			MB_TX_Put(regs_written*2 & 0xFF); 	// LSB
 		}
 		else
 		{
-			UART_TXBUF.n 	= old_n; 					//remove everything we just added to the TX buffer
-			UART_TXBUF.tail	= old_tail;
+			MB_TX_Discard(); 	//remove everything we just added to the TX frame
 			MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 			Discard_MB_Pkt_Head(&MB_PKT_LIST); 			//discard the packet at the head of the list
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
-
-		msg_num_bytes = 6; // slave byte + fxn byte + 2 address bytes + 2 data bytes
 	}
 	
-	/// check if long_addr
-	if (mb_pkt_ptr->long_address) la_offset = LONG_OFFSET;
-	else la_offset = 0;
-
-	if (UART_TXBUF.tail < old_tail) // if there was a buffer wrap around
-	{
-		wrap_count = MAX_BFR_SIZE - UART_TXBUF.head;
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,wrap_count);
-	}
-	else
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,0);
 
-	BfrPut(&UART_TXBUF, CRC & 0xFF);						// LSB
-	BfrPut(&UART_TXBUF, CRC >> 8);							// MSB
+	// calculate & send CRC
+	MB_TX_Put_CRC();
 	Discard_MB_Pkt_Head(&MB_PKT_LIST); 						// discard the packet at the head of the list
 
-	if (mb_pkt_ptr->is_broadcast == TRUE) 					// don't respond to broadcasts
+	if (mb_pkt_ptr->is_broadcast == TRUE) // don't respond to broadcasts
 	{
-		//remove everything we just added to the TX buffer
-		UART_TXBUF.n 	= old_n;
-		UART_TXBUF.tail	= old_tail;
+		MB_STAT.no_resp++;
+		MB_TX_Discard();
 	}
 	else
-	{
-		MB_TX_IN_PROGRESS = TRUE;
-		Hwi_restoreInterrupt(5,key);
-
-		if ( CSL_FEXT(uartRegs->IER,UART_IER_ETBEI) != 1) 	//if disabled
-			CSL_FINST(uartRegs->IER,UART_IER_ETBEI,ENABLE);	//enable TX buffer empty interrupt
-		Uart_ISR(); // prime the pump
-	}
+		MB_TX_Send();
 
 	STAT_CURRENT = 0;
 	STAT_SUCCESS++;
@@ -2119,145 +3054,148 @@ MB_SendPacket_LongInt(void)
 void 
 MB_SendPacket_Float(void)
 {
-	Uint32 	key,CRC, msg_num_bytes, wrap_count, mbtable_val;
-	Uint16 	i, regs_written, st_reg;
-	Uint8	la_offset, data_type, prot; //protection status
+	Uint8	excep;
+	Uint32 	mbtable_val;
+	Uint16 	i, n, reg, regs_written, st_reg;
+	Uint8	data_type, prot; //protection status
 	Int8	rtn;
 	double* mbtable_ptr_dbl = NULL;
 	REGSWI*	mbtable_ptr_rsw = NULL;
 	double	dbl_val;
 	int*	mbtable_ptr_int = NULL;
 	VAR*	mbtable_ptr_var = NULL;
-	float	float_val;
-	int		old_tail, old_n;
 	MB_PKT*	mb_pkt_ptr;
 
+	// if TX is busy, MB_Schedule() runs again once the line is free
 	if (MB_TX_IN_PROGRESS == TRUE)
-	{
-		Clock_start(MB_Start_Clock_Float);
 		return;
-	}
 
 	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
 
-	key = Hwi_disableInterrupt(5); ////
-	old_tail	= UART_TXBUF.tail;
-	old_n		= UART_TXBUF.n;
+	MB_TX_Begin(mb_pkt_ptr);
 
 	///create the modbus frame
 	if (mb_pkt_ptr->long_address)
 	{
 		// Do we need to worry about byte order here? ABCD for now.
-		BfrPut(&UART_TXBUF,(Uint8)0xFA);
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
 	}
     else
     {
-	    BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS);
+	    MB_TX_Put(REG_SLAVE_ADDRESS);
     }
 
-	//BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS); // DKOH
-	BfrPut(&UART_TXBUF,mb_pkt_ptr->fxn);
+	//MB_TX_Put(REG_SLAVE_ADDRESS); // DKOH
+	MB_TX_Put(mb_pkt_ptr->fxn);
 
 	////////////////////////////////////////////
 	/// READ REGISTER
 	////////////////////////////////////////////
 
-	if (  (mb_pkt_ptr->fxn == 0x3)	|| (mb_pkt_ptr->fxn == 0x4) )
+	if (  (mb_pkt_ptr->fxn == 0x3)	|| (mb_pkt_ptr->fxn == 0x4) || (mb_pkt_ptr->fxn == 0x17) )
 	{ //read register(s)
-		BfrPut(&UART_TXBUF,mb_pkt_ptr->byte_cnt); //send byte count
+		if (mb_pkt_ptr->fxn == 0x17) //read/write multiple registers: write first
+		{
+			excep = MB_Write_Regs(mb_pkt_ptr);
+			if (excep != 0)
+			{
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
+				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, excep);
+				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+				return;
+			}
+		}
 
-		for (i=0;i<mb_pkt_ptr->byte_cnt/4;i++)
+		MB_TX_Put(mb_pkt_ptr->byte_cnt); //send byte count
+
+		//pre-encoded since the last Poll()?
+		if (MB_Float_Cache_Put(mb_pkt_ptr))
+			i = mb_pkt_ptr->byte_cnt;
+		else
+			i = 0;
+
+		// i counts data bytes: 4 per float, 2 per character of an extended string
+		for (reg=mb_pkt_ptr->start_reg;i<mb_pkt_ptr->byte_cnt;i+=n)
 		{
 			if (!mb_pkt_ptr->is_special_reg)
-                rtn = MB_Tbl_Search_FloatRegs(mb_pkt_ptr->start_reg+(i*2),&mbtable_ptr_dbl,&data_type,&prot);
+                rtn = MB_Tbl_Search_FloatRegs(reg,&mbtable_ptr_dbl,&data_type,&prot);
 			else	//extended tables
-				rtn = MB_Tbl_Search_Extended(mb_pkt_ptr->start_reg+(i*2),&mbtable_ptr_dbl,&data_type,&prot);
+				rtn = MB_Tbl_Search_Extended(reg,&mbtable_ptr_dbl,&data_type,&prot);
 
 			if (isNoPermission(prot, MB_READ_QRY)) //crosscheck R/W permission of register with lock status
 			{
-				UART_TXBUF.n 	= old_n; //remove everything we just added to the TX buffer
-				UART_TXBUF.tail	= old_tail;
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 
 			if ((rtn == -1) || (mbtable_ptr_dbl == (double*)NULL))			// illegal data address, clean TX buffer
 			{
-				UART_TXBUF.n 	= old_n; 
-				UART_TXBUF.tail	= old_tail;
+				MB_TX_Discard();
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST);
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 
-			if (data_type == REGTYPE_VAR)
-			{
-				mbtable_ptr_var = (VAR*)mbtable_ptr_dbl;
-				mbtable_val = *(Uint32*)(&mbtable_ptr_var->val); // treat float like a Uint32 so we can bit-shift
+			if (data_type == REGTYPE_CHAR)
+			{	// one register per character, sent as MB_SendPacket_Mixed() sends it
+				MB_TX_Put((Uint8)0);								// MSB
+				MB_TX_Put(*((Uint8*)mbtable_ptr_dbl));			// LSB
+				reg++;
+				n = 2;
+				continue;
 			}
-			else if (data_type == REGTYPE_DBL)
-			{
-				float_val = (float)(*mbtable_ptr_dbl);	// dereference and cast the value as float
-				mbtable_val = *(Uint32*)(&float_val);	// treat float like a Uint32 so we can bit-shift
-			}
-			else if (data_type == REGTYPE_SWI)
-			{
-				float_val = (float)(((REGSWI*)mbtable_ptr_dbl)->val);	// dereference as REGSWI and cast .val as float
-				mbtable_val = *(Uint32*)(&float_val);	// treat float like a Uint32 so we can bit-shift
-			}
-			else if (data_type == REGTYPE_LONGINT)
-			{
-				mbtable_ptr_int = (int*) mbtable_ptr_dbl; 		// cast variable pointer to int*
-				mbtable_val 	= (Uint32)(*mbtable_ptr_int);	// dereference and cast the value as Uint32
-			}
-			else if (data_type == REGTYPE_INT)
+
+			if (i + 4 > mb_pkt_ptr->byte_cnt)	// a float cut in half, after an odd number of characters
 			{
-				mbtable_ptr_int = (int*) mbtable_ptr_dbl; 	// cast variable pointer to int*
-				float_val 	= (float)(*mbtable_ptr_int);	// dereference and cast the value as float
-				mbtable_val = *(Uint32*)(&float_val);		// treat float like a Uint32 so we can bit-shift
+				MB_TX_Discard();
+				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
+				Discard_MB_Pkt_Head(&MB_PKT_LIST);
+				return;
 			}
 
+			reg += 2;
+			n = 4;
+
+			mbtable_val = MB_Float_Image(data_type, mbtable_ptr_dbl); // float bits as a Uint32 so we can bit-shift
+
 			// note: fortunately the C6748 uses IEEE standard floats
 
 			/// Send data value in correct byte order ///
 			if (mb_pkt_ptr->byte_order == MB_BYTE_ORDER_CDAB)
 			{	// CDAB
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 8) & 0xFF));
-				BfrPut(&UART_TXBUF,(Uint8)(mbtable_val  &  0xFF));		// LSB
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 24) & 0xFF));// MSB
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 16) & 0xFF));
+				MB_TX_Put((Uint8)((mbtable_val >> 8) & 0xFF));
+				MB_TX_Put((Uint8)(mbtable_val  &  0xFF));		// LSB
+				MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));// MSB
+				MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
 			}
 			else if (mb_pkt_ptr->byte_order == MB_BYTE_ORDER_DCBA)
 			{	// DCBA
-				BfrPut(&UART_TXBUF,(Uint8)(mbtable_val  &  0xFF));		// LSB
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 8) & 0xFF));
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 16) & 0xFF));
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 24) & 0xFF));// MSB
+				MB_TX_Put((Uint8)(mbtable_val  &  0xFF));		// LSB
+				MB_TX_Put((Uint8)((mbtable_val >> 8) & 0xFF));
+				MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
+				MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));// MSB
 			}
 			else if (mb_pkt_ptr->byte_order == MB_BYTE_ORDER_BADC)
 			{	// BADC
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 16) & 0xFF));
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 24) & 0xFF));// MSB
-				BfrPut(&UART_TXBUF,(Uint8)(mbtable_val  &  0xFF));		// LSB
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 8) & 0xFF));
+				MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
+				MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));// MSB
+				MB_TX_Put((Uint8)(mbtable_val  &  0xFF));		// LSB
+				MB_TX_Put((Uint8)((mbtable_val >> 8) & 0xFF));
 			}
 			else //if (mb_pkt_ptr->byte_order == MB_BYTE_ORDER_ABCD)
 			{	// ABCD
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 24) & 0xFF));// MSB
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 16) & 0xFF));
-				BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 8) & 0xFF));
-				BfrPut(&UART_TXBUF,(Uint8)(mbtable_val  &  0xFF));		// LSB
+				MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));// MSB
+				MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
+				MB_TX_Put((Uint8)((mbtable_val >> 8) & 0xFF));
+				MB_TX_Put((Uint8)(mbtable_val  &  0xFF));		// LSB
 			}
 		}
-
-		msg_num_bytes = 3 + mb_pkt_ptr->byte_cnt; // address byte + fxn byte + bytecnt byte + data bytes
 	}
 
 	/////////////////////////////////////////////
@@ -2266,6 +3204,8 @@ MB_SendPacket_Float(void)
 
 	else if (mb_pkt_ptr->fxn == 0x10)
 	{ 
+		MB_Float_Cache_Dirty();
+
 		//write registers
 		regs_written = 0;
 		st_reg = mb_pkt_ptr->start_reg;
@@ -2282,32 +3222,51 @@ MB_SendPacket_Float(void)
 			st_reg += SPECIAL_OFFSET;
 
 		// send starting register -- note: need to use 0-based addressing
-		BfrPut(&UART_TXBUF,(st_reg-1) >> 8);	// MSB
-		BfrPut(&UART_TXBUF,(st_reg-1) & 0xFF);	// LSB
+		MB_TX_Put((st_reg-1) >> 8);	// MSB
+		MB_TX_Put((st_reg-1) & 0xFF);	// LSB
 
-		for (i=0;i<mb_pkt_ptr->byte_cnt/4;i++)
+		// i counts data bytes: 4 per float, 2 per character of an extended string
+		for (i=0,reg=mb_pkt_ptr->start_reg;i<mb_pkt_ptr->byte_cnt;i+=n)
 		{
+			mbtable_ptr_dbl = NULL;
+
 			if (!mb_pkt_ptr->is_special_reg)
-				rtn = MB_Tbl_Search_FloatRegs(mb_pkt_ptr->start_reg+(i*2),&mbtable_ptr_dbl,&data_type,&prot);
+				rtn = MB_Tbl_Search_FloatRegs(reg,&mbtable_ptr_dbl,&data_type,&prot);
 			else	//extended tables
-				rtn = MB_Tbl_Search_Extended(mb_pkt_ptr->start_reg+(i*2),&mbtable_ptr_dbl,&data_type,&prot);
+				rtn = MB_Tbl_Search_Extended(reg,&mbtable_ptr_dbl,&data_type,&prot);
+
+			if ((mbtable_ptr_dbl != NULL) && (data_type != REGTYPE_CHAR) && (i + 4 > mb_pkt_ptr->byte_cnt))
+				mbtable_ptr_dbl = NULL;	// a float cut in half: illegal data address
 
 			if (mbtable_ptr_dbl != NULL)
 			{
 				if (isNoPermission(prot,MB_WRITE_QRY)) //crosscheck R/W permission of register with lock status
 				{
-					UART_TXBUF.n 	= old_n; //remove everything we just added to the TX buffer
-					UART_TXBUF.tail	= old_tail;
+					MB_TX_Discard(); 	//remove everything we just added to the TX frame
 					MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
 					Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-					Hwi_restoreInterrupt(5,key);
 					return;
 				}
 
-				mbtable_val  = mb_pkt_ptr->data[i*4]   << 24; 	//MSB
-				mbtable_val |= mb_pkt_ptr->data[i*4+1] << 16;
-				mbtable_val |= mb_pkt_ptr->data[i*4+2] << 8;
-				mbtable_val |= mb_pkt_ptr->data[i*4+3]; 		//LSB
+				if (data_type == REGTYPE_CHAR)
+				{	// one register per character, as it is read: the LSB is the character
+					*(char*)mbtable_ptr_dbl = (char)mb_pkt_ptr->data[i+1];
+
+                    // update nand flash
+                    requestNandWrite(); 
+
+					regs_written++;
+					reg++;
+					n = 2;
+					continue;
+				}
+
+				mbtable_val  = mb_pkt_ptr->data[i]   << 24; 	//MSB
+				mbtable_val |= mb_pkt_ptr->data[i+1] << 16;
+				mbtable_val |= mb_pkt_ptr->data[i+2] << 8;
+				mbtable_val |= mb_pkt_ptr->data[i+3]; 		//LSB
+				reg += 2;
+				n = 4;
 
 				///// WRITE TO MODBUS TABLE /////
 				/*NOTE:	Although the MB master is writing 16-bit integers, our actual	//
@@ -2318,7 +3277,7 @@ MB_SendPacket_Float(void)
 					*mbtable_ptr_dbl = (double)*(float*)&mbtable_val;	//read in value at mbtable_val as a float, then cast to double
 
                     // update nand flash
-                    Swi_post(Swi_writeNand); 
+                    requestNandWrite(); 
                 }
 				else if (data_type == REGTYPE_SWI)
 				{
@@ -2337,7 +3296,7 @@ MB_SendPacket_Float(void)
 					*mbtable_ptr_int = (int) *(float*)&mbtable_val;	//read in value as a floating point, then cast to integer
 
                     // update nand flash
-                    Swi_post(Swi_writeNand); 
+                    requestNandWrite(); 
 				}
 				else if (data_type == REGTYPE_LONGINT)
 				{
@@ -2345,7 +3304,7 @@ MB_SendPacket_Float(void)
 					*mbtable_ptr_int = *(int*)&mbtable_val; 		//read in value as SIGNED 32-bit integer
 
                     // update nand flash
-                    Swi_post(Swi_writeNand); 
+                    requestNandWrite(); 
 				}
 				else if (data_type == REGTYPE_VAR)
 				{
@@ -2354,400 +3313,1918 @@ MB_SendPacket_Float(void)
 					VAR_Update(mbtable_ptr_var, dbl_val, 0); 		//write to VAR
 
                     // update nand flash
-                    Swi_post(Swi_writeNand); 
+                    requestNandWrite(); 
 
 					if (mbtable_ptr_var->swi != (Swi_Handle)NULL)	// post any VAR-related SWI
 						Swi_post(mbtable_ptr_var->swi);
 				}
 
-				regs_written++;
+				regs_written += 2;
 			}
 			else
 			{
-				UART_TXBUF.n 	= old_n; //remove everything we just added to the TX buffer
-				UART_TXBUF.tail	= old_tail;
+				MB_TX_Discard(); 	//remove everything we just added to the TX frame
 				MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 				Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-				Hwi_restoreInterrupt(5,key);
 				return;
 			}
 		}
 
-		//if we found and wrote to each register
-		if (regs_written == mb_pkt_ptr->num_regs)
+		//if we found and wrote to each (16-bit) register
+		if (regs_written == mb_pkt_ptr->byte_cnt/2)
 		{
 			//send number of registers written
-			BfrPut(&UART_TXBUF,regs_written*2 >> 8); 	// MSB
-			BfrPut(&UART_TXBUF,regs_written*2 & 0xFF); 	// LSB
+			MB_TX_Put(regs_written >> 8); 	// MSB
+			MB_TX_Put(regs_written & 0xFF); 	// LSB
 		}
 		else
 		{
-			UART_TXBUF.n 	= old_n; 					//remove everything we just added to the TX buffer
-			UART_TXBUF.tail	= old_tail;
+			MB_TX_Discard(); 	//remove everything we just added to the TX frame
 			MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
 			Discard_MB_Pkt_Head(&MB_PKT_LIST); 			//discard the packet at the head of the list
-			Hwi_restoreInterrupt(5,key);
 			return;
 		}
-
-		msg_num_bytes = 6; // slave byte + fxn byte + 2 address bytes + 2 data bytes
 	}
 
-	/// check if long offset
-	if (mb_pkt_ptr->long_address) la_offset = LONG_OFFSET;
-	else la_offset = 0;
-
-	if (UART_TXBUF.tail < old_tail) // if there was a buffer wrap around
-	{
-		wrap_count = MAX_BFR_SIZE - UART_TXBUF.head;
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,wrap_count);
-	}
-	else
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,0);
 
-	BfrPut(&UART_TXBUF, CRC & 0xFF);						// LSB
-	BfrPut(&UART_TXBUF, CRC >> 8);							// MSB
+	// calculate & send CRC
+	MB_TX_Put_CRC();
 	Discard_MB_Pkt_Head(&MB_PKT_LIST); 						// discard the packet at the head of the list
 	
-	if (mb_pkt_ptr->is_broadcast == TRUE) 					// don't respond to broadcasts
+	if (mb_pkt_ptr->is_broadcast == TRUE) // don't respond to broadcasts
 	{
-		//remove everything we just added to the TX buffer
-		UART_TXBUF.n 	= old_n;
-		UART_TXBUF.tail	= old_tail;
+		MB_STAT.no_resp++;
+		MB_TX_Discard();
 	}
 	else
-	{
-		MB_TX_IN_PROGRESS = TRUE;
-		Hwi_restoreInterrupt(5,key);
-
-		if ( CSL_FEXT(uartRegs->IER,UART_IER_ETBEI) != 1) 	//if disabled
-			CSL_FINST(uartRegs->IER,UART_IER_ETBEI,ENABLE);	//enable TX buffer empty interrupt
-		Uart_ISR(); // prime the pump
-	}
+		MB_TX_Send();
 
 	STAT_CURRENT = 0;
 	STAT_SUCCESS++;
 }
 
 
-void 
-MB_SendPacket_Sample(void)
+/***************************************************************************
+ * MB_Tbl_Resolve() - finds a register in whichever table holds its address
+ * @param reg	- 1-based address as sent; above SPECIAL_OFFSET is the
+ * 				  extended table
+ * @return		- REG_TYPE_INTEGER, REG_TYPE_LONG_INT or REG_TYPE_FLOAT,
+ * 				  0 if nothing is mapped at reg
+ ***************************************************************************/
+static Uint8
+MB_Tbl_Resolve(Uint16 reg, double** ptr, Uint8* data_type, Uint8* prot)
 {
-	Uint32 	key,CRC, msg_num_bytes, wrap_count, mbtable_val;
-	Uint16 	i, reg;
-	Uint8	vtune;
-	Uint8	la_offset, data_type, prot; //protection status
-	Int8	rtn;
-	double* mbtable_ptr_dbl = NULL;
-	REGSWI*	mbtable_ptr_rsw = NULL;
-	int*	mbtable_ptr_int = NULL;
-	VAR*	mbtable_ptr_var = NULL;
-	float	float_val;
-	int		old_tail;
+	Uint8 reg_type;
+
+	if (reg > SPECIAL_OFFSET)
+	{
+		if (MB_Tbl_Search_Extended(reg - SPECIAL_OFFSET, ptr, data_type, prot) == -1)
+			reg_type = 0;
+		else
+			reg_type = EXT_REG_TYPE(*data_type);
+	}
+	else if (MB_Tbl_Search_IntRegs(reg, ptr, data_type, prot) != -1)
+		reg_type = REG_TYPE_INTEGER;
+	else if (MB_Tbl_Search_LongIntRegs(reg, ptr, data_type, prot) != -1)
+		reg_type = REG_TYPE_LONG_INT;
+	else if (MB_Tbl_Search_FloatRegs(reg, ptr, data_type, prot) != -1)
+		reg_type = REG_TYPE_FLOAT;
+	else
+		reg_type = 0;
+
+	if (*ptr == (double*)NULL)
+		return 0;
+
+	return reg_type;
+}
+
+/***************************************************************************
+ * MB_SendPacket_Mixed() - 0x03/0x04 read that runs across tables
+ * Walks the request one table register at a time: integers take one
+ * 16-bit register, long integers and floats (ABCD) take two. A register
+ * that is not mapped, or that would not fit in what is left of the
+ * request, is answered with REG_MB_SENTINEL for each 16-bit register.
+ * A register the master may not read still fails the whole request.
+ ***************************************************************************/
+void
+MB_SendPacket_Mixed(void)
+{
+	Uint32	mbtable_val;
+	Uint16	i, reg, n;
+	Uint8	data_type, prot, reg_type;
+	double*	mbtable_ptr_dbl = NULL;
 	MB_PKT*	mb_pkt_ptr;
 
+	// if TX is busy, MB_Schedule() runs again once the line is free
 	if (MB_TX_IN_PROGRESS == TRUE)
-	{
-		Clock_start(MB_Start_Clock_Sample);
 		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	MB_TX_Begin(mb_pkt_ptr);
+
+	///create the modbus frame
+	if (mb_pkt_ptr->long_address)
+	{
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
 	}
+	else
+	{
+		MB_TX_Put(REG_SLAVE_ADDRESS);
+	}
+
+	MB_TX_Put(mb_pkt_ptr->fxn);
+	MB_TX_Put(mb_pkt_ptr->byte_cnt);
+
+	for (i=0;i<mb_pkt_ptr->num_regs;i+=n)
+	{
+		reg = mb_pkt_ptr->start_reg + i;
+		reg_type = MB_Tbl_Resolve(reg, &mbtable_ptr_dbl, &data_type, &prot);
+		n = (reg_type == REG_TYPE_INTEGER) ? 1 : 2;
+
+		if ((reg_type == 0) || (i + n > mb_pkt_ptr->num_regs))
+		{ // hole: one sentinel per 16-bit register
+			n = 1;
+			MB_TX_Put((Uint8)((REG_MB_SENTINEL >> 8) & 0xFF));	// MSB
+			MB_TX_Put((Uint8)(REG_MB_SENTINEL & 0xFF));			// LSB
+			continue;
+		}
+
+		if (isNoPermission(prot, MB_READ_QRY)) //crosscheck R/W permission of register with lock status
+		{
+			MB_TX_Discard(); 	//remove everything we just added to the TX frame
+			MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_VALUE);
+			Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+			return;
+		}
+
+		if (reg_type == REG_TYPE_INTEGER)
+		{ // same conversions as MB_SendPacket_Int16()
+			if (data_type == REGTYPE_DBL)
+				mbtable_val = (int) Round_N(*mbtable_ptr_dbl,0);
+			else if (data_type == REGTYPE_SWI)
+				mbtable_val = (int) Round_N(((REGSWI*)mbtable_ptr_dbl)->val,0);
+			else if (data_type == REGTYPE_VAR)
+				mbtable_val = (int) Round_N(((VAR*)mbtable_ptr_dbl)->val,0);
+			else if (data_type == REGTYPE_CHAR)
+				mbtable_val = *((Uint8*)mbtable_ptr_dbl);
+			else
+				mbtable_val = *((int*)mbtable_ptr_dbl);
+
+			MB_TX_Put((Uint8)((mbtable_val >> 8) & 0xFF));	// MSB
+			MB_TX_Put((Uint8)(mbtable_val & 0xFF));			// LSB
+			continue;
+		}
+
+		if (reg_type == REG_TYPE_LONG_INT)
+			mbtable_val = (Uint32)(*(int*)mbtable_ptr_dbl);
+		else
+			mbtable_val = MB_Float_Image(data_type, mbtable_ptr_dbl);
+
+		MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
+		MB_TX_Put((Uint8)((mbtable_val >> 8) & 0xFF));
+		MB_TX_Put((Uint8)(mbtable_val  &  0xFF));		// LSB
+	}
+
+	MB_TX_Put_CRC();
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); // discard the packet at the head of the list
+	MB_TX_Send();
+
+	STAT_CURRENT = 0;
+	STAT_SUCCESS++;
+}
+
+
+void 
+MB_SendPacket_Sample(void)
+{
+	Uint32 	mbtable_val;
+	Uint16 	i, reg;
+	Uint8	vtune;
+	Uint8	data_type, prot; //protection status
+	Int8	rtn;
+	double* mbtable_ptr_dbl = NULL;
+	REGSWI*	mbtable_ptr_rsw = NULL;
+	int*	mbtable_ptr_int = NULL;
+	VAR*	mbtable_ptr_var = NULL;
+	float	float_val;
+	MB_PKT*	mb_pkt_ptr;
+
+	// if TX is busy, MB_Schedule() runs again once the line is free
+	if (MB_TX_IN_PROGRESS == TRUE)
+		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	vtune = mb_pkt_ptr->vtune; // meaningless for Razor but needs to be parroted back correctly
+
+	MB_TX_Begin(mb_pkt_ptr);
+
+	///create the modbus frame
+	if (mb_pkt_ptr->long_address)
+	{
+		MB_TX_Put((Uint8)0xFA);
+
+		// note: Cal SW wants this in DCBA order
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));	// LSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));	// MSB
+	}
+    else
+    {
+	    MB_TX_Put(REG_SLAVE_ADDRESS);
+    }
+	//MB_TX_Put(REG_SLAVE_ADDRESS); // DKOH
+	MB_TX_Put(mb_pkt_ptr->fxn);
+	MB_TX_Put(mb_pkt_ptr->vtune);
+
+	////////////////////////////////////////////
+	///////////// Read register(s) /////////////
+	////////////////////////////////////////////
+
+	for (i=0;i<34;i++)
+	{
+		if (i==0)
+			reg = 19;	// REG_FREQ - frequency
+		else if	(i==1)
+			reg = 67;	// REG_OIL_RP - VREF
+		else if	(i==2)
+			reg = 67;	// Using REG_OIL_RP - "VINC"
+		else if	(i==3)
+		{ // just feed it whatever VTUNE the PC thinks it is using...
+			float_val 	= (float)vtune;					// cast the value as float
+			mbtable_val = *(Uint32*)(&float_val);		// treat float like an Uint32 so we can bit-shift
+
+			// note: Cal SW wants this in DCBA order
+			MB_TX_Put((Uint8)(mbtable_val    	   & 0xFF));	// LSB
+			MB_TX_Put((Uint8)((mbtable_val >> 8)  & 0xFF));
+			MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
+			MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));	// MSB
+			continue;
+		}
+		else if	(i==4)
+			reg = 5;	// REG_TEMPERATURE - temperature (should this be REG_TEMP_USER?)
+		else if	(i==5)
+			reg = 5;	// REG_TEMPERATURE - temperature internal?
+		else
+		{	// all other sample values are don't cares to the calibration software
+			MB_TX_Put(0x00);// LSB
+			MB_TX_Put(0x00);
+			MB_TX_Put(0x00);
+			MB_TX_Put(0x00);// MSB
+			continue;
+		}
+
+		//frequency and temperature from the same Poll() generation
+		if (MB_Float_Cache_Get(reg, &mbtable_val))
+		{
+			// note: Cal SW wants this in DCBA order
+			MB_TX_Put((Uint8)( mbtable_val    	   & 0xFF));	// LSB
+			MB_TX_Put((Uint8)((mbtable_val >> 8)  & 0xFF));
+			MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
+			MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));	// MSB
+			continue;
+		}
+
+		rtn = MB_Tbl_Search_FloatRegs(reg,&mbtable_ptr_dbl,&data_type,&prot);
+		if ((rtn == -1) || (mbtable_ptr_dbl == (double*)NULL))
+		{// illegal data address
+			Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+			return;
+		}
+
+		if (data_type == REGTYPE_VAR)
+		{
+			mbtable_ptr_var = (VAR*)mbtable_ptr_dbl;
+			mbtable_val = *(Uint32*)(&mbtable_ptr_var->val); // treat float like an Uint32 so we can bit-shift
+		}
+		else if (data_type == REGTYPE_DBL)
+		{
+			float_val = (float)(*mbtable_ptr_dbl);	// dereference and cast the value as float
+			mbtable_val = *(Uint32*)(&float_val);	// treat float like an Uint32 so we can bit-shift
+		}
+		else if (data_type == REGTYPE_SWI)
+		{
+			float_val = (float)(mbtable_ptr_rsw->val);	// dereference and cast the value as float
+			mbtable_val = *(Uint32*)(&float_val);	// treat float like an Uint32 so we can bit-shift
+
+		}
+		else if (data_type == REGTYPE_INT)
+		{
+			mbtable_ptr_int = (int*) mbtable_ptr_dbl; 	// cast variable pointer to int*
+			float_val 	= (float)(*mbtable_ptr_int);	// dereference and cast the value as float
+			mbtable_val = *(Uint32*)(&float_val);		// treat float like an Uint32 so we can bit-shift
+		}
+
+		// note: Cal SW wants this in DCBA order
+		MB_TX_Put((Uint8)( mbtable_val    	   & 0xFF));	// LSB
+		MB_TX_Put((Uint8)((mbtable_val >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)((mbtable_val >> 16) & 0xFF));
+		MB_TX_Put((Uint8)((mbtable_val >> 24) & 0xFF));	// MSB
+	}
+
+
+	// calculate & send CRC
+	MB_TX_Put_CRC();
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	MB_TX_Send();
+
+	STAT_CURRENT = 0;
+	STAT_SUCCESS++;
+}
+
+
+/***************************************************************************
+ * Sample stream (PDI function 67)
+ * Once armed, every Poll() pushes one record to the transport the arm
+ * command came in on, without being asked:
+ *
+ *	slave (or 0xFA + SN), 67, seq(2), dropped(2), time us(4), pulses(4),
+ *	frequency(4), temperature(4), RP(4), raw watercut(4), CRC(2)
+ *
+ * Multi-byte fields are DCBA like the rest of the cal sw commands. seq
+ * counts records from the arm command and dropped counts records that
+ * were skipped because a response was still going out, so the cal sw can
+ * tell a gap from a slow master. Both wrap at 0xFFFF.
+ * A record goes out unsolicited, so this is only for a link with nothing
+ * else on it but the cal sw.
+ ***************************************************************************/
+#define MB_STREAM_RECORD_SIZE	(5 + 1 + 2 + 2 + 4*6 + 2)
+
+static volatile Uint32	MB_STREAM_LEFT = 0;		// records still to send; 0 = stopped
+static Uint16			MB_STREAM_SEQ;
+static Uint16			MB_STREAM_DROPPED;
+static Uint8			MB_STREAM_LONG_ADDR;
+static const MB_TX_DRIVER* MB_STREAM_DRV;
+static Uint32			MB_STREAM_TAG;
+static Uint32			MB_STREAM_US;			// record time, microseconds since armed
+static Uint32			MB_STREAM_TS;			// timestamp MB_STREAM_US was last advanced to
+static Uint8			MB_STREAM_FRAME[MB_STREAM_RECORD_SIZE];
+
+static inline Uint32
+MB_Stream_Put32(Uint32 n, Uint32 v)
+{ // DCBA
+	MB_STREAM_FRAME[n++] = (Uint8)( v 		 & 0xFF);	// LSB
+	MB_STREAM_FRAME[n++] = (Uint8)((v >> 8)  & 0xFF);
+	MB_STREAM_FRAME[n++] = (Uint8)((v >> 16) & 0xFF);
+	MB_STREAM_FRAME[n++] = (Uint8)((v >> 24) & 0xFF);	// MSB
+	return n;
+}
+
+void
+MB_SendPacket_Stream(void)
+{
+	Uint32	key, count;
+	MB_PKT*	mb_pkt_ptr;
+
+	// if TX is busy, MB_Schedule() runs again once the line is free
+	if (MB_TX_IN_PROGRESS == TRUE)
+		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	// count rides in start_reg (MSW) and num_regs (LSW)
+	count = ((Uint32)mb_pkt_ptr->start_reg << 16) | mb_pkt_ptr->num_regs;
+
+	MB_TX_Begin(mb_pkt_ptr);
+
+	///create the modbus frame
+	if (mb_pkt_ptr->long_address)
+	{
+		MB_TX_Put((Uint8)0xFA);
+
+		// note: Cal SW wants this in DCBA order
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));	// LSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));	// MSB
+	}
+	else
+	{
+		MB_TX_Put(REG_SLAVE_ADDRESS);
+	}
+	MB_TX_Put(mb_pkt_ptr->fxn);
+	MB_TX_Put((Uint8)((count >> 24) & 0xFF));	// MSB
+	MB_TX_Put((Uint8)((count >> 16) & 0xFF));
+	MB_TX_Put((Uint8)((count >> 8)  & 0xFF));
+	MB_TX_Put((Uint8)( count 		& 0xFF));	// LSB
+
+	// the first record can only follow the echo, it is sent in the same SWI
+	key = Swi_disable(); /////////////////////////////////////////////////////
+	MB_STREAM_DRV 		= mb_pkt_ptr->tx_drv;
+	MB_STREAM_TAG 		= mb_pkt_ptr->tx_tag;
+	MB_STREAM_LONG_ADDR = mb_pkt_ptr->long_address;
+	MB_STREAM_SEQ 		= 0;
+	MB_STREAM_DROPPED 	= 0;
+	MB_STREAM_US 		= 0;
+	MB_STREAM_TS 		= Timestamp_get32();
+	MB_STREAM_LEFT 		= count;
+	Swi_restore(key); ////////////////////////////////////////////////////////
+
+	// calculate & send CRC
+	MB_TX_Put_CRC();
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	MB_TX_Send();
+
+	STAT_CURRENT = 0;
+	STAT_SUCCESS++;
+}
+
+/***************************************************************************
+ * MB_Stream_Sample() - sends one stream record if the stream is armed
+ * Called from Poll() once the measurements are updated.
+ ***************************************************************************/
+void
+MB_Stream_Sample(void)
+{
+	Uint32	key, n, ts, us;
+	Uint16	CRC;
+
+	if (MB_STREAM_LEFT == 0)
+		return;
+
+	ts = Timestamp_get32();
+	us = (ts - MB_STREAM_TS) / MB_TS_PER_US;
+	MB_STREAM_US += us;
+	MB_STREAM_TS += us * MB_TS_PER_US;	// keep the remainder for the next record
+
+	n = 0;
+	if (MB_STREAM_LONG_ADDR)
+	{
+		MB_STREAM_FRAME[n++] = 0xFA;
+		n = MB_Stream_Put32(n, (Uint32)REG_SN_PIPE);
+	}
+	else
+	{
+		MB_STREAM_FRAME[n++] = (Uint8)REG_SLAVE_ADDRESS;
+	}
+	MB_STREAM_FRAME[n++] = MB_CMD_PDI_SAMPLE_STREAM;
+	MB_STREAM_FRAME[n++] = (Uint8)(MB_STREAM_SEQ & 0xFF);
+	MB_STREAM_FRAME[n++] = (Uint8)(MB_STREAM_SEQ >> 8);
+	MB_STREAM_FRAME[n++] = (Uint8)(MB_STREAM_DROPPED & 0xFF);
+	MB_STREAM_FRAME[n++] = (Uint8)(MB_STREAM_DROPPED >> 8);
+	n = MB_Stream_Put32(n, MB_STREAM_US);
+	n = MB_Stream_Put32(n, FREQ_PULSE_COUNT_LO);
+	n = MB_Stream_Put32(n, MB_Float_Image(REGTYPE_VAR, (double*)&REG_FREQ));
+	n = MB_Stream_Put32(n, MB_Float_Image(REGTYPE_VAR, (double*)&REG_TEMP_USER));
+	n = MB_Stream_Put32(n, MB_Float_Image(REGTYPE_DBL, (double*)&REG_OIL_RP));
+	n = MB_Stream_Put32(n, MB_Float_Image(REGTYPE_DBL, (double*)&REG_WATERCUT_RAW));
+
+	CRC = Calc_CRC(MB_STREAM_FRAME, n);
+	MB_STREAM_FRAME[n++] = CRC & 0xFF;	// LSB
+	MB_STREAM_FRAME[n++] = CRC >> 8;	// MSB
+
+	// responses go first; a record that would have to wait is dropped
+	key = Swi_disable(); /////////////////////////////////////////////////////
+	if (MB_STREAM_LEFT == 0)
+	{ // stopped while the record was being built
+		Swi_restore(key);
+		return;
+	}
+
+	if (MB_TX_IN_PROGRESS == TRUE)
+	{
+		MB_STREAM_DROPPED++;
+		MB_STAT.stream_dropped++;
+	}
+	else
+	{
+		MB_TX_IN_PROGRESS = TRUE;
+		MB_STREAM_DRV->send(MB_STREAM_DRV->ctx, MB_STREAM_TAG, MB_STREAM_FRAME, n);
+	}
+
+	MB_STREAM_SEQ++;
+	if (MB_STREAM_LEFT != MB_STREAM_FOREVER)
+		MB_STREAM_LEFT--;
+	Swi_restore(key); ////////////////////////////////////////////////////////
+}
+
+void 
+MB_SendPacket_ForceSlaveAddr(void)
+{
+	Uint8	new_slave_addr;
+	MB_PKT*	mb_pkt_ptr;
+
+	// if TX is busy, MB_Schedule() runs again once the line is free
+	if (MB_TX_IN_PROGRESS == TRUE)
+		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	//Note: Admittedly some slapdash coding here. Using the start_reg parameter
+	//		to carry the new slave address to MB_SendPacket_ForceSlaveAddr()
+	new_slave_addr = mb_pkt_ptr->start_reg;
+
+	MB_TX_Begin(mb_pkt_ptr);
+
+	///create the modbus frame
+	if (mb_pkt_ptr->long_address)
+	{
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+	}
+
+	/// CHANGE SLAVE ADDRESS ///
+	REG_SLAVE_ADDRESS = new_slave_addr;
+	/// CHANGE SLAVE ADDRESS ///
+
+	MB_TX_Put(REG_SLAVE_ADDRESS);
+	MB_TX_Put(mb_pkt_ptr->fxn);
+	MB_TX_Put(new_slave_addr);
+
+	MB_TX_Put((Uint8)((REG_SN_PIPE >> 24) & 0xFF));	// MSB
+	MB_TX_Put((Uint8)((REG_SN_PIPE >> 16) & 0xFF));
+	MB_TX_Put((Uint8)((REG_SN_PIPE >> 8)  & 0xFF));
+	MB_TX_Put((Uint8)( REG_SN_PIPE  	   & 0xFF));	// LSB
+
+
+	// calculate & send CRC
+	MB_TX_Put_CRC();
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	MB_TX_Send();
+
+	STAT_CURRENT = 0;
+	STAT_SUCCESS++;
+}
+
+/////////////////////////////////////////////////
+/// CALIBRATION PROFILE (MB_FILE_PROFILE)
+/////////////////////////////////////////////////
+
+// the registers downloadCsv() puts in a CSV profile, below the extended table
+static const Uint16 MB_PROFILE_REGS[] = {
+	201, 203, 204, 205, 206, 219, 220, 221, 222, 223, 227, 228, 229, 230, 231, 232,		// int
+	15,  31,  35,  37,  39,  41,  43,  45,  47,  49,  51,  55,  67,  69,  73,  107, 109,	// float
+	111, 113, 117, 119, 121, 123, 125, 151, 161, 163, 165, 169, 171, 179, 181, 781, 783, 785,
+	301, 303, 305, 307, 309, 311, 313, 315, 317, 319, 321, 323, 325, 327, 329, 331		// long int
+};
+
+#define MB_PROFILE_N_REGS	(sizeof(MB_PROFILE_REGS) / sizeof(MB_PROFILE_REGS[0]))
+#define MB_PROFILE_N_EXT	(51)	// 60001-60101: oil curve count, temperatures, coefficients
+#define MB_PROFILE_ITEMS	(MB_PROFILE_N_REGS + MB_PROFILE_N_EXT + SMAX)	// + stream oil adjust
+#define MB_PROFILE_WORDS	(2 + 3*MB_PROFILE_ITEMS)
+
+static Uint16 MB_PROFILE_STAGE[MB_PROFILE_WORDS];	// written by the master, applied as a whole
+static Uint16 MB_PROFILE_RESULT = 0;				// 0 = none yet, 1 = applied, 2 = rejected
+static Uint16 MB_PROFILE_BAD = 0;					// item that got the last profile rejected
+
+static Uint16
+MB_Profile_Id(Uint32 n)
+{ // register of profile item n
+	if (n < MB_PROFILE_N_REGS)
+		return MB_PROFILE_REGS[n];
+
+	n -= MB_PROFILE_N_REGS;
+	if (n < MB_PROFILE_N_EXT)
+		return 60001 + 2*n;
+
+	return 63647 + 2*(n - MB_PROFILE_N_EXT);
+}
+
+static double*
+MB_Profile_Ext(Uint16 id)
+{ // extended profile registers, as in uploadCsv()
+	if (id == 60001)
+		return &REG_TEMP_OIL_NUM_CURVES;
+	if ((id >= 60003) && (id < 60023))
+		return &REG_TEMPS_OIL[(id - 60003) / 2];
+	if ((id >= 60023) && (id < 60103))
+		return &REG_COEFFS_TEMP_OIL[0][0] + (id - 60023) / 2;
+	if ((id >= 63647) && (id < 63647 + 2*SMAX))
+		return &STREAM_OIL_ADJUST[(id - 63647) / 2];
+	return (double*)NULL;
+}
+
+/***************************************************************************
+ * MB_Profile_Lookup() - where profile register id lives
+ * @return	- FALSE if id is not part of the profile
+ * data_type is REGTYPE_INT for int and long int registers (32 bits as
+ * they are stored); everything else travels as an IEEE float, VARs in
+ * their calc unit like the CSV profile.
+ ***************************************************************************/
+static BOOL
+MB_Profile_Lookup(Uint16 id, double** ptr, Uint8* data_type, Uint8* prot)
+{
+	Uint32 i;
+	Int8 rtn;
+
+	for (i=0;i<MB_PROFILE_ITEMS;i++)
+		if (MB_Profile_Id(i) == id)
+			break;
+
+	if (i == MB_PROFILE_ITEMS)
+		return FALSE;
+
+	if (id > 60000)
+	{
+		*ptr = MB_Profile_Ext(id);
+		*data_type = REGTYPE_DBL;
+		*prot = REGPERM_PASSWD;
+		return TRUE;
+	}
+
+	if ((id > 200) && (id < 301))
+		rtn = MB_Tbl_Search_IntRegs(id, ptr, data_type, prot);
+	else if ((id > 300) && (id < 401))
+		rtn = MB_Tbl_Search_LongIntRegs(id, ptr, data_type, prot);
+	else
+		rtn = MB_Tbl_Search_FloatRegs(id, ptr, data_type, prot);
+
+	if ((rtn == -1) || (*ptr == (double*)NULL))
+		return FALSE;
+
+	if ((id > 200) && (id < 401))
+		*data_type = REGTYPE_INT;
+
+	return TRUE;
+}
+
+static Uint16
+MB_Profile_Word(Uint32 w)
+{ // word w of the live profile: version, items, then id and value (MSW first) per item
+	double*	ptr;
+	Uint8	data_type, prot;
+	Uint16	id;
+	Uint32	val;
+	float	f;
+
+	if (w == 0)
+		return MB_PROFILE_VERSION;
+	if (w == 1)
+		return MB_PROFILE_ITEMS;
+
+	id = MB_Profile_Id((w - 2) / 3);
+	if ((w - 2) % 3 == 0)
+		return id;
+
+	if (!MB_Profile_Lookup(id, &ptr, &data_type, &prot))
+		return 0;
+
+	if (data_type == REGTYPE_INT)
+		val = *(Uint32*)ptr;
+	else
+	{
+		if (data_type == REGTYPE_VAR)
+			f = ((VAR*)ptr)->calc_val;
+		else if (data_type == REGTYPE_SWI)
+			f = ((REGSWI*)ptr)->val;
+		else
+			f = *ptr;
+		val = *(Uint32*)&f;
+	}
+
+	return ((w - 2) % 3 == 1) ? (val >> 16) : (val & 0xFFFF);
+}
+
+/***************************************************************************
+ * MB_Profile_Apply() - MB_PROFILE_CMD_APPLY
+ * @return	- 0, or the exception to answer with
+ * Every staged item is checked (part of the profile, write permission at
+ * the current lock level, a finite float within the VAR's bounds) before
+ * any of them is written, so a profile goes in whole or not at all. The
+ * writes are those of a master writing the registers one by one.
+ ***************************************************************************/
+static Uint8
+MB_Profile_Apply(void)
+{
+	double*	ptr;
+	Uint8	data_type, prot;
+	Uint16	i, n, pass;
+	Uint32	val;
+	float	f;
+	double	t;
+
+	n = MB_PROFILE_STAGE[1];
+	MB_PROFILE_RESULT = 2;
+	MB_PROFILE_BAD = 0xFFFF;
+
+	if ( (MB_PROFILE_STAGE[0] != MB_PROFILE_VERSION) || (n > MB_PROFILE_ITEMS) )
+		return MB_EXCEP_BAD_VALUE;
+
+	MB_Float_Cache_Dirty();
+
+	for (pass=0;pass<2;pass++) // pass 0 checks, pass 1 writes
+	{
+		for (i=0;i<n;i++)
+		{
+			val = ((Uint32)MB_PROFILE_STAGE[2 + 3*i + 1] << 16) | MB_PROFILE_STAGE[2 + 3*i + 2];
+			f = *(float*)&val;
+
+			if (pass == 0)
+			{
+				MB_PROFILE_BAD = i;
+
+				if (!MB_Profile_Lookup(MB_PROFILE_STAGE[2 + 3*i], &ptr, &data_type, &prot))
+					return MB_EXCEP_BAD_ADDRESS;
+
+				if (isNoPermission(prot, MB_WRITE_QRY))
+					return MB_EXCEP_BAD_VALUE;
+
+				if (data_type == REGTYPE_INT)
+					continue;
+
+				if ((f - f) != 0) // NaN or infinite
+					return MB_EXCEP_BAD_VALUE;
+
+				t = f;
+				if ( (data_type == REGTYPE_VAR) && !VAR_Check_Bounds((VAR*)ptr, &t) )
+					return MB_EXCEP_BAD_VALUE;
+
+				continue;
+			}
+
+			MB_Profile_Lookup(MB_PROFILE_STAGE[2 + 3*i], &ptr, &data_type, &prot);
+
+			if (data_type == REGTYPE_INT)
+				*(int*)ptr = *(int*)&val;
+			else if (data_type == REGTYPE_VAR)
+			{
+				VAR_Update((VAR*)ptr, f, CALC_UNIT);	// posts the VAR's SWI
+			}
+			else if (data_type == REGTYPE_SWI)
+			{
+				((REGSWI*)ptr)->val = f;
+				if (((REGSWI*)ptr)->swi != (Swi_Handle)NULL)
+					Swi_post(((REGSWI*)ptr)->swi);
+			}
+			else
+				*ptr = f;
+		}
+	}
+
+	requestNandWrite();
+
+	MB_PROFILE_RESULT = 1;
+	MB_PROFILE_BAD = 0;
+	return 0;
+}
+
+/////////////////////////////////////////////////
+/// REGISTER CATALOG (MB_FILE_CATALOG)
+/////////////////////////////////////////////////
+
+#define MB_CAT_ROWS(tbl)	(sizeof(tbl) / sizeof(tbl[0]) - 1)	// rows before the end-of-table row
+#define MB_CAT_ENTRIES		(MB_CAT_ROWS(MB_TBL_FLOAT) + MB_CAT_ROWS(MB_TBL_INT) + MB_CAT_ROWS(MB_TBL_LONGINT) \
+							 + MB_CAT_ROWS(MB_TBL_COIL) + MB_CAT_ROWS(MB_TBL_EXTENDED))
+#define MB_CAT_WORDS		(MB_CATALOG_HDR_WORDS + MB_CAT_ENTRIES*MB_CATALOG_ENTRY_WORDS)
+#define MB_CAT_NONE			(0xFFFFFFFF)
+
+static Uint16 MB_CAT_ENTRY[MB_CATALOG_ENTRY_WORDS];	// entry MB_CAT_CUR, as sent
+static Uint32 MB_CAT_CUR = MB_CAT_NONE;
+
+static void
+MB_Catalog_Put32(Uint16* w, float f)
+{ // MSW first, like a float register read in ABCD
+	Uint32 v = *(Uint32*)&f;
+
+	w[0] = v >> 16;
+	w[1] = v & 0xFFFF;
+}
+
+/***************************************************************************
+ * MB_Catalog_Entry() - builds catalog entry e in MB_CAT_ENTRY
+ * Entries follow the tables in ModbusTables.h row by row: float, integer,
+ * long int, coil, then one per array of the extended table. Words:
+ *   0		register address (coil number; 60000+ for the extended table)
+ *   1		16-bit registers it spans (bits for a coil)
+ *   2		REG_TYPE_* of the table (MSB), REGTYPE_* of the row (LSB)
+ *   3		REGPERM_*
+ *   4		unit code a read returns the value in (VARs only, else 0)
+ *   5		VAR class (VARs only, else 0)
+ *   6-7	lower bound, float, in that unit (0 if not a VAR or unbounded)
+ *   8-9	upper bound
+ *   10-	name of the variable behind the register (see MB_VAR)
+ ***************************************************************************/
+static void
+MB_Catalog_Entry(Uint32 e)
+{
+	const MB_TBL_CELL*	row;
+	const char*		name;
+	VAR*			v;
+	Uint16			i, size;
+	Uint8			table;
+	char			c[MB_CATALOG_NAME_SIZE];
+
+	if (e < MB_CAT_ROWS(MB_TBL_FLOAT))
+	{
+		row = MB_TBL_FLOAT[e];
+		table = REG_TYPE_FLOAT;
+		size = 2;
+	}
+	else if ((e -= MB_CAT_ROWS(MB_TBL_FLOAT)) < MB_CAT_ROWS(MB_TBL_INT))
+	{
+		row = MB_TBL_INT[e];
+		table = REG_TYPE_INTEGER;
+		size = 1;
+	}
+	else if ((e -= MB_CAT_ROWS(MB_TBL_INT)) < MB_CAT_ROWS(MB_TBL_LONGINT))
+	{
+		row = MB_TBL_LONGINT[e];
+		table = REG_TYPE_LONG_INT;
+		size = 2;
+	}
+	else if ((e -= MB_CAT_ROWS(MB_TBL_LONGINT)) < MB_CAT_ROWS(MB_TBL_COIL))
+	{
+		row = MB_TBL_COIL[e];
+		table = REG_TYPE_COIL;
+		size = 1;
+	}
+	else
+	{ // extended: {start, element type, array, name}, as in MB_Tbl_Search_Extended()
+		e -= MB_CAT_ROWS(MB_TBL_COIL);
+		MB_CAT_ENTRY[0] = SPECIAL_OFFSET + MB_TBL_EXTENDED[e][0];
+		MB_CAT_ENTRY[1] = MB_TBL_EXTENDED[e+1][0] - MB_TBL_EXTENDED[e][0];
+		MB_CAT_ENTRY[2] = (EXT_REG_TYPE(MB_TBL_EXTENDED[e][1]) << 8) | MB_TBL_EXTENDED[e][1];	// as MB_Tbl_Resolve() serves it
+		MB_CAT_ENTRY[3] = REGPERM_PASSWD;
+		name = (const char*)MB_TBL_EXTENDED[e][3];
+		row = NULL;
+	}
+
+	if (row != NULL)
+	{
+		MB_CAT_ENTRY[0] = row[0];
+		MB_CAT_ENTRY[1] = size;
+		MB_CAT_ENTRY[2] = (table << 8) | row[1];
+		MB_CAT_ENTRY[3] = row[2];
+		name = (const char*)row[4];
+	}
+
+	for (i=4;i<10;i++)
+		MB_CAT_ENTRY[i] = 0;
+
+	if ((row != NULL) && (row[1] == REGTYPE_VAR))
+	{
+		v = (VAR*)row[3];
+		MB_CAT_ENTRY[4] = v->unit;
+		MB_CAT_ENTRY[5] = v->class;
+
+		if ((v->STAT & var_no_bound) == 0)
+		{
+			MB_Catalog_Put32(&MB_CAT_ENTRY[6], VAR_Get_Unit_Param(v, reg_direct_bmin, 0, TRUE));
+			MB_Catalog_Put32(&MB_CAT_ENTRY[8], VAR_Get_Unit_Param(v, reg_direct_bmax, 0, TRUE));
+		}
+	}
+
+	strncpy(c, name, MB_CATALOG_NAME_SIZE); // pads with NULs; a 32-character name is not terminated
+	for (i=0;i<MB_CATALOG_NAME_SIZE/2;i++)
+		MB_CAT_ENTRY[10 + i] = ((Uint8)c[2*i] << 8) | (Uint8)c[2*i + 1];
+}
+
+static Uint16
+MB_Catalog_Word(Uint32 w)
+{ // word w of the catalog: version, entries, words per entry, name bytes, then the entries
+	if (w < MB_CATALOG_HDR_WORDS)
+	{
+		switch (w)
+		{
+			case 0:		return MB_CATALOG_VERSION;
+			case 1:		return MB_CAT_ENTRIES;
+			case 2:		return MB_CATALOG_ENTRY_WORDS;
+			default:	return MB_CATALOG_NAME_SIZE;
+		}
+	}
+
+	w -= MB_CATALOG_HDR_WORDS;
+	if (w / MB_CATALOG_ENTRY_WORDS != MB_CAT_CUR)
+	{
+		MB_CAT_CUR = w / MB_CATALOG_ENTRY_WORDS;
+		MB_Catalog_Entry(MB_CAT_CUR);
+	}
+
+	return MB_CAT_ENTRY[w % MB_CATALOG_ENTRY_WORDS];
+}
+
+/***************************************************************************
+ * MB_SendPacket_File() -- Read File Record (0x14)
+ *  Serves the in-memory history (see: History_Record in Log.c).
+ *  File 1 describes it, one word per record number:
+ *    0-1	History_Seq() -- records written since boot
+ *    2-3	HIST_RECORDS
+ *    4		HIST_WORDS
+ *    5		MB_FILE_HIST_ROWS
+ *    6		REG_LOGGING_PERIOD (seconds)
+ *  Files 2 and up hold the HIST rows, MB_FILE_HIST_ROWS to a file: record
+ *  r of file f is word r % HIST_WORDS of HIST row
+ *  (f-2)*MB_FILE_HIST_ROWS + r/HIST_WORDS. Record n of the history is in
+ *  row n % HIST_RECORDS.
+ *  MB_FILE_FW_INFO is firmwareInfo() in nandwriter.c; MB_FILE_PROFILE is
+ *  the live calibration profile (MB_Profile_Word) and MB_FILE_PROFILE_CTRL
+ *  the outcome of the last MB_Profile_Apply(): result, rejected item,
+ *  MB_PROFILE_ITEMS, MB_PROFILE_VERSION. MB_FILE_CATALOG describes every
+ *  register in ModbusTables.h (MB_Catalog_Entry).
+ ***************************************************************************/
+void
+MB_SendPacket_File(void)
+{
+	Uint8	info[MB_FILE_INFO_WORDS*2];
+	Uint8*	sub;
+	Uint16	fw[FW_INFO_WORDS];
+	Uint16	prof[MB_PROFILE_CTRL_WORDS];
+	Uint16	i, j, file, rec, len, val;
+	Uint32	seq;
+	MB_PKT*	mb_pkt_ptr;
+
+	// if TX is busy, MB_Schedule() runs again once the line is free
+	if (MB_TX_IN_PROGRESS == TRUE)
+		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	MB_TX_Begin(mb_pkt_ptr);
+
+	///create the modbus frame
+	if (mb_pkt_ptr->long_address)
+	{
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+	}
+    else
+    {
+        MB_TX_Put(REG_SLAVE_ADDRESS);
+    }
+	MB_TX_Put(mb_pkt_ptr->fxn);
+	MB_TX_Put(mb_pkt_ptr->byte_cnt); // response data length
+
+	seq = History_Seq();
+	info[0]  = (seq >> 24) & 0xFF;
+	info[1]  = (seq >> 16) & 0xFF;
+	info[2]  = (seq >> 8) & 0xFF;
+	info[3]  = seq & 0xFF;
+	info[4]  = ((Uint32)HIST_RECORDS >> 24) & 0xFF;
+	info[5]  = ((Uint32)HIST_RECORDS >> 16) & 0xFF;
+	info[6]  = ((Uint32)HIST_RECORDS >> 8) & 0xFF;
+	info[7]  = (Uint32)HIST_RECORDS & 0xFF;
+	info[8]  = 0;
+	info[9]  = HIST_WORDS;
+	info[10] = MB_FILE_HIST_ROWS >> 8;
+	info[11] = MB_FILE_HIST_ROWS & 0xFF;
+	info[12] = (REG_LOGGING_PERIOD >> 8) & 0xFF;
+	info[13] = REG_LOGGING_PERIOD & 0xFF;
+
+	// sub-requests, as received: reference type, file, record number, record length
+	for (i=0;i<mb_pkt_ptr->num_regs;i++)
+	{
+		sub  = &mb_pkt_ptr->data[i*7];
+		file = (sub[1] << 8) | sub[2];
+		rec  = (sub[3] << 8) | sub[4];
+		len  = (sub[5] << 8) | sub[6];
+
+		MB_TX_Put(1 + len*2);	// sub-response length
+		MB_TX_Put(6);			// reference type
+
+		if ( (sub[0] != 6) || (rec > 0x270F) )
+			break;
+
+		if (file == MB_FILE_HIST_INFO)
+		{
+			if (rec + len > MB_FILE_INFO_WORDS)
+				break;
+
+			for (j=rec*2;j<(rec+len)*2;j++)
+				MB_TX_Put(info[j]);
+		}
+		else if (file == MB_FILE_FW_INFO)
+		{
+			if (rec + len > FW_INFO_WORDS)
+				break;
+
+			firmwareInfo(fw);
+			for (j=rec;j<rec+len;j++)
+			{
+				MB_TX_Put(fw[j] >> 8);
+				MB_TX_Put(fw[j] & 0xFF);
+			}
+		}
+		else if (file == MB_FILE_PROFILE)
+		{
+			if (rec + len > MB_PROFILE_WORDS)
+				break;
+
+			for (j=rec;j<rec+len;j++)
+			{
+				val = MB_Profile_Word(j);
+				MB_TX_Put(val >> 8);
+				MB_TX_Put(val & 0xFF);
+			}
+		}
+		else if (file == MB_FILE_CATALOG)
+		{
+			if (rec + len > MB_CAT_WORDS)
+				break;
+
+			MB_CAT_CUR = MB_CAT_NONE; // bounds and units may have changed since the last read
+			for (j=rec;j<rec+len;j++)
+			{
+				val = MB_Catalog_Word(j);
+				MB_TX_Put(val >> 8);
+				MB_TX_Put(val & 0xFF);
+			}
+		}
+		else if (file == MB_FILE_PROFILE_CTRL)
+		{
+			if (rec + len > MB_PROFILE_CTRL_WORDS)
+				break;
+
+			prof[0] = MB_PROFILE_RESULT;
+			prof[1] = MB_PROFILE_BAD;
+			prof[2] = MB_PROFILE_ITEMS;
+			prof[3] = MB_PROFILE_VERSION;
+			for (j=rec;j<rec+len;j++)
+			{
+				MB_TX_Put(prof[j] >> 8);
+				MB_TX_Put(prof[j] & 0xFF);
+			}
+		}
+		else if ( (file >= MB_FILE_HIST_DATA) && (rec + len <= MB_FILE_HIST_ROWS * HIST_WORDS) )
+		{	// straight into the TX frame, leaving room for the CRC
+			if (MB_TX_FRAME_N + 2*(Uint32)len > MB_FRAME_SIZE - 2)
+				break;
+
+			if (!History_Read((Uint32)(file - MB_FILE_HIST_DATA) * MB_FILE_HIST_ROWS, rec, len, &MB_TX_FRAME[MB_TX_FRAME_N]))
+				break;
+
+			MB_TX_FRAME_N += len*2;
+		}
+		else
+			break;
+	}
+
+	if (i < mb_pkt_ptr->num_regs)
+	{ //no such file or record
+		MB_TX_Discard(); 	//remove everything we just added to the TX frame
+		MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, MB_EXCEP_BAD_ADDRESS);
+		Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+		return;
+	}
+
+	// calculate & send CRC
+	MB_TX_Put_CRC();
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	MB_TX_Send();
+
+	STAT_CURRENT = 0;
+	STAT_SUCCESS++;
+}
+
+/***************************************************************************
+ * MB_Write_File() - one sub-request of a write file record (0x15)
+ * @return	- 0, or the exception to answer with
+ * MB_FILE_FW_DATA record n is chunk n of the firmware image, preceded by
+ * its CRC32 (MSB first). Record 0 of MB_FILE_FW_INFO takes a command word,
+ * followed for MB_FW_CMD_BEGIN by the image size and CRC32 (MSW first).
+ * MB_FILE_PROFILE records are staged, laid out as MB_Profile_Word() reads
+ * them, until MB_PROFILE_CMD_APPLY goes to record 0 of MB_FILE_PROFILE_CTRL.
+ ***************************************************************************/
+static Uint8
+MB_Write_File(Uint8 ref, Uint16 file, Uint16 rec, Uint16 len, const Uint8* data)
+{
+	Uint32 size, crc;
+	Uint16 i;
+
+	if ( (ref != 6) || (rec > 0x270F) )
+		return MB_EXCEP_BAD_ADDRESS;
+
+	if (file == MB_FILE_FW_DATA)
+	{
+		if (len != (4 + FW_CHUNK_SIZE) / 2)
+			return MB_EXCEP_BAD_VALUE;
+
+		crc = ((Uint32)data[0] << 24) | ((Uint32)data[1] << 16) | ((Uint32)data[2] << 8) | data[3];
+
+		switch (stageFirmware(rec, &data[4], crc))
+		{
+			case FW_STAGE_OK:	return 0;
+			case FW_STAGE_CRC:	return MB_EXCEP_BAD_VALUE;	// the master sends the chunk again
+			default:			return MB_EXCEP_BAD_ADDRESS;
+		}
+	}
+
+	if (file == MB_FILE_PROFILE)
+	{ // staged until MB_PROFILE_CMD_APPLY
+		if (rec + len > MB_PROFILE_WORDS)
+			return MB_EXCEP_BAD_ADDRESS;
+
+		for (i=0;i<len;i++)
+			MB_PROFILE_STAGE[rec + i] = (data[2*i] << 8) | data[2*i + 1];
+		return 0;
+	}
+
+	if ( (file == MB_FILE_PROFILE_CTRL) && (rec == 0) && (len == 1) )
+		return (((data[0] << 8) | data[1]) == MB_PROFILE_CMD_APPLY) ? MB_Profile_Apply() : MB_EXCEP_BAD_VALUE;
+
+	if ( (file != MB_FILE_FW_INFO) || (rec != 0) || (len < 1) )
+		return MB_EXCEP_BAD_ADDRESS;
+
+	switch ((data[0] << 8) | data[1])
+	{
+		case MB_FW_CMD_ABORT:
+			abortFirmware();
+			return 0;
+
+		case MB_FW_CMD_BEGIN:
+			if (len != 5)
+				return MB_EXCEP_BAD_VALUE;
+
+			size = ((Uint32)data[2] << 24) | ((Uint32)data[3] << 16) | ((Uint32)data[4] << 8) | data[5];
+			crc  = ((Uint32)data[6] << 24) | ((Uint32)data[7] << 16) | ((Uint32)data[8] << 8) | data[9];
+			return beginFirmware(size, crc) ? 0 : MB_EXCEP_BAD_VALUE;
+
+		case MB_FW_CMD_COMMIT:	// chunks missing, or already committing
+			return commitFirmware() ? 0 : MB_EXCEP_BAD_VALUE;
+
+		default:
+			return MB_EXCEP_BAD_VALUE;
+	}
+}
+
+/***************************************************************************
+ * MB_SendPacket_FileWrite() - write file record (0x15)
+ * data[] holds the byte_cnt bytes of sub-requests as received; the normal
+ * response echoes them. Only the firmware and profile files can be written
+ * (see MB_Write_File), and only while unlocked.
+ ***************************************************************************/
+void
+MB_SendPacket_FileWrite(void)
+{
+	Uint8*	sub;
+	Uint8	excep;
+	Uint32	i, len;
+	MB_PKT*	mb_pkt_ptr;
+
+	// if TX is busy, MB_Schedule() runs again once the line is free
+	if (MB_TX_IN_PROGRESS == TRUE)
+		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	MB_TX_Begin(mb_pkt_ptr);
+
+	excep = isNoPermission(REGPERM_PASSWD, MB_WRITE_QRY) ? MB_EXCEP_BAD_VALUE : 0;
+
+	for (i=0;(excep == 0) && (i<mb_pkt_ptr->byte_cnt);i+=7+len*2)
+	{
+		sub = &mb_pkt_ptr->data[i];
+		if (i + 7 > mb_pkt_ptr->byte_cnt)
+		{ // MB_RX_Parse() checked the walk; never step past data[]
+			excep = MB_EXCEP_BAD_VALUE;
+			break;
+		}
+		len = (sub[5] << 8) | sub[6];
+		if (len > (mb_pkt_ptr->byte_cnt - i - 7) / 2)
+		{
+			excep = MB_EXCEP_BAD_VALUE;
+			break;
+		}
+		excep = MB_Write_File(sub[0], (sub[1] << 8) | sub[2], (sub[3] << 8) | sub[4], len, &sub[7]);
+	}
+
+	if (excep != 0)
+	{
+		MB_TX_Discard(); 	//remove everything we just added to the TX frame
+		MB_SendException(mb_pkt_ptr->slave, mb_pkt_ptr->fxn, excep);
+		Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+		return;
+	}
+
+	///create the modbus frame
+	if (mb_pkt_ptr->long_address)
+	{
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+	}
+    else
+    {
+        MB_TX_Put(REG_SLAVE_ADDRESS);
+    }
+	MB_TX_Put(mb_pkt_ptr->fxn);
+	MB_TX_Put(mb_pkt_ptr->byte_cnt);
+
+	for (i=0;i<mb_pkt_ptr->byte_cnt;i++)
+		MB_TX_Put(mb_pkt_ptr->data[i]);
+
+	// calculate & send CRC
+	MB_TX_Put_CRC();
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	MB_TX_Send();
+
+	STAT_CURRENT = 0;
+	STAT_SUCCESS++;
+}
+
+void 
+MB_SendException(Uint8 slv, Uint8 fxn, Uint8 code)
+{
+	Uint8  fxn_excep;
+
+	if ((code < 0x01) || (code > 0x06)) // check bounds
+	{
+		return;
+	}
+
+	fxn_excep = fxn | 0x80; //set the MSB
+	MB_STAT.excep++;
+
+	MB_TX_Begin(NULL); // answering the request being parsed or sent
+
+	if (MB_TX_LONG_ADDR)
+	{ // slv is only the low byte of the serial number; answer with all of it, as the senders do
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+	}
+	else
+	{
+		MB_TX_Put(slv);
+	}
+
+	MB_TX_Put(fxn_excep);
+	MB_TX_Put(code);
+	MB_TX_Put_CRC();
+
+	STAT_CURRENT = 2;
+	STAT_CMD++;
+	MB_TX_Send();
+}
+
+/***************************************************************************
+ * MB_SendPacket_Busy() - Server Busy (0x06) for a request that arrived
+ * while MB_PKT_LIST was full (see Create_MB_Pkt)
+ ***************************************************************************/
+void
+MB_SendPacket_Busy(void)
+{
+	Uint8	slave, fxn;
+	MB_PKT*	mb_pkt_ptr;
+
+	// if TX is busy, MB_Schedule() runs again once the line is free
+	if (MB_TX_IN_PROGRESS == TRUE)
+		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+	slave = mb_pkt_ptr->slave;
+	fxn = mb_pkt_ptr->fxn;
+
+	MB_TX_Begin(mb_pkt_ptr);
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	MB_SendException(slave, fxn, MB_EXCEP_SLAVE_BUSY);
+}
+
+/////////////////////////////////////////////////
+/// DIAGNOSTICS (0x08)
+/////////////////////////////////////////////////
+
+// MB_STAT when the diagnostic counters were last cleared; MB_STAT itself
+// is never cleared, so the long-int registers keep counting
+static MB_STATS MB_DIAG_BASE;
+
+static Uint16
+MB_Diag_Counter(Uint16 sub)
+{ // counters are 16 bits and wrap
+	switch (sub)
+	{
+		case MB_DIAG_BUS_MSG:
+			return (MB_STAT.frames - MB_DIAG_BASE.frames) + (MB_STAT.foreign - MB_DIAG_BASE.foreign);
+		case MB_DIAG_BUS_ERR: // frames with a parity or framing error are dropped before the CRC check
+			return (MB_STAT.crc_err - MB_DIAG_BASE.crc_err) + UART_ERROR_CNT.PE + UART_ERROR_CNT.FE;
+		case MB_DIAG_EXCEP:
+			return MB_STAT.excep - MB_DIAG_BASE.excep;
+		case MB_DIAG_SRV_MSG:
+			return MB_STAT.served - MB_DIAG_BASE.served;
+		case MB_DIAG_NO_RESP:
+			return MB_STAT.no_resp - MB_DIAG_BASE.no_resp;
+		case MB_DIAG_OVERRUN:
+			return MB_STAT.overrun - MB_DIAG_BASE.overrun;
+		default:
+			return 0;
+	}
+}
+
+/***************************************************************************
+ * MB_SendPacket_Diag() - diagnostics (0x08)
+ * start_reg is the sub-function, num_regs its data word and data[] the
+ * byte_cnt data bytes to echo for return query data. The counters are
+ * those of the serial line and of Modbus TCP together; restart
+ * communications only clears them, the UART keeps running.
+ ***************************************************************************/
+void
+MB_SendPacket_Diag(void)
+{
+	Uint16	i, val;
+	MB_PKT*	mb_pkt_ptr;
+
+	// if TX is busy, MB_Schedule() runs again once the line is free
+	if (MB_TX_IN_PROGRESS == TRUE)
+		return;
+
+	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+
+	MB_TX_Begin(mb_pkt_ptr);
+
+	///create the modbus frame
+	if (mb_pkt_ptr->long_address)
+	{
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+	}
+    else
+    {
+        MB_TX_Put(REG_SLAVE_ADDRESS);
+    }
+	MB_TX_Put(mb_pkt_ptr->fxn);
+	MB_TX_Put(mb_pkt_ptr->start_reg >> 8);	// sub-function
+	MB_TX_Put(mb_pkt_ptr->start_reg & 0xFF);
+
+	switch (mb_pkt_ptr->start_reg)
+	{
+		case MB_DIAG_QUERY_DATA:
+			for (i=0;i<mb_pkt_ptr->byte_cnt;i++)
+				MB_TX_Put(mb_pkt_ptr->data[i]);
+			break;
+
+		case MB_DIAG_RESTART:
+		case MB_DIAG_CLEAR:
+			MB_DIAG_BASE = MB_STAT;
+			Reset_Uart_Error_Count();
+			MB_TX_Put(mb_pkt_ptr->num_regs >> 8);	// echo data
+			MB_TX_Put(mb_pkt_ptr->num_regs & 0xFF);
+			break;
+
+		case MB_DIAG_CLEAR_OVERRUN:
+			MB_DIAG_BASE.overrun = MB_STAT.overrun;
+			UART_ERROR_CNT.OE = 0;
+			MB_TX_Put(mb_pkt_ptr->num_regs >> 8);	// echo data
+			MB_TX_Put(mb_pkt_ptr->num_regs & 0xFF);
+			break;
+
+		default:
+			val = MB_Diag_Counter(mb_pkt_ptr->start_reg);
+			MB_TX_Put(val >> 8);	// MSB
+			MB_TX_Put(val & 0xFF);	// LSB
+	}
+
+	// calculate & send CRC
+	MB_TX_Put_CRC();
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	MB_TX_Send();
+
+	STAT_CURRENT = 0;
+	STAT_SUCCESS++;
+}
+
+
+void 
+MB_PacketDone(void)
+{
+	//if both THR and TSR are empty, switch back to "RX mode"
+	if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) )
+	{
+		MB_TX_END_TS = Timestamp_get32();
+		MB_TX_IN_PROGRESS = FALSE;
+		CSL_FINS(gpioRegs->BANK[0].OUT_DATA,GPIO_OUT_DATA_OUT9,0);
+		MB_Schedule(); // next queued request, if any
+	}
+	else  //if not, keep checking until it is
+		Clock_start(MB_End_Clock);
+    //	CSL_FINS(gpioRegs->BANK[0].OUT_DATA,GPIO_OUT_DATA_OUT9,0);
+}
+
+/***************************************************************************
+ * MB_Build_Tbl_Index()
+ * Fills a direct-index array so that idx[reg] holds the row of reg in tbl.
+ * Registers that are not in the table (or past the end of the array) stay
+ * MB_IDX_NONE. The MB_IDX_*_ROWS_OK checks keep every row below MB_IDX_NONE.
+ ***************************************************************************/
+static void
+MB_Build_Tbl_Index(const MB_TBL_CELL tbl[][MB_TBL_COLS], Uint8* idx, Uint16 size)
+{
+	Uint16 i;
+
+	for (i=0;i<size;i++)
+		idx[i] = MB_IDX_NONE;
+
+	for (i=0;(tbl[i][0] != 0) && (i < MB_IDX_NONE);i++) //address 0 = end of table
+	{
+		if (tbl[i][0] < size)
+			idx[tbl[i][0]] = (Uint8)i;
+	}
+}
+
+/***************************************************************************
+ * MB_Float_Image()
+ * @return	- the 32-bit image MB_SendPacket_Float sends for a float table
+ * 			  entry, before it is put in byte order
+ ***************************************************************************/
+static inline Uint32
+MB_Float_Image(Uint32 data_type, const double* mbtable_ptr_dbl)
+{
+	float float_val;
+
+	if (data_type == REGTYPE_VAR)
+		return *(Uint32*)(&((VAR*)mbtable_ptr_dbl)->val);
+
+	if (data_type == REGTYPE_LONGINT)
+		return (Uint32)(*(int*)mbtable_ptr_dbl);
+
+	if (data_type == REGTYPE_DBL)
+		float_val = (float)(*mbtable_ptr_dbl);
+	else if (data_type == REGTYPE_SWI)
+		float_val = (float)(((REGSWI*)mbtable_ptr_dbl)->val);
+	else if (data_type == REGTYPE_CHAR)
+		float_val = (float)(*(Uint8*)mbtable_ptr_dbl);
+	else //REGTYPE_INT
+		float_val = (float)(*(int*)mbtable_ptr_dbl);
+
+	return *(Uint32*)(&float_val);
+}
+
+/***************************************************************************
+ * MB_Float_Cache_Init()
+ * Marks the float table registers that a read can be served for from
+ * MB_FLT_CACHE. Anything else (not in the table, write-only, or of a type
+ * MB_Float_Image doesn't handle) goes through the table search, which
+ * raises the matching exception.
+ ***************************************************************************/
+static void
+MB_Float_Cache_Init(void)
+{
+	Uint16 i, reg;
+	Uint32 data_type;
+
+	MB_FLT_CACHE_READY = FALSE;
+	MB_FLT_CACHE_SEQ = 0;
+
+	for (i=0;i<MB_FLT_CACHE_REGS;i++)
+		MB_FLT_CACHE_OK[i] = FALSE;
+
+	for (i=0;MB_TBL_FLOAT[i][0] != 0;i++) //address 0 = end of table
+	{
+		reg = MB_TBL_FLOAT[i][0];
+		data_type = MB_TBL_FLOAT[i][1];
 
-	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
+		if (((reg & 1) == 0) || (reg >= MB_FLT_CACHE_REGS*2))
+			continue;
+		if ((MB_TBL_FLOAT[i][3] == 0) || isNoPermission(MB_TBL_FLOAT[i][2], MB_READ_QRY))
+			continue;
+		if ((data_type == REGTYPE_VAR) || (data_type == REGTYPE_DBL) || (data_type == REGTYPE_SWI)
+			|| (data_type == REGTYPE_LONGINT) || (data_type == REGTYPE_INT))
+			MB_FLT_CACHE_OK[(reg-1)/2] = TRUE;
+	}
+}
 
-	vtune = mb_pkt_ptr->vtune; // meaningless for Razor but needs to be parroted back correctly
+/***************************************************************************
+ * MB_Float_Cache_Refresh()
+ * Re-encodes every cached float register in all four byte orders and
+ * publishes the result as one consistent generation. Called at the end of
+ * Poll().
+ * There are two images. The refresh only ever writes the one that is not
+ * published, then flips MB_FLT_CACHE_SEQ, so readers never mask anything
+ * and never see a register half-written. A Modbus write that lands while
+ * the refresh is running (MB_FLT_CACHE_WGEN moved) may not be in the new
+ * image, so that image is thrown away and the table is read directly
+ * until the next Poll().
+ * A seqlock with readers spinning on an odd count would not do here: the
+ * readers run in a higher priority SWI than Poll() and would spin forever.
+ ***************************************************************************/
+void
+MB_Float_Cache_Refresh(void)
+{
+	Uint32	key, v, seq, wgen;
+	Uint16	i, reg, k;
+	Uint8	(*img)[MB_FLT_CACHE_REGS*4];
 
-	key = Hwi_disableInterrupt(5); ////
-	old_tail = UART_TXBUF.tail;
+	wgen = MB_FLT_CACHE_WGEN;
+	seq = MB_FLT_CACHE_SEQ;
+	img = MB_FLT_CACHE[(seq + 1) & 1]; // the image readers are not using
 
-	///create the modbus frame
-	if (mb_pkt_ptr->long_address)
+	for (i=0;MB_TBL_FLOAT[i][0] != 0;i++) //address 0 = end of table
 	{
-		BfrPut(&UART_TXBUF,(Uint8)0xFA);
+		reg = MB_TBL_FLOAT[i][0];
+		if (((reg & 1) == 0) || (reg >= MB_FLT_CACHE_REGS*2) || (!MB_FLT_CACHE_OK[(reg-1)/2]))
+			continue;
 
-		// note: Cal SW wants this in DCBA order
-		BfrPut(&UART_TXBUF,(Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));	// LSB
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));	// MSB
+		v = MB_Float_Image(MB_TBL_FLOAT[i][1], (double*)MB_TBL_FLOAT[i][3]);
+		k = ((reg-1)/2)*4;
+
+		// ABCD
+		img[MB_BYTE_ORDER_ABCD][k+0] = (Uint8)((v >> 24) & 0xFF);	// MSB
+		img[MB_BYTE_ORDER_ABCD][k+1] = (Uint8)((v >> 16) & 0xFF);
+		img[MB_BYTE_ORDER_ABCD][k+2] = (Uint8)((v >> 8) & 0xFF);
+		img[MB_BYTE_ORDER_ABCD][k+3] = (Uint8)(v & 0xFF);			// LSB
+		// CDAB
+		img[MB_BYTE_ORDER_CDAB][k+0] = (Uint8)((v >> 8) & 0xFF);
+		img[MB_BYTE_ORDER_CDAB][k+1] = (Uint8)(v & 0xFF);
+		img[MB_BYTE_ORDER_CDAB][k+2] = (Uint8)((v >> 24) & 0xFF);
+		img[MB_BYTE_ORDER_CDAB][k+3] = (Uint8)((v >> 16) & 0xFF);
+		// DCBA
+		img[MB_BYTE_ORDER_DCBA][k+0] = (Uint8)(v & 0xFF);
+		img[MB_BYTE_ORDER_DCBA][k+1] = (Uint8)((v >> 8) & 0xFF);
+		img[MB_BYTE_ORDER_DCBA][k+2] = (Uint8)((v >> 16) & 0xFF);
+		img[MB_BYTE_ORDER_DCBA][k+3] = (Uint8)((v >> 24) & 0xFF);
+		// BADC
+		img[MB_BYTE_ORDER_BADC][k+0] = (Uint8)((v >> 16) & 0xFF);
+		img[MB_BYTE_ORDER_BADC][k+1] = (Uint8)((v >> 24) & 0xFF);
+		img[MB_BYTE_ORDER_BADC][k+2] = (Uint8)(v & 0xFF);
+		img[MB_BYTE_ORDER_BADC][k+3] = (Uint8)((v >> 8) & 0xFF);
 	}
-    else
-    {
-	    BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS);
-    }
-	//BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS); // DKOH
-	BfrPut(&UART_TXBUF,mb_pkt_ptr->fxn);
-	BfrPut(&UART_TXBUF,mb_pkt_ptr->vtune);
 
-	////////////////////////////////////////////
-	///////////// Read register(s) /////////////
-	////////////////////////////////////////////
+	// check and publish in one step, or a write could slip in between
+	key = Swi_disable(); /////////////////////////////////////////////////////
+	if (wgen == MB_FLT_CACHE_WGEN)
+	{
+		MB_FLT_CACHE_SEQ = seq + 1;
+		MB_FLT_CACHE_READY = TRUE;
+	}
+	Swi_restore(key); ////////////////////////////////////////////////////////
+}
 
-	for (i=0;i<34;i++)
+/***************************************************************************
+ * MB_Float_Cache_Put()
+ * @return	- TRUE if every register of the read was copied to the TX frame
+ * 			  from MB_FLT_CACHE, FALSE if the caller has to build it
+ ***************************************************************************/
+static BOOL
+MB_Float_Cache_Put(const MB_PKT* mb_pkt_ptr)
+{
+	Uint32 seq;
+	Uint16 slot, n, i;
+
+	if ((!MB_FLT_CACHE_READY) || (mb_pkt_ptr->is_special_reg) || ((mb_pkt_ptr->start_reg & 1) == 0))
+		return FALSE;
+
+	slot = (mb_pkt_ptr->start_reg - 1) / 2;
+	n = mb_pkt_ptr->byte_cnt / 4;
+
+	if ((slot + n > MB_FLT_CACHE_REGS) || (MB_TX_FRAME_N + n*4 > MB_FRAME_SIZE))
+		return FALSE;
+
+	for (i=0;i<n;i++)
 	{
-		if (i==0)
-			reg = 19;	// REG_FREQ - frequency
-		else if	(i==1)
-			reg = 67;	// REG_OIL_RP - VREF
-		else if	(i==2)
-			reg = 67;	// Using REG_OIL_RP - "VINC"
-		else if	(i==3)
-		{ // just feed it whatever VTUNE the PC thinks it is using...
-			float_val 	= (float)vtune;					// cast the value as float
-			mbtable_val = *(Uint32*)(&float_val);		// treat float like an Uint32 so we can bit-shift
+		if (!MB_FLT_CACHE_OK[slot+i])
+			return FALSE;
+	}
 
-			// note: Cal SW wants this in DCBA order
-			BfrPut(&UART_TXBUF,(Uint8)(mbtable_val    	   & 0xFF));	// LSB
-			BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 8)  & 0xFF));
-			BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 16) & 0xFF));
-			BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 24) & 0xFF));	// MSB
-			continue;
-		}
-		else if	(i==4)
-			reg = 5;	// REG_TEMPERATURE - temperature (should this be REG_TEMP_USER?)
-		else if	(i==5)
-			reg = 5;	// REG_TEMPERATURE - temperature internal?
-		else
-		{	// all other sample values are don't cares to the calibration software
-			BfrPut(&UART_TXBUF,0x00);// LSB
-			BfrPut(&UART_TXBUF,0x00);
-			BfrPut(&UART_TXBUF,0x00);
-			BfrPut(&UART_TXBUF,0x00);// MSB
-			continue;
-		}
+	seq = MB_FLT_CACHE_SEQ;
+	memcpy(&MB_TX_FRAME[MB_TX_FRAME_N], &MB_FLT_CACHE[seq & 1][mb_pkt_ptr->byte_order][slot*4], n*4);
 
-		rtn = MB_Tbl_Search_FloatRegs(reg,&mbtable_ptr_dbl,&data_type,&prot);
-		if ((rtn == -1) || (mbtable_ptr_dbl == (double*)NULL))
-		{// illegal data address
-			Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-			Hwi_restoreInterrupt(5,key);
-			return;
-		}
+	// two more publications and the image was being rewritten under us
+	// (only possible for a reader that Poll() can preempt)
+	if (MB_FLT_CACHE_SEQ - seq > 1)
+		return FALSE;
 
-		if (data_type == REGTYPE_VAR)
-		{
-			mbtable_ptr_var = (VAR*)mbtable_ptr_dbl;
-			mbtable_val = *(Uint32*)(&mbtable_ptr_var->val); // treat float like an Uint32 so we can bit-shift
-		}
-		else if (data_type == REGTYPE_DBL)
-		{
-			float_val = (float)(*mbtable_ptr_dbl);	// dereference and cast the value as float
-			mbtable_val = *(Uint32*)(&float_val);	// treat float like an Uint32 so we can bit-shift
-		}
-		else if (data_type == REGTYPE_SWI)
-		{
-			float_val = (float)(mbtable_ptr_rsw->val);	// dereference and cast the value as float
-			mbtable_val = *(Uint32*)(&float_val);	// treat float like an Uint32 so we can bit-shift
+	MB_TX_FRAME_N += n*4;
+	return TRUE;
+}
 
-		}
-		else if (data_type == REGTYPE_INT)
+/***************************************************************************
+ * MB_Mirror_Refresh()
+ * Copies the registers listed in REG_MIRROR_SRC into the read-only mirror
+ * block at MB_MIRROR_BASE, so one read returns them all. Called from
+ * Poll() before MB_Float_Cache_Refresh(), which makes the whole block one
+ * generation for the readers. Everything is published as a float; slots
+ * that are unused, point at a write-only or missing register, or at the
+ * mirror itself read 0.
+ ***************************************************************************/
+void
+MB_Mirror_Refresh(void)
+{
+	Uint32	v;
+	Uint16	i, reg;
+	Uint8	data_type, prot;
+	Int8	rtn;
+	double*	mbtable_ptr_dbl;
+	double	val;
+
+	for (i=0;i<MB_MIRROR_SLOTS;i++)
+	{
+		reg = (Uint16)REG_MIRROR_SRC[i];
+		mbtable_ptr_dbl = (double*)NULL;
+		rtn = -1;
+
+		if ( ((reg >= MIN_MB_INT) && (reg < MAX_MB_INT)) || ((reg >= MIN_FCT_INT) && (reg < MAX_FCT_INT)) )
+			rtn = MB_Tbl_Search_IntRegs(reg, &mbtable_ptr_dbl, &data_type, &prot);
+		else if ((reg >= MIN_MB_LONGINT) && (reg < MAX_MB_LONGINT))
+			rtn = MB_Tbl_Search_LongIntRegs(reg, &mbtable_ptr_dbl, &data_type, &prot);
+		else if ((reg > 0) && ((reg < MB_MIRROR_BASE) || (reg >= MB_MIRROR_BASE + MB_MIRROR_SLOTS*2)))
+			rtn = MB_Tbl_Search_FloatRegs(reg, &mbtable_ptr_dbl, &data_type, &prot);
+
+		val = 0;
+		if ((rtn != -1) && (mbtable_ptr_dbl != (double*)NULL) && !isNoPermission(prot, MB_READ_QRY))
 		{
-			mbtable_ptr_int = (int*) mbtable_ptr_dbl; 	// cast variable pointer to int*
-			float_val 	= (float)(*mbtable_ptr_int);	// dereference and cast the value as float
-			mbtable_val = *(Uint32*)(&float_val);		// treat float like an Uint32 so we can bit-shift
+			if ((data_type == REGTYPE_INT) || (data_type == REGTYPE_LONGINT))
+				val = (double)*(int*)mbtable_ptr_dbl;
+			else if ((data_type == REGTYPE_VAR) || (data_type == REGTYPE_DBL) || (data_type == REGTYPE_SWI))
+			{
+				v = MB_Float_Image(data_type, mbtable_ptr_dbl);
+				val = (double)*(float*)&v;
+			}
 		}
 
-		// note: Cal SW wants this in DCBA order
-		BfrPut(&UART_TXBUF,(Uint8)( mbtable_val    	   & 0xFF));	// LSB
-		BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 8)  & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 16) & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)((mbtable_val >> 24) & 0xFF));	// MSB
+		MB_MIRROR[i] = val;
 	}
+}
+
+/***************************************************************************
+ * Change list (report by exception, PDI function 65)
+ * Every readable float, integer and long-int register carries the change
+ * sequence number it last changed at. MB_Change_Scan() runs once per
+ * Poll(), after the measurements, VAR_Update()s and any Modbus or
+ * updateVars() writes have landed, compares each register with its image
+ * from the last scan and stamps the ones that moved with the next number
+ * from MB_CHANGE_SEQ. Changes are caught where registers are published:
+ * VAR_Update() does not know register numbers, and many registers are
+ * plain doubles assigned directly.
+ * Sequence numbers are unique per stamp (the initial ones too) and are
+ * compared modulo 2^32.
+ ***************************************************************************/
+#define MB_CHG_TABLES		(3)				// float, integer, long int
+#define MB_CHG_ROWS			(MB_IDX_NONE)	// rows the table indexes can address
+#define MB_CHG_MAX_PAIRS	(40)			// 5 + 40*6 data bytes still fit a 256-byte frame with a long address
+
+static const MB_TBL_CELL (*const MB_CHG_TBL[MB_CHG_TABLES])[MB_TBL_COLS] = { MB_TBL_FLOAT, MB_TBL_INT, MB_TBL_LONGINT };
+static Uint32 MB_CHG_IMG[MB_CHG_TABLES][MB_CHG_ROWS];	// image at the last scan
+static Uint32 MB_CHG_SEQ[MB_CHG_TABLES][MB_CHG_ROWS];	// sequence number of the last change; 0 = not tracked
+static Uint32 MB_CHANGE_SEQ;							// last sequence number handed out
+
+/***************************************************************************
+ * MB_Change_Image()
+ * @param t		- 0 float table, 1 integer table, 2 long int table
+ * @param v		- set to the 32 bits a read of the register returns (float
+ * 				  image for the float table, the integer otherwise)
+ * @return	- FALSE if the register is not tracked
+ ***************************************************************************/
+static BOOL
+MB_Change_Image(Uint8 t, const MB_TBL_CELL* row, Uint32* v)
+{
+	Uint32 data_type = row[1];
 
-	msg_num_bytes = 3 + (34 * 4); // address byte + fxn byte + vtune byte + (34 registers * 4 bytes per reg)
+	*v = 0;
 
-	/// check if long_addr
-	if (mb_pkt_ptr->long_address) la_offset = LONG_OFFSET;
-	else la_offset = 0;
+	if ((row[3] == 0) || (row[2] == REGPERM_WRITE_O))
+		return FALSE;
+	if ((row[0] >= MB_MIRROR_BASE) && (row[0] < MB_MIRROR_BASE + MB_MIRROR_SLOTS*2))
+		return FALSE; // copies of other registers
 
-	if (UART_TXBUF.tail < old_tail) // Calc_CRC() needs to know if there was a buffer wrap-around
+	if (t == 0)
 	{
-		wrap_count = MAX_BFR_SIZE - UART_TXBUF.head;
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,wrap_count);
+		if ((data_type != REGTYPE_VAR) && (data_type != REGTYPE_DBL) && (data_type != REGTYPE_SWI)
+			&& (data_type != REGTYPE_INT) && (data_type != REGTYPE_LONGINT))
+			return FALSE;
+		*v = MB_Float_Image(data_type, (double*)row[3]);
 	}
 	else
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,0);
+	{
+		if ((data_type != REGTYPE_INT) && (data_type != REGTYPE_LONGINT))
+			return FALSE;
+		*v = (Uint32)(*(int*)row[3]);
+	}
 
-	BfrPut(&UART_TXBUF, CRC & 0xFF);	// LSB
-	BfrPut(&UART_TXBUF, CRC >> 8);		// MSB
-	MB_TX_IN_PROGRESS = TRUE;
-	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
-	Hwi_restoreInterrupt(5,key); ////
+	return TRUE;
+}
 
-	if ( CSL_FEXT(uartRegs->IER,UART_IER_ETBEI) != 1) //if disabled
-		CSL_FINST(uartRegs->IER,UART_IER_ETBEI,ENABLE);	//enable TX buffer empty interrupt
+static void
+MB_Change_Init(void)
+{
+	Uint16	i;
+	Uint8	t;
 
-	STAT_CURRENT = 0;
-	STAT_SUCCESS++;
+	MB_CHANGE_SEQ = 0;
 
-	Uart_ISR(); // prime the pump
+	for (t=0;t<MB_CHG_TABLES;t++)
+	{
+		for (i=0;(i<MB_CHG_ROWS) && (MB_CHG_TBL[t][i][0] != 0);i++) //address 0 = end of table
+		{
+			if (MB_Change_Image(t, MB_CHG_TBL[t][i], &MB_CHG_IMG[t][i]))
+				MB_CHG_SEQ[t][i] = ++MB_CHANGE_SEQ;
+			else
+				MB_CHG_SEQ[t][i] = 0;
+		}
+	}
 }
 
+/***************************************************************************
+ * MB_Change_Scan() - stamps the registers that changed since the last scan
+ * Called from Poll(). Each stamp is made under Swi_disable() so that a
+ * change list request never sees a row stamped past MB_CHANGE_SEQ.
+ ***************************************************************************/
+void
+MB_Change_Scan(void)
+{
+	Uint32	key, v, seq;
+	Uint16	i;
+	Uint8	t;
 
-void 
-MB_SendPacket_ForceSlaveAddr(void)
+	for (t=0;t<MB_CHG_TABLES;t++)
+	{
+		for (i=0;(i<MB_CHG_ROWS) && (MB_CHG_TBL[t][i][0] != 0);i++) //address 0 = end of table
+		{
+			if (MB_CHG_SEQ[t][i] == 0)
+				continue;
+
+			MB_Change_Image(t, MB_CHG_TBL[t][i], &v);
+			if (v == MB_CHG_IMG[t][i])
+				continue;
+
+			key = Swi_disable(); /////////////////////////////////////////////
+			seq = MB_CHANGE_SEQ + 1;
+			if (seq == 0)
+				seq = 1; // 0 marks untracked rows
+			MB_CHG_IMG[t][i] = v;
+			MB_CHG_SEQ[t][i] = seq;
+			MB_CHANGE_SEQ = seq;
+			Swi_restore(key); ////////////////////////////////////////////////
+		}
+	}
+}
+
+/***************************************************************************
+ * MB_SendPacket_Changes() -- PDI function 65
+ * Request:  slave, 65, since(4), CRC
+ * Response: slave, 65, byte count, seq(4), more(1), then per register
+ * 			 address(2), value(4), all MSB first
+ * Returns the registers that changed after sequence number since, oldest
+ * change first, as many as fit. seq is what to send as since next time;
+ * more is 1 when changes were left out for lack of room, so the master
+ * asks again straight away. since = 0 (or anything not yet handed out,
+ * e.g. after a restart) returns every register.
+ ***************************************************************************/
+void
+MB_SendPacket_Changes(void)
 {
-	Uint32 	key,CRC, msg_num_bytes, wrap_count;
-	Uint8	la_offset, new_slave_addr;
-	int		old_tail;
+	Uint32	since, snap, limit, prev, best, k, seq;
+	Uint16	i, pairs, cnt_pos, best_i;
+	Uint8	t, best_t, more;
 	MB_PKT*	mb_pkt_ptr;
 
+	// if TX is busy, MB_Schedule() runs again once the line is free
 	if (MB_TX_IN_PROGRESS == TRUE)
-	{
-		Clock_start(MB_Start_Clock_Sample);
 		return;
-	}
 
 	mb_pkt_ptr = &MB_PKT_LIST.BFR[MB_PKT_LIST.head];
 
-	//Note: Admittedly some slapdash coding here. Using the start_reg parameter
-	//		to carry the new slave address to MB_SendPacket_ForceSlaveAddr()
-	new_slave_addr = mb_pkt_ptr->start_reg;
+	// since rides in start_reg (MSW) and num_regs (LSW)
+	since = ((Uint32)mb_pkt_ptr->start_reg << 16) | mb_pkt_ptr->num_regs;
 
-	key = Hwi_disableInterrupt(5); ////
-	old_tail	= UART_TXBUF.tail;
+	MB_TX_Begin(mb_pkt_ptr);
 
 	///create the modbus frame
 	if (mb_pkt_ptr->long_address)
 	{
-		BfrPut(&UART_TXBUF,(Uint8)0xFA);
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
-		BfrPut(&UART_TXBUF,(Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
+		MB_TX_Put((Uint8)0xFA);
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 24) & 0xFF));// MSB
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 16) & 0xFF));
+		MB_TX_Put((Uint8)(((Uint32)REG_SN_PIPE >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( (Uint32)REG_SN_PIPE  	   & 0xFF));// LSB
 	}
+    else
+    {
+        MB_TX_Put(REG_SLAVE_ADDRESS);
+    }
+	MB_TX_Put(mb_pkt_ptr->fxn);
+	cnt_pos = MB_TX_FRAME_N;
+	MB_TX_Put(0);	// byte count, filled in below
+	MB_TX_Put(0);	// seq and more, filled in below
+	MB_TX_Put(0);
+	MB_TX_Put(0);
+	MB_TX_Put(0);
+	MB_TX_Put(0);
+
+	// k = snap - seq is a change's age; anything younger than since is wanted
+	snap  = MB_CHANGE_SEQ;
+	limit = snap - since + 1;
+	if ((since == 0) || ((Int32)(since - snap) > 0))
+		limit = 0xFFFFFFFF; // everything; since is ahead of us after a restart
+
+	// oldest first: each pass takes the oldest change younger than the last one sent
+	prev = limit;
+	pairs = 0;
+	more = FALSE;
+	for (;;)
+	{
+		best = 0;
+		best_t = 0;
+		best_i = 0;
+		for (t=0;t<MB_CHG_TABLES;t++)
+		{
+			for (i=0;(i<MB_CHG_ROWS) && (MB_CHG_TBL[t][i][0] != 0);i++) //address 0 = end of table
+			{
+				if (MB_CHG_SEQ[t][i] == 0)
+					continue;
+				k = snap - MB_CHG_SEQ[t][i] + 1; // 1 = newest
+				if ((k < prev) && (k > best))
+				{
+					best = k;
+					best_t = t;
+					best_i = i;
+				}
+			}
+		}
 
-	/// CHANGE SLAVE ADDRESS ///
-	REG_SLAVE_ADDRESS = new_slave_addr;
-	/// CHANGE SLAVE ADDRESS ///
-
-	BfrPut(&UART_TXBUF,REG_SLAVE_ADDRESS);
-	BfrPut(&UART_TXBUF,mb_pkt_ptr->fxn);
-	BfrPut(&UART_TXBUF,new_slave_addr);
-
-	BfrPut(&UART_TXBUF,(Uint8)((REG_SN_PIPE >> 24) & 0xFF));	// MSB
-	BfrPut(&UART_TXBUF,(Uint8)((REG_SN_PIPE >> 16) & 0xFF));
-	BfrPut(&UART_TXBUF,(Uint8)((REG_SN_PIPE >> 8)  & 0xFF));
-	BfrPut(&UART_TXBUF,(Uint8)( REG_SN_PIPE  	   & 0xFF));	// LSB
+		if (best == 0)
+			break; // nothing left
 
-	msg_num_bytes = 3 + 4; // address byte + fxn byte + new slave addr byte + SN bytes (4)
+		if (pairs >= MB_CHG_MAX_PAIRS)
+		{
+			more = TRUE;
+			break;
+		}
 
-	/// check if long_addr
-	if (mb_pkt_ptr->long_address) la_offset = LONG_OFFSET;
-	else la_offset = 0;
+		MB_TX_Put((Uint8)((MB_CHG_TBL[best_t][best_i][0] >> 8) & 0xFF));
+		MB_TX_Put((Uint8)( MB_CHG_TBL[best_t][best_i][0] 	  & 0xFF));
+		MB_TX_Put((Uint8)((MB_CHG_IMG[best_t][best_i] >> 24) & 0xFF));
+		MB_TX_Put((Uint8)((MB_CHG_IMG[best_t][best_i] >> 16) & 0xFF));
+		MB_TX_Put((Uint8)((MB_CHG_IMG[best_t][best_i] >> 8)  & 0xFF));
+		MB_TX_Put((Uint8)( MB_CHG_IMG[best_t][best_i] 		  & 0xFF));
 
-	if (UART_TXBUF.tail < old_tail) // if there was a buffer wrap around
-	{
-		wrap_count = MAX_BFR_SIZE - UART_TXBUF.head;
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,wrap_count);
+		pairs++;
+		prev = best;
 	}
-	else
-		CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],msg_num_bytes+la_offset,0);
 
-	BfrPut(&UART_TXBUF, CRC & 0xFF);	// LSB
-	BfrPut(&UART_TXBUF, CRC >> 8);		// MSB
-	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	seq = more ? (snap - prev + 1) : snap;
 
-	MB_TX_IN_PROGRESS = TRUE;
+	MB_TX_FRAME[cnt_pos]   = (Uint8)(5 + pairs*6);
+	MB_TX_FRAME[cnt_pos+1] = (Uint8)((seq >> 24) & 0xFF);
+	MB_TX_FRAME[cnt_pos+2] = (Uint8)((seq >> 16) & 0xFF);
+	MB_TX_FRAME[cnt_pos+3] = (Uint8)((seq >> 8) & 0xFF);
+	MB_TX_FRAME[cnt_pos+4] = (Uint8)(seq & 0xFF);
+	MB_TX_FRAME[cnt_pos+5] = more;
 
-	Hwi_restoreInterrupt(5,key); ////
+	// calculate & send CRC
+	MB_TX_Put_CRC();
+	Discard_MB_Pkt_Head(&MB_PKT_LIST); //discard the packet at the head of the list
+	MB_TX_Send();
 
-	if ( CSL_FEXT(uartRegs->IER,UART_IER_ETBEI) != 1) //if disabled
-		CSL_FINST(uartRegs->IER,UART_IER_ETBEI,ENABLE);	//enable TX buffer empty interrupt
-	
 	STAT_CURRENT = 0;
 	STAT_SUCCESS++;
-
-	Uart_ISR(); // prime the pump
 }
 
-void 
-MB_SendException(Uint8 slv, Uint8 fxn, Uint8 code)
+/***************************************************************************
+ * MB_Float_Cache_Get()
+ * @param reg	- float register
+ * @param v		- set to the register's 32-bit image from the published
+ * 				  generation
+ * @return		- FALSE if the register has to be read from the table
+ ***************************************************************************/
+static BOOL
+MB_Float_Cache_Get(Uint16 reg, Uint32* v)
 {
-	Uint32 key, CRC;
-	Uint8  fxn_excep;
-
-	if ((code < 0x01) || (code > 0x06)) // check bounds
-	{
-		return;
-	}
-
-	fxn_excep = fxn | 0x80; //set the MSB
-
-	///////////////////////////////////////////////////////////
-	key = Hwi_disableInterrupt(5); 
-	Clear_Buffer(&UART_TXBUF);
-	BfrPut(&UART_TXBUF,slv);
-	BfrPut(&UART_TXBUF,fxn_excep);
-	BfrPut(&UART_TXBUF,code);
+	Uint32 seq;
+	const Uint8* p;
 
-	CRC = Calc_CRC(&UART_TXBUF.buff[UART_TXBUF.head],3,0);
-
-	BfrPut(&UART_TXBUF, CRC & 0xFF);	// LSB
-	BfrPut(&UART_TXBUF, CRC >> 8);		// MSB
-	Hwi_restoreInterrupt(5,key); 
-	///////////////////////////////////////////////////////////
-
-	STAT_CURRENT = 2;
-	STAT_CMD++;
-	Uart_ISR(); // prime the pump
-}
+	if ((!MB_FLT_CACHE_READY) || ((reg & 1) == 0) || (reg >= MB_FLT_CACHE_REGS*2) || (!MB_FLT_CACHE_OK[(reg-1)/2]))
+		return FALSE;
 
+	seq = MB_FLT_CACHE_SEQ;
+	p = &MB_FLT_CACHE[seq & 1][MB_BYTE_ORDER_ABCD][((reg-1)/2)*4];
+	*v = ((Uint32)p[0] << 24) | ((Uint32)p[1] << 16) | ((Uint32)p[2] << 8) | (Uint32)p[3];
 
-/****************************************************************************
- * MB_Watchdog_Timeout() -- clock module function							*
- *  Timeout on the Modbus frame -> remove the bad data from the RX buffer	*
- * 																			*
- ****************************************************************************/
-void 
-MB_Watchdog_Timeout(void)
-{
-	STAT_RETRY++;
-	STAT_CURRENT = 3;
-	Uint32 key;
-	key = Hwi_disableInterrupt(5);	/////////////////////////////////////
-	//remove data from RX buffer
-	UART_RXBUF.n 	-= WDOG_BYTES_TO_REMOVE;
-	UART_RXBUF.head += WDOG_BYTES_TO_REMOVE;
-	if (UART_RXBUF.n < 0) // this shouldn't happen
-		Clear_Buffer(&UART_RXBUF);
-	else if (UART_RXBUF.head >= MAX_BFR_SIZE)
-		UART_RXBUF.head -= MAX_BFR_SIZE;	//wrap around
-	Hwi_restoreInterrupt(5,key);		/////////////////////////////////////
+	return (MB_FLT_CACHE_SEQ - seq > 1) ? FALSE : TRUE;
 }
 
-void 
-MB_PacketDone(void)
+/***************************************************************************
+ * Init_MB_Tbl_Index()
+ * Builds the lookup arrays for MB_Tbl_Search_*Regs(). Must run before the
+ * first packet is served (called from Init_Modbus()).
+ ***************************************************************************/
+void
+Init_MB_Tbl_Index(void)
 {
-	//if both THR and TSR are empty, switch back to "RX mode"
-	if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) )
-	{
-		MB_TX_IN_PROGRESS = FALSE;
-		CSL_FINS(gpioRegs->BANK[0].OUT_DATA,GPIO_OUT_DATA_OUT9,0);
-	}
-	else  //if not, keep checking until it is
-		Clock_start(MB_End_Clock);
-    //	CSL_FINS(gpioRegs->BANK[0].OUT_DATA,GPIO_OUT_DATA_OUT9,0);
+	MB_Build_Tbl_Index(MB_TBL_FLOAT,   MB_IDX_FLOAT,   MB_IDX_FLOAT_SIZE);
+	MB_Build_Tbl_Index(MB_TBL_INT,     MB_IDX_INT,     MB_IDX_INT_SIZE);
+	MB_Build_Tbl_Index(MB_TBL_LONGINT, MB_IDX_LONGINT, MB_IDX_LONGINT_SIZE);
+	MB_Build_Tbl_Index(MB_TBL_COIL,    MB_IDX_COIL,    MB_IDX_COIL_SIZE);
+	MB_Float_Cache_Init();
+	MB_Change_Init();
 }
 
 // search the integer registers
 inline Int8 
 MB_Tbl_Search_IntRegs(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type, Uint8 *prot_status)
 {
-	Uint16 i = 0;
+	Uint8 i;
 
-	//should we use a binary search?
-	//linear search (for now)
-	while (MB_TBL_INT[i][0] != 0) //address 0 = end of table
-	{
-		if ( MB_TBL_INT[i][0] == reg_num)
-			break;
-		else
-			i++;
-	}
-	if (MB_TBL_INT[i][0] == 0)		// reached end of the list
+	if ((reg_num >= MB_IDX_INT_SIZE) || ((i = MB_IDX_INT[reg_num]) == MB_IDX_NONE))
 	{
 		*mbtable_ptr = (double*)NULL;
-		data_type = (Uint8*)NULL;
 		return -1; //not found
 	}
 
@@ -2762,22 +5239,11 @@ MB_Tbl_Search_IntRegs(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type, Ui
 inline Int8 
 MB_Tbl_Search_LongIntRegs(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type, Uint8 *prot_status)
 {
-	Uint16 i = 0;
-
-	//should we use a binary search?
-	//linear search (for now)
-	while (MB_TBL_LONGINT[i][0] != 0) //address 0 = end of table
-	{
-		if ( MB_TBL_LONGINT[i][0] == reg_num)
-			break;
-		else
-			i++;
-	}
+	Uint8 i;
 
-	if (MB_TBL_LONGINT[i][0] == 0)		// reached end of the list
+	if ((reg_num >= MB_IDX_LONGINT_SIZE) || ((i = MB_IDX_LONGINT[reg_num]) == MB_IDX_NONE))
 	{
 		*mbtable_ptr = (double*)NULL;
-		data_type = (Uint8*)NULL;
 		return -1; //not found
 	}
 
@@ -2793,19 +5259,11 @@ MB_Tbl_Search_LongIntRegs(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type
 inline Int8 
 MB_Tbl_Search_FloatRegs(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type, Uint8 *prot_status)
 {
-	Uint16 i = 0;
+	Uint8 i;
 
-	//should we use a binary search?
-	//linear search (for now)
-	while (MB_TBL_FLOAT[i][0] != 0) //address 0 = end of table
-	{
-		if ( MB_TBL_FLOAT[i][0] == reg_num) break;
-		else i++;
-	}
-	if (MB_TBL_FLOAT[i][0] == 0)		// reached end of the list
+	if ((reg_num >= MB_IDX_FLOAT_SIZE) || ((i = MB_IDX_FLOAT[reg_num]) == MB_IDX_NONE))
 	{
 		*mbtable_ptr = (double*)NULL;
-		data_type = (Uint8*)NULL;
 		return -1; //not found
 	}
 
@@ -2820,19 +5278,21 @@ MB_Tbl_Search_FloatRegs(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type,
 inline Int8 
 MB_Tbl_Search_CoilRegs(Uint16 reg_num, COIL **mbtable_ptr_coil, Uint8 *data_type, Uint8 *prot_status)
 {
-	Uint16 i = 0;
+	Uint16 i;
 
-	//should we use a binary search?
-	//linear search (for now)
-	while (MB_TBL_COIL[i][0] != 0) //address 0 = end of table
-	{
-		if ( MB_TBL_COIL[i][0] == reg_num) break;
-		else i++;
+	if (reg_num < MB_IDX_COIL_SIZE)
+		i = MB_IDX_COIL[reg_num];
+	else
+	{	// the few special coils (9999) live past the index; scan for them
+		i = 0;
+		while ((MB_TBL_COIL[i][0] != 0) && (MB_TBL_COIL[i][0] != reg_num))
+			i++;
+		if (MB_TBL_COIL[i][0] == 0)
+			i = MB_IDX_NONE;
 	}
 
-	if (MB_TBL_COIL[i][0] == 0)		// reached end of the list
+	if (i == MB_IDX_NONE)
 	{
-		data_type = (Uint8*)NULL;
 		*mbtable_ptr_coil = (COIL*)NULL;
 		return -1; //not found
 	}
@@ -2854,7 +5314,7 @@ MB_Tbl_Search_Extended(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type, U
 
 	//should we use a binary search?
 	//linear search (for now)
-	while (MB_TBL_EXTENDED[i][1] != 0) //null value = end of table
+	while (MB_TBL_EXTENDED[i][2] != 0) //null value = end of table
 	{
 		//	if address is within the address range of the array
 		if ( (reg_num >= MB_TBL_EXTENDED[i][0]) && (reg_num < MB_TBL_EXTENDED[i+1][0]) )
@@ -2868,11 +5328,19 @@ MB_Tbl_Search_Extended(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type, U
 
 	if (addr_found)
 	{
-		*data_type 		= REGTYPE_DBL; //THIS TABLE CANNOT PROPERLY HOLD A REGSWI
+		*data_type 		= MB_TBL_EXTENDED[i][1]; //THIS TABLE CANNOT PROPERLY HOLD A REGSWI
 		*prot_status 	= REGPERM_PASSWD;
 
-		index = (reg_num - MB_TBL_EXTENDED[i][0]) / 2; // extract array index from register address
-		*mbtable_ptr = (double*) (MB_TBL_EXTENDED[i][1]) + index*sizeof(Uint8); // pointer points to the individual element in array
+		if (*data_type == REGTYPE_CHAR)
+		{	// one character per register
+			index = reg_num - MB_TBL_EXTENDED[i][0];
+			*mbtable_ptr = (double*) ((char*)MB_TBL_EXTENDED[i][2] + index);
+		}
+		else
+		{
+			index = (reg_num - MB_TBL_EXTENDED[i][0]) / 2; // extract array index from register address
+			*mbtable_ptr = (double*) (MB_TBL_EXTENDED[i][2]) + index*sizeof(Uint8); // pointer points to the individual element in array
+		}
 	}
 	else
 	{
@@ -2904,55 +5372,36 @@ isNoPermission(Uint8 prot, Uint8 isWriteCommand)
 BOOL
 updateVars(const int id, double val)
 {
+	double* mbtable_ptr;
+	Uint8 data_type, prot;
+
+	MB_Float_Cache_Dirty();
+
 	/// integer
 	if (((id > 200) && (id < 301)) || ((id > 400) && (id < 501)))
 	{
-		int i = 0;
-		while (MB_TBL_INT[i][0] != 0) //address 0 = end of table
+		if (MB_Tbl_Search_IntRegs(id,&mbtable_ptr,&data_type,&prot) == 0)
 		{
-			if (MB_TBL_INT[i][0] == id)
-			{
-				int* mbtable_ptr;
-				mbtable_ptr = (int*) MB_TBL_INT[i][3]; 
-                *mbtable_ptr = val;
-
-				return TRUE;
-			}
-			else i++;
+			*((int*)mbtable_ptr) = val;
+			return TRUE;
 		}
 	}
 	else if ((id > 300) && (id < 401))
 	{
-		int i = 0;
-		while (MB_TBL_LONGINT[i][0] != 0) //address 0 = end of table
+		if (MB_Tbl_Search_LongIntRegs(id,&mbtable_ptr,&data_type,&prot) == 0)
 		{
-			if (MB_TBL_LONGINT[i][0] == id)
-			{
-				int* mbtable_ptr;
-				mbtable_ptr = (int*) MB_TBL_LONGINT[i][3]; 
-                *mbtable_ptr = val;
-
-				return TRUE;
-			}
-			else i++;
+			*((int*)mbtable_ptr) = val;
+			return TRUE;
 		}
 	}
 	else if (((id > 0) && (id < 201)) || ((id > 700) && (id < 801)))
 	{
-		int i = 0;
-		while (MB_TBL_FLOAT[i][0] != 0) //address 0 = end of table
+		if (MB_Tbl_Search_FloatRegs(id,&mbtable_ptr,&data_type,&prot) == 0)
 		{
-			if (MB_TBL_FLOAT[i][0] == id)
-			{
-				double* mbtable_ptr;
-				Uint8 data_type = (int*) MB_TBL_FLOAT[i][1];
-				mbtable_ptr = (double*) MB_TBL_FLOAT[i][3]; 
-				if (data_type == REGTYPE_DBL) *mbtable_ptr = val;
-				else if (data_type == REGTYPE_VAR) VAR_Update(mbtable_ptr, (double) val, 0);
-                
-				return TRUE;
-			}
-			else i++;
+			if (data_type == REGTYPE_DBL) *mbtable_ptr = val;
+			else if (data_type == REGTYPE_VAR) VAR_Update((VAR*)mbtable_ptr, (double) val, 0);
+
+			return TRUE;
 		}
 	}
 	else if (id > 60000)
@@ -2960,10 +5409,10 @@ updateVars(const int id, double val)
 		int i = 0;
 		while (MB_TBL_EXTENDED[i][0] != 0) //address 0 = end of table
 		{
-			if (MB_TBL_EXTENDED[i][0] == id)
+			if (MB_TBL_EXTENDED[i][0] == (MB_TBL_CELL)id)
 			{
 				int* mbtable_ptr;
-				mbtable_ptr = (int*) MB_TBL_EXTENDED[i][1]; 
+				mbtable_ptr = (int*) MB_TBL_EXTENDED[i][2]; 
 				*mbtable_ptr = val;
                 
 				return TRUE;
@@ -32,7 +32,10 @@
 #ifndef MODBUSRTU_H_
 #define MODBUSRTU_H_
 
-#define MAX_MB_BFR					(8)
+#define MAX_MB_BFR					(16)
+#define MB_BUSY_SLOTS				(2)		// kept for Server Busy replies when the list is full
+#define MB_FRAME_SIZE				(264)	// 256-byte RTU frame + long address prefix, rounded up
+#define MB_MIXED_MAX_REGS			(125)	// longest cross-table 0x03/0x04 read (250 data bytes)
 #define GSEED_DEFAULT				(0xA001)
 #define ERROR_VAL					(0x1)
 #define TX_FIFO_EMPTY_INT			(0x2)
@@ -41,6 +44,16 @@
 #define LINE_STATUS_INT				(0x6)
 #define NOTHING_INT					(0x1)
 #define UART_FIFO_SIZE				(16)
+#define UART_CHAR_BITS				(11)	// start + 8 data + parity/stop + stop
+#define MB_RX_FRAMES				(8)		// frames queued for Modbus_RX (must be a power of two)
+#define MB_T35_MIN_US				(1750)	// fixed t3.5 above 19200 baud (Modbus over serial line)
+#define MB_LAT_BINS					(6)		// turnaround bins: <2,<4,<8,<16,<32,>=32 ms
+#define MB_LAT_BIN0_US				(2000)	// upper edge of the first bin; each bin doubles it
+#define MB_LAT_READ					(0)		// fxn 0x01-0x04
+#define MB_LAT_WRITE				(1)		// fxn 0x05, 0x06, 0x0F, 0x10
+#define MB_LAT_READ_WRITE			(2)		// fxn 0x17
+#define MB_LAT_OTHER				(3)		// PDI commands (65-68) and anything else
+#define MB_LAT_CLASSES				(4)
 #define UART_PARITY_NONE			(0)
 #define UART_PARITY_EVEN			(1)
 #define UART_PARITY_ODD				(2)
@@ -53,6 +66,46 @@
 #define REG_TYPE_LONG_INT			(5)
 #define REG_TYPE_GET_SAMPLE			(6)	// 'fake' type -- denotes we're getting a sample for the cal sw
 #define REG_TYPE_FORCE_SN			(7) // 'fake' type -- denotes that the cal sw requests we change slave address
+#define REG_TYPE_FILE				(8) // 'fake' type -- file record read (0x14) from the history
+#define MB_FILE_HIST_INFO			(1)		// file describing the history
+#define MB_FILE_HIST_DATA			(2)		// first file of history rows
+#define MB_FILE_HIST_ROWS			(10000 / HIST_WORDS)	// history rows per file (records 0-9999)
+#define MB_FILE_INFO_WORDS			(7)
+#define MB_FILE_MAX_RECS			(125)	// most records one 0x14 sub-request can ask for
+#define MB_FILE_FW_INFO				(0x1000)	// firmware transfer: firmwareInfo() (0x14), commands (0x15)
+#define MB_FILE_FW_DATA				(0x1001)	// firmware image: record n = CRC32 + chunk n (0x15)
+#define MB_FILE_PROFILE				(0x1002)	// calibration profile: live (0x14), staged for apply (0x15)
+#define MB_FILE_PROFILE_CTRL		(0x1003)	// profile: apply result (0x14), MB_PROFILE_CMD_APPLY (0x15)
+#define MB_PROFILE_VERSION			(1)
+#define MB_PROFILE_CMD_APPLY		(1)
+#define MB_PROFILE_CTRL_WORDS		(4)
+#define MB_FILE_CATALOG				(0x1004)	// register catalog: MB_Catalog_Word() (0x14)
+#define MB_CATALOG_VERSION			(1)
+#define MB_CATALOG_HDR_WORDS		(4)		// version, entries, words per entry, name bytes
+#define MB_CATALOG_NAME_SIZE		(32)	// bytes, NUL padded
+#define MB_CATALOG_ENTRY_WORDS		(10 + MB_CATALOG_NAME_SIZE/2)
+#define MB_FW_CMD_ABORT				(0)
+#define MB_FW_CMD_BEGIN				(1)			// + image size, image CRC32
+#define MB_FW_CMD_COMMIT			(2)
+#define REG_TYPE_STREAM				(9) // 'fake' type -- the cal sw arms or stops the sample stream
+#define MB_STREAM_FOREVER			(0xFFFFFFFF)	// stream count: until stopped
+#define REG_TYPE_CHANGES			(10) // 'fake' type -- change list since a sequence number
+#define REG_TYPE_BUSY				(11) // 'fake' type -- Server Busy reply, MB_PKT_LIST was full
+#define REG_TYPE_DIAG				(12) // 'fake' type -- diagnostics (0x08) sub-function
+#define REG_TYPE_FILE_WR			(13) // 'fake' type -- file record write (0x15)
+#define REG_TYPE_MIXED				(14) // 'fake' type -- 0x03/0x04 read across tables (see MB_SendPacket_Mixed)
+#define MB_DIAG_QUERY_DATA			(0x00)	// echo the request
+#define MB_DIAG_RESTART				(0x01)	// restart communications: clear the counters
+#define MB_DIAG_CLEAR				(0x0A)	// clear the counters
+#define MB_DIAG_BUS_MSG				(0x0B)	// frames seen on the line
+#define MB_DIAG_BUS_ERR				(0x0C)	// CRC, parity and framing errors
+#define MB_DIAG_EXCEP				(0x0D)	// exception responses sent
+#define MB_DIAG_SRV_MSG				(0x0E)	// requests addressed to this device
+#define MB_DIAG_NO_RESP				(0x0F)	// requests not answered (broadcasts)
+#define MB_DIAG_OVERRUN				(0x12)	// character overruns
+#define MB_DIAG_CLEAR_OVERRUN		(0x14)	// clear the overrun counter
+#define MB_MIRROR_SLOTS				(32)	// mirror block: float registers 501, 503, ... 563
+#define MB_MIRROR_BASE				(501)
 #define PDI_SLAVE_NUM 				(1)
 #define MB_WRITE_QRY				(1)
 #define MB_READ_QRY					(0)
@@ -62,7 +115,9 @@
 #define MB_EXCEP_SLAVE_FAIL			(0x04)
 #define MB_EXCEP_ACK_WAIT			(0x05)
 #define MB_EXCEP_SLAVE_BUSY			(0x06)
+#define MB_CMD_PDI_CHANGES			(65)	// registers changed since a sequence number
 #define MB_CMD_PDI_ANALYZER_SAMPLE	(66)
+#define MB_CMD_PDI_SAMPLE_STREAM	(67)	// arm/stop the sample stream
 #define MB_CMD_PDI_FORCE_SLAVE_PIPE	(68)
 #define MB_BYTE_ORDER_ABCD			(0)
 #define MB_BYTE_ORDER_CDAB			(1)
@@ -75,6 +130,12 @@
 /*============================================================================*/
 /*                             Type Definitions                               */
 /*============================================================================*/
+typedef struct
+{ //transmit driver for complete response frames
+	void (*send)(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n);	// frame includes its CRC
+	void* ctx;	// handed back to send()
+} MB_TX_DRIVER;
+
 typedef struct
 { //modbus packet
 	Uint8	slave;
@@ -82,7 +143,12 @@ typedef struct
 	Uint8	byte_cnt;
 	Uint16	start_reg;
 	Uint16	num_regs;
+	Uint16	wr_start_reg;	// 0x17: registers written before start_reg..num_regs are read
+	Uint16	wr_num_regs;
 	Uint16	CRC;
+	Uint32	rx_ts;			// timestamp of the last byte of the request
+	const MB_TX_DRIVER* tx_drv;	// transport the request came in on
+	Uint32	tx_tag;			// handed back to tx_drv->send() (e.g. MBAP transaction)
 	Uint8	vtune;			// N/A for Razor, but needed for calibration software compatibility
 	Uint8	long_address;	// master packet used long address mode
 	Uint8	is_broadcast;	// received master packet as a broadcast
@@ -102,19 +168,56 @@ typedef struct
 	MB_PKT BFR[MAX_MB_BFR];
 } MODBUS_PACKET_LIST;
 
+typedef struct
+{ //one RTU frame in UART_RXBUF, delimited by line silence
+	Uint32	start;		// UART_RXBUF index of the first byte
+	Uint32	end;		// UART_RXBUF index just past the last byte
+	Uint32	crc_end;	// index just past the last byte that left a zero CRC residue
+	Uint32	end_ts;		// timestamp of the last byte
+	Uint8	is_bad;		// overrun or line error inside the frame
+} MB_RX_FRAME;
+
+typedef struct
+{ //written by Uart_ISR/MB_Frame_Timeout (tail), read by Modbus_RX (head)
+	volatile Uint32	head;
+	volatile Uint32	tail;
+	MB_RX_FRAME BFR[MB_RX_FRAMES];
+} MODBUS_FRAME_LIST;
+
+typedef struct
+{ //link statistics -- read-only long-int registers 333-397, queue_* integer registers 274-276
+	Uint32	frames;			// frames delimited on the line
+	Uint32	responses;		// responses sent, exceptions included
+	Uint32	crc_err;		// requests dropped on a CRC mismatch
+	Uint32	overrun;		// UART or UART_RXBUF overruns
+	Uint32	excep;			// exception responses sent
+	Uint32	foreign;		// frames for other slaves, dropped in Uart_ISR
+	Uint32	served;			// requests for this device with a good CRC
+	Uint32	no_resp;		// requests not answered (broadcasts)
+	Uint32	stream_dropped;	// stream records not sent because the line was busy
+	int		queue_max;		// most requests queued on MB_PKT_LIST at once
+	int		queue_busy;		// requests answered Server Busy, MB_PKT_LIST full
+	int		queue_drop;		// requests dropped, no room even for Server Busy (or broadcast)
+	Uint32	lat_last_us;	// last turnaround: last request byte to first response byte
+	Uint32	lat_max_us;		// longest turnaround
+	Uint32	lat_hist[MB_LAT_CLASSES][MB_LAT_BINS];	// turnarounds per function class and bin
+} MB_STATS;
+
 /*============================================================================*/
 /*                           Function Declarations                            */
 /*============================================================================*/
 
-Uint8 BfrGet(volatile BFR* buffer);
-int BfrPut(volatile BFR* buffer, Uint8 in_byte);
-void Clear_Buffer(BFR* buffer);
 void Reset_Uart_Error_Count(void);
 void Init_PSC(void);
 void delayInt(Uint32 count);
 void Init_PinMux(void);
 void Init_Uart(void);
 void Init_Modbus(void);
+void Init_MB_Tbl_Index(void);
+void MB_Float_Cache_Refresh(void);
+void MB_Mirror_Refresh(void);
+void MB_Change_Scan(void);
+void MB_Stream_Sample(void);
 void Config_Uart(Uint32 baudrate, Uint8 parity);
 void Discard_MB_Pkt_Head(MODBUS_PACKET_LIST* pkt_list);
 void Discard_MB_Pkt_Tail(MODBUS_PACKET_LIST* pkt_list);
@@ -125,7 +228,26 @@ inline Int8 MB_Tbl_Search_FloatRegs(Uint16 reg_num, double** mbtable_ptr, Uint8
 inline Int8 MB_Tbl_Search_LongIntRegs(Uint16 reg_num, double** mbtable_ptr, Uint8 *data_type, Uint8 *prot_status);
 inline Int8 MB_Tbl_Search_CoilRegs(Uint16 reg_num, COIL **mbtable_ptr_coil, Uint8 *data_type, Uint8 *prot_status);
 inline Int8 MB_Tbl_Search_Extended(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type, Uint8 *prot_status);
-unsigned int Calc_CRC(unsigned int* s, unsigned int n,unsigned int wrap_count);
+Uint16 Calc_CRC(const Uint8* s, Uint32 n);
+void Uart_ISR(void);
+void MB_TX_Set_Driver(const MB_TX_DRIVER* drv);
+void MB_Schedule(void);
+void MB_Dispatch(void);
+void MB_SendPacket_Int16(void);
+void MB_SendPacket_Coil(void);
+void MB_SendPacket_LongInt(void);
+void MB_SendPacket_Float(void);
+void MB_SendPacket_Sample(void);
+void MB_SendPacket_Stream(void);
+void MB_SendPacket_ForceSlaveAddr(void);
+void MB_SendPacket_File(void);
+void MB_SendPacket_FileWrite(void);
+void MB_SendPacket_Changes(void);
+void MB_SendPacket_Busy(void);
+void MB_SendPacket_Diag(void);
+void MB_SendPacket_Mixed(void);
+void MB_RX_Submit(const Uint8* frame, Uint32 n, const MB_TX_DRIVER* drv, Uint32 tag);
+void MB_Frame_Timeout(void);
 //static Uint8 MB_Check_Permissions(Uint8 prot, Uint8 is_write_cmd);
 static Uint8 isNoPermission(Uint8 prot, Uint8 is_write_cmd);
 MB_PKT* Create_MB_Pkt(MODBUS_PACKET_LIST* pkt_list, Uint8 sl, Uint8 fx, Uint16 st, Uint16 nu,
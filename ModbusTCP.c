@@ -0,0 +1,168 @@
+/*------------------------------------------------------------------------
+* This Information is proprietary to Phase Dynamics Inc, Richardson, Texas
+* and MAY NOT be copied by any method or incorporated into another program
+* without the express written consent of Phase Dynamics Inc. This information
+* or any portion thereof remains the property of Phase Dynamics Inc.
+* The information contained herein is believed to be accurate and Phase
+* Dynamics Inc assumes no responsibility or liability for its use in any way
+* and conveys no license or title under any patent or copyright and makes
+* no representation or warranty that this Information is free from patent
+* or copyright infringement.
+*
+* Copyright (c) 2018 Phase Dynamics Inc. ALL RIGHTS RESERVED.
+*------------------------------------------------------------------------*/
+
+/*------------------------------------------------------------------------
+* ModbusTCP.c
+*-------------------------------------------------------------------------
+* Modbus TCP (MBAP) framing on top of the request/response code in
+* ModbusRTU.c. Each ADU is turned into an RTU frame addressed to this
+* device and handed to MB_RX_Submit(); the response comes back through
+* the connection's MB_TX_DRIVER, which drops the CRC and puts the MBAP
+* header back. The transaction and unit ids ride along as the request's
+* tag, so every connection can have requests queued at the same time.
+* The TCP stack is not part of this file: whatever owns the sockets calls
+* MBTCP_Open() on accept, feeds received bytes to MBTCP_Receive() and
+* calls MBTCP_Close() when the peer goes away.
+*------------------------------------------------------------------------*/
+
+#include "Globals.h"
+
+static inline Uint16
+MBTCP_Length(const Uint8* mbap)
+{ // unit id + PDU
+	return (mbap[4] << 8) | mbap[5];
+}
+
+/***************************************************************************
+ * MBTCP_Send() - MB_TX_DRIVER.send for one connection
+ * @param tag	- transaction id (bits 31-16) and unit id (bits 7-0)
+ * @param frame	- RTU response: slave, PDU, CRC
+ * Runs in the Swi that built the response, so write() must not block.
+ ***************************************************************************/
+static void
+MBTCP_Send(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n)
+{
+	MBTCP_CONN* c = (MBTCP_CONN*)ctx;
+	Uint32 pdu_n = n - 3;
+
+	if ((c->write != NULL) && (n > 3) && (pdu_n <= MBTCP_PDU_SIZE))
+	{
+		c->tx[0] = (tag >> 24) & 0xFF;		// transaction id
+		c->tx[1] = (tag >> 16) & 0xFF;
+		c->tx[2] = 0;						// protocol id
+		c->tx[3] = 0;
+		c->tx[4] = ((pdu_n + 1) >> 8) & 0xFF;	// length
+		c->tx[5] = (pdu_n + 1) & 0xFF;
+		c->tx[6] = tag & 0xFF;				// unit id
+		memcpy(&c->tx[MBTCP_MBAP_SIZE], &frame[1], pdu_n);
+
+		c->write(c->sock, c->tx, MBTCP_MBAP_SIZE + pdu_n);
+	}
+
+	// nothing went to UART2; leave the flag to MB_PacketDone if the line is busy
+	if (Ring_Count(&UART_TXBUF) == 0)
+	{
+		MB_TX_IN_PROGRESS = FALSE;
+		MB_Schedule();
+	}
+}
+
+static void
+MBTCP_Request(MBTCP_CONN* c)
+{
+	Uint8	frame[1 + MBTCP_PDU_SIZE + 2];
+	Uint32	pdu_n, tag;
+	Uint16	CRC;
+
+	pdu_n = MBTCP_Length(c->rx) - 1;
+
+	// the unit id is only echoed; a TCP request is always for this device
+	frame[0] = (Uint8)REG_SLAVE_ADDRESS;
+	memcpy(&frame[1], &c->rx[MBTCP_MBAP_SIZE], pdu_n);
+
+	CRC = Calc_CRC(frame, pdu_n + 1);
+	frame[pdu_n + 1] = CRC & 0xFF;	// LSB
+	frame[pdu_n + 2] = CRC >> 8;	// MSB
+
+	tag = ((Uint32)c->rx[0] << 24) | ((Uint32)c->rx[1] << 16) | c->rx[6];
+
+	MB_RX_Submit(frame, pdu_n + 3, &c->drv, tag);
+}
+
+/***************************************************************************
+ * MBTCP_Open() - start serving a client connection
+ * @param write	- sends one ADU to the client; called from Swi context
+ * @param sock	- handed back to write()
+ * c has to stay allocated until every request it submitted is answered,
+ * even after MBTCP_Close().
+ ***************************************************************************/
+void
+MBTCP_Open(MBTCP_CONN* c, void (*write)(void* sock, const Uint8* adu, Uint32 n), void* sock)
+{
+	c->drv.send = MBTCP_Send;
+	c->drv.ctx 	= c;
+	c->sock 	= sock;
+	c->rx_n 	= 0;
+	c->write 	= write;
+}
+
+void
+MBTCP_Close(MBTCP_CONN* c)
+{ // responses still queued for c are dropped
+	c->write = NULL;
+	c->rx_n = 0;
+}
+
+/***************************************************************************
+ * MBTCP_Receive()
+ * @param bytes	- received from the client; ADUs may be split or run
+ * 				  together in any way
+ * A header that is not Modbus (protocol id 0, sane length) throws away
+ * everything up to the end of this call, since there is no way to find
+ * the next ADU in the stream after it.
+ ***************************************************************************/
+void
+MBTCP_Receive(MBTCP_CONN* c, const Uint8* bytes, Uint32 n)
+{
+	Uint32 adu_n, take, len;
+
+	while (n > 0)
+	{
+		if (c->rx_n < MBTCP_MBAP_SIZE)
+			adu_n = MBTCP_MBAP_SIZE;
+		else
+			adu_n = MBTCP_MBAP_SIZE - 1 + MBTCP_Length(c->rx);
+
+		take = adu_n - c->rx_n;
+		if (take > n)
+			take = n;
+
+		memcpy(&c->rx[c->rx_n], bytes, take);
+		c->rx_n += take;
+		bytes 	+= take;
+		n 		-= take;
+
+		if (c->rx_n < MBTCP_MBAP_SIZE)
+			break;
+
+		len = MBTCP_Length(c->rx);
+
+		if (c->rx_n == MBTCP_MBAP_SIZE)
+		{ // header complete
+			if ( (c->rx[2] != 0) || (c->rx[3] != 0) || (len < 2) || (len > MBTCP_PDU_SIZE + 1) )
+			{
+				STAT_CURRENT = 1;
+				STAT_PKT++;
+				c->rx_n = 0;
+				return;
+			}
+		}
+
+		if (c->rx_n == MBTCP_MBAP_SIZE - 1 + len)
+		{
+			MBTCP_Request(c);
+			c->rx_n = 0;
+		}
+	}
+}
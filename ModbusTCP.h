@@ -0,0 +1,28 @@
+/*************************************************/
+/*  ModbusTCP.c					 */
+/*  Copyright 2018, Phase Dynamics Inc.		 */
+/*************************************************/
+
+#ifndef MODBUSTCP_H_
+#define MODBUSTCP_H_
+
+#define MBTCP_PORT			(502)
+#define MBTCP_MBAP_SIZE		(7)		// transaction(2) protocol(2) length(2) unit(1)
+#define MBTCP_PDU_SIZE		(253)
+#define MBTCP_ADU_SIZE		(MBTCP_MBAP_SIZE + MBTCP_PDU_SIZE)
+
+typedef struct
+{ //one Modbus TCP client connection
+	MB_TX_DRIVER	drv;	// responses to this connection's requests (drv.ctx = this)
+	void			(*write)(void* sock, const Uint8* adu, Uint32 n);	// NULL once closed
+	void*			sock;	// handed back to write()
+	Uint32			rx_n;	// bytes of the next ADU received so far
+	Uint8			rx[MBTCP_ADU_SIZE];
+	Uint8			tx[MBTCP_ADU_SIZE];
+} MBTCP_CONN;
+
+void MBTCP_Open(MBTCP_CONN* c, void (*write)(void* sock, const Uint8* adu, Uint32 n), void* sock);
+void MBTCP_Close(MBTCP_CONN* c);
+void MBTCP_Receive(MBTCP_CONN* c, const Uint8* bytes, Uint32 n);
+
+#endif /* MODBUSTCP_H_ */
@@ -22,6 +22,14 @@
 #define REGTYPE_BOUND_LO	13	// Address of an VAR's lower bound value
 #define REGTYPE_ALARM_HI	14	// Address of an VAR's upper alarm value
 #define REGTYPE_ALARM_LO	15	// Address of an VAR's lower alarm value
+#define REGTYPE_CHAR		16	// Address of a char array, one character per register (extended table only)
+
+#include <stdint.h>
+
+typedef uintptr_t MB_TBL_CELL;	// holds an address; a Uint32 on the C6748, wider on a 64-bit host (tests/host)
+
+#define MB_TBL_COLS			5	// #, function, R/W protection, variable address, name
+#define MB_VAR(v)			(MB_TBL_CELL)&v, (MB_TBL_CELL)#v	// variable address and its name for the register catalog
 
 /////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +39,7 @@
 ///   0 - 200   : FLOAT or DOUBLE
 /// 201 - 300   : INTEGER
 /// 301 - 60K   : LONG INTEGER
+/// 501 - 563   : FLOAT, read-only mirror of the registers listed at 241 - 272
 /// 60K         : EXTENDED ARRAY TYPE
 /////////////////////////////////////////////////////////////////////////////////////
 /// FACTORY REGISTERS & COILS
@@ -39,304 +48,420 @@
 /////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////
 
-const Uint32 MB_TBL_FLOAT[][4] = {
+const MB_TBL_CELL MB_TBL_FLOAT[][MB_TBL_COLS] = {
 
 ///-----------------------------------------------------------------------------
-///  #	,	function	,	R/W protection	,	variable address
+///  #	,	function	,	R/W protection	,	variable address, name
 ///-----------------------------------------------------------------------------
 
-	1	, 	REGTYPE_DBL	,	REGPERM_READ_O 	,	(Uint32)&RESERVED_1, 			// RESERVED
-	3	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_WATERCUT,			// Watercut
-	5	, 	REGTYPE_VAR	,	REGPERM_READ_O 	,	(Uint32)&REG_TEMPERATURE,		// Temperature
-	7	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_EMULSION_PHASE,	// Emulstion Phase
-	9	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_SALINITY,			// Salinity
-	11	,   REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&REG_HARDWARE_VERSION,	// Hardware Version
-	13	,   REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&REG_FIRMWARE_VERSION,	// Firmware Version
-	15	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_ADJUST,		// Oil Adjust
-	17	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_WATER_ADJUST,		// Water Adjust
-	19	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_FREQ,				// oscillator frequency
-	21	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_FREQ_AVG,			// average frequency
-	23	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_WATERCUT_AVG,		// average watercut
-	25	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&REG_WATERCUT_RAW,		// average RAW watercut
-	27	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_27,		    // RESERVED 
-	29	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_TEMP_AVG,			// average temperature (NOT YET IMPLEMENTED)
-	31	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_TEMP_ADJUST,		// temperature adjust
-	33	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_TEMP_USER,			// REG_TEMPERATURE + REG_TEMP_ADJUST
-	35	, 	REGTYPE_VAR ,	REGPERM_PASSWD	,	(Uint32)&REG_PROC_AVGING,		// all average variables: number of seconds to average over
-	37	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_INDEX,			//
-	39	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_P0,			//
-	41	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_P1,			//
-	43	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_FREQ_LOW,		//
-	45	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_FREQ_HIGH,		//
-	47	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_SAMPLE_PERIOD,		//
-	49	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_AO_LRV,			//
-	51	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_AO_URV,			//
-	53	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_53,			//
-	55	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_BAUD_RATE,			//
-	57	, 	REGTYPE_DBL	,	REGPERM_FCT 	,	(Uint32)&REG_SALINITY_CURVES,   //
-	59	, 	REGTYPE_DBL	,	REGPERM_FCT 	,	(Uint32)&REG_WATER_CURVES,		//
-	61	,   REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&REG_OIL_RP,			//
-	63	,   REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&REG_WATER_RP,			//
-	65	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_65,   		//
-	67	, 	REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_CALC_MAX,		// maximum watercut (for oil phase)
-	69	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_PHASE_CUTOFF,	// oil curve switch-over threshold
-	71	,   REGTYPE_DBL	,	REGPERM_FCT	    ,	(Uint32)&REG_TEMP_OIL_NUM_CURVES,//number of temperature curves
-	73	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_STREAM,			// stream select
-	75	,   REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&REG_OIL_RP_AVG,		// average reflected power (oil)
-	77	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_PLACE_HOLDER,	    // 
-	79	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_SAMPLE,		// Upon writing: calibrates oil adjust to yield given WC value
-	81	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_81,			// RTC current value, read-only: seconds
-	83	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_83,			// RTC current value, read-only: minutes
-	85	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_85,			// RTC current value, read-only: hours
-	87	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_87,			// RTC current value, read-only: day
-	89	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_89,			// RTC current value, read-only: month
-	91	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_91,			// RTC current value, read-only: year
-	93	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_93,		    // RTC input: seconds (see: COIL_WRITE_RTC)
-	95	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_95,		    // RTC input: minutes (see: COIL_WRITE_RTC)
-	97	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_97,			// RTC input: hours (see: COIL_WRITE_RTC)
-	99	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_99,		    // RTC input: day (see: COIL_WRITE_RTC)
-	101	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_101,		    // RTC input: month (see: COIL_WRITE_RTC)
-	103	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_103,			// RTC input: year (see: COIL_WRITE_RTC)
-	105	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_AO_MANUAL_VAL,		// Analog output value for MANUAL mode, as a percentage (e.g. 25% = 8mA)
-	107	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_AO_TRIMLO,		    // User-inputed measure of actual output current (4mA)
-	109	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_AO_TRIMHI,		    // User-inputed measure of actual output current (20mA)
-	111	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_DENSITY_ADJ,		// oil density offset
-	113	,   REGTYPE_SWI ,	REGPERM_PASSWD	,	(Uint32)&REG_DENSITY_UNIT,		// oil density units i.e. kg/m^3@15C -or- API@60F
-	115	,   REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&REG_DENS_CORR,		// adjustment to the watercut based on density correction
-	117	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_DENSITY_D3,		// density correction third-order coefficient -- not used
-	119	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_DENSITY_D2,		// density correction second-order coefficient
-	121	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_DENSITY_D1,		// density correction first-order coefficient
-	123	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_DENSITY_D0,		// density correction zeroth-order coefficient
-	125	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_DENSITY_CAL_VAL,	// density correction calibration value; default=32
-	127	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_127,		    // Fields A-D (ascii)
-	129	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_129,		    // Fields E-H (ascii)
-	131	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_131,		    // Fields I-L (ascii)
-	133	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_133,		    // Fields M-P (ascii)
-	135	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_135,	        // Loggin Period
-	137	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_137,			// Razor global password
-	139	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_139,		    // Statistics
-	141 , 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_141,		    // Active Error Count
-	143	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_143,	    	// AO alarm mode
-	145	,   REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&REG_AO_OUTPUT,			// User-inputed measure of actual output current (4mA)
-	147	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_147,	        // Phase hold over
-	149	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_149,		    // Relay Delay
-	151	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_RELAY_SETPOINT,	// Relay Setpoint
-	153	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	(Uint32)&RESERVED_153,			// AO mode
-	155	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	(Uint32)&REG_OIL_DENSITY,		// Oil Density main register
-	157	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_DENSITY_MODBUS,// density value in modbus input - intermediate scalar value
-	159	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_DENSITY_AI,	// density value in Analog input - intermediate scalar value
-	161	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_DENSITY_MANUAL,// density value in manual - intermediate scalar value
-	163	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_DENSITY_AI_LRV,// AI LRV
-	165	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	(Uint32)&REG_OIL_DENSITY_AI_URV,// AI URV
-	167	, 	REGTYPE_DBL	,	REGPERM_READ_O 	,	(Uint32)&RESERVED_167,          // Disabled, Ai, Modbus, Manual
-	169	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_AI_TRIMLO,			// Trimmed Analog Input (4mA)
-	171	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_AI_TRIMHI,			// Trimmed Analog Input (20mA)
-	173	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_AI_MEASURE,		// Measured Analog Input
-	175	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	(Uint32)&REG_AI_TRIMMED,		// Trimmed Analog Input
-    177 ,   REGTYPE_DBL ,   REGPERM_PASSWD  ,   (Uint32)&REG_DENS_ADJ,          // Density Adjustment
-    179 ,   REGTYPE_VAR ,   REGPERM_PASSWD  ,   (Uint32)&REG_OIL_T0,            // T0 for threshold
-    181 ,   REGTYPE_VAR ,   REGPERM_PASSWD  ,   (Uint32)&REG_OIL_T1,            // T1 for threshold
-    183 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   (Uint32)&REG_OIL_PT,            // OIL RP THRESHOLD
-
-	701	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_SALINITY,			// Salinity
-	703	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_ADJUST,		// Oil Adjust
-	705	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_WATER_ADJUST,		// Water Adjust
-	707	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_TEMP_ADJUST,		// temperature adjust
-	709	, 	REGTYPE_VAR ,	REGPERM_FCT	,	(Uint32)&FCT_PROC_AVGING,		// all average variables: number of seconds to average over
-	711	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_INDEX,			//
-	713	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_P0,			//
-	715	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_P1,			//
-	717	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_FREQ_LOW,		//
-	719	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_FREQ_HIGH,		//
-	721	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_SAMPLE_PERIOD,		//
-	723	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_AO_LRV,			//
-	725	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_AO_URV,			//
-	727	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_BAUD_RATE,			//
-	729	, 	REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_CALC_MAX,		// maximum watercut (for oil phase)
-	731	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_PHASE_CUTOFF,	// oil curve switch-over threshold
-	733	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_STREAM,			// stream select
-	735	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_SAMPLE,		// Upon writing: calibrates oil adjust to yield given WC value
-	737	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_AO_MANUAL_VAL,		// Analog output value for MANUAL mode, as a percentage (e.g. 25% = 8mA)
-	739	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_AO_TRIMLO,		    // User-inputed measure of actual output current (4mA)
-	741	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_AO_TRIMHI,		    // User-inputed measure of actual output current (20mA)
-	743	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_DENSITY_ADJ,		// oil density offset
-	745	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_DENSITY_D3,		// density correction third-order coefficient -- not used
-	747	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_DENSITY_D2,		// density correction second-order coefficient
-	749	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_DENSITY_D1,		// density correction first-order coefficient
-	751	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_DENSITY_D0,		// density correction zeroth-order coefficient
-	753	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_DENSITY_CAL_VAL,	// density correction calibration value; default=32
-	755	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_RELAY_SETPOINT,	// Relay Setpoint
-	757	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_DENSITY_MODBUS,// density value in modbus input - intermediate scalar value
-	759	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_DENSITY_AI,	// density value in Analog input - intermediate scalar value
-	761	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_DENSITY_MANUAL,// density value in manual - intermediate scalar value
-	763	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_DENSITY_AI_LRV,// AI LRV
-	765	, 	REGTYPE_VAR	,	REGPERM_FCT	,	(Uint32)&FCT_OIL_DENSITY_AI_URV,// AI URV
-	767	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_AI_TRIMLO,			// Trimmed Analog Input (4mA)
-	769	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_AI_TRIMHI,			// Trimmed Analog Input (20mA)
-	771	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_AI_MEASURE,		// Measured Analog Input
-	773	,   REGTYPE_DBL	,	REGPERM_FCT	,	(Uint32)&FCT_AI_TRIMMED,		// Trimmed Analog Input
-    775 ,   REGTYPE_DBL ,   REGPERM_FCT ,   (Uint32)&FCT_DENS_ADJ,          // Density Adjustment
-    777 ,   REGTYPE_VAR ,   REGPERM_FCT ,   (Uint32)&FCT_OIL_T0,            // T0 for threshold
-    779 ,   REGTYPE_VAR ,   REGPERM_FCT ,   (Uint32)&FCT_OIL_T1,            // T1 for threshold
-    781 ,   REGTYPE_DBL ,   REGPERM_FCT ,   (Uint32)&PDI_TEMP_ADJ,          // PDI factory temp adjust - no FCT_ exists
-    783 ,   REGTYPE_DBL ,   REGPERM_FCT ,   (Uint32)&PDI_FREQ_F0,           // PDI factory freq adjust - no FCT_ exists
-    785 ,   REGTYPE_DBL ,   REGPERM_FCT ,   (Uint32)&PDI_FREQ_F1,           // PDI factory freq adjust - no FCT_ exists
-
-	0	, 	0			, 	0			, 	0
+	1	, 	REGTYPE_DBL	,	REGPERM_READ_O 	,	MB_VAR(RESERVED_1), 			// RESERVED
+	3	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_WATERCUT),			// Watercut
+	5	, 	REGTYPE_VAR	,	REGPERM_READ_O 	,	MB_VAR(REG_TEMPERATURE),		// Temperature
+	7	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_EMULSION_PHASE),	// Emulstion Phase
+	9	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_SALINITY),			// Salinity
+	11	,   REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(REG_HARDWARE_VERSION),	// Hardware Version
+	13	,   REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(REG_FIRMWARE_VERSION),	// Firmware Version
+	15	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_ADJUST),		// Oil Adjust
+	17	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_WATER_ADJUST),		// Water Adjust
+	19	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_FREQ),				// oscillator frequency
+	21	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_FREQ_AVG),			// average frequency
+	23	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_WATERCUT_AVG),		// average watercut
+	25	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(REG_WATERCUT_RAW),		// average RAW watercut
+	27	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_27),		    // RESERVED 
+	29	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_TEMP_AVG),			// average temperature (NOT YET IMPLEMENTED)
+	31	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_TEMP_ADJUST),		// temperature adjust
+	33	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_TEMP_USER),			// REG_TEMPERATURE + REG_TEMP_ADJUST
+	35	, 	REGTYPE_VAR ,	REGPERM_PASSWD	,	MB_VAR(REG_PROC_AVGING),		// all average variables: number of seconds to average over
+	37	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_INDEX),			//
+	39	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_P0),			//
+	41	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_P1),			//
+	43	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_FREQ_LOW),		//
+	45	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_FREQ_HIGH),		//
+	47	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_SAMPLE_PERIOD),		//
+	49	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_AO_LRV),			//
+	51	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_AO_URV),			//
+	53	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_53),			//
+	55	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_BAUD_RATE),			//
+	57	, 	REGTYPE_DBL	,	REGPERM_FCT 	,	MB_VAR(REG_SALINITY_CURVES),   //
+	59	, 	REGTYPE_DBL	,	REGPERM_FCT 	,	MB_VAR(REG_WATER_CURVES),		//
+	61	,   REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(REG_OIL_RP),			//
+	63	,   REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(REG_WATER_RP),			//
+	65	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_65),   		//
+	67	, 	REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_CALC_MAX),		// maximum watercut (for oil phase)
+	69	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_PHASE_CUTOFF),	// oil curve switch-over threshold
+	71	,   REGTYPE_DBL	,	REGPERM_FCT	    ,	MB_VAR(REG_TEMP_OIL_NUM_CURVES),//number of temperature curves
+	73	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_STREAM),			// stream select
+	75	,   REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(REG_OIL_RP_AVG),		// average reflected power (oil)
+	77	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_PLACE_HOLDER),	    // 
+	79	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_SAMPLE),		// Upon writing: calibrates oil adjust to yield given WC value
+	81	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_81),			// RTC current value, read-only: seconds
+	83	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_83),			// RTC current value, read-only: minutes
+	85	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_85),			// RTC current value, read-only: hours
+	87	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_87),			// RTC current value, read-only: day
+	89	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_89),			// RTC current value, read-only: month
+	91	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_91),			// RTC current value, read-only: year
+	93	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_93),		    // RTC input: seconds (see: COIL_WRITE_RTC)
+	95	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_95),		    // RTC input: minutes (see: COIL_WRITE_RTC)
+	97	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_97),			// RTC input: hours (see: COIL_WRITE_RTC)
+	99	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_99),		    // RTC input: day (see: COIL_WRITE_RTC)
+	101	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_101),		    // RTC input: month (see: COIL_WRITE_RTC)
+	103	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_103),			// RTC input: year (see: COIL_WRITE_RTC)
+	105	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_AO_MANUAL_VAL),		// Analog output value for MANUAL mode, as a percentage (e.g. 25% = 8mA)
+	107	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_AO_TRIMLO),		    // User-inputed measure of actual output current (4mA)
+	109	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_AO_TRIMHI),		    // User-inputed measure of actual output current (20mA)
+	111	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_DENSITY_ADJ),		// oil density offset
+	113	,   REGTYPE_SWI ,	REGPERM_PASSWD	,	MB_VAR(REG_DENSITY_UNIT),		// oil density units i.e. kg/m^3@15C -or- API@60F
+	115	,   REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(REG_DENS_CORR),		// adjustment to the watercut based on density correction
+	117	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_DENSITY_D3),		// density correction third-order coefficient -- not used
+	119	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_DENSITY_D2),		// density correction second-order coefficient
+	121	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_DENSITY_D1),		// density correction first-order coefficient
+	123	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_DENSITY_D0),		// density correction zeroth-order coefficient
+	125	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_DENSITY_CAL_VAL),	// density correction calibration value; default=32
+	127	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_127),		    // Fields A-D (ascii)
+	129	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_129),		    // Fields E-H (ascii)
+	131	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_131),		    // Fields I-L (ascii)
+	133	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_133),		    // Fields M-P (ascii)
+	135	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_135),	        // Loggin Period
+	137	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_137),			// Razor global password
+	139	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_139),		    // Statistics
+	141 , 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_141),		    // Active Error Count
+	143	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_143),	    	// AO alarm mode
+	145	,   REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(REG_AO_OUTPUT),			// User-inputed measure of actual output current (4mA)
+	147	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_147),	        // Phase hold over
+	149	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_149),		    // Relay Delay
+	151	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_RELAY_SETPOINT),	// Relay Setpoint
+	153	, 	REGTYPE_DBL	,	REGPERM_READ_O	,	MB_VAR(RESERVED_153),			// AO mode
+	155	, 	REGTYPE_VAR	,	REGPERM_READ_O	,	MB_VAR(REG_OIL_DENSITY),		// Oil Density main register
+	157	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_DENSITY_MODBUS),// density value in modbus input - intermediate scalar value
+	159	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_DENSITY_AI),	// density value in Analog input - intermediate scalar value
+	161	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_DENSITY_MANUAL),// density value in manual - intermediate scalar value
+	163	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_DENSITY_AI_LRV),// AI LRV
+	165	, 	REGTYPE_VAR	,	REGPERM_PASSWD	,	MB_VAR(REG_OIL_DENSITY_AI_URV),// AI URV
+	167	, 	REGTYPE_DBL	,	REGPERM_READ_O 	,	MB_VAR(RESERVED_167),          // Disabled, Ai, Modbus, Manual
+	169	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_AI_TRIMLO),			// Trimmed Analog Input (4mA)
+	171	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_AI_TRIMHI),			// Trimmed Analog Input (20mA)
+	173	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_AI_MEASURE),		// Measured Analog Input
+	175	,   REGTYPE_DBL	,	REGPERM_PASSWD	,	MB_VAR(REG_AI_TRIMMED),		// Trimmed Analog Input
+    177 ,   REGTYPE_DBL ,   REGPERM_PASSWD  ,   MB_VAR(REG_DENS_ADJ),          // Density Adjustment
+    179 ,   REGTYPE_VAR ,   REGPERM_PASSWD  ,   MB_VAR(REG_OIL_T0),            // T0 for threshold
+    181 ,   REGTYPE_VAR ,   REGPERM_PASSWD  ,   MB_VAR(REG_OIL_T1),            // T1 for threshold
+    183 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(REG_OIL_PT),            // OIL RP THRESHOLD
+
+    501 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[0]),         // mirror of REG_MIRROR_SRC[0]
+    503 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[1]),         // mirror of REG_MIRROR_SRC[1]
+    505 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[2]),         // mirror of REG_MIRROR_SRC[2]
+    507 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[3]),         // mirror of REG_MIRROR_SRC[3]
+    509 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[4]),         // mirror of REG_MIRROR_SRC[4]
+    511 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[5]),         // mirror of REG_MIRROR_SRC[5]
+    513 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[6]),         // mirror of REG_MIRROR_SRC[6]
+    515 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[7]),         // mirror of REG_MIRROR_SRC[7]
+    517 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[8]),         // mirror of REG_MIRROR_SRC[8]
+    519 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[9]),         // mirror of REG_MIRROR_SRC[9]
+    521 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[10]),        // mirror of REG_MIRROR_SRC[10]
+    523 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[11]),        // mirror of REG_MIRROR_SRC[11]
+    525 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[12]),        // mirror of REG_MIRROR_SRC[12]
+    527 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[13]),        // mirror of REG_MIRROR_SRC[13]
+    529 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[14]),        // mirror of REG_MIRROR_SRC[14]
+    531 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[15]),        // mirror of REG_MIRROR_SRC[15]
+    533 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[16]),        // mirror of REG_MIRROR_SRC[16]
+    535 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[17]),        // mirror of REG_MIRROR_SRC[17]
+    537 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[18]),        // mirror of REG_MIRROR_SRC[18]
+    539 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[19]),        // mirror of REG_MIRROR_SRC[19]
+    541 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[20]),        // mirror of REG_MIRROR_SRC[20]
+    543 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[21]),        // mirror of REG_MIRROR_SRC[21]
+    545 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[22]),        // mirror of REG_MIRROR_SRC[22]
+    547 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[23]),        // mirror of REG_MIRROR_SRC[23]
+    549 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[24]),        // mirror of REG_MIRROR_SRC[24]
+    551 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[25]),        // mirror of REG_MIRROR_SRC[25]
+    553 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[26]),        // mirror of REG_MIRROR_SRC[26]
+    555 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[27]),        // mirror of REG_MIRROR_SRC[27]
+    557 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[28]),        // mirror of REG_MIRROR_SRC[28]
+    559 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[29]),        // mirror of REG_MIRROR_SRC[29]
+    561 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[30]),        // mirror of REG_MIRROR_SRC[30]
+    563 ,   REGTYPE_DBL ,   REGPERM_READ_O  ,   MB_VAR(MB_MIRROR[31]),        // mirror of REG_MIRROR_SRC[31]
+
+	701	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_SALINITY),			// Salinity
+	703	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_ADJUST),		// Oil Adjust
+	705	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_WATER_ADJUST),		// Water Adjust
+	707	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_TEMP_ADJUST),		// temperature adjust
+	709	, 	REGTYPE_VAR ,	REGPERM_FCT	,	MB_VAR(FCT_PROC_AVGING),		// all average variables: number of seconds to average over
+	711	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_INDEX),			//
+	713	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_P0),			//
+	715	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_P1),			//
+	717	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_FREQ_LOW),		//
+	719	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_FREQ_HIGH),		//
+	721	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_SAMPLE_PERIOD),		//
+	723	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_AO_LRV),			//
+	725	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_AO_URV),			//
+	727	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_BAUD_RATE),			//
+	729	, 	REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_CALC_MAX),		// maximum watercut (for oil phase)
+	731	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_PHASE_CUTOFF),	// oil curve switch-over threshold
+	733	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_STREAM),			// stream select
+	735	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_SAMPLE),		// Upon writing: calibrates oil adjust to yield given WC value
+	737	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_AO_MANUAL_VAL),		// Analog output value for MANUAL mode, as a percentage (e.g. 25% = 8mA)
+	739	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_AO_TRIMLO),		    // User-inputed measure of actual output current (4mA)
+	741	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_AO_TRIMHI),		    // User-inputed measure of actual output current (20mA)
+	743	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_DENSITY_ADJ),		// oil density offset
+	745	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_DENSITY_D3),		// density correction third-order coefficient -- not used
+	747	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_DENSITY_D2),		// density correction second-order coefficient
+	749	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_DENSITY_D1),		// density correction first-order coefficient
+	751	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_DENSITY_D0),		// density correction zeroth-order coefficient
+	753	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_DENSITY_CAL_VAL),	// density correction calibration value; default=32
+	755	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_RELAY_SETPOINT),	// Relay Setpoint
+	757	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_DENSITY_MODBUS),// density value in modbus input - intermediate scalar value
+	759	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_DENSITY_AI),	// density value in Analog input - intermediate scalar value
+	761	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_DENSITY_MANUAL),// density value in manual - intermediate scalar value
+	763	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_DENSITY_AI_LRV),// AI LRV
+	765	, 	REGTYPE_VAR	,	REGPERM_FCT	,	MB_VAR(FCT_OIL_DENSITY_AI_URV),// AI URV
+	767	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_AI_TRIMLO),			// Trimmed Analog Input (4mA)
+	769	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_AI_TRIMHI),			// Trimmed Analog Input (20mA)
+	771	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_AI_MEASURE),		// Measured Analog Input
+	773	,   REGTYPE_DBL	,	REGPERM_FCT	,	MB_VAR(FCT_AI_TRIMMED),		// Trimmed Analog Input
+    775 ,   REGTYPE_DBL ,   REGPERM_FCT ,   MB_VAR(FCT_DENS_ADJ),          // Density Adjustment
+    777 ,   REGTYPE_VAR ,   REGPERM_FCT ,   MB_VAR(FCT_OIL_T0),            // T0 for threshold
+    779 ,   REGTYPE_VAR ,   REGPERM_FCT ,   MB_VAR(FCT_OIL_T1),            // T1 for threshold
+    781 ,   REGTYPE_DBL ,   REGPERM_FCT ,   MB_VAR(PDI_TEMP_ADJ),          // PDI factory temp adjust - no FCT_ exists
+    783 ,   REGTYPE_DBL ,   REGPERM_FCT ,   MB_VAR(PDI_FREQ_F0),           // PDI factory freq adjust - no FCT_ exists
+    785 ,   REGTYPE_DBL ,   REGPERM_FCT ,   MB_VAR(PDI_FREQ_F1),           // PDI factory freq adjust - no FCT_ exists
+
+	0	, 	0			, 	0			, 	0	,	0
 };
 
- const Uint32 MB_TBL_INT[][4] = {
+ const MB_TBL_CELL MB_TBL_INT[][MB_TBL_COLS] = {
 
 ///-----------------------------------------------------------------------------
-///  #	,	function	,	R/W protection	,	variable address
+///  #	,	function	,	R/W protection	,	variable address, name
 ///-----------------------------------------------------------------------------
 
-    201 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&REG_SN_PIPE,           // serial number of the pipe
-    202 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_ANALYZER_MODE,     // presumably there will be multiple versions of the Razor in the future
-    203 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_AO_DAMPEN,         //
-    204 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_SLAVE_ADDRESS,     //  
-    205 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_STOP_BITS,         //
-    206 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_DENSITY_MODE,      //  
-    207 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   (Uint32)&TMP_RTC_SEC,           // RTC current value, read-only: seconds
-    208 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   (Uint32)&TMP_RTC_MIN,           // RTC current value, read-only: minutes
-    209 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   (Uint32)&TMP_RTC_HR,            // RTC current value, read-only: hours
-    210 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   (Uint32)&TMP_RTC_DAY,           // RTC current value, read-only: day 
-    211 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   (Uint32)&TMP_RTC_MON,           // RTC current value, read-only: month
-    212 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   (Uint32)&TMP_RTC_YR,            // RTC current value, read-only: year
-    213 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&TMP_RTC_SEC_IN,        // RTC input: seconds (see: COIL_WRITE_RTC)
-    214 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&TMP_RTC_MIN_IN,        // RTC input: minutes (see: COIL_WRITE_RTC)
-    215 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&TMP_RTC_HR_IN,         // RTC input: hours (see: COIL_WRITE_RTC)
-    216 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&TMP_RTC_DAY_IN,        // RTC input: day (see: COIL_WRITE_RTC)
-    217 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&TMP_RTC_MON_IN,        // RTC input: month (see: COIL_WRITE_RTC)
-    218 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&TMP_RTC_YR_IN,         // RTC input: year (see: COIL_WRITE_RTC)
-    219 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&REG_MODEL_CODE[0],     // Fields A-D (ascii)
-    220 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&REG_MODEL_CODE[1],     // Fields E-H (ascii)
-    221 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&REG_MODEL_CODE[2],     // Fields I-L (ascii)
-    222 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&REG_MODEL_CODE[3],     // Fields M-P (ascii)
-    223 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_LOGGING_PERIOD,    // Loggin Period
-    224 ,   REGTYPE_INT ,   REGPERM_WRITE_O ,   (Uint32)&REG_PASSWORD,          // Razor global password
-    225 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_STATISTICS,        // Statistics
-    226 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_ACTIVE_ERROR,      // Active Error Count
-    227 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_AO_ALARM_MODE,     // AO alarm mode
-    228 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_PHASE_HOLD_CYCLES, // Phase hold over
-    229 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_RELAY_DELAY,       // Relay Delay
-    230 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_AO_MODE,           // AO mode
-    231 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_OIL_DENS_CORR_MODE,// Disabled, Ai, Modbus, Manual
-    232 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   (Uint32)&REG_RELAY_MODE,        // relay mode
-    233 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   (Uint32)&REG_DIAGNOSTICS,       // diagnostics 
-    234 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&REG_USB_TRY,           // MAX_USB_TRY 
-
-    402 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_AO_DAMPEN,         //
-    403 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_SLAVE_ADDRESS,     //  
-    404 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_STOP_BITS,         //
-    405 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_DENSITY_MODE,      //  
-    406 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_LOGGING_PERIOD,    // Loggin Period
-    407 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_STATISTICS,        // Statistics
-    408 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_ACTIVE_ERROR,      // Active Error Count
-    409 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_AO_ALARM_MODE,     // AO alarm mode
-    410 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_PHASE_HOLD_CYCLES, // Phase hold over
-    411 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_RELAY_DELAY,       // Relay Delay
-    412 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_AO_MODE,           // AO mode
-    413 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_OIL_DENS_CORR_MODE,// Disabled, Ai, Modbus, Manual
-    414 ,   REGTYPE_INT ,   REGPERM_FCT     ,   (Uint32)&FCT_RELAY_MODE,        // relay mode
-
-	0	, 	0			, 	0					, 	0
+    201 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(REG_SN_PIPE),           // serial number of the pipe
+    202 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_ANALYZER_MODE),     // presumably there will be multiple versions of the Razor in the future
+    203 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_AO_DAMPEN),         //
+    204 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_SLAVE_ADDRESS),     //  
+    205 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_STOP_BITS),         //
+    206 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_DENSITY_MODE),      //  
+    207 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(TMP_RTC_SEC),           // RTC current value, read-only: seconds
+    208 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(TMP_RTC_MIN),           // RTC current value, read-only: minutes
+    209 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(TMP_RTC_HR),            // RTC current value, read-only: hours
+    210 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(TMP_RTC_DAY),           // RTC current value, read-only: day 
+    211 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(TMP_RTC_MON),           // RTC current value, read-only: month
+    212 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(TMP_RTC_YR),            // RTC current value, read-only: year
+    213 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(TMP_RTC_SEC_IN),        // RTC input: seconds (see: COIL_WRITE_RTC)
+    214 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(TMP_RTC_MIN_IN),        // RTC input: minutes (see: COIL_WRITE_RTC)
+    215 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(TMP_RTC_HR_IN),         // RTC input: hours (see: COIL_WRITE_RTC)
+    216 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(TMP_RTC_DAY_IN),        // RTC input: day (see: COIL_WRITE_RTC)
+    217 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(TMP_RTC_MON_IN),        // RTC input: month (see: COIL_WRITE_RTC)
+    218 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(TMP_RTC_YR_IN),         // RTC input: year (see: COIL_WRITE_RTC)
+    219 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(REG_MODEL_CODE[0]),     // Fields A-D (ascii)
+    220 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(REG_MODEL_CODE[1]),     // Fields E-H (ascii)
+    221 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(REG_MODEL_CODE[2]),     // Fields I-L (ascii)
+    222 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(REG_MODEL_CODE[3]),     // Fields M-P (ascii)
+    223 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_LOGGING_PERIOD),    // Loggin Period
+    224 ,   REGTYPE_INT ,   REGPERM_WRITE_O ,   MB_VAR(REG_PASSWORD),          // Razor global password
+    225 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_STATISTICS),        // Statistics
+    226 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_ACTIVE_ERROR),      // Active Error Count
+    227 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_AO_ALARM_MODE),     // AO alarm mode
+    228 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_PHASE_HOLD_CYCLES), // Phase hold over
+    229 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_RELAY_DELAY),       // Relay Delay
+    230 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_AO_MODE),           // AO mode
+    231 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_OIL_DENS_CORR_MODE),// Disabled, Ai, Modbus, Manual
+    232 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_RELAY_MODE),        // relay mode
+    233 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(REG_DIAGNOSTICS),       // diagnostics 
+    234 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(REG_USB_TRY),           // MAX_USB_TRY 
+
+    241 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[0]),     // source of mirror register 501
+    242 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[1]),     // source of mirror register 503
+    243 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[2]),     // source of mirror register 505
+    244 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[3]),     // source of mirror register 507
+    245 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[4]),     // source of mirror register 509
+    246 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[5]),     // source of mirror register 511
+    247 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[6]),     // source of mirror register 513
+    248 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[7]),     // source of mirror register 515
+    249 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[8]),     // source of mirror register 517
+    250 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[9]),     // source of mirror register 519
+    251 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[10]),    // source of mirror register 521
+    252 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[11]),    // source of mirror register 523
+    253 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[12]),    // source of mirror register 525
+    254 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[13]),    // source of mirror register 527
+    255 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[14]),    // source of mirror register 529
+    256 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[15]),    // source of mirror register 531
+    257 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[16]),    // source of mirror register 533
+    258 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[17]),    // source of mirror register 535
+    259 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[18]),    // source of mirror register 537
+    260 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[19]),    // source of mirror register 539
+    261 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[20]),    // source of mirror register 541
+    262 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[21]),    // source of mirror register 543
+    263 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[22]),    // source of mirror register 545
+    264 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[23]),    // source of mirror register 547
+    265 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[24]),    // source of mirror register 549
+    266 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[25]),    // source of mirror register 551
+    267 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[26]),    // source of mirror register 553
+    268 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[27]),    // source of mirror register 555
+    269 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[28]),    // source of mirror register 557
+    270 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[29]),    // source of mirror register 559
+    271 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[30]),    // source of mirror register 561
+    272 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MIRROR_SRC[31]),    // source of mirror register 563
+
+    273 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(MB_PKT_LIST.n),         // requests queued now
+    274 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(MB_STAT.queue_max),     // most requests queued at once
+    275 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(MB_STAT.queue_busy),    // Server Busy replies (low 16 bits)
+    276 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(MB_STAT.queue_drop),    // requests dropped (low 16 bits)
+
+    277 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(NAND_CFG_STATUS),       // 0 = saved, 1 = commit pending, 2 = last commit failed
+    278 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(NAND_PENDING),          // configuration changes not yet saved
+    279 ,   REGTYPE_INT ,   REGPERM_READ_O  ,   MB_VAR(NAND_COMMIT_MS),        // duration of the last commit [ms]
+
+    280 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_MB_SENTINEL),       // read for unmapped registers in a cross-table read
+    281 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_FREQ_MODE),         // 0 = count over 500 ms, 1 = reciprocal
+    282 ,   REGTYPE_INT ,   REGPERM_PASSWD  ,   MB_VAR(REG_FREQ_GATE_MS),      // reciprocal gate [ms], 50 - 1000
+
+    402 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_AO_DAMPEN),         //
+    403 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_SLAVE_ADDRESS),     //  
+    404 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_STOP_BITS),         //
+    405 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_DENSITY_MODE),      //  
+    406 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_LOGGING_PERIOD),    // Loggin Period
+    407 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_STATISTICS),        // Statistics
+    408 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_ACTIVE_ERROR),      // Active Error Count
+    409 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_AO_ALARM_MODE),     // AO alarm mode
+    410 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_PHASE_HOLD_CYCLES), // Phase hold over
+    411 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_RELAY_DELAY),       // Relay Delay
+    412 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_AO_MODE),           // AO mode
+    413 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_OIL_DENS_CORR_MODE),// Disabled, Ai, Modbus, Manual
+    414 ,   REGTYPE_INT ,   REGPERM_FCT     ,   MB_VAR(FCT_RELAY_MODE),        // relay mode
+
+	0	, 	0			, 	0					, 	0	,	0
 };
 
- const Uint32 MB_TBL_LONGINT[][4] = {
+ const MB_TBL_CELL MB_TBL_LONGINT[][MB_TBL_COLS] = {
 
 ///-----------------------------------------------------------------------------
-///  #	,	function	,	R/W protection	,	variable address
+///  #	,	function	,	R/W protection	,	variable address, name
 ///-----------------------------------------------------------------------------
 
-    301 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_MEASSECTION_SN,        // serial number of measurement section
-    303 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_BACKBOARD_SN,          // serial number of back board
-    305 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_SAFETYBARRIER_SN,      // serial number of safety barrier
-    307 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_POWERSUPPLY_SN,        // serial number of power supply
-    309 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_PROCESSOR_SN,          // serial number of processor
-    311 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_DISPLAY_SN,            // serial number of display
-    313 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_RF_SN,                 // serial number of RF
-    315 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ASSEMBLY_SN,           // serial number of final assembly
-    317 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ELECTRONICS_SN[0],     // serial number of electronics[0]
-    319 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ELECTRONICS_SN[1],     // serial number of electronics[1]
-    321 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ELECTRONICS_SN[2],     // serial number of electronics[2]
-    323 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ELECTRONICS_SN[3],     // serial number of electronics[3]
-    325 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ELECTRONICS_SN[4],     // serial number of electronics[4]
-    327 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ELECTRONICS_SN[5],     // serial number of electronics[5]
-    329 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ELECTRONICS_SN[6],     // serial number of electronics[6]
-    331 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   (Uint32)&REG_ELECTRONICS_SN[7],     // serial number of electronics[7]
-	0	, 	0			, 	0				 , 	0
+    301 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_MEASSECTION_SN),        // serial number of measurement section
+    303 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_BACKBOARD_SN),          // serial number of back board
+    305 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_SAFETYBARRIER_SN),      // serial number of safety barrier
+    307 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_POWERSUPPLY_SN),        // serial number of power supply
+    309 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_PROCESSOR_SN),          // serial number of processor
+    311 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_DISPLAY_SN),            // serial number of display
+    313 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_RF_SN),                 // serial number of RF
+    315 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ASSEMBLY_SN),           // serial number of final assembly
+    317 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ELECTRONICS_SN[0]),     // serial number of electronics[0]
+    319 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ELECTRONICS_SN[1]),     // serial number of electronics[1]
+    321 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ELECTRONICS_SN[2]),     // serial number of electronics[2]
+    323 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ELECTRONICS_SN[3]),     // serial number of electronics[3]
+    325 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ELECTRONICS_SN[4]),     // serial number of electronics[4]
+    327 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ELECTRONICS_SN[5]),     // serial number of electronics[5]
+    329 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ELECTRONICS_SN[6]),     // serial number of electronics[6]
+    331 ,   REGTYPE_LONGINT ,   REGPERM_FCT  ,   MB_VAR(REG_ELECTRONICS_SN[7]),     // serial number of electronics[7]
+
+    /// modbus link statistics [see: MB_STATS]
+    333 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.frames),            // frames delimited on the line
+    335 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.responses),         // responses sent, exceptions included
+    337 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.crc_err),           // requests dropped on a CRC mismatch
+    339 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.overrun),           // UART or RX buffer overruns
+    341 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.excep),             // exception responses sent
+    343 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_last_us),       // last turnaround (us)
+    345 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_max_us),        // longest turnaround (us)
+    347 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[0][0]),    // read turnarounds <2ms
+    349 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[0][1]),    // read turnarounds <4ms
+    351 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[0][2]),    // read turnarounds <8ms
+    353 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[0][3]),    // read turnarounds <16ms
+    355 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[0][4]),    // read turnarounds <32ms
+    357 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[0][5]),    // read turnarounds >=32ms
+    359 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[1][0]),    // write turnarounds <2ms
+    361 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[1][1]),    // write turnarounds <4ms
+    363 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[1][2]),    // write turnarounds <8ms
+    365 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[1][3]),    // write turnarounds <16ms
+    367 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[1][4]),    // write turnarounds <32ms
+    369 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[1][5]),    // write turnarounds >=32ms
+    371 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[2][0]),    // read/write turnarounds <2ms
+    373 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[2][1]),    // read/write turnarounds <4ms
+    375 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[2][2]),    // read/write turnarounds <8ms
+    377 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[2][3]),    // read/write turnarounds <16ms
+    379 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[2][4]),    // read/write turnarounds <32ms
+    381 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[2][5]),    // read/write turnarounds >=32ms
+    383 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[3][0]),    // other turnarounds <2ms
+    385 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[3][1]),    // other turnarounds <4ms
+    387 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[3][2]),    // other turnarounds <8ms
+    389 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[3][3]),    // other turnarounds <16ms
+    391 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[3][4]),    // other turnarounds <32ms
+    393 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.lat_hist[3][5]),    // other turnarounds >=32ms
+    395 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.foreign),           // frames for other slaves
+    397 ,   REGTYPE_LONGINT ,   REGPERM_READ_O,   MB_VAR(MB_STAT.stream_dropped),    // stream records dropped, line busy
+	0	, 	0			, 	0				 , 	0	,	0
 };
 
 ///-----------------------------------------------------------------------------
 ///	NOTE:	In the interest of NOT typing out each individual element of large arrays, this table is
 ///			structured differently; only the base address of each array is listed, and software figures
 ///			out the rest. [see: MB_Tbl_Search_Extended()]
+///			REGTYPE_DBL arrays take two registers per element, REGTYPE_CHAR arrays one.
 ///-----------------------------------------------------------------------------
 /// [60K OFFSET] EXTENDED LARGE ARRAY REGISTERS
-/// Start Register   , Array base address
+/// Start Register   , Element type, Array base address, name
 ///-----------------------------------------------------------------------------
-const Uint32 MB_TBL_EXTENDED[][2] = {
-
-       1 , (Uint32)&REG_TEMP_OIL_NUM_CURVES,   // 2*(size = 1)
-       3 , (Uint32)&REG_TEMPS_OIL,             // 2*(size = 10)
-      23 , (Uint32)&REG_COEFFS_TEMP_OIL,       // 2*(size = 4*10)
-     103 , (Uint32)&REG_SALINITY_CURVES,       // 2*(size = 1)  
-     105 , (Uint32)&REG_COEFFS_SALINITY,       // 2*(size = 20)  
-     145 , (Uint32)&REG_WATER_CURVES,          // 2*(size = 1)  
-     147 , (Uint32)&REG_WATER_TEMPS,           // 2*(size = 15)  
-     177 , (Uint32)&REG_COEFFS_TEMP_WATER,     // 2*(size = 4*300)  
-    2577 , (Uint32)&REG_STRING_TAG,            // 1*(size = 8)
-    2585 , (Uint32)&REG_STRING_LONGTAG,        // 1*(size = 32)
-    2617 , (Uint32)&REG_STRING_INITIAL,        // 1*(size = 4)
-    2621 , (Uint32)&REG_STRING_MEAS,           // 1*(size = 2)
-    2623 , (Uint32)&REG_STRING_ASSEMBLY,       // 1*(size = 16)
-    2639 , (Uint32)&REG_STRING_INFO,           // 1*(size = 20)
-    2659 , (Uint32)&REG_STRING_PVNAME,         // 1*(size = 20)
-    2679 , (Uint32)&REG_STRING_PVUNIT,         // 1*(size = 8)
-    2687 , (Uint32)&STREAM_TIMESTAMP,          // 1*(size = 60*16) 
-    3647 , (Uint32)&STREAM_OIL_ADJUST,         // 2*(size = 60) 
-    3767 , (Uint32)&STREAM_WATERCUT_AVG,       // 2*(size = 60) 
-    3887 , (Uint32)&STREAM_SAMPLES,            // 2*(size = 60) 
-    4007 , 0
+const MB_TBL_CELL MB_TBL_EXTENDED[][4] = {
+
+       1 , REGTYPE_DBL , MB_VAR(REG_TEMP_OIL_NUM_CURVES),   // 2*(size = 1)
+       3 , REGTYPE_DBL , MB_VAR(REG_TEMPS_OIL),             // 2*(size = 10)
+      23 , REGTYPE_DBL , MB_VAR(REG_COEFFS_TEMP_OIL),       // 2*(size = 4*10)
+     103 , REGTYPE_DBL , MB_VAR(REG_SALINITY_CURVES),       // 2*(size = 1)  
+     105 , REGTYPE_DBL , MB_VAR(REG_COEFFS_SALINITY),       // 2*(size = 20)  
+     145 , REGTYPE_DBL , MB_VAR(REG_WATER_CURVES),          // 2*(size = 1)  
+     147 , REGTYPE_DBL , MB_VAR(REG_WATER_TEMPS),           // 2*(size = 15)  
+     177 , REGTYPE_DBL , MB_VAR(REG_COEFFS_TEMP_WATER),     // 2*(size = 4*300)  
+    2577 , REGTYPE_CHAR, MB_VAR(REG_STRING_TAG),            // 1*(size = 8)
+    2585 , REGTYPE_CHAR, MB_VAR(REG_STRING_LONGTAG),        // 1*(size = 32)
+    2617 , REGTYPE_CHAR, MB_VAR(REG_STRING_INITIAL),        // 1*(size = 4)
+    2621 , REGTYPE_CHAR, MB_VAR(REG_STRING_MEAS),           // 1*(size = 2)
+    2623 , REGTYPE_CHAR, MB_VAR(REG_STRING_ASSEMBLY),       // 1*(size = 16)
+    2639 , REGTYPE_CHAR, MB_VAR(REG_STRING_INFO),           // 1*(size = 20)
+    2659 , REGTYPE_CHAR, MB_VAR(REG_STRING_PVNAME),         // 1*(size = 20)
+    2679 , REGTYPE_CHAR, MB_VAR(REG_STRING_PVUNIT),         // 1*(size = 8)
+    2687 , REGTYPE_CHAR, MB_VAR(STREAM_TIMESTAMP),          // 1*(size = 60*16) 
+    3647 , REGTYPE_DBL , MB_VAR(STREAM_OIL_ADJUST),         // 2*(size = 60) 
+    3767 , REGTYPE_DBL , MB_VAR(STREAM_WATERCUT_AVG),       // 2*(size = 60) 
+    3887 , REGTYPE_DBL , MB_VAR(STREAM_SAMPLES),            // 2*(size = 60) 
+    4007 , 0           , 0, 0
 };
 
 
-const Uint32 MB_TBL_COIL[][4] = {
+const MB_TBL_CELL MB_TBL_COIL[][MB_TBL_COLS] = {
 
 ///-----------------------------------------------------------------------------
-///  #	,	function	    ,	R/W protection	,	variable address
+///  #	,	function	    ,	R/W protection	,	variable address, name
 ///-----------------------------------------------------------------------------
 
-	1	, 	REGTYPE_COIL	,	REGPERM_PASSWD 	,	(Uint32)&COIL_RELAY[0],				    //manual R/W of relay
-	2	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_RELAY[1],				    //unused; hardware not implemented
-	3	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_RELAY[2],				    //unused; hardware not implemented
-	4	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_RELAY[3],				    //unused; hardware not implemented
-	5	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_BEGIN_OIL_CAP,		    //begins oil capture process
-	6	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_UPGRADE_ENABLE,			    //enable USB logging (basic)
-	7	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_LOG_ALARMS,			    //enable USB logging for alarms
-	8	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_LOG_ERRORS,			    //enable USB logging for errors
-	9	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_LOG_ACTIVITY,			    //enable USB logging for configuration changes by user
-	10	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_AO_ALARM,				    //??? ask Enrique how this works; unimplemented
-	11	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_PARITY,				    //modbus parity bit enable
-	12	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_WRITE_RTC,			    //initiates write to RTC
-	13	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_OIL_DENS_CORR_EN,		    //enable density correction mode
-	14	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_AO_MANUAL,			    //enable analog output MANUAL mode
-	15	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_MB_AUX_SELECT_MODE,	    //enables auxiliary mode where a COIL (instead of an offset) determines which Modbus table to write to
-	16	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_INTEGER_TABLE_SELECT,	    //only applicable to auxiliary select mode; 0 = floating-point table; 1 = integer table
-	17	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_AVGTEMP_RESET,		    // reset average temperature
-	18	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_AVGTEMP_MODE,			    // Average temp mode - 24 hr (1), onDemand (0)
-	19	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	(Uint32)&COIL_OIL_PHASE,			    // Oil Phase
-	20	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	(Uint32)&COIL_ACT_RELAY_OIL,		    // Active Relay While Oil Phase 
-	21	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	(Uint32)&COIL_RELAY_MANUAL,			    // Manual Relay ON 
-	22	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	(Uint32)&COIL_UNLOCKED,				    // Password locker 
-	23	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	(Uint32)&COIL_AO_TRIM_MODE,			    // Enable trimming mode 
-	24	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	(Uint32)&COIL_AI_TRIM_MODE,			    // Enable trimming mode 
-	25, 	REGTYPE_COIL	,	REGPERM_PASSWD  ,	(Uint32)&COIL_LOCKED_SOFT_FACTORY_RESET,// copy factory default values to user space 
-	26, 	REGTYPE_COIL	,	REGPERM_FCT     ,	(Uint32)&COIL_LOCKED_HARD_FACTORY_RESET,// Re-initialize all modebus registers and coils 
-	999 , 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_UNLOCKED_FACTORY_DEFAULT,	// Unlock factory default registers and coils 
-	9999, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	(Uint32)&COIL_UPDATE_FACTORY_DEFAULT,	// Update factory default registers and coils
-	0	, 	0			, 	0					,   0
+	1	, 	REGTYPE_COIL	,	REGPERM_PASSWD 	,	MB_VAR(COIL_RELAY[0]),				    //manual R/W of relay
+	2	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_RELAY[1]),				    //unused; hardware not implemented
+	3	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_RELAY[2]),				    //unused; hardware not implemented
+	4	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_RELAY[3]),				    //unused; hardware not implemented
+	5	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_BEGIN_OIL_CAP),		    //begins oil capture process
+	6	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_UPGRADE_ENABLE),			    //enable USB logging (basic)
+	7	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_LOG_ALARMS),			    //enable USB logging for alarms
+	8	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_LOG_ERRORS),			    //enable USB logging for errors
+	9	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_LOG_ACTIVITY),			    //enable USB logging for configuration changes by user
+	10	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_AO_ALARM),				    //??? ask Enrique how this works; unimplemented
+	11	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_PARITY),				    //modbus parity bit enable
+	12	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_WRITE_RTC),			    //initiates write to RTC
+	13	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_OIL_DENS_CORR_EN),		    //enable density correction mode
+	14	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_AO_MANUAL),			    //enable analog output MANUAL mode
+	15	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_MB_AUX_SELECT_MODE),	    //enables auxiliary mode where a COIL (instead of an offset) determines which Modbus table to write to
+	16	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_INTEGER_TABLE_SELECT),	    //only applicable to auxiliary select mode; 0 = floating-point table; 1 = integer table
+	17	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_AVGTEMP_RESET),		    // reset average temperature
+	18	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_AVGTEMP_MODE),			    // Average temp mode - 24 hr (1), onDemand (0)
+	19	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	MB_VAR(COIL_OIL_PHASE),			    // Oil Phase
+	20	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	MB_VAR(COIL_ACT_RELAY_OIL),		    // Active Relay While Oil Phase 
+	21	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	MB_VAR(COIL_RELAY_MANUAL),			    // Manual Relay ON 
+	22	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	MB_VAR(COIL_UNLOCKED),				    // Password locker 
+	23	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	MB_VAR(COIL_AO_TRIM_MODE),			    // Enable trimming mode 
+	24	, 	REGTYPE_COIL	,	REGPERM_READ_O	,	MB_VAR(COIL_AI_TRIM_MODE),			    // Enable trimming mode 
+	25, 	REGTYPE_COIL	,	REGPERM_PASSWD  ,	MB_VAR(COIL_LOCKED_SOFT_FACTORY_RESET),// copy factory default values to user space 
+	26, 	REGTYPE_COIL	,	REGPERM_FCT     ,	MB_VAR(COIL_LOCKED_HARD_FACTORY_RESET),// Re-initialize all modebus registers and coils 
+	27	, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_CFG_COMMIT),			    // save pending configuration changes to NAND now
+	999 , 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_UNLOCKED_FACTORY_DEFAULT),	// Unlock factory default registers and coils 
+	9999, 	REGTYPE_COIL	,	REGPERM_PASSWD	,	MB_VAR(COIL_UPDATE_FACTORY_DEFAULT),	// Update factory default registers and coils
+	0	, 	0			, 	0					,   0	,	0
 };
 
 
@@ -147,25 +147,14 @@ unsigned char Hex2Bcd(unsigned char HexVal)
  ********************************************************************************/
 void Init_I2C(void)
 {
-	int i;
 	Hwi_disableInterrupt(6);
 	LCD_IS_INIT = FALSE;
 	CSL_FINST(i2cRegs->ICMDR,I2C_ICMDR_IRS,DISABLE);  //put i2c module in reset
 	i2cRegs->ICSTR = CSL_I2C_ICSTR_RESETVAL;
 
 	// initialize I2C buffers
-	I2C_TXBUF.head = 0;
-	I2C_TXBUF.tail = 0;
-	I2C_RXBUF.head = 0;
-	I2C_RXBUF.tail = 0;
-	I2C_TXBUF.n = 0;
-	I2C_RXBUF.n = 0;
-
-	for(i=0;i<MAX_BFR_SIZE;i++)
-	{
-		I2C_TXBUF.buff[i] = 0;
-		I2C_RXBUF.buff[i] = 0xFF;
-	}
+	Ring_Init(&I2C_TXBUF);
+	Ring_Init(&I2C_RXBUF);
 
 	// convince slave devices to let go
 	I2C_Recover(); 
@@ -206,7 +195,6 @@ void Reset_I2C(Uint8 isKey, Uint32 I2C_KEY)
     /// if Swi_disabled(), then restore
     if (isKey) Swi_restore(I2C_KEY);
 
-	int i;
 	
 	Hwi_disableInterrupt(6);
 
@@ -250,10 +238,7 @@ void Reset_I2C(Uint8 isKey, Uint32 I2C_KEY)
 	i2cRegs->ICSTR = CSL_I2C_ICSTR_RESETVAL;
 
 	// initialize I2C RX buffer
-	I2C_RXBUF.head = 0;
-	I2C_RXBUF.tail = 0;
-	I2C_RXBUF.n = 0;
-	for(i=0;i<MAX_BFR_SIZE;i++) I2C_RXBUF.buff[i] = 0xFF;
+	Ring_Init(&I2C_RXBUF);
 
 	// convince slave devices to let go
 	I2C_Recover();	
@@ -649,7 +634,7 @@ static inline void Pulse_ePin_Manual(int read, int write, Uint8 lcd_data)
  ********************************************************************************/
 void I2C_LCD_ClockFxn(void)
 {
-	if ( (I2C_TXBUF.n > 0) )
+	if ( (Ring_Count(&I2C_TXBUF) > 0) )
 	{
 		Swi_post(Swi_I2C_TX); //if THR is ready then start sending now
 		CSL_FINST(i2cRegs->ICIMR,I2C_ICIMR_ICXRDY,ENABLE); //unmask icxrdy interrupt
@@ -688,7 +673,7 @@ void I2C_Start_Pulse_MBVE(void)
 	Uint32	key;
 	Uint8	msb, lsb;
 	
-	if( (I2C_TXBUF.n > 0) || (I2C_FINISHED_TX == FALSE) )
+	if( (Ring_Count(&I2C_TXBUF) > 0) || (I2C_FINISHED_TX == FALSE) )
 	{
 		Clock_start(I2C_Pulse_MBVE_Clock_Short); // try again in ~37.5ms (100 clock ticks)
 		return;
@@ -938,7 +923,7 @@ void I2C_HwiFxn(void)
 	//if ICXRDY caused the interrupt and the I2C THR is still ready
 	if( (intcode == CSL_I2C_ICIVR_INTCODE_ICXRDY) && (CSL_FEXT(i2cRegs->ICSTR,I2C_ICSTR_ICXRDY)))
 	{
-		if (I2C_TXBUF.n > 0) // if there is something to send
+		if (Ring_Count(&I2C_TXBUF) > 0) // if there is something to send
 		{
 			Swi_post(Swi_I2C_TX); //keep sending from the TX buffer until it's empty
 			Hwi_disableInterrupt(6);
@@ -970,7 +955,7 @@ void I2C_RX_Fxn(void)
 	CSL_FINST(i2cRegs->ICMDR,I2C_ICMDR_TRX,RX_MODE); //put I2C in RX mode
 
 	i2c_byte = i2cRegs->ICDRR; //read byte
-	BfrPut(&I2C_RXBUF, i2c_byte);
+	Ring_Put(&I2C_RXBUF, i2c_byte);
 
 	Swi_restore(key);
 }
@@ -987,12 +972,9 @@ void I2C_TX_Fxn(void)
 	int timeout = FALSE;
 	unsigned int key;
 
-	if (I2C_TXBUF.n <= 0)
+	if (Ring_Count(&I2C_TXBUF) == 0)
 	{
 		CSL_FINST(i2cRegs->ICIMR,I2C_ICIMR_ICXRDY,DISABLE); //mask icxrdy interrupt
-		I2C_TXBUF.n = 0;
-
-		I2C_TXBUF.tail = I2C_TXBUF.head;
 		Clock_start(I2C_LCD_Clock);
 		I2C_FINISHED_TX = TRUE;
 		Hwi_enableInterrupt(6); //re-enable I2C hwi
@@ -1002,28 +984,19 @@ void I2C_TX_Fxn(void)
 	key = Swi_disable();
 	CSL_FINST(i2cRegs->ICIMR,I2C_ICIMR_ICXRDY,DISABLE); //mask icxrdy interrupt
 	I2C_FINISHED_TX = FALSE;
-	while(I2C_TXBUF.n > 0)
+	while(Ring_Count(&I2C_TXBUF) > 0)
 	{ // data is available from the buffer
 		if (!I2C_Wait_To_Send_ARDY())
 		{
-			i2c_byte = BfrGet(&I2C_TXBUF);
+			Ring_Get(&I2C_TXBUF, &i2c_byte);
 			i2cRegs->ICDXR = i2c_byte;
 			CSL_FINST(i2cRegs->ICIMR,I2C_ICIMR_ICXRDY,ENABLE); //unmask the ICXRDY interrupt
 		}
 		else
-		{
-			I2C_TXBUF.head = 0;
-			I2C_TXBUF.tail = 0;
-			I2C_TXBUF.n = 0;
-		}
+			Ring_Flush(&I2C_TXBUF);
 	}
 //	CSL_FINST(i2cRegs->ICIMR,I2C_ICIMR_ICXRDY,ENABLE); //unmask the ICXRDY interrupt
 	I2C_FINISHED_TX = TRUE;
-	if (I2C_TXBUF.n < 0)
-	{
-		I2C_TXBUF.n = 0;
-		I2C_TXBUF.tail = I2C_TXBUF.head;
-	}
 	Clock_start(I2C_LCD_Clock);
 	Swi_restore(key);
 	Hwi_enableInterrupt(6); //re-enable I2C hwi
@@ -1038,7 +1011,7 @@ void I2C_TX_Fxn(void)
 void I2C_SendByte(Uint8 out_byte)
 {
 	if (I2C_FINISHED_TX == TRUE) I2C_FINISHED_TX = FALSE;
-	if (I2C_TXBUF.n < MAX_BFR_SIZE-1) BfrPut(&I2C_TXBUF,out_byte);
+	Ring_Put(&I2C_TXBUF,out_byte);
 }
 
 
@@ -1172,7 +1145,7 @@ static inline int I2C_Wait_For_Ack(void)
 
 void I2C_ADC_Read_Temp(void)
 {
-	if (I2C_TXBUF.n > 0)
+	if (Ring_Count(&I2C_TXBUF) > 0)
 	{
 		Clock_start(I2C_ADC_Read_Temp_Clock_Retry);
 		return;
@@ -1223,7 +1196,7 @@ void I2C_ADC_Read_Temp(void)
 // This function is called after waiting for the ADC conversion. Reads in value.
 void I2C_ADC_Read_Temp_Callback(void)
 {
-	if (I2C_TXBUF.n > 0)
+	if (Ring_Count(&I2C_TXBUF) > 0)
 	{
 		Clock_start(I2C_ADC_Read_Temp_Callback_Clock_Retry);
 		return;
@@ -1324,7 +1297,7 @@ void I2C_ADC_Read_Temp_Callback(void)
 
 void I2C_ADC_Read_VREF(void)
 {
-	if (I2C_TXBUF.n > 0)
+	if (Ring_Count(&I2C_TXBUF) > 0)
 	{
 		Clock_start(I2C_ADC_Read_VREF_Clock_Retry);
 		return;
@@ -1374,7 +1347,7 @@ void I2C_ADC_Read_VREF(void)
 
 void I2C_ADC_Read_VREF_Callback(void)
 {
-    if (I2C_TXBUF.n > 0) 
+    if (Ring_Count(&I2C_TXBUF) > 0) 
     {
         Clock_start(I2C_ADC_Read_VREF_Callback_Clock_Retry);
         return;
@@ -1474,7 +1447,7 @@ void I2C_ADC_Read_VREF_Callback(void)
 
 void I2C_DS1340_Read_RTC(void)
 {
-	if (I2C_TXBUF.n > 0)
+	if (Ring_Count(&I2C_TXBUF) > 0)
 	{
 		Clock_start(I2C_DS1340_Read_RTC_Clock_Retry);
 		return;
@@ -1587,7 +1560,7 @@ int I2C_DS1340_Read(int TIME_ADDR)
 
 void I2C_ADC_Read_Density(void)
 {
-	if(I2C_TXBUF.n > 0)
+	if(Ring_Count(&I2C_TXBUF) > 0)
 	{
 		Clock_start(I2C_ADC_Read_Density_Clock_Retry);
 		return;
@@ -1638,7 +1611,7 @@ void I2C_ADC_Read_Density(void)
 
 void I2C_ADC_Read_Density_Callback(void)
 {
-    if (I2C_TXBUF.n > 0) 
+    if (Ring_Count(&I2C_TXBUF) > 0) 
     {
         Clock_start(I2C_ADC_Read_Density_Callback_Clock_Retry);
         return;
@@ -1789,7 +1762,7 @@ void I2C_DS1340_Write_RTC(void)
 
 void I2C_DS1340_Write(int RTC_ADDR, int RTC_DATA)
 {
-    if (I2C_TXBUF.n > 0) 
+    if (Ring_Count(&I2C_TXBUF) > 0) 
     {
         Clock_start(I2C_DS1340_Write_RTC_Clock_Retry);
         return;
@@ -1835,7 +1808,7 @@ void I2C_DS1340_Write(int RTC_ADDR, int RTC_DATA)
 void I2C_Update_AO(void)
 {
 
-	if(I2C_TXBUF.n > 0)
+	if(Ring_Count(&I2C_TXBUF) > 0)
     {
         Clock_start(I2C_Update_AO_Clock_Retry);
         return;
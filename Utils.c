@@ -137,6 +137,7 @@ saveStreamData(void)
 
     // SAVE CURRENT REGISTER DATA TO STREAM REGISTER 
     STREAM_OIL_ADJUST[STREAM-1] = REG_OIL_ADJUST.calc_val;
+    requestNandWrite();
 }
 
 void
@@ -84,17 +84,62 @@ static Uint8 DEVICE_ASYNC_MEM_IsNandReadyPin(ASYNC_MEM_InfoHandle hAsyncMemInfo)
 }
 
 
+/****************************************************************************************
+ * writeNand() - Swi_writeNand: commits every pending configuration change at once		*
+ ****************************************************************************************/
 void writeNand(void)
 {
+	Types_FreqHz freq;
+	Uint32 ts, rtn;
+
+	Clock_stop(Commit_Nand_Clock);
+	NAND_PENDING = 0;
+	COIL_CFG_COMMIT.val = FALSE;
+
+	ts = Timestamp_get32();
 	Swi_disable();
-	Store_Vars_in_NAND();
+	rtn = Store_Vars_in_NAND();
 	Swi_enable();
+
+	Timestamp_getFreq(&freq);
+	NAND_COMMIT_MS = (Timestamp_get32() - ts) / (freq.lo / 1000);
+
+	if (NAND_PENDING > 0) // changed while Swi_writeNand was preempted
+		NAND_CFG_STATUS = NAND_CFG_PENDING;
+	else
+		NAND_CFG_STATUS = (rtn == E_PASS) ? NAND_CFG_CLEAN : NAND_CFG_FAILED;
+}
+
+/****************************************************************************************
+ * requestNandWrite() - marks the configuration dirty										*
+ * A configuration tool writes dozens of registers in a row; rather than rewriting the	*
+ * whole CFG section for each one, Commit_Nand_Clock is restarted on every change and	*
+ * commits them together once the writes stop (or when COIL_CFG_COMMIT is set).			*
+ ****************************************************************************************/
+void requestNandWrite(void)
+{
+	UInt key;
+
+	key = Swi_disable();
+	NAND_PENDING++;
+	NAND_CFG_STATUS = NAND_CFG_PENDING;
+	Clock_stop(Commit_Nand_Clock);
+	Clock_start(Commit_Nand_Clock);
+	Swi_restore(key);
+}
+
+/****************************************************************************************
+ * commitNand() - Commit_Nand_Clock: the configuration has been quiet long enough		*
+ ****************************************************************************************/
+void commitNand(void)
+{
+	Swi_post(Swi_writeNand);
 }
 
 /****************************************************************************************
  * Store_Vars_in_NAND() writes all variables in the "CFG" data section into NAND flash	*
  ****************************************************************************************/
-void Store_Vars_in_NAND(void)
+Uint32 Store_Vars_in_NAND(void)
 {
     Uint32 num_pages;
     NAND_InfoHandle  hNandInfo;
@@ -106,7 +151,7 @@ void Store_Vars_in_NAND(void)
     // Initialize NAND Flash
     hNandInfo = NAND_open((Uint32)NANDStart, BUS_16BIT );
 
-    if (hNandInfo == NULL) return;
+    if (hNandInfo == NULL) return E_FAIL;
     data_size = SIZE_CFG;
     num_pages = 0;
     while ((num_pages * hNandInfo->dataBytesPerPage) < data_size) num_pages++;
@@ -123,7 +168,13 @@ void Store_Vars_in_NAND(void)
     for (i=0; i<alloc_size; i++) heapPtr[i]=cfgPtr[i];
 
     // Write the file data to the NAND flash
-    if (LOCAL_writeData(hNandInfo, heapPtr, num_pages) != E_PASS) printf("\tERROR: Write failed.\r\n");
+    if (LOCAL_writeData(hNandInfo, heapPtr, num_pages) != E_PASS)
+    {
+        printf("\tERROR: Write failed.\r\n");
+        return E_FAIL;
+    }
+
+    return E_PASS;
 }
 
 
@@ -520,3 +571,194 @@ void upgradeFirmware(void)
 	/// change firmware name not to redo upgrade
     while (1) displayLcd("   RESTARTING   ",1);
 }
+
+
+/****************************************************************************************
+ * Firmware staged over Modbus																*
+ * A master sends the image as FW_CHUNK_SIZE-byte chunks, each with its own CRC32		*
+ * (see MB_FILE_FW_DATA). Chunks may arrive in any order and any number of times, so a	*
+ * master that lost the link reads firmwareInfo() and sends whatever is still missing.	*
+ * Nothing touches NAND until commitFirmware(), and then only if the CRC32 of the whole	*
+ * image matches the one given to beginFirmware(). The configuration blocks are left	*
+ * alone, unlike upgradeFirmware().														*
+ ****************************************************************************************/
+#pragma DATA_SECTION(FW_IMAGE,"DDR")
+static Uint8 FW_IMAGE[FW_MAX_SIZE + NAND_MAX_PAGE_SIZE];	// room to pad the last page
+static Uint32 FW_HAVE[(FW_MAX_CHUNKS + 31) / 32];			// chunks received, one bit each
+static Uint32 FW_CRC_LUT[256];
+static BOOL FW_CRC_LUT_READY = FALSE;
+
+static volatile Uint32 FW_STATE = FW_STATE_IDLE;
+static Uint32 FW_SIZE;		// image bytes
+static Uint32 FW_CRC;		// CRC32 of the whole image
+static Uint32 FW_CHUNKS;	// chunks in the image
+static Uint32 FW_RECEIVED;	// distinct chunks received
+static Uint32 FW_REJECTED;	// chunks dropped on a CRC32 mismatch
+
+static Uint32 fwCrc32(const Uint8* data, Uint32 n)
+{
+	if (!FW_CRC_LUT_READY)
+	{
+		UTIL_buildCRC32Table(FW_CRC_LUT, 0x04C11DB7);
+		FW_CRC_LUT_READY = TRUE;
+	}
+
+	return UTIL_calcCRC32(FW_CRC_LUT, (Uint8*)data, n, 0);
+}
+
+/****************************************************************************************
+ * beginFirmware() - starts a transfer, or resumes it if size and crc are those of the	*
+ * image already being received																*
+ ****************************************************************************************/
+BOOL beginFirmware(Uint32 size, Uint32 crc)
+{
+	if ((size == 0) || (size > FW_MAX_SIZE) || (FW_STATE == FW_STATE_COMMITTING)) return FALSE;
+
+	if (((FW_STATE == FW_STATE_RECEIVING) || (FW_STATE == FW_STATE_COMPLETE)) && (size == FW_SIZE) && (crc == FW_CRC))
+		return TRUE;
+
+	memset(FW_HAVE, 0, sizeof(FW_HAVE));
+	FW_SIZE		= size;
+	FW_CRC		= crc;
+	FW_CHUNKS	= (size + FW_CHUNK_SIZE - 1) / FW_CHUNK_SIZE;
+	FW_RECEIVED	= 0;
+	FW_REJECTED	= 0;
+	FW_STATE	= FW_STATE_RECEIVING;
+
+	return TRUE;
+}
+
+/****************************************************************************************
+ * stageFirmware() - copies one chunk into the staging image								*
+ * @param crc	- CRC32 of the FW_CHUNK_SIZE bytes at data; bytes past the end of the	*
+ * 				  image in the last chunk are ignored but still covered by crc			*
+ ****************************************************************************************/
+Uint8 stageFirmware(Uint32 chunk, const Uint8* data, Uint32 crc)
+{
+	if (((FW_STATE != FW_STATE_RECEIVING) && (FW_STATE != FW_STATE_COMPLETE)) || (chunk >= FW_CHUNKS))
+		return FW_STAGE_RANGE;
+
+	if (fwCrc32(data, FW_CHUNK_SIZE) != crc)
+	{
+		FW_REJECTED++;
+		return FW_STAGE_CRC;
+	}
+
+	memcpy(&FW_IMAGE[chunk * FW_CHUNK_SIZE], data, FW_CHUNK_SIZE);
+
+	if ((FW_HAVE[chunk >> 5] & (1u << (chunk & 31))) == 0)
+	{
+		FW_HAVE[chunk >> 5] |= 1u << (chunk & 31);
+		FW_RECEIVED++;
+	}
+
+	if (FW_RECEIVED == FW_CHUNKS) FW_STATE = FW_STATE_COMPLETE;
+
+	return FW_STAGE_OK;
+}
+
+/****************************************************************************************
+ * commitFirmware() - hands a complete image to Swi_flashFirmware							*
+ ****************************************************************************************/
+BOOL commitFirmware(void)
+{
+	if (FW_STATE != FW_STATE_COMPLETE) return FALSE;
+
+	FW_STATE = FW_STATE_COMMITTING;
+	Swi_post(Swi_flashFirmware);
+
+	return TRUE;
+}
+
+void abortFirmware(void)
+{
+	if (FW_STATE != FW_STATE_COMMITTING) FW_STATE = FW_STATE_IDLE;
+}
+
+/****************************************************************************************
+ * firmwareInfo() - FW_INFO_WORDS words describing the transfer							*
+ *   0     state (FW_STATE_*)																*
+ *   1-2   image size, MSW first																*
+ *   3-4   image CRC32, MSW first															*
+ *   5     chunks in the image																*
+ *   6     chunks received																	*
+ *   7     first chunk still missing (= word 5 when none)									*
+ *   8     chunks rejected on a CRC32 mismatch												*
+ *   9     FW_CHUNK_SIZE																		*
+ ****************************************************************************************/
+void firmwareInfo(Uint16* w)
+{
+	Uint32 i;
+
+	for (i=0;i<FW_CHUNKS;i++)
+	{
+		if (FW_HAVE[i >> 5] == 0xFFFFFFFF) { i |= 31; continue; }
+		if ((FW_HAVE[i >> 5] & (1u << (i & 31))) == 0) break;
+	}
+
+	if (i > FW_CHUNKS) i = FW_CHUNKS;
+
+	w[0] = FW_STATE;
+	w[1] = FW_SIZE >> 16;
+	w[2] = FW_SIZE & 0xFFFF;
+	w[3] = FW_CRC >> 16;
+	w[4] = FW_CRC & 0xFFFF;
+	w[5] = FW_CHUNKS;
+	w[6] = FW_RECEIVED;
+	w[7] = i;
+	w[8] = FW_REJECTED;
+	w[9] = FW_CHUNK_SIZE;
+}
+
+/****************************************************************************************
+ * flashFirmware() - Swi_flashFirmware: verifies the staged image, writes it over the	*
+ * application blocks and lets the watchdog restart the system							*
+ ****************************************************************************************/
+void flashFirmware(void)
+{
+	NAND_InfoHandle hNandInfo;
+	Uint32 num_pages;
+
+	if (FW_STATE != FW_STATE_COMMITTING) return;
+
+	if (fwCrc32(FW_IMAGE, FW_SIZE) != FW_CRC)
+	{
+		FW_STATE = FW_STATE_BAD_IMAGE;
+		return;
+	}
+
+	UTIL_setCurrMemPtr(0);
+
+	hNandInfo = NAND_open((Uint32)NANDStart, DEVICE_BUSWIDTH_16BIT);
+	if (hNandInfo == NULL)
+	{
+		FW_STATE = FW_STATE_FAILED;
+		return;
+	}
+
+	num_pages = (FW_SIZE + hNandInfo->dataBytesPerPage - 1) / hNandInfo->dataBytesPerPage;
+	memset(&FW_IMAGE[FW_SIZE], 0xFF, num_pages * hNandInfo->dataBytesPerPage - FW_SIZE);
+
+	updateDisplay("FIRMWARE UPGRADE","     LOADING    ");
+
+	/// disable all interrupts while accessing flash memory
+	Swi_disable();
+
+	if (USB_writeData(hNandInfo, FW_IMAGE, num_pages) != E_PASS)
+	{
+		Swi_enable();
+		FW_STATE = FW_STATE_FAILED;
+		return;
+	}
+
+	/// re-enable interrupts
+	Swi_enable();
+
+	/// let the watchdog restart the system
+	setupWatchDog();
+
+	isUpdateDisplay=TRUE;
+	updateDisplay("FIRMWARE UPGRADE","   RESTARTING   ");
+
+	while (1) displayLcd("   RESTARTING   ",1);
+}
@@ -22,8 +22,40 @@
 
 #define ADDR_DDR_CFG		(0xC7FF33EC) //beginning of CFG section
 
+// NAND_CFG_STATUS (not NAND_STATUS, which nand.h defines)
+#define NAND_CFG_CLEAN		(0)	// CFG section matches NAND
+#define NAND_CFG_PENDING	(1)	// changes waiting for Commit_Nand_Clock or COIL_CFG_COMMIT
+#define NAND_CFG_FAILED		(2)	// last commit did not complete
+
+// firmware staged over Modbus, FW_CHUNK_SIZE bytes at a time
+#define FW_CHUNK_SIZE		(128)
+#define FW_MAX_CHUNKS		(10000)	// one file record per chunk, records 0-9999
+#define FW_MAX_SIZE			((Uint32)FW_CHUNK_SIZE * FW_MAX_CHUNKS)
+#define FW_INFO_WORDS		(10)	// see firmwareInfo()
+
+// firmware staging state
+#define FW_STATE_IDLE		(0)
+#define FW_STATE_RECEIVING	(1)	// chunks still missing
+#define FW_STATE_COMPLETE	(2)	// every chunk in, waiting for commitFirmware()
+#define FW_STATE_COMMITTING	(3)	// Swi_flashFirmware is verifying/writing the image
+#define FW_STATE_BAD_IMAGE	(4)	// whole-image CRC32 did not match
+#define FW_STATE_FAILED		(5)	// NAND write failed
+
+// stageFirmware()
+#define FW_STAGE_OK			(0)
+#define FW_STAGE_RANGE		(1)	// no transfer in progress or chunk past the image
+#define FW_STAGE_CRC		(2)	// chunk CRC32 mismatch
+
 void writeNand(void);
-void Store_Vars_in_NAND(void);
+void requestNandWrite(void);
+void commitNand(void);
+Uint32 Store_Vars_in_NAND(void);
 Uint32 Restore_Vars_From_NAND(void);
+Uint8 beginFirmware(Uint32 size, Uint32 crc);	// TRUE/FALSE; BOOL is not defined before Globals.h
+Uint8 stageFirmware(Uint32 chunk, const Uint8* data, Uint32 crc);
+Uint8 commitFirmware(void);
+void abortFirmware(void);
+void firmwareInfo(Uint16* w);
+void flashFirmware(void);
 
 #endif //_NANDWRITER_H_
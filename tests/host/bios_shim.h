@@ -0,0 +1,194 @@
+/*************************************************\
+|*  bios_shim.h									 *|
+|*	Copyright 2018, Phase Dynamics Inc.			 *|
+\*************************************************/
+
+/*------------------------------------------------------------------------
+* Host stand-in for the SYS/BIOS, XDC and CSL headers the firmware
+* includes. Every one of those headers is generated by the Makefile as a
+* one-liner that pulls this file in, so the sources build unchanged with
+* gcc. Only what the code under test touches is here: the types, the
+* handles from PDI_Razor.cfg, the BIOS calls (defined in host_bios.c)
+* and enough CSL names for the register overlays to compile against
+* HOST_REGS, a block of plain memory. Of the registers only UART2's
+* receiver does anything: host_uart_byte() hands it one byte at a time.
+*------------------------------------------------------------------------*/
+
+#ifndef BIOS_SHIM_H_
+#define BIOS_SHIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+///// xdc/std.h, tistdtypes.h /////
+typedef uint8_t		Uint8;
+typedef int8_t		Int8;
+typedef uint16_t	Uint16;
+typedef int16_t		Int16;
+typedef uint32_t	Uint32;
+typedef int32_t		Int32;
+typedef uint64_t	Uint64;
+typedef int			Int;
+typedef unsigned	UInt;
+typedef uint32_t	UInt32;
+typedef int			Bool;
+typedef char		Char;
+typedef unsigned long ULong;
+typedef volatile Uint8	VUint8;
+typedef volatile Uint16	VUint16;
+typedef volatile Uint32	VUint32;
+
+#define TRUE		1
+#define FALSE		0
+#define far
+#define __FAR__
+#define BUS_8BIT	(0x01)
+#define BUS_16BIT	(0x02)
+#define BUS_32BIT	(0x04)
+#define E_PASS		(0x00000000u)
+#define E_FAIL		(0x00000001u)
+#define E_TIMEOUT	(0x00000002u)
+
+typedef char*		String;
+
+///// ti/sysbios /////
+typedef struct Swi_Obj*			Swi_Handle;
+typedef struct Clock_Obj*		Clock_Handle;
+typedef struct Semaphore_Obj*	Semaphore_Handle;
+typedef struct Task_Obj*		Task_Handle;
+typedef struct Timer_Obj*		Timer_Handle;
+
+void	Swi_post(Swi_Handle swi);
+UInt	Swi_disable(void);
+void	Swi_enable(void);
+void	Swi_restore(UInt key);
+void	Clock_start(Clock_Handle clk);
+void	Clock_stop(Clock_Handle clk);
+Bool	Clock_isActive(Clock_Handle clk);
+void	Clock_setTimeout(Clock_Handle clk, UInt32 timeout);
+void	Clock_setPeriod(Clock_Handle clk, UInt32 period);
+UInt32	Clock_getTicks(void);
+UInt	Hwi_disable(void);
+void	Hwi_restore(UInt key);
+UInt	Hwi_disableInterrupt(UInt intNum);
+void	Hwi_restoreInterrupt(UInt intNum, UInt key);
+void	Hwi_enableInterrupt(UInt intNum);
+void	Timer_start(Timer_Handle t);
+void	Timer_stop(Timer_Handle t);
+Bool	Timer_setPeriodMicroSecs(Timer_Handle t, UInt32 us);
+
+extern const UInt32 Clock_tickPeriod;
+
+///// xdc/runtime/Timestamp.h /////
+typedef struct { UInt32 hi; UInt32 lo; } Types_FreqHz;
+
+UInt32	Timestamp_get32(void);
+void	Timestamp_getFreq(Types_FreqHz* freq);
+
+///// xdc/cfg/global.h: the static instances in PDI_Razor.cfg /////
+extern void*			sysHeap;
+extern Task_Handle		Menu_task;
+extern Semaphore_Handle	Menu_sem;
+extern Timer_Handle		counterTimerHandle;
+extern Timer_Handle		delayTimerHandle;
+extern void*			UART_Hwi;
+extern void*			I2C_Hwi;
+extern Clock_Handle		MB_Start_Clock_Int16, MB_Start_Clock_Float, MB_Start_Clock_Coil,
+						MB_Start_Clock_LongInt, MB_Start_Clock_Sample, MB_Start_Clock_ForceSlaveAddr,
+						MB_Start_Clock_File, MB_Start_Clock_Stream, MB_Start_Clock_Changes,
+						MB_Start_Clock_Response, MB_End_Clock, MB_Frame_Clock, Commit_Nand_Clock,
+						I2C_LCD_Clock, Process_Menu_Clock, DebounceMBVE_Clock, Update_Relays_Clock,
+						Capture_Sample_Clock, I2C_Update_AO_Clock, I2C_Update_AO_Clock_Retry,
+						I2C_Pulse_MBVE_Clock, I2C_Pulse_MBVE_Clock_Short, I2C_Pulse_MBVE_Clock_Retry,
+						I2C_Start_Pulse_MBVE_Clock, I2C_DS1340_Read_RTC_Clock, I2C_DS1340_Read_RTC_Clock_Retry,
+						I2C_DS1340_Write_RTC_Clock, I2C_DS1340_Write_RTC_Clock_Retry,
+						I2C_ADC_Read_Temp_Clock, I2C_ADC_Read_Temp_Clock_Retry,
+						I2C_ADC_Read_Temp_Callback_Clock, I2C_ADC_Read_Temp_Callback_Clock_Retry,
+						I2C_ADC_Read_VREF_Clock, I2C_ADC_Read_VREF_Clock_Retry,
+						I2C_ADC_Read_VREF_Callback_Clock, I2C_ADC_Read_VREF_Callback_Clock_Retry,
+						I2C_ADC_Read_Density_Clock, I2C_ADC_Read_Density_Clock_Retry,
+						I2C_ADC_Read_Density_Callback_Clock, I2C_ADC_Read_Density_Callback_Clock_Retry;
+extern Swi_Handle		Swi_I2C_RX, Swi_I2C_TX, Swi_Modbus_RX, Swi_writeNand, Swi_Poll,
+						Swi_REG_OIL_SAMPLE, Swi_REG_STREAM, Swi_Set_REG_DENSITY_CAL_Unit,
+						Swi_Unlock_Via_Modbus_Basic, Swi_Unlock_Via_Modbus_Tech, Swi_Unlock_Via_Modbus_Factory,
+						Swi_REG_OIL_ADJUST, Swi_Apply_Density_Adj, Swi_upgradeFirmware, Swi_uploadCsv,
+						Swi_downloadCsv, Swi_scanCsvFiles, Swi_logData, Swi_flashFirmware;
+
+///// ti/csl: register overlays all point at HOST_REGS /////
+typedef struct
+{
+	volatile Uint32 IER, LSR, THR, RBR, IIR, FCR, LCR, MCR, DLL, DLH, PWREMU_MGMT, MDR;
+	volatile Uint32 ICMDR, ICSTR, ICIMR, ICDRR, ICDXR, ICCNT, ICSAR, ICOAR, ICCLKL, ICCLKH, ICPSC, ICIVR;
+	volatile Uint32 TIM12, TIM34, PRD12, PRD34, TCR, TGCR, EMUMGT_CLKSPD, PTCMD;
+	volatile Uint32 PINMUX[20], MDCTL[32], MDSTAT[32], KICK0R, KICK1R, CFGCHIP[5];
+	struct { volatile Uint32 DIR, OUT_DATA, SET_DATA, CLR_DATA, IN_DATA; } BANK[5];
+} HOST_REGS_T;
+
+extern HOST_REGS_T HOST_REGS;
+
+typedef HOST_REGS_T *CSL_Usb_otgRegsOvly, *CSL_I2cRegsOvly, *CSL_SyscfgRegsOvly, *CSL_PscRegsOvly,
+					*CSL_GpioRegsOvly, *CSL_IntcRegsOvly, *CSL_UartRegsOvly, *CSL_EmifaRegsOvly,
+					*CSL_TmrRegsOvly, *CSL_RtcRegsOvly, *CSL_Syscfg1RegsOvly;
+
+#define CSL_USB_0_REGS			(&HOST_REGS)
+#define CSL_I2C_0_DATA_CFG		(&HOST_REGS)
+#define CSL_SYSCFG_0_REGS		(&HOST_REGS)
+#define CSL_SYSCFG_1_REGS		(&HOST_REGS)
+#define CSL_PSC_0_REGS			(&HOST_REGS)
+#define CSL_PSC_1_REGS			(&HOST_REGS)
+#define CSL_GPIO_0_REGS			(&HOST_REGS)
+#define CSL_INTC_0_REGS			(&HOST_REGS)
+#define CSL_UART_2_REGS			(&HOST_REGS)
+#define CSL_EMIFA_0_REGS		(&HOST_REGS)
+#define CSL_TMR_0_REGS			(&HOST_REGS)
+#define CSL_TMR_1_REGS			(&HOST_REGS)
+#define CSL_TMR_2_REGS			(&HOST_REGS)
+#define CSL_TMR_3_REGS			(&HOST_REGS)
+#define CSL_RTC_0_REGS			(&HOST_REGS)
+
+#define CSL_FINST(reg,field,tok)	((void)0)
+#define CSL_FINS(reg,field,val)		((void)(val))
+#define CSL_FEXT(reg,field)			HOST_FEXT_##field
+#define CSL_FEXTR(reg,msb,lsb)		host_uart_fextr(&(reg))
+#define CSL_FMKT(field,tok)			(0)
+#define CSL_FMK(field,val)			(0)
+
+// the fields the firmware reads: UART2's receiver is played by host_uart_byte()
+// (host.h), its transmitter is always empty and its THR interrupt enabled
+#define HOST_FEXT_PSC_MDSTAT_STATE	CSL_PSC_MDSTAT_STATE_ENABLE
+#define HOST_FEXT_UART_RBR_DATA		host_uart_rbr()
+#define HOST_FEXT_UART_LSR_TEMT		(1)
+#define HOST_FEXT_UART_IER_ETBEI	(1)
+
+Uint32	host_uart_fextr(volatile Uint32* reg);
+Uint32	host_uart_rbr(void);
+
+#define CSL_GPIO_DIR_DIR_IN			(1)
+#define CSL_GPIO_DIR_DIR_OUT		(0)
+#define CSL_PSC_GPIO				(3)
+#define CSL_PSC_UART2				(13)
+#define CSL_PSC_MDSTAT_STATE_ENABLE	(3)
+
+///// ti/fs/fatfs/ff.h /////
+typedef unsigned char	BYTE;
+typedef unsigned int	UINT;
+typedef unsigned long	DWORD;
+typedef struct { DWORD fsize; DWORD fptr; } FIL;
+typedef struct { DWORD fsize; char fname[13]; BYTE fattrib; } FILINFO;
+typedef struct { int id; } DIR;
+typedef enum { FR_OK = 0, FR_DISK_ERR, FR_NO_FILE = 4 } FRESULT;
+
+#define FA_READ				(0x01)
+#define FA_WRITE			(0x02)
+#define FA_OPEN_ALWAYS		(0x10)
+#define FA_CREATE_ALWAYS	(0x08)
+
+FRESULT	f_open(FIL* fp, const char* path, BYTE mode);
+FRESULT	f_close(FIL* fp);
+FRESULT	f_read(FIL* fp, void* buff, UINT btr, UINT* br);
+FRESULT	f_write(FIL* fp, const void* buff, UINT btw, UINT* bw);
+FRESULT	f_lseek(FIL* fp, DWORD ofs);
+
+#define f_size(fp)			((fp)->fsize)
+
+#endif /* BIOS_SHIM_H_ */
@@ -0,0 +1,207 @@
+/*------------------------------------------------------------------------
+* cat_master.c
+*-------------------------------------------------------------------------
+* The master side of the register catalog (MB_FILE_CATALOG, built by
+* MB_Catalog_Entry() in ModbusRTU.c) over any HOST_XFER transport: the
+* header, then the entries a few at a time with 0x14, decoded into
+* CAT_ENTRY and written out as JSON or as a CSV a SCADA package imports.
+* Used by mb_catalog and test_catalog.c.
+*------------------------------------------------------------------------*/
+
+#include <math.h>
+#include "host.h"
+
+#define CAT_ENTRIES_PER_READ	(4)	// 4 x 26 words: one 0x14 response under MBTCP_PDU_SIZE
+
+static Uint32
+cat_read(HOST_XFER xfer, void* ctx, Uint32 rec, Uint32 n, Uint16* dst)
+{
+	Uint8	pdu[9], rsp[MBTCP_PDU_SIZE];
+	Uint32	i, rsp_n;
+
+	pdu[0] = 0x14;
+	pdu[1] = 7;
+	pdu[2] = 6;
+	pdu[3] = MB_FILE_CATALOG >> 8;
+	pdu[4] = MB_FILE_CATALOG & 0xFF;
+	pdu[5] = rec >> 8;
+	pdu[6] = rec & 0xFF;
+	pdu[7] = n >> 8;
+	pdu[8] = n & 0xFF;
+
+	rsp_n = xfer(ctx, pdu, sizeof(pdu), rsp);
+	if (rsp_n == 0)
+		return CAT_LINK;
+	if ( (rsp[0] != 0x14) || (rsp_n != 4 + 2*n) )
+		return CAT_REFUSED;
+
+	for (i=0;i<n;i++)
+		dst[i] = (rsp[4 + 2*i] << 8) | rsp[5 + 2*i];
+
+	return CAT_OK;
+}
+
+static float
+cat_float(const Uint16* w)
+{ // MSW first (MB_Catalog_Put32)
+	Uint32	u = ((Uint32)w[0] << 16) | w[1];
+	float	f;
+
+	memcpy(&f, &u, sizeof(f));
+	return f;
+}
+
+/***************************************************************************
+ * cat_master_read() - the whole catalog
+ * @param e		- room for max entries
+ * @param n		- entries read
+ * @return		- CAT_OK; CAT_LINK if the slave stopped answering;
+ *				  CAT_REFUSED on an exception, or a catalog this does not
+ *				  know (version, entry size) or with more than max entries
+ ***************************************************************************/
+int
+cat_master_read(HOST_XFER xfer, void* ctx, CAT_ENTRY* e, Uint32 max, Uint32* n)
+{
+	Uint16	hdr[MB_CATALOG_HDR_WORDS], w[CAT_ENTRIES_PER_READ * MB_CATALOG_ENTRY_WORDS];
+	Uint32	i, k, got, entries;
+	int		rc;
+
+	*n = 0;
+	rc = cat_read(xfer, ctx, 0, MB_CATALOG_HDR_WORDS, hdr);
+	if (rc != CAT_OK)
+		return rc;
+
+	entries = hdr[1];
+	if ( (hdr[0] != MB_CATALOG_VERSION) || (hdr[2] != MB_CATALOG_ENTRY_WORDS)
+		|| (hdr[3] != MB_CATALOG_NAME_SIZE) || (entries > max) )
+		return CAT_REFUSED;
+
+	for (i=0;i<entries;i+=got)
+	{
+		got = ((entries - i) < CAT_ENTRIES_PER_READ) ? (entries - i) : CAT_ENTRIES_PER_READ;
+		rc = cat_read(xfer, ctx, MB_CATALOG_HDR_WORDS + i*MB_CATALOG_ENTRY_WORDS, got*MB_CATALOG_ENTRY_WORDS, w);
+		if (rc != CAT_OK)
+			return rc;
+
+		for (k=0;k<got;k++)
+		{
+			const Uint16* p = &w[k * MB_CATALOG_ENTRY_WORDS];
+			CAT_ENTRY* c = &e[i + k];
+			Uint32 j;
+
+			c->address	= p[0];
+			c->span		= p[1];
+			c->table	= p[2] >> 8;
+			c->type		= p[2] & 0xFF;
+			c->perm		= p[3];
+			c->unit		= p[4];
+			c->cls		= p[5];
+			c->lo		= cat_float(&p[6]);
+			c->hi		= cat_float(&p[8]);
+			for (j=0;j<MB_CATALOG_NAME_SIZE/2;j++)
+			{
+				c->name[2*j]		= p[10 + j] >> 8;
+				c->name[2*j + 1]	= p[10 + j] & 0xFF;
+			}
+			c->name[MB_CATALOG_NAME_SIZE] = 0;
+		}
+	}
+
+	*n = entries;
+	return CAT_OK;
+}
+
+///// names for the codes in an entry /////
+static const char*
+cat_table_name(Uint8 t)
+{
+	switch (t)
+	{
+		case REG_TYPE_COIL:		return "coil";
+		case REG_TYPE_INTEGER:	return "int";
+		case REG_TYPE_FLOAT:	return "float";
+		case REG_TYPE_LONG_INT:	return "longint";
+		default:				return "?";
+	}
+}
+
+static const char*
+cat_type_name(Uint8 t)
+{
+	static const char* NAMES[] = { "var", "dbl", "swi", "int", "longint", "coil", "unit_code",
+									"bound_hi", "bound_lo", "alarm_hi", "alarm_lo", "char" };
+
+	return ( (t >= REGTYPE_VAR) && (t <= REGTYPE_CHAR) ) ? NAMES[t - REGTYPE_VAR] : "?";
+}
+
+static const char*
+cat_perm_name(Uint16 p)
+{
+	static const char* NAMES[] = { "?", "passwd", "read_only", "write_only", "factory" };
+
+	return (p < sizeof(NAMES)/sizeof(NAMES[0])) ? NAMES[p] : "?";
+}
+
+static void
+cat_json_float(FILE* f, float v)
+{
+	if (isfinite(v))
+		fprintf(f, "%.9g", v);
+	else
+		fprintf(f, "null");
+}
+
+/***************************************************************************
+ * cat_write_json() - { "version": 1, "registers": [ {...}, ... ] }
+ * One object per entry, in catalog order. Bounds are null where the
+ * catalog has no finite figure.
+ ***************************************************************************/
+void
+cat_write_json(FILE* f, const CAT_ENTRY* e, Uint32 n)
+{
+	Uint32		i;
+	const char*	s;
+
+	fprintf(f, "{\n  \"version\": %u,\n  \"registers\": [", MB_CATALOG_VERSION);
+	for (i=0;i<n;i++)
+	{
+		fprintf(f, "%s\n    { \"address\": %u, \"registers\": %u, \"table\": \"%s\", \"type\": \"%s\", "
+				"\"access\": \"%s\", \"unit\": %u, \"class\": %u, \"low\": ",
+				(i > 0) ? "," : "", e[i].address, e[i].span, cat_table_name(e[i].table),
+				cat_type_name(e[i].type), cat_perm_name(e[i].perm), e[i].unit, e[i].cls);
+		cat_json_float(f, e[i].lo);
+		fprintf(f, ", \"high\": ");
+		cat_json_float(f, e[i].hi);
+
+		fprintf(f, ", \"name\": \"");
+		for (s=e[i].name;*s;s++)
+		{
+			if ( (*s == '"') || (*s == '\\') )
+				fprintf(f, "\\%c", *s);
+			else if ((Uint8)*s < 0x20)
+				fprintf(f, "\\u%04x", (Uint8)*s);
+			else
+				fputc(*s, f);
+		}
+		fprintf(f, "\" }");
+	}
+	fprintf(f, "\n  ]\n}\n");
+}
+
+/***************************************************************************
+ * cat_write_csv() - a header line, then one line per entry
+ * address,registers,table,type,access,unit,class,low,high,name
+ ***************************************************************************/
+void
+cat_write_csv(FILE* f, const CAT_ENTRY* e, Uint32 n)
+{
+	Uint32 i;
+
+	fprintf(f, "address,registers,table,type,access,unit,class,low,high,name\n");
+	for (i=0;i<n;i++)
+	{
+		fprintf(f, "%u,%u,%s,%s,%s,%u,%u,%.9g,%.9g,%s\n", e[i].address, e[i].span,
+				cat_table_name(e[i].table), cat_type_name(e[i].type), cat_perm_name(e[i].perm),
+				e[i].unit, e[i].cls, e[i].lo, e[i].hi, e[i].name);
+	}
+}
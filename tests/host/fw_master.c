@@ -0,0 +1,200 @@
+/*------------------------------------------------------------------------
+* fw_master.c
+*-------------------------------------------------------------------------
+* The master side of the firmware transfer in nandwriter.c, over any
+* transport that can carry one request PDU and bring back its response
+* (HOST_XFER): MB_FW_CMD_BEGIN on MB_FILE_FW_INFO, firmwareInfo() read
+* back with 0x14, one MB_FILE_FW_DATA record per chunk with its CRC32,
+* then MB_FW_CMD_COMMIT. BEGIN with the same size and CRC32 resumes a
+* transfer, so a master that lost the link calls fw_master_load() again
+* and only the chunks from the first missing one on are sent.
+* Used by mb_fwload and test_transfer.c.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define FW_MASTER_PASSES	(4)		// walks over the missing chunks before giving up
+
+static Uint32 FW_MASTER_LUT[256];
+
+static Uint32
+fw_crc32(const Uint8* data, Uint32 n)
+{
+	if (FW_MASTER_LUT[1] == 0)
+		UTIL_buildCRC32Table(FW_MASTER_LUT, 0x04C11DB7);
+
+	return UTIL_calcCRC32(FW_MASTER_LUT, (Uint8*)data, n, 0);
+}
+
+static void
+put32(Uint8* p, Uint32 v)
+{
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+}
+
+/***************************************************************************
+ * fw_request() - one request, sent again while it gets no response
+ * @return	- length of the response PDU, 0 once m->tries requests were lost
+ ***************************************************************************/
+static Uint32
+fw_request(FW_MASTER* m, const Uint8* pdu, Uint32 pdu_n, Uint8* rsp)
+{
+	Uint32 k, n;
+
+	for (k=0;k<m->tries;k++)
+	{
+		n = m->xfer(m->ctx, pdu, pdu_n, rsp);
+		if (n >= 2)
+		{
+			m->excep = (rsp[0] == (pdu[0] | 0x80)) ? rsp[1] : 0;
+			return n;
+		}
+		m->lost++;
+	}
+
+	return 0;
+}
+
+// MB_FILE_FW_INFO record 0: one command word and its arguments
+static Uint32
+fw_command(FW_MASTER* m, Uint16 cmd, const Uint8* args, Uint32 args_n, Uint8* rsp)
+{
+	Uint8 pdu[MBTCP_PDU_SIZE];
+
+	pdu[0] = 0x15;
+	pdu[1] = 7 + 2 + args_n;
+	pdu[2] = 6;
+	pdu[3] = MB_FILE_FW_INFO >> 8;
+	pdu[4] = MB_FILE_FW_INFO & 0xFF;
+	pdu[5] = 0;
+	pdu[6] = 0;
+	pdu[7] = 0;
+	pdu[8] = (2 + args_n) / 2;
+	pdu[9] = cmd >> 8;
+	pdu[10] = cmd & 0xFF;
+	if (args_n > 0)
+		memcpy(&pdu[11], args, args_n);
+
+	return fw_request(m, pdu, 11 + args_n, rsp);
+}
+
+/***************************************************************************
+ * fw_master_info() - firmwareInfo() into m->info
+ * @return	- FW_LOAD_OK, FW_LOAD_LINK or FW_LOAD_REFUSED
+ ***************************************************************************/
+int
+fw_master_info(FW_MASTER* m)
+{
+	Uint8	pdu[9] = { 0x14, 7, 6, MB_FILE_FW_INFO >> 8, MB_FILE_FW_INFO & 0xFF, 0, 0, 0, FW_INFO_WORDS };
+	Uint8	rsp[MBTCP_PDU_SIZE];
+	Uint32	i, n;
+
+	n = fw_request(m, pdu, sizeof(pdu), rsp);
+	if (n == 0)
+		return FW_LOAD_LINK;
+	if ( (m->excep != 0) || (n != 4 + 2*FW_INFO_WORDS) )
+		return FW_LOAD_REFUSED;
+
+	for (i=0;i<FW_INFO_WORDS;i++)
+		m->info[i] = (rsp[4 + 2*i] << 8) | rsp[5 + 2*i];
+
+	return FW_LOAD_OK;
+}
+
+// chunk c of the image, its CRC32 first; bytes past the image are sent as 0
+static int
+fw_chunk(FW_MASTER* m, const Uint8* image, Uint32 size, Uint32 c)
+{
+	Uint8	pdu[9 + 4 + FW_CHUNK_SIZE];
+	Uint8	rsp[MBTCP_PDU_SIZE];
+	Uint32	k, n, from;
+
+	pdu[0] = 0x15;
+	pdu[1] = sizeof(pdu) - 2;
+	pdu[2] = 6;
+	pdu[3] = MB_FILE_FW_DATA >> 8;
+	pdu[4] = MB_FILE_FW_DATA & 0xFF;
+	pdu[5] = c >> 8;
+	pdu[6] = c & 0xFF;
+	pdu[7] = 0;
+	pdu[8] = (4 + FW_CHUNK_SIZE) / 2;
+
+	from = c * FW_CHUNK_SIZE;
+	n = ((size - from) < FW_CHUNK_SIZE) ? (size - from) : FW_CHUNK_SIZE;
+	memset(&pdu[13], 0, FW_CHUNK_SIZE);
+	memcpy(&pdu[13], &image[from], n);
+	put32(&pdu[9], fw_crc32(&pdu[13], FW_CHUNK_SIZE));
+
+	for (k=0;k<m->tries;k++)
+	{
+		m->sent++;
+		if (fw_request(m, pdu, sizeof(pdu), rsp) == 0)
+			return FW_LOAD_LINK;
+		if (m->excep == 0)
+			return FW_LOAD_OK;
+		if (m->excep != MB_EXCEP_BAD_VALUE)
+			return FW_LOAD_REFUSED;
+		m->rejected++;	// the chunk's CRC32 did not match what arrived: send it again
+	}
+
+	return FW_LOAD_REFUSED;
+}
+
+/***************************************************************************
+ * fw_master_load() - transfers image and commits it
+ * Starts a transfer, or resumes the one in progress for the same image,
+ * and sends the chunks from the first missing one on.
+ * @return	- FW_LOAD_OK once MB_FW_CMD_COMMIT is accepted; FW_LOAD_LINK if
+ *			  the slave stopped answering (call again to resume);
+ *			  FW_LOAD_REFUSED on an exception no retry can fix
+ ***************************************************************************/
+int
+fw_master_load(FW_MASTER* m, const Uint8* image, Uint32 size)
+{
+	Uint8	args[8], rsp[MBTCP_PDU_SIZE];
+	Uint32	c, pass;
+	int		rc;
+
+	put32(&args[0], size);
+	put32(&args[4], fw_crc32(image, size));
+
+	if (fw_command(m, MB_FW_CMD_BEGIN, args, sizeof(args), rsp) == 0)
+		return FW_LOAD_LINK;
+	if (m->excep != 0)
+		return FW_LOAD_REFUSED;
+
+	for (pass=0;pass<FW_MASTER_PASSES;pass++)
+	{
+		rc = fw_master_info(m);
+		if (rc != FW_LOAD_OK)
+			return rc;
+
+		if (pass == 0)
+			m->resume = m->info[7];	// where this call picked the transfer up
+
+		if (m->info[0] == FW_STATE_COMPLETE)
+			break;
+		if (m->info[0] != FW_STATE_RECEIVING)
+			return FW_LOAD_REFUSED;
+
+		for (c=m->info[7];c<m->info[5];c++)
+		{
+			rc = fw_chunk(m, image, size, c);
+			if (rc != FW_LOAD_OK)
+				return rc;
+		}
+	}
+
+	if (pass == FW_MASTER_PASSES)
+		return FW_LOAD_REFUSED;
+
+	if (fw_command(m, MB_FW_CMD_COMMIT, NULL, 0, rsp) == 0)
+		return FW_LOAD_LINK;
+	if (m->excep != 0)
+		return FW_LOAD_REFUSED;
+
+	return fw_master_info(m);
+}
@@ -0,0 +1,144 @@
+/*------------------------------------------------------------------------
+* hist_master.c
+*-------------------------------------------------------------------------
+* The master side of the logged history (MB_SendPacket_File) over any
+* HOST_XFER transport: file 1 for where the history stands, then records
+* pulled from the row files HIST_RECS_PER_READ at a time with 0x14, each
+* checked against its sequence number so a record overwritten while it
+* was being read is not taken for the one asked for. Counts what went
+* over the link, so the time the same reads take on an RTU line can be
+* worked out at any baud rate. Used by mb_history and test_history.c.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+// one 0x14 sub-request of n words; the words land in dst
+static int
+hist_read(HIST_MASTER* m, Uint16 file, Uint32 rec, Uint32 n, Uint16* dst)
+{
+	Uint8	pdu[9], rsp[MBTCP_PDU_SIZE];
+	Uint32	i, rsp_n;
+
+	pdu[0] = 0x14;
+	pdu[1] = 7;
+	pdu[2] = 6;
+	pdu[3] = file >> 8;
+	pdu[4] = file & 0xFF;
+	pdu[5] = rec >> 8;
+	pdu[6] = rec & 0xFF;
+	pdu[7] = n >> 8;
+	pdu[8] = n & 0xFF;
+
+	m->requests++;
+	m->bytes_out += sizeof(pdu);
+	rsp_n = m->xfer(m->ctx, pdu, sizeof(pdu), rsp);
+	if (rsp_n == 0)
+		return HIST_LINK;
+
+	m->bytes_in += rsp_n;
+	if ( (rsp[0] != 0x14) || (rsp_n != 4 + 2*n) )
+		return HIST_REFUSED;
+
+	for (i=0;i<n;i++)
+		dst[i] = (rsp[4 + 2*i] << 8) | rsp[5 + 2*i];
+
+	return HIST_OK;
+}
+
+/***************************************************************************
+ * hist_master_info() - file 1 into m->info
+ * @return	- HIST_OK, HIST_LINK or HIST_REFUSED
+ ***************************************************************************/
+int
+hist_master_info(HIST_MASTER* m)
+{
+	Uint16	w[MB_FILE_INFO_WORDS];
+	int		rc;
+
+	rc = hist_read(m, MB_FILE_HIST_INFO, 0, MB_FILE_INFO_WORDS, w);
+	if (rc != HIST_OK)
+		return rc;
+
+	m->info.seq		= ((Uint32)w[0] << 16) | w[1];
+	m->info.depth	= ((Uint32)w[2] << 16) | w[3];
+	m->info.words	= w[4];
+	m->info.rows	= w[5];
+	m->info.period	= w[6];
+
+	if ( (m->info.words != HIST_WORDS) || (m->info.depth == 0) || (m->info.rows == 0) )
+		return HIST_REFUSED;
+
+	return HIST_OK;
+}
+
+/***************************************************************************
+ * hist_master_read() - records first to first+n-1, as m->info last saw
+ * the history
+ * @return	- HIST_OK; HIST_GONE if any of them is not (or no longer) in
+ *			  the history; HIST_LINK or HIST_REFUSED as the link failed
+ ***************************************************************************/
+int
+hist_master_read(HIST_MASTER* m, Uint32 first, Uint32 n, HIST_RECORD* r)
+{
+	Uint16	w[HIST_RECS_PER_READ * HIST_WORDS];
+	Uint32	row, k, j, i, u;
+	int		rc;
+
+	if ( (first + n > m->info.seq) || (m->info.seq - first > m->info.depth) )
+		return HIST_GONE;
+
+	for (;n > 0;n-=k,first+=k,r+=k)
+	{
+		// as many records as one response holds, without crossing a file or the end of the rows
+		row	= first % m->info.depth;
+		k	= (n < HIST_RECS_PER_READ) ? n : HIST_RECS_PER_READ;
+		if (k > m->info.rows - row % m->info.rows)
+			k = m->info.rows - row % m->info.rows;
+		if (k > m->info.depth - row)
+			k = m->info.depth - row;
+
+		rc = hist_read(m, MB_FILE_HIST_DATA + row / m->info.rows, (row % m->info.rows) * HIST_WORDS, k * HIST_WORDS, w);
+		if (rc != HIST_OK)
+			return rc;
+
+		for (j=0;j<k;j++)
+		{
+			const Uint16* p = &w[j * HIST_WORDS];
+
+			r[j].seq	= ((Uint32)p[0] << 16) | p[1];
+			r[j].rtc	= ((Uint32)p[2] << 16) | p[3];
+			r[j].diag	= ((Uint32)p[4] << 16) | p[5];
+			for (i=0;i<HIST_VALUES;i++)
+			{
+				u = ((Uint32)p[6 + 2*i] << 16) | p[7 + 2*i];
+				memcpy(&r[j].val[i], &u, sizeof(u));
+			}
+
+			if (r[j].seq != first + j)
+			{ // the slave wrapped onto it since m->info was read
+				m->overwritten++;
+				return HIST_GONE;
+			}
+		}
+	}
+
+	return HIST_OK;
+}
+
+/***************************************************************************
+ * hist_master_line_us() - how long the requests so far would hold an RTU
+ * line at baud: each frame with its address and CRC, t3.5 before the
+ * response (MB_Schedule) and before the next request
+ ***************************************************************************/
+double
+hist_master_line_us(const HIST_MASTER* m, Uint32 baud)
+{
+	double char_us, t35_us;
+
+	char_us	= 1e6 * UART_CHAR_BITS / baud;
+	t35_us	= 3.5 * char_us;
+	if ( (baud > 19200) && (t35_us < MB_T35_MIN_US) )
+		t35_us = MB_T35_MIN_US;
+
+	return ((double)m->bytes_out + m->bytes_in + 2*3*m->requests) * char_us + 2 * t35_us * m->requests;
+}
@@ -0,0 +1,237 @@
+/*************************************************\
+|*  host.h										 *|
+|*	Copyright 2018, Phase Dynamics Inc.			 *|
+\*************************************************/
+
+/*------------------------------------------------------------------------
+* Host shim around MB_RX_Submit()/MB_Dispatch(), shared by the unit tests
+* and mb_load. A request goes in as an RTU frame, is parsed and queued by
+* the firmware exactly as one from ModbusTCP.c would be, and host_run()
+* plays MB_Start_Clock_Response until the queue is empty. Responses land
+* in HOST_RSP through HOST_DRV.
+*------------------------------------------------------------------------*/
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stdio.h>
+#include "Globals.h"
+#include "nandwriter.h"
+#include "util.h"
+
+#define HOST_SLAVE		(1)		// REG_SLAVE_ADDRESS after host_init()
+#define HOST_TCP_CLIENTS	(16)	// Modbus TCP connections host_tcp_serve() takes at a time
+#define HOST_SWI_SIGNAL	SIGALRM	// blocked by Swi_disable(); its handler plays a Swi (signal.h)
+
+typedef struct
+{ // last response handed to HOST_DRV
+	Uint8	frame[MB_FRAME_SIZE];
+	Uint32	n;
+	Uint32	tag;
+	Uint32	count;	// responses so far
+} HOST_RESPONSE;
+
+// ModbusTables.h defines the tables, so only ModbusRTU.c includes it
+#define MB_TBL_COLS		5
+#define REGPERM_WRITE_O	3
+#define REGTYPE_VAR		5
+#define REGTYPE_DBL		6
+#define REGTYPE_CHAR	16
+
+typedef uintptr_t MB_TBL_CELL;
+
+extern const MB_TBL_CELL MB_TBL_FLOAT[][MB_TBL_COLS];
+extern const MB_TBL_CELL MB_TBL_INT[][MB_TBL_COLS];
+extern const MB_TBL_CELL MB_TBL_LONGINT[][MB_TBL_COLS];
+extern const MB_TBL_CELL MB_TBL_COIL[][MB_TBL_COLS];
+extern const MB_TBL_CELL MB_TBL_EXTENDED[][4];
+
+struct Clock_Obj
+{ // MB_Start_Clock_Response, MB_End_Clock and MB_Frame_Clock; the other handles are NULL
+	UInt32	timeout;	// ticks, as last set
+	Bool	active;
+	Uint32	starts;		// Clock_start() calls so far
+	UInt32	at;			// Timestamp_get32() at the last Clock_start()
+};
+
+struct Timer_Obj
+{ // counterTimerHandle; delayTimerHandle is NULL
+	UInt32	period_us;
+	Bool	running;
+	UInt32	at;			// Timestamp_get32() at the last Timer_start()
+};
+
+extern HOST_RESPONSE		HOST_RSP;
+extern const MB_TX_DRIVER	HOST_DRV;
+extern int					HOST_FAILS;
+extern Bool					HOST_VCLOCK;	// Timestamp_get32() returns HOST_NOW
+extern UInt32				HOST_NOW;
+extern UInt32				HOST_VCLOCK_STEP;	// added to HOST_NOW by every read, so busy-waits end
+extern void					(*HOST_VCLOCK_HOOK)(void);	// then called: whatever moves with time
+extern Uint32				HOST_SWI_POSTS;	// Swi_post() calls so far
+
+void	host_init(void);
+void	host_run(void);
+Uint32	host_frame(Uint8* frame, Uint8 slave, const Uint8* pdu, Uint32 pdu_n);
+Uint32	host_request(const Uint8* pdu, Uint32 pdu_n);
+void	host_uart_byte(Uint8 b, Uint32 now);
+void	host_history_add(Uint32 rtc, Uint32 diag, const float* val);	// the next History_Seq() record
+void	Modbus_RX(void);		// Swi_Modbus_RX and MB_End_Clock: PDI_Razor.cfg names them, no header does
+void	MB_PacketDone(void);
+void	host_tcp_serve(int listen_fd);
+
+///// masters: host_master.c (Modbus TCP client), fw_master.c /////
+// one request PDU out, its response PDU (function code first) back in rsp; 0: no response
+typedef Uint32 (*HOST_XFER)(void* ctx, const Uint8* pdu, Uint32 pdu_n, Uint8* rsp);
+
+typedef struct
+{ // a Modbus TCP connection to one unit
+	int		fd;
+	Uint8	unit;
+	Uint16	tid;		// transaction id of the last request
+	Uint32	timeout_ms;
+} HOST_MASTER;
+
+int		host_master_open(HOST_MASTER* m, const char* host, Uint32 port, Uint8 unit);
+void	host_master_close(HOST_MASTER* m);
+Uint32	host_master_xfer(void* m, const Uint8* pdu, Uint32 pdu_n, Uint8* rsp);
+Uint32	host_xfer(void* ctx, const Uint8* pdu, Uint32 pdu_n, Uint8* rsp);	// no server: host_request()
+
+// fw_master_load(), fw_master_info()
+#define FW_LOAD_OK		(0)
+#define FW_LOAD_LINK	(1)	// no response: call fw_master_load() again to resume
+#define FW_LOAD_REFUSED	(2)	// an exception retrying cannot fix (m->excep)
+
+typedef struct
+{
+	HOST_XFER	xfer;
+	void*		ctx;
+	Uint32		tries;		// requests without a response before the link counts as lost
+	Uint32		sent;		// chunk requests, repeats included
+	Uint32		lost;		// requests that got no response
+	Uint32		rejected;	// chunks the slave refused on a CRC32 mismatch
+	Uint32		resume;		// first chunk sent by the last fw_master_load()
+	Uint8		excep;		// exception code of the last response, 0 if none
+	Uint16		info[FW_INFO_WORDS];	// firmwareInfo() as last read
+} FW_MASTER;
+
+int		fw_master_load(FW_MASTER* m, const Uint8* image, Uint32 size);
+int		fw_master_info(FW_MASTER* m);
+
+///// cat_master.c: MB_FILE_CATALOG /////
+#define CAT_OK			(0)
+#define CAT_LINK		(1)	// no response
+#define CAT_REFUSED		(2)	// an exception, or a catalog this master does not read
+
+typedef struct
+{ // one catalog entry, as MB_Catalog_Entry() describes it
+	Uint16	address;
+	Uint16	span;		// 16-bit registers (bits for a coil)
+	Uint8	table;		// REG_TYPE_*
+	Uint8	type;		// REGTYPE_*
+	Uint16	perm;		// REGPERM_*
+	Uint16	unit;		// VARs only
+	Uint16	cls;
+	float	lo, hi;		// bounds in unit; 0, 0 if none
+	char	name[MB_CATALOG_NAME_SIZE + 1];
+} CAT_ENTRY;
+
+int		cat_master_read(HOST_XFER xfer, void* ctx, CAT_ENTRY* e, Uint32 max, Uint32* n);
+void	cat_write_json(FILE* f, const CAT_ENTRY* e, Uint32 n);
+void	cat_write_csv(FILE* f, const CAT_ENTRY* e, Uint32 n);
+
+///// hist_master.c: the logged history (0x14, MB_FILE_HIST_*) /////
+#define HIST_OK				(0)
+#define HIST_LINK			(1)	// no response
+#define HIST_REFUSED		(2)	// an exception, or a history this master does not read
+#define HIST_GONE			(3)	// not in the history, or overwritten while being read
+#define HIST_VALUES			(5)	// watercut, raw watercut, temperature, frequency, RP
+#define HIST_RECS_PER_READ	(7)	// 112 words: the most one 0x14 response holds
+
+typedef struct
+{ // file 1
+	Uint32	seq;		// records written since boot
+	Uint32	depth;		// HIST_RECORDS
+	Uint32	words;		// HIST_WORDS
+	Uint32	rows;		// MB_FILE_HIST_ROWS
+	Uint32	period;		// REG_LOGGING_PERIOD, seconds
+} HIST_INFO;
+
+typedef struct
+{ // one record, as History_Record() wrote it
+	Uint32	seq;
+	Uint32	rtc;		// yr<<26 | mon<<22 | day<<17 | hr<<12 | min<<6 | sec
+	Uint32	diag;		// DIAGNOSTICS
+	float	val[HIST_VALUES];
+} HIST_RECORD;
+
+typedef struct
+{
+	HOST_XFER	xfer;
+	void*		ctx;
+	HIST_INFO	info;		// as hist_master_info() last read it
+	Uint32		requests;
+	Uint32		bytes_out;	// request PDUs
+	Uint32		bytes_in;	// response PDUs
+	Uint32		overwritten;	// reads that found a newer record than asked for
+} HIST_MASTER;
+
+int		hist_master_info(HIST_MASTER* m);
+int		hist_master_read(HIST_MASTER* m, Uint32 first, Uint32 n, HIST_RECORD* r);
+double	hist_master_line_us(const HIST_MASTER* m, Uint32 baud);
+
+///// stream_master.c: the sample stream (PDI function 67) /////
+typedef struct
+{ // one record, as MB_Stream_Sample() sent it
+	Uint16	seq;		// since the arm command
+	Uint16	dropped;	// records the analyzer has not sent, line busy
+	Uint32	us;			// since the arm command
+	Uint32	pulses;		// FREQ_PULSE_COUNT_LO
+	float	freq, temp, rp, wc_raw;
+} STREAM_SAMPLE;
+
+typedef struct
+{
+	Uint8	slave;
+	Uint32	sn;			// long (0xFA) address; 0 if not
+	Uint32	addr_n;		// bytes of address
+	BOOL	echo;		// the echo of the arm command is still to come
+	BOOL	synced;		// the last frame checked
+	Uint8	buf[40];	// the frame so far
+	Uint32	n;
+	Uint16	next_seq, last_dropped;
+	Uint32	count;		// records asked for, from the echo
+	Uint32	records;	// decoded
+	Uint32	dropped;	// by the analyzer
+	Uint32	lost;		// on the line: seq gaps the analyzer did not drop
+	Uint32	crc_errors;	// times a bad frame lost the decoder its place
+	Uint32	skipped;	// bytes passed over finding it again
+} STREAM_DECODER;
+
+void	stream_decoder_init(STREAM_DECODER* d, Uint8 slave, Uint32 sn);
+BOOL	stream_decode(STREAM_DECODER* d, Uint8 b, STREAM_SAMPLE* s);
+
+///// unit tests (test_main.c) /////
+#define CHECK(cond)		host_check((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQ(a,b)	host_check_eq((long)(a), (long)(b), #a, #b, __FILE__, __LINE__)
+
+void	host_check(int ok, const char* what, const char* file, int line);
+void	host_check_eq(long a, long b, const char* sa, const char* sb, const char* file, int line);
+
+void	test_crc(void);
+void	test_ring(void);
+void	test_mbtcp(void);
+void	test_tables(void);
+void	test_firmware(void);
+void	test_transfer(void);
+void	test_cache(void);
+void	test_replay(void);
+void	test_framing(void);
+void	test_schedule(void);
+void	test_freq(void);
+void	test_catalog(void);
+void	test_profile(void);
+void	test_history(void);
+void	test_stream(void);
+
+#endif /* HOST_H_ */
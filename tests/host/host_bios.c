@@ -0,0 +1,332 @@
+/*------------------------------------------------------------------------
+* host_bios.c
+*-------------------------------------------------------------------------
+* Definitions behind bios_shim.h, and the host transport (HOST_DRV) that
+* the unit tests and mb_load hand requests to the firmware through.
+* The clocks never fire; host_run() does the work of
+* MB_Start_Clock_Response by calling MB_Dispatch() directly. The Hwi gates
+* are no-ops. A test that wants a Swi to preempt task-level code runs it
+* from a HOST_SWI_SIGNAL handler: Swi_disable() blocks that signal, as on
+* the target it holds off every Swi.
+*------------------------------------------------------------------------*/
+
+#include <signal.h>
+#include <time.h>
+#include "host.h"
+
+///// BIOS /////
+HOST_REGS_T		HOST_REGS;
+const UInt32	Clock_tickPeriod = 150;	// us, as in PDI_Razor.cfg
+
+void*			sysHeap;
+Task_Handle		Menu_task;
+Semaphore_Handle Menu_sem;
+Timer_Handle	delayTimerHandle;
+
+// Count_Freq_Pulses() runs on it
+static struct Timer_Obj HOST_COUNTER_TIMER;
+Timer_Handle	counterTimerHandle = &HOST_COUNTER_TIMER;
+void*			UART_Hwi;
+void*			I2C_Hwi;
+Clock_Handle	MB_Start_Clock_Int16, MB_Start_Clock_Float, MB_Start_Clock_Coil,
+				MB_Start_Clock_LongInt, MB_Start_Clock_Sample, MB_Start_Clock_ForceSlaveAddr,
+				MB_Start_Clock_File, MB_Start_Clock_Stream, MB_Start_Clock_Changes, Commit_Nand_Clock;
+
+// the clocks ModbusRTU.c arms keep their state for the tests to look at
+static struct Clock_Obj HOST_CLOCKS[3];
+Clock_Handle	MB_Start_Clock_Response = &HOST_CLOCKS[0];
+Clock_Handle	MB_End_Clock			= &HOST_CLOCKS[1];
+Clock_Handle	MB_Frame_Clock			= &HOST_CLOCKS[2];
+Swi_Handle		Swi_Modbus_RX, Swi_writeNand, Swi_Poll, Swi_flashFirmware,
+				Swi_logData, Swi_downloadCsv, Swi_scanCsvFiles, Swi_uploadCsv;
+
+Uint32	HOST_SWI_POSTS;
+
+void	Swi_post(Swi_Handle swi)						{ (void)swi; HOST_SWI_POSTS++; }
+void	Clock_start(Clock_Handle clk)					{ if (clk) { clk->active = TRUE; clk->starts++; clk->at = Timestamp_get32(); } }
+void	Clock_stop(Clock_Handle clk)					{ if (clk) clk->active = FALSE; }
+Bool	Clock_isActive(Clock_Handle clk)				{ return clk ? clk->active : FALSE; }
+void	Clock_setTimeout(Clock_Handle clk, UInt32 t)	{ if (clk) clk->timeout = t; }
+void	Clock_setPeriod(Clock_Handle clk, UInt32 p)		{ (void)clk; (void)p; }
+UInt	Hwi_disable(void)								{ return 0; }
+void	Hwi_restore(UInt key)							{ (void)key; }
+UInt	Hwi_disableInterrupt(UInt n)					{ (void)n; return 0; }
+void	Hwi_restoreInterrupt(UInt n, UInt key)			{ (void)n; (void)key; }
+void	Hwi_enableInterrupt(UInt n)						{ (void)n; }
+void	Timer_start(Timer_Handle t)						{ if (t) { t->running = TRUE; t->at = Timestamp_get32(); } }
+void	Timer_stop(Timer_Handle t)						{ if (t) t->running = FALSE; }
+Bool	Timer_setPeriodMicroSecs(Timer_Handle t, UInt32 us)	{ if (t) t->period_us = us; return TRUE; }
+
+// key: TRUE if the "Swis" were already held off
+UInt
+Swi_disable(void)
+{
+	sigset_t s, old;
+
+	sigemptyset(&s);
+	sigaddset(&s, HOST_SWI_SIGNAL);
+	sigprocmask(SIG_BLOCK, &s, &old);
+
+	return sigismember(&old, HOST_SWI_SIGNAL);
+}
+
+void
+Swi_enable(void)
+{
+	sigset_t s;
+
+	sigemptyset(&s);
+	sigaddset(&s, HOST_SWI_SIGNAL);
+	sigprocmask(SIG_UNBLOCK, &s, NULL);
+}
+
+void
+Swi_restore(UInt key)
+{
+	if (!key)
+		Swi_enable();
+}
+
+UInt32
+Clock_getTicks(void)
+{
+	return Timestamp_get32() / (Clock_tickPeriod * 1000);
+}
+
+// a 1 GHz timestamp: nanoseconds, wrapping at 32 bits like TSCL; HOST_NOW while HOST_VCLOCK is set
+Bool	HOST_VCLOCK;
+UInt32	HOST_NOW;
+UInt32	HOST_VCLOCK_STEP;
+void	(*HOST_VCLOCK_HOOK)(void);
+
+UInt32
+Timestamp_get32(void)
+{
+	struct timespec ts;
+
+	if (HOST_VCLOCK)
+	{
+		HOST_NOW += HOST_VCLOCK_STEP;
+		if (HOST_VCLOCK_HOOK != NULL)
+			HOST_VCLOCK_HOOK();
+		return HOST_NOW;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (UInt32)((Uint64)ts.tv_sec * 1000000000u + ts.tv_nsec);
+}
+
+void
+Timestamp_getFreq(Types_FreqHz* freq)
+{
+	freq->hi = 0;
+	freq->lo = 1000000000u;
+}
+
+///// Variable.h: the VAR library is not built here; no units, no bounds /////
+void
+COIL_Initialize(COIL* c, Uint8 val, Swi_Handle swi)
+{
+	c->val = val;
+	c->swi = swi;
+}
+
+BOOL
+VAR_Update(VAR* v, double valin, BOOL user_unit)
+{
+	(void)user_unit;
+
+	v->base_val	= valin;
+	v->calc_val	= valin;
+	v->val		= (float)valin;
+	return TRUE;
+}
+
+BOOL	VAR_Check_Bounds(VAR* v, double* t)									{ (void)v; (void)t; return TRUE; }
+float	VAR_Get_Unit_Param(VAR* v, unsigned int p, int type, BOOL user_unit)	{ (void)v; (void)p; (void)type; (void)user_unit; return 0; }
+
+///// Log.c is not built here (the USB stack): its history, filled by host_history_add() /////
+static Uint16	HOST_HIST[HIST_RECORDS][HIST_WORDS];
+static Uint32	HOST_HIST_SEQ;
+
+// record History_Seq() in History_Record()'s layout, the time packed as it packs it
+void
+host_history_add(Uint32 rtc, Uint32 diag, const float* val)
+{
+	Uint16*	w = HOST_HIST[HOST_HIST_SEQ % HIST_RECORDS];
+	Uint32	i, u;
+
+	w[0] = HOST_HIST_SEQ >> 16;
+	w[1] = HOST_HIST_SEQ & 0xFFFF;
+	w[2] = rtc >> 16;
+	w[3] = rtc & 0xFFFF;
+	w[4] = diag >> 16;
+	w[5] = diag & 0xFFFF;
+	for (i=0;i<HIST_VALUES;i++)
+	{
+		memcpy(&u, &val[i], sizeof(u));
+		w[6 + 2*i] = u >> 16;
+		w[7 + 2*i] = u & 0xFFFF;
+	}
+	HOST_HIST_SEQ++;
+}
+
+Uint32
+History_Seq(void)
+{
+	return HOST_HIST_SEQ;
+}
+
+BOOL
+History_Read(Uint32 slot, Uint32 word, Uint32 n, Uint8* dst)
+{
+	const Uint16*	w;
+	Uint32			i;
+
+	word += slot * HIST_WORDS;
+	if (word + n > (Uint32)HIST_RECORDS * HIST_WORDS)
+		return FALSE;
+
+	w = &HOST_HIST[0][0] + word;
+	for (i=0;i<n;i++)
+	{
+		*dst++ = w[i] >> 8;
+		*dst++ = w[i] & 0xFF;
+	}
+	return TRUE;
+}
+
+///// UART2 receiver: one byte in RBR at a time /////
+static Uint8	HOST_UART_RBR;
+static Bool		HOST_UART_READY;	// LSR.DR
+
+Uint32
+host_uart_fextr(volatile Uint32* reg)
+{
+	if (reg == &HOST_REGS.IIR)
+		return HOST_UART_READY ? RX_DATA_RDY_INT : NOTHING_INT;
+	if (reg == &HOST_REGS.LSR)
+		return 0x60 | HOST_UART_READY;	// THRE and TEMT: nothing is ever waiting to go out
+
+	return 0;
+}
+
+Uint32
+host_uart_rbr(void)
+{
+	HOST_UART_READY = FALSE;
+	return HOST_UART_RBR;
+}
+
+/***************************************************************************
+ * host_uart_byte() - b arrives on UART2 at timestamp now
+ * Uart_ISR() runs and reads it, as the receive interrupt would; HOST_VCLOCK
+ * is left set at now.
+ ***************************************************************************/
+void
+host_uart_byte(Uint8 b, Uint32 now)
+{
+	HOST_VCLOCK		= TRUE;
+	HOST_NOW		= now;
+	HOST_UART_RBR	= b;
+	HOST_UART_READY	= TRUE;
+
+	Uart_ISR();
+}
+
+///// HOST TRANSPORT /////
+HOST_RESPONSE	HOST_RSP;
+int				HOST_FAILS;
+
+static void
+host_send(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n)
+{
+	(void)ctx;
+
+	memcpy(HOST_RSP.frame, frame, n);
+	HOST_RSP.n = n;
+	HOST_RSP.tag = tag;
+	HOST_RSP.count++;
+
+	// the frame is "on the line" and gone at once
+	MB_TX_IN_PROGRESS = FALSE;
+}
+
+const MB_TX_DRIVER HOST_DRV = { host_send, NULL };
+
+void
+host_init(void)
+{
+	Init_Modbus();
+	Init_Uart();	// 9600 baud frame timing; the registers are HOST_REGS
+	MB_TX_Set_Driver(&HOST_DRV);
+
+	REG_SLAVE_ADDRESS	= HOST_SLAVE;
+	REG_MB_SENTINEL		= 0xFFFF;
+	COIL_UNLOCKED.val	= FALSE;
+}
+
+// MB_Start_Clock_Response: answer everything that is queued
+void
+host_run(void)
+{
+	Uint32 guard;
+
+	for (guard=0;(MB_PKT_LIST.n > 0) && (guard < MAX_MB_BFR*2);guard++)
+		MB_Dispatch();
+}
+
+/***************************************************************************
+ * host_frame() - slave, PDU and CRC as they would arrive on the line
+ * @return	- frame length
+ ***************************************************************************/
+Uint32
+host_frame(Uint8* frame, Uint8 slave, const Uint8* pdu, Uint32 pdu_n)
+{
+	Uint16 CRC;
+
+	frame[0] = slave;
+	memcpy(&frame[1], pdu, pdu_n);
+	CRC = Calc_CRC(frame, pdu_n + 1);
+	frame[pdu_n + 1] = CRC & 0xFF;	// LSB
+	frame[pdu_n + 2] = CRC >> 8;	// MSB
+
+	return pdu_n + 3;
+}
+
+/***************************************************************************
+ * host_request() - one request to HOST_SLAVE, answered before returning
+ * @return	- length of the response in HOST_RSP, 0 if there was none
+ ***************************************************************************/
+Uint32
+host_request(const Uint8* pdu, Uint32 pdu_n)
+{
+	Uint8	frame[MB_FRAME_SIZE];
+	Uint32	n, count;
+
+	n = host_frame(frame, HOST_SLAVE, pdu, pdu_n);
+	count = HOST_RSP.count;
+
+	MB_RX_Submit(frame, n, &HOST_DRV, 0);
+	host_run();
+
+	return (HOST_RSP.count != count) ? HOST_RSP.n : 0;
+}
+
+/***************************************************************************
+ * host_xfer() - HOST_XFER into the firmware linked here (ctx unused), so
+ * the masters run without a server: the response PDU, or 0
+ ***************************************************************************/
+Uint32
+host_xfer(void* ctx, const Uint8* pdu, Uint32 pdu_n, Uint8* rsp)
+{
+	Uint32 n;
+
+	(void)ctx;
+	n = host_request(pdu, pdu_n);
+	if (n < 4)
+		return 0;
+
+	memcpy(rsp, &HOST_RSP.frame[1], n - 3);	// the address and the CRC off
+	return n - 3;
+}
@@ -0,0 +1,154 @@
+/*------------------------------------------------------------------------
+* host_master.c
+*-------------------------------------------------------------------------
+* A Modbus TCP client for the host tools: one connection to one unit,
+* one request outstanding. Responses whose transaction id is not that of
+* the request (late answers to a request that already timed out) are
+* dropped. Works against mb_tcpd or any Modbus TCP gateway.
+*------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <netdb.h>
+#undef NO_DATA	// PDI_I2C.h has one of its own
+#include <poll.h>
+#include <stdlib.h>
+#define truncate unistd_truncate	// Globals.h has a truncate() of its own
+#include <unistd.h>
+#undef truncate
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "host.h"
+
+/***************************************************************************
+ * host_master_open() - connects to host:port
+ * @return	- 0, or -1 with errno set
+ ***************************************************************************/
+int
+host_master_open(HOST_MASTER* m, const char* host, Uint32 port, Uint8 unit)
+{
+	struct addrinfo	hints, *ai, *p;
+	char			service[8];
+	int				one = 1;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family		= AF_UNSPEC;
+	hints.ai_socktype	= SOCK_STREAM;
+	snprintf(service, sizeof(service), "%u", port);
+
+	m->fd = -1;
+	if (getaddrinfo(host, service, &hints, &ai) != 0)
+	{
+		errno = EHOSTUNREACH;
+		return -1;
+	}
+
+	for (p=ai;(p != NULL) && (m->fd < 0);p=p->ai_next)
+	{
+		m->fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+		if (m->fd < 0)
+			continue;
+
+		if (connect(m->fd, p->ai_addr, p->ai_addrlen) < 0)
+		{
+			close(m->fd);
+			m->fd = -1;
+		}
+	}
+	freeaddrinfo(ai);
+
+	if (m->fd < 0)
+		return -1;
+
+	setsockopt(m->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	m->unit = unit;
+	m->tid = 0;
+	if (m->timeout_ms == 0)
+		m->timeout_ms = 1000;
+
+	return 0;
+}
+
+void
+host_master_close(HOST_MASTER* m)
+{
+	if (m->fd >= 0)
+		close(m->fd);
+	m->fd = -1;
+}
+
+// n bytes, or FALSE on a timeout or a closed connection
+static BOOL
+recv_all(HOST_MASTER* m, Uint8* dst, Uint32 n)
+{
+	struct pollfd	pfd;
+	ssize_t			k;
+
+	while (n > 0)
+	{
+		pfd.fd		= m->fd;
+		pfd.events	= POLLIN;
+		if (poll(&pfd, 1, (int)m->timeout_ms) <= 0)
+			return FALSE;
+
+		k = recv(m->fd, dst, n, 0);
+		if (k <= 0)
+			return FALSE;
+
+		dst += k;
+		n	-= k;
+	}
+
+	return TRUE;
+}
+
+/***************************************************************************
+ * host_master_xfer() - HOST_XFER over Modbus TCP; ctx is a HOST_MASTER
+ * A timeout or a broken connection closes the connection, so the caller
+ * can tell a lost link (m->fd < 0) from one lost response.
+ ***************************************************************************/
+Uint32
+host_master_xfer(void* ctx, const Uint8* pdu, Uint32 pdu_n, Uint8* rsp)
+{
+	HOST_MASTER*	m = (HOST_MASTER*)ctx;
+	Uint8			adu[MBTCP_ADU_SIZE];
+	Uint32			n;
+
+	if ( (m->fd < 0) || (pdu_n > MBTCP_PDU_SIZE) )
+		return 0;
+
+	m->tid++;
+	adu[0] = m->tid >> 8;
+	adu[1] = m->tid & 0xFF;
+	adu[2] = 0;	// protocol: Modbus
+	adu[3] = 0;
+	adu[4] = (pdu_n + 1) >> 8;
+	adu[5] = (pdu_n + 1) & 0xFF;
+	adu[6] = m->unit;
+	memcpy(&adu[MBTCP_MBAP_SIZE], pdu, pdu_n);
+
+	if (send(m->fd, adu, MBTCP_MBAP_SIZE + pdu_n, MSG_NOSIGNAL) != (ssize_t)(MBTCP_MBAP_SIZE + pdu_n))
+	{
+		host_master_close(m);
+		return 0;
+	}
+
+	for (;;)
+	{
+		if (!recv_all(m, adu, MBTCP_MBAP_SIZE))
+			break;
+
+		n = (adu[4] << 8) | adu[5];
+		if ( (n < 2) || (n > MBTCP_PDU_SIZE + 1) || (adu[2] != 0) || (adu[3] != 0) )
+			break;	// not Modbus TCP: the stream cannot be trusted any more
+
+		if (!recv_all(m, rsp, n - 1))
+			break;
+
+		if ( (((adu[0] << 8) | adu[1]) == m->tid) && (adu[6] == m->unit) )
+			return n - 1;
+	}
+
+	host_master_close(m);
+	return 0;
+}
@@ -0,0 +1,120 @@
+/*------------------------------------------------------------------------
+* host_tcp.c
+*-------------------------------------------------------------------------
+* The socket side ModbusTCP.c leaves to its caller, on Linux: accept()
+* calls MBTCP_Open(), received bytes go to MBTCP_Receive(), and a closed
+* connection gets MBTCP_Close(). One poll() loop serves the listener and
+* every client, so the firmware stack is only ever entered from one
+* place at a time, as Swi_Modbus_RX and the Clock Swis are on the target.
+* Shared by mb_tcpd and the --tcp mode of mb_load.
+*------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <poll.h>
+#define truncate unistd_truncate	// Globals.h has a truncate() of its own
+#include <unistd.h>
+#undef truncate
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "host.h"
+
+static MBTCP_CONN	TCP_CONN[HOST_TCP_CLIENTS];
+static int			TCP_FD[HOST_TCP_CLIENTS];
+
+// MBTCP_CONN.write: the whole ADU, or nothing once the peer is gone
+static void
+tcp_write(void* sock, const Uint8* adu, Uint32 n)
+{
+	ssize_t k;
+
+	while (n > 0)
+	{
+		k = send(*(int*)sock, adu, n, MSG_NOSIGNAL);
+		if (k < 0)
+		{
+			if (errno == EINTR) continue;
+			return;	// the read side sees the close and calls MBTCP_Close()
+		}
+		adu += k;
+		n	-= k;
+	}
+}
+
+static void
+tcp_accept(int listen_fd)
+{
+	int fd, k, one = 1;
+
+	fd = accept(listen_fd, NULL, NULL);
+	if (fd < 0)
+		return;
+
+	for (k=0;(k < HOST_TCP_CLIENTS) && (TCP_FD[k] >= 0);k++);
+	if (k == HOST_TCP_CLIENTS)
+	{ // no room: refuse, as a gateway with all its slots in use would
+		close(fd);
+		return;
+	}
+
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	TCP_FD[k] = fd;
+	MBTCP_Open(&TCP_CONN[k], tcp_write, &TCP_FD[k]);
+}
+
+/***************************************************************************
+ * host_tcp_serve() - Modbus TCP server on an already listening socket
+ * Up to HOST_TCP_CLIENTS connections at a time. Every request is answered
+ * before the next read, so a connection is never freed with requests of
+ * its own still queued. Returns only if poll() fails.
+ ***************************************************************************/
+void
+host_tcp_serve(int listen_fd)
+{
+	struct pollfd	pfd[1 + HOST_TCP_CLIENTS];
+	Uint8			bytes[MBTCP_ADU_SIZE];
+	ssize_t			n;
+	int				k;
+
+	for (k=0;k<HOST_TCP_CLIENTS;k++)
+		TCP_FD[k] = -1;
+
+	for (;;)
+	{
+		pfd[0].fd		= listen_fd;
+		pfd[0].events	= POLLIN;
+		for (k=0;k<HOST_TCP_CLIENTS;k++)
+		{
+			pfd[1 + k].fd		= TCP_FD[k];	// negative: ignored
+			pfd[1 + k].events	= POLLIN;
+			pfd[1 + k].revents	= 0;
+		}
+
+		if (poll(pfd, 1 + HOST_TCP_CLIENTS, -1) < 0)
+		{
+			if (errno == EINTR) continue;
+			return;
+		}
+
+		for (k=0;k<HOST_TCP_CLIENTS;k++)
+		{
+			if ((TCP_FD[k] < 0) || (pfd[1 + k].revents == 0))
+				continue;
+
+			n = recv(TCP_FD[k], bytes, sizeof(bytes), 0);
+			if (n <= 0)
+			{
+				MBTCP_Close(&TCP_CONN[k]);
+				close(TCP_FD[k]);
+				TCP_FD[k] = -1;
+				continue;
+			}
+
+			MBTCP_Receive(&TCP_CONN[k], bytes, (Uint32)n);
+			host_run();
+		}
+
+		if (pfd[0].revents & POLLIN)
+			tcp_accept(listen_fd);
+	}
+}
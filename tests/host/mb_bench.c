@@ -0,0 +1,487 @@
+/*------------------------------------------------------------------------
+* mb_bench.c
+*-------------------------------------------------------------------------
+* Before/after timings of the firmware's Modbus fast paths (make bench,
+* ahead of mb_load). Each section runs the code as it is in this tree
+* against a copy of the code it replaced, kept here as the reference, on
+* the same inputs; the two must agree before either is timed.
+*
+*   index	MB_Tbl_Search_FloatRegs(): the direct index (MB_IDX_FLOAT)
+*			against the linear scan of MB_TBL_FLOAT it replaced
+*   crc		Calc_CRC(): the table (MB_CRC_TABLE) against the bit-by-bit
+*			loop it replaced, over a request and a full-size frame
+*   cache	a 0x03 read of the longest run of float registers, served
+*			from the image MB_Float_Cache_Refresh() pre-encodes and, after
+*			a register write, from the tables as before the cache
+*   tx		a 60-float response from its encoder to the UART FIFO: built in
+*			a frame and queued with Ring_Write() for Uart_ISR(), against
+*			the per-byte BfrPut() into UART_TXBUF and BfrGet() 15 at a
+*			time per interrupt they replaced
+*
+*   mb_bench [--rounds N]
+*
+* The times are host times, for comparing the two columns, not for what
+* the C6748 takes. Exits 1 if a reference and the firmware disagree.
+*------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "host.h"
+
+#define BENCH_FLOATS		(60)	// most floats in one read: 120 registers, 240 bytes
+#define BENCH_CACHE_END		(800)	// first register past MB_FLT_CACHE (MB_FLT_CACHE_REGS*2)
+#define BENCH_WRITE_REG		(31)	// REG_TEMP_ADJUST, PASSWD
+#define BENCH_BFR_SIZE		(1024)	// MAX_BFR_SIZE of the old UART_TXBUF
+
+static Uint32 ROUNDS = 200;
+static volatile Uint32 SINK;	// keeps the timed loops from being optimized away
+static int FAILED;
+
+static double
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void
+report(const char* name, const char* per, double before, double after)
+{
+	printf("%-8s before %9.1f ns/%s   after %9.1f ns/%s   %6.1fx\n",
+			name, before, per, after, per, (after > 0) ? before / after : 0);
+}
+
+static void
+disagree(const char* name, Uint32 at)
+{
+	fprintf(stderr, "%s: reference and firmware disagree at %u\n", name, at);
+	FAILED = 1;
+}
+
+///// index: direct index vs linear scan /////
+
+// MB_Tbl_Search_FloatRegs() before MB_IDX_FLOAT
+static Int8 __attribute__((noinline))
+ref_search_float(Uint16 reg_num, double **mbtable_ptr, Uint8 *data_type, Uint8 *prot_status)
+{
+	Uint16 i = 0;
+
+	while (MB_TBL_FLOAT[i][0] != 0) //address 0 = end of table
+	{
+		if ( MB_TBL_FLOAT[i][0] == reg_num) break;
+		else i++;
+	}
+	if (MB_TBL_FLOAT[i][0] == 0)		// reached end of the list
+	{
+		*mbtable_ptr = (double*)NULL;
+		return -1; //not found
+	}
+
+	*data_type = MB_TBL_FLOAT[i][1];
+	*prot_status = (Uint8) MB_TBL_FLOAT[i][2];
+	*mbtable_ptr = (double*) MB_TBL_FLOAT[i][3];
+
+	return 0;
+}
+
+// every float register, and every odd address below the last (the second word of one, or none)
+static void
+bench_index(void)
+{
+	Uint16	regs[2048];
+	Uint32	n, i, r;
+	double	t0, before, after;
+	double	*p, *q;
+	Uint8	dt, dq, pt, pq;
+	Int8	a, b;
+
+	for (n=0;(MB_TBL_FLOAT[n][0] != 0) && (n < sizeof(regs)/sizeof(regs[0])/2);n++)
+		regs[n] = (Uint16)MB_TBL_FLOAT[n][0];
+	for (i=0;(i < n) && (n < sizeof(regs)/sizeof(regs[0]));i++)
+		regs[n++] = regs[i] + 1;
+
+	for (i=0;i<n;i++)
+	{
+		dt = dq = pt = pq = 0;
+		a = MB_Tbl_Search_FloatRegs(regs[i], &p, &dt, &pt);
+		b = ref_search_float(regs[i], &q, &dq, &pq);
+		if ( (a != b) || (p != q) || ((a == 0) && ((dt != dq) || (pt != pq))) )
+			disagree("index", regs[i]);
+	}
+
+	t0 = now_ns();
+	for (r=0;r<ROUNDS;r++)
+		for (i=0;i<n;i++)
+			SINK += ref_search_float(regs[i], &q, &dq, &pq);
+	before = (now_ns() - t0) / ((double)ROUNDS * n);
+
+	t0 = now_ns();
+	for (r=0;r<ROUNDS;r++)
+		for (i=0;i<n;i++)
+			SINK += MB_Tbl_Search_FloatRegs(regs[i], &p, &dt, &pt);
+	after = (now_ns() - t0) / ((double)ROUNDS * n);
+
+	report("index", "lookup", before, after);
+}
+
+///// crc: table vs bitwise /////
+
+// Calc_CRC() before MB_CRC_TABLE, over a frame that does not wrap in UART_RXBUF
+static Uint16 __attribute__((noinline))
+ref_crc(const Uint8* s, Uint32 n)
+{
+	Uint32 i,j;
+	unsigned int t;
+	unsigned int CRC;
+	Uint32 key;
+
+	key = Hwi_disableInterrupt(5);
+
+	CRC = 0xFFFF;
+
+	for(j=0;j<n;j++)
+	{
+		t = s[j];
+
+		CRC ^= (t & 0xFF);
+
+		for (i=0;i<8;i++)
+		{
+			if (CRC & 0x01) //if LSB is set
+			{
+				CRC >>= 1;	//shift right
+				CRC ^= 0xA001; //XOR with 0xA001
+			}
+			else
+				CRC >>= 1;	//shift right
+		}
+	}
+
+	Hwi_restoreInterrupt(5,key);
+	return (Uint16)CRC;
+}
+
+static void
+bench_crc(const char* name, Uint32 n)
+{
+	Uint8	frame[MB_FRAME_SIZE];
+	Uint32	i, r, rounds;
+	double	t0, before, after;
+
+	for (i=0;i<n;i++)
+		frame[i] = (Uint8)(i * 37 + 11);
+	for (i=1;i<=n;i++)
+	{
+		if (Calc_CRC(frame, i) != ref_crc(frame, i))
+			disagree(name, i);
+	}
+
+	rounds = ROUNDS * 256 * 16 / n;
+	t0 = now_ns();
+	for (r=0;r<rounds;r++)
+	{
+		frame[0] = (Uint8)r;
+		SINK += ref_crc(frame, n);
+	}
+	before = (now_ns() - t0) / rounds;
+
+	t0 = now_ns();
+	for (r=0;r<rounds;r++)
+	{
+		frame[0] = (Uint8)r;
+		SINK += Calc_CRC(frame, n);
+	}
+	after = (now_ns() - t0) / rounds;
+
+	report(name, "frame", before, after);
+}
+
+///// cache: cached vs uncached float reads /////
+
+// a normal response to a read of n floats from reg
+static BOOL
+read_floats(Uint16 reg, Uint32 n)
+{
+	Uint8 pdu[5] = { 0x03, (reg - 1) >> 8, reg - 1, 0, n * 2 };
+
+	return (host_request(pdu, sizeof(pdu)) == 5 + 4*n) && (HOST_RSP.frame[1] == 0x03);
+}
+
+// a float register written back with what it holds: the cache reads the tables until the next refresh
+static void
+dirty_cache(void)
+{
+	Uint8 pdu[10] = { 0x10, 0, BENCH_WRITE_REG - 1, 0, 2, 4 };
+
+	if (!read_floats(BENCH_WRITE_REG, 1))
+		disagree("cache", BENCH_WRITE_REG);
+	memcpy(&pdu[6], &HOST_RSP.frame[3], 4);
+	COIL_UNLOCKED.val = TRUE;
+	if ( (host_request(pdu, sizeof(pdu)) != 8) || (HOST_RSP.frame[1] != 0x10) )
+		disagree("cache", BENCH_WRITE_REG);
+	COIL_UNLOCKED.val = FALSE;
+}
+
+static void
+bench_cache(void)
+{
+	Uint8	cached[MB_FRAME_SIZE];
+	Uint16	reg, best_reg;
+	Uint32	i, k, n, best_n, r, rounds;
+	double	t0, before, after;
+
+	// the longest run of consecutive float registers in the cache's range that reads back whole
+	best_reg = 0;
+	best_n = 0;
+	for (i=0;MB_TBL_FLOAT[i][0] != 0;i+=k)
+	{
+		reg = (Uint16)MB_TBL_FLOAT[i][0];
+		for (k=1;(MB_TBL_FLOAT[i+k][0] == reg + 2*k) && (k < BENCH_FLOATS);k++);
+		if ( ((reg & 1) == 0) || (reg + 2*k > BENCH_CACHE_END) )
+			continue;
+
+		for (n=k;(n > best_n) && !read_floats(reg, n);n--);
+		if (n > best_n)
+		{
+			best_reg = reg;
+			best_n = n;
+		}
+	}
+
+	MB_Float_Cache_Refresh();
+	if (!read_floats(best_reg, best_n))
+		disagree("cache", best_reg);
+	memcpy(cached, HOST_RSP.frame, HOST_RSP.n);
+	dirty_cache();
+	if ( !read_floats(best_reg, best_n) || (memcmp(cached, HOST_RSP.frame, HOST_RSP.n) != 0) )
+		disagree("cache", best_reg);
+
+	rounds = ROUNDS * 20;
+	t0 = now_ns();
+	for (r=0;r<rounds;r++)
+		SINK += read_floats(best_reg, best_n);
+	before = (now_ns() - t0) / rounds;
+
+	MB_Float_Cache_Refresh();
+	if ( !read_floats(best_reg, best_n) || (memcmp(cached, HOST_RSP.frame, HOST_RSP.n) != 0) )
+		disagree("cache", best_reg);
+	t0 = now_ns();
+	for (r=0;r<rounds;r++)
+		SINK += read_floats(best_reg, best_n);
+	after = (now_ns() - t0) / rounds;
+
+	report("cache", "read", before, after);
+	printf("         (%u floats from register %u, request to response)\n", best_n, best_reg);
+}
+
+///// tx: the TX driver vs the old path /////
+
+// UART_TXBUF, BfrPut() and BfrGet() before the ring and the TX driver
+typedef struct { //circular FIFO buffer
+			int		head;
+			int		tail;
+			int		n;
+			Uint16		gseed;
+			Uint16		crc16;
+			unsigned int	buff[BENCH_BFR_SIZE];
+		} REF_BFR;
+
+static REF_BFR REF_TXBUF;
+
+static int __attribute__((noinline))
+ref_bfr_put(volatile REF_BFR* buffer, Uint8 in_byte)
+{
+	Uint32 key;
+
+	key = Hwi_disableInterrupt(5);
+	buffer->buff[buffer->tail] = in_byte; //write byte at tail
+
+	//increment tail
+	buffer->tail++;
+	if ((buffer->tail)>=BENCH_BFR_SIZE)
+		buffer->tail -= BENCH_BFR_SIZE;
+
+	buffer->n++; //inc number of buffer elements
+	if ((buffer->n) < BENCH_BFR_SIZE)
+	{
+		Hwi_restoreInterrupt(5,key);
+		return 0; // no buffer overwrite happened
+	}
+	else
+	{	//buffer overwrite
+		buffer->n = BENCH_BFR_SIZE; //we're still at max capacity
+		Hwi_restoreInterrupt(5,key);
+		return ERROR_VAL;
+	}
+}
+
+static Uint8 __attribute__((noinline))
+ref_bfr_get(volatile REF_BFR* buffer)
+{
+	Uint8 out_byte;
+	Uint32 key;
+
+	key = Hwi_disableInterrupt(5);
+	if (buffer->n <= 0) //if buffer empty
+	{
+		Hwi_restoreInterrupt(5,key);
+		buffer->n = 0;
+		buffer->head = buffer->tail;
+		return 0;
+	}
+
+	out_byte = buffer->buff[buffer->head]; //read byte at tail
+
+	//increment head
+	buffer->head++;
+	if ((buffer->head) >= BENCH_BFR_SIZE)
+		buffer->head -= BENCH_BFR_SIZE;
+
+	buffer->n--; //dec number of buffer elements
+
+	Hwi_restoreInterrupt(5,key);
+	return out_byte;
+}
+
+// the transmit half of Uart_ISR() before the ring: one THR empty interrupt
+static void __attribute__((noinline))
+ref_uart_isr(void)
+{
+	Uint32 i;
+
+	if ( (CSL_FEXT(uartRegs->LSR,UART_LSR_TEMT) == 1) && (REF_TXBUF.n > 0) )
+	{
+		for (i=0;i<UART_FIFO_SIZE-1;i++)
+		{
+			if (REF_TXBUF.n > 0) //transfer from SW TX buffer to HW TX FIFO
+				CSL_FINS(uartRegs->THR,UART_THR_DATA,ref_bfr_get(&REF_TXBUF));
+		}
+	}
+}
+
+// old path: each byte into UART_TXBUF as it is encoded; the interrupts it takes to send
+static Uint32
+ref_tx(const Uint8* rsp, Uint32 n)
+{
+	Uint32	key, i, ints;
+	Uint16	CRC;
+
+	key = Hwi_disableInterrupt(5); ////
+	for (i=0;i<n;i++)
+		ref_bfr_put(&REF_TXBUF, rsp[i]);
+	CRC = Calc_CRC(rsp, n);
+	ref_bfr_put(&REF_TXBUF, CRC & 0xFF);	// LSB
+	ref_bfr_put(&REF_TXBUF, CRC >> 8);		// MSB
+	Hwi_restoreInterrupt(5,key);
+
+	for (ints=0;REF_TXBUF.n > 0;ints++)
+		ref_uart_isr();
+	return ints;
+}
+
+// TX driver: MB_TX_Put() into a frame and MB_TX_Put_CRC()
+static Uint32
+drv_frame(const Uint8* rsp, Uint32 n, Uint8* frame)
+{
+	Uint32	frame_n, i;
+	Uint16	CRC;
+
+	frame_n = 0;
+	for (i=0;i<n;i++)
+	{
+		if (frame_n < MB_FRAME_SIZE)
+			frame[frame_n++] = rsp[i];
+	}
+	CRC = Calc_CRC(frame, frame_n);
+	frame[frame_n++] = CRC & 0xFF;	// LSB
+	frame[frame_n++] = CRC >> 8;	// MSB
+
+	return frame_n;
+}
+
+// then MB_TX_Uart_Send() and Uart_ISR() per interrupt
+static Uint32
+drv_tx(const Uint8* rsp, Uint32 n)
+{
+	static Uint8	frame[MB_FRAME_SIZE];
+	Uint32			ints;
+
+	Ring_Write(&UART_TXBUF, frame, drv_frame(rsp, n, frame));
+	for (ints=0;Ring_Count(&UART_TXBUF) > 0;ints++)
+		Uart_ISR();
+	return ints;
+}
+
+static void
+bench_tx(void)
+{
+	Uint8	rsp[3 + 4*BENCH_FLOATS], sent[MB_FRAME_SIZE], frame[MB_FRAME_SIZE];
+	Uint32	n, i, r, rounds, ref_ints, drv_ints;
+	double	t0, before, after;
+
+	rsp[0] = HOST_SLAVE;
+	rsp[1] = 0x03;
+	rsp[2] = 4*BENCH_FLOATS;
+	for (i=3;i<sizeof(rsp);i++)
+		rsp[i] = (Uint8)(i * 53 + 7);
+	n = sizeof(rsp);
+
+	// both queue the same bytes for the FIFO
+	for (i=0;i<n;i++)
+		ref_bfr_put(&REF_TXBUF, rsp[i]);
+	i = Calc_CRC(rsp, n);
+	ref_bfr_put(&REF_TXBUF, i & 0xFF);
+	ref_bfr_put(&REF_TXBUF, i >> 8);
+	for (i=0;REF_TXBUF.n > 0;i++)
+		sent[i] = ref_bfr_get(&REF_TXBUF);
+	if ( (drv_frame(rsp, n, frame) != i) || (memcmp(frame, sent, i) != 0) )
+		disagree("tx", i);
+
+	Ring_Init(&UART_TXBUF);
+	ref_ints = ref_tx(rsp, n);
+	drv_ints = drv_tx(rsp, n);
+
+	rounds = ROUNDS * 50;
+	t0 = now_ns();
+	for (r=0;r<rounds;r++)
+		SINK += ref_tx(rsp, n);
+	before = (now_ns() - t0) / rounds;
+
+	t0 = now_ns();
+	for (r=0;r<rounds;r++)
+		SINK += drv_tx(rsp, n);
+	after = (now_ns() - t0) / rounds;
+
+	report("tx", "frame", before, after);
+	printf("         (%u bytes: %u THR empty interrupts before, %u after)\n", n + 2, ref_ints, drv_ints);
+}
+
+int
+main(int argc, char** argv)
+{
+	int i;
+
+	for (i=1;i<argc-1;i+=2)
+	{
+		if (strcmp(argv[i], "--rounds") == 0)	ROUNDS = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else break;
+	}
+
+	if ( (i != argc) || (ROUNDS == 0) )
+	{
+		fprintf(stderr, "usage: mb_bench [--rounds N]\n");
+		return 2;
+	}
+
+	host_init();
+	bench_index();
+	bench_crc("crc 8", 8);
+	bench_crc("crc 256", 256);
+	bench_cache();
+	bench_tx();
+
+	return FAILED;
+}
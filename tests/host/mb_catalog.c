@@ -0,0 +1,84 @@
+/*------------------------------------------------------------------------
+* mb_catalog.c
+*-------------------------------------------------------------------------
+* Reads the register catalog (MB_FILE_CATALOG) from an analyzer over
+* Modbus TCP (cat_master.c) and writes it to stdout as JSON, or as a CSV
+* import file for a SCADA tag database: one line per register with its
+* address, size, type, access, unit and bounds.
+*
+*   mb_catalog [--host A] [--port N] [--unit N] [--csv 1] [--local 1]
+*
+* --local 1 reads the catalog of the firmware built into the tool
+* instead, no analyzer or mb_tcpd needed ("make catalog" does this).
+* Exits 0 once written, 1 if the analyzer refused the read, 2 if it could
+* not be reached.
+*------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+
+#define CATALOG_MAX	(1024)	// entries
+
+static CAT_ENTRY CATALOG[CATALOG_MAX];
+
+int
+main(int argc, char** argv)
+{
+	HOST_MASTER	link;
+	const char*	host;
+	Uint32		port, unit, n;
+	int			i, csv, local, rc;
+
+	host	= "127.0.0.1";
+	port	= MBTCP_PORT;
+	unit	= HOST_SLAVE;
+	csv		= 0;
+	local	= 0;
+	for (i=1;i<argc-1;i+=2)
+	{
+		if (strcmp(argv[i], "--host") == 0)			host = argv[i+1];
+		else if (strcmp(argv[i], "--port") == 0)	port = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--unit") == 0)	unit = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--csv") == 0)		csv = atoi(argv[i+1]);
+		else if (strcmp(argv[i], "--local") == 0)	local = atoi(argv[i+1]);
+		else break;
+	}
+
+	if ( (i != argc) || (port == 0) || (port > 0xFFFF) || (unit > 0xFF) )
+	{
+		fprintf(stderr, "usage: mb_catalog [--host A] [--port N] [--unit N] [--csv 1] [--local 1]\n");
+		return 2;
+	}
+
+	if (local)
+	{
+		host_init();
+		rc = cat_master_read(host_xfer, NULL, CATALOG, CATALOG_MAX, &n);
+	}
+	else
+	{
+		memset(&link, 0, sizeof(link));
+		link.fd = -1;
+		if (host_master_open(&link, host, port, (Uint8)unit) < 0)
+		{
+			perror("connect");
+			return 2;
+		}
+		rc = cat_master_read(host_master_xfer, &link, CATALOG, CATALOG_MAX, &n);
+		host_master_close(&link);
+	}
+
+	if (rc != CAT_OK)
+	{
+		fprintf(stderr, "catalog: %s\n", (rc == CAT_LINK) ? "no response" : "refused");
+		return (rc == CAT_LINK) ? 2 : 1;
+	}
+
+	if (csv)
+		cat_write_csv(stdout, CATALOG, n);
+	else
+		cat_write_json(stdout, CATALOG, n);
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+/*------------------------------------------------------------------------
+* mb_fwload.c
+*-------------------------------------------------------------------------
+* Sends a firmware image to the analyzer over Modbus TCP (fw_master.c)
+* and commits it. When the connection drops the tool reconnects and the
+* transfer resumes from the first chunk the analyzer is still missing.
+* The analyzer must be unlocked from the front panel first (or mb_tcpd
+* started with --unlocked 1).
+*
+*   mb_fwload [--host A] [--port N] [--unit N] [--reconnects N] image.bin
+*
+* Exits 0 once the image is committed, 1 if the analyzer refused it, 2 if
+* the link could not be kept up.
+*------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#define truncate unistd_truncate	// Globals.h has a truncate() of its own
+#include <unistd.h>
+#undef truncate
+#include "host.h"
+
+static Uint8 IMAGE[FW_MAX_SIZE];
+
+static const char*
+fw_state(Uint16 s)
+{
+	static const char* NAMES[] = { "idle", "receiving", "complete", "committing", "bad image", "failed" };
+
+	return (s < sizeof(NAMES)/sizeof(NAMES[0])) ? NAMES[s] : "?";
+}
+
+int
+main(int argc, char** argv)
+{
+	HOST_MASTER	link;
+	FW_MASTER	m;
+	const char*	host;
+	FILE*		f;
+	Uint32		port, unit, reconnects, size, k;
+	int			i, rc;
+
+	host		= "127.0.0.1";
+	port		= MBTCP_PORT;
+	unit		= HOST_SLAVE;
+	reconnects	= 5;
+	for (i=1;i<argc-2;i+=2)
+	{
+		if (strcmp(argv[i], "--host") == 0)				host = argv[i+1];
+		else if (strcmp(argv[i], "--port") == 0)		port = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--unit") == 0)		unit = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--reconnects") == 0)	reconnects = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else break;
+	}
+
+	if ( (i != argc-1) || (port == 0) || (port > 0xFFFF) || (unit > 0xFF) )
+	{
+		fprintf(stderr, "usage: mb_fwload [--host A] [--port N] [--unit N] [--reconnects N] image.bin\n");
+		return 2;
+	}
+
+	f = fopen(argv[i], "rb");
+	if (f == NULL)
+	{
+		perror(argv[i]);
+		return 2;
+	}
+	size = (Uint32)fread(IMAGE, 1, sizeof(IMAGE), f);
+	if ( (size == 0) || (fgetc(f) != EOF) )
+	{
+		fprintf(stderr, "%s: empty, or larger than %u bytes\n", argv[i], FW_MAX_SIZE);
+		fclose(f);
+		return 2;
+	}
+	fclose(f);
+
+	memset(&link, 0, sizeof(link));
+	link.fd	= -1;
+	memset(&m, 0, sizeof(m));
+	m.xfer	= host_master_xfer;
+	m.ctx	= &link;
+	m.tries	= 3;
+
+	rc = FW_LOAD_LINK;
+	for (k=0;(k <= reconnects) && (rc == FW_LOAD_LINK);k++)
+	{
+		if (k > 0)
+			sleep(1);
+
+		if (host_master_open(&link, host, port, (Uint8)unit) < 0)
+		{
+			perror("connect");
+			continue;
+		}
+
+		rc = fw_master_load(&m, IMAGE, size);
+		if (rc == FW_LOAD_REFUSED)
+		{ // say why: the state of whatever transfer the analyzer has
+			k = m.excep;
+			if (fw_master_info(&m) == FW_LOAD_OK)
+				printf("transfer %s, %u of %u chunks\n", fw_state(m.info[0]), m.info[6], m.info[5]);
+			printf("refused: exception %02X\n", k);
+			break;
+		}
+		host_master_close(&link);
+
+		printf("%s: %u bytes, resumed at chunk %u, %u chunk requests, %u rejected, %u lost\n",
+				(rc == FW_LOAD_OK) ? "committed" : "link lost", size, m.resume, m.sent, m.rejected, m.lost);
+	}
+	host_master_close(&link);
+
+	if (rc == FW_LOAD_OK)
+		printf("transfer %s\n", fw_state(m.info[0]));
+
+	return (rc == FW_LOAD_OK) ? 0 : (rc == FW_LOAD_REFUSED) ? 1 : 2;
+}
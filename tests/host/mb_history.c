@@ -0,0 +1,134 @@
+/*------------------------------------------------------------------------
+* mb_history.c
+*-------------------------------------------------------------------------
+* Pulls the logged history off an analyzer with Read File Record (0x14,
+* hist_master.c) over Modbus TCP and reports the records per second: as
+* measured over the link, and as the same requests would run on an RTU
+* line at the given baud rate.
+*
+*   mb_history [--host A] [--port N] [--unit N] [--baud N] [--records N]
+*			   [--csv 1] [--local N]
+*
+* --records reads only the newest N records; --csv 1 writes them to
+* stdout. --local N reads instead from the firmware built into the tool,
+* after logging N records into its history.
+* Exits 0 once read, 1 if the analyzer refused, 2 if the link failed.
+*------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "host.h"
+
+static HIST_RECORD RECORDS[HIST_RECORDS];
+
+static double
+now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int
+main(int argc, char** argv)
+{
+	HOST_MASTER	link;
+	HIST_MASTER	m;
+	const char*	host;
+	Uint32		port, unit, baud, records, local, csv, first, k;
+	float		val[HIST_VALUES];
+	double		t0, t;
+	int			i, rc;
+
+	host	= "127.0.0.1";
+	port	= MBTCP_PORT;
+	unit	= HOST_SLAVE;
+	baud	= 9600;
+	records	= HIST_RECORDS;
+	csv		= 0;
+	local	= 0;
+	for (i=1;i<argc-1;i+=2)
+	{
+		if (strcmp(argv[i], "--host") == 0)			host = argv[i+1];
+		else if (strcmp(argv[i], "--port") == 0)	port = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--unit") == 0)	unit = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--baud") == 0)	baud = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--records") == 0)	records = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--csv") == 0)		csv = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--local") == 0)	local = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else break;
+	}
+
+	if ( (i != argc) || (port == 0) || (port > 0xFFFF) || (unit > 0xFF) || (baud == 0) )
+	{
+		fprintf(stderr, "usage: mb_history [--host A] [--port N] [--unit N] [--baud N] [--records N] [--csv 1] [--local N]\n");
+		return 2;
+	}
+
+	memset(&m, 0, sizeof(m));
+	memset(&link, 0, sizeof(link));
+	link.fd = -1;
+	if (local > 0)
+	{
+		host_init();
+		for (k=0;k<local;k++)
+		{
+			for (i=0;i<HIST_VALUES;i++)
+				val[i] = k + i * 0.5f;
+			host_history_add(k, 0, val);
+		}
+		m.xfer = host_xfer;
+	}
+	else
+	{
+		if (host_master_open(&link, host, port, (Uint8)unit) < 0)
+		{
+			perror("connect");
+			return 2;
+		}
+		m.xfer	= host_master_xfer;
+		m.ctx	= &link;
+	}
+
+	t0 = now_us();
+	rc = hist_master_info(&m);
+	if (rc == HIST_OK)
+	{
+		if (records > m.info.seq)
+			records = m.info.seq;
+		if (records > m.info.depth)
+			records = m.info.depth;
+
+		// the oldest of them can be overwritten while we read: start again from the new oldest
+		do
+		{
+			first = m.info.seq - records;
+			rc = hist_master_read(&m, first, records, RECORDS);
+		} while ( (rc == HIST_GONE) && (hist_master_info(&m) == HIST_OK) );
+	}
+	t = now_us() - t0;
+	host_master_close(&link);
+
+	if (rc != HIST_OK)
+	{
+		fprintf(stderr, "history: %s\n", (rc == HIST_LINK) ? "no response" : "refused");
+		return (rc == HIST_LINK) ? 2 : 1;
+	}
+
+	if (csv)
+	{
+		printf("seq,rtc,diagnostics,watercut,watercut_raw,temperature,frequency,rp\n");
+		for (k=0;k<records;k++)
+			printf("%u,%u,%u,%.7g,%.7g,%.7g,%.7g,%.7g\n", RECORDS[k].seq, RECORDS[k].rtc, RECORDS[k].diag,
+					RECORDS[k].val[0], RECORDS[k].val[1], RECORDS[k].val[2], RECORDS[k].val[3], RECORDS[k].val[4]);
+	}
+
+	fprintf(stderr, "%u records (%u to %u) in %u requests, %u overwritten while read\n",
+			records, first, first + records - 1, m.requests, m.overwritten);
+	fprintf(stderr, "  %.0f records/s over the link, %.1f records/s on an RTU line at %u baud\n",
+			(t > 0) ? records * 1e6 / t : 0, records * 1e6 / hist_master_line_us(&m, baud), baud);
+
+	return 0;
+}
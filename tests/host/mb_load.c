@@ -0,0 +1,626 @@
+/*------------------------------------------------------------------------
+* mb_load.c
+*-------------------------------------------------------------------------
+* Modbus load generator and conformance bench (make bench).
+*
+* A slave process runs the firmware's own stack behind host.h: each RTU
+* frame read from a SOCK_SEQPACKET socketpair (one datagram per frame, as
+* the 3.5 character gap delimits frames on the line) goes through
+* MB_RX_Submit() and MB_Dispatch(), and the response goes back through
+* the socket. The master process paces a mixed workload at increasing
+* request rates, one request outstanding as on a serial line:
+*
+*   float reads at the 0/+2000/+4000/+6000 byte-order offsets, long
+*   integer reads at the same offsets, integer and coil reads, extended
+*   array and string reads, a cross-table read, register and coil writes,
+*   and every eighth request in long-address form (0xFA + REG_SN_PIPE).
+*
+* The byte-order offsets are sent as Create_MB_Pkt() decodes them, but
+* MB_RX_Reg_Type() splits addresses at REMAINDER (10000, "used to be
+* 2000"), so they never reach it: those rows of the per-request table
+* show 100% exceptions (02) until that is settled.
+*
+* Every response is checked for its CRC (with a bitwise CRC-16 of its
+* own, not Calc_CRC), address and function code. Each rate step prints
+* the throughput, latency percentiles and exception rate; the ramp stops
+* at the first rate that is not sustained. Line time is not modelled, so
+* the rates measure the cost of the stack itself, for comparing builds.
+*
+* With --tcp N the same workload goes to the MBAP front end instead
+* (ModbusTCP.c, served by host_tcp_serve() on a loopback port), over N
+* client connections with one request outstanding on each. There is no
+* long-address form in MBAP, so every request carries only the unit id.
+* Run it next to the default RTU mode to compare the two transports.
+*
+*   mb_load [--start N] [--max N] [--step-ms N] [--seed N] [--min-rate N]
+*          [--tcp N] [--verbose 1]
+*
+* Exits non-zero on a CRC or framing error, a missing response, or when
+* the highest sustained rate is below --min-rate.
+*------------------------------------------------------------------------*/
+
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define truncate unistd_truncate	// Globals.h has a truncate() of its own
+#include <unistd.h>
+#undef truncate
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "host.h"
+
+#define LOAD_SN			(0x00C0FFEE)	// REG_SN_PIPE in the slave
+#define LOAD_EXTENDED	(60000)			// SPECIAL_OFFSET in ModbusRTU.c
+#define LOAD_TIMEOUT_MS	(1000)			// no response: the step fails
+#define LOAD_MAX_SAMPLES (1u << 20)		// latencies kept per step
+#define LOAD_SUSTAINED	(0.95)			// fraction of the offered rate that counts as keeping up
+#define LOAD_MAX_CONNS	(HOST_TCP_CLIENTS)
+
+///// slave /////
+static int SLAVE_FD;
+
+static void
+load_send(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n)
+{
+	(void)tag;
+
+	if (send(*(int*)ctx, frame, n, 0) < 0)
+		exit(2);
+
+	MB_TX_IN_PROGRESS = FALSE;
+}
+
+static const MB_TX_DRIVER LOAD_DRV = { load_send, &SLAVE_FD };
+
+static void
+slave(int fd)
+{
+	Uint8	frame[MB_FRAME_SIZE];
+	ssize_t	n;
+
+	SLAVE_FD = fd;
+	host_init();
+	REG_SN_PIPE			= LOAD_SN;
+	COIL_UNLOCKED.val	= TRUE;	// the workload writes PASSWD registers
+
+	while ((n = recv(fd, frame, sizeof(frame), 0)) > 0)
+	{
+		MB_RX_Submit(frame, (Uint32)n, &LOAD_DRV, 0);
+		host_run();
+	}
+
+	exit(0);
+}
+
+///// master /////
+typedef struct
+{
+	Uint8	frame[MB_FRAME_SIZE];	// RTU frame, or MBAP ADU with --tcp
+	Uint32	n;
+	Uint8	fxn;
+	Uint8	long_addr;
+	Uint8	kind;		// row of KIND[]
+	Uint16	tid;		// MBAP transaction id
+} LOAD_REQ;
+
+typedef struct
+{
+	Uint32	sent, answered, exceptions, crc_errors, bad_frames, timeouts;
+	Uint32	samples;
+	Uint64	elapsed_ns;
+} LOAD_STEP;
+
+static Uint32 LAT[LOAD_MAX_SAMPLES];	// ns
+static Uint32 VERBOSE;					// --verbose: print what failed
+static Uint32 TCP_CONNS;				// --tcp: MBAP connections; 0 = RTU
+static Uint16 TCP_TID;					// last transaction id sent
+
+static Uint64
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (Uint64)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Modbus CRC-16, bit by bit, independent of Calc_CRC()
+static Uint16
+crc16(const Uint8* s, Uint32 n)
+{
+	Uint16	crc = 0xFFFF;
+	Uint32	i, b;
+
+	for (i=0;i<n;i++)
+	{
+		crc ^= s[i];
+		for (b=0;b<8;b++)
+			crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+	}
+
+	return crc;
+}
+
+static Uint32
+rows(const MB_TBL_CELL tbl[][MB_TBL_COLS])
+{
+	Uint32 i;
+
+	for (i=0;tbl[i][0] != 0;i++);
+	return i;
+}
+
+// a readable row of tbl, chosen at random
+static Uint16
+pick(const MB_TBL_CELL tbl[][MB_TBL_COLS])
+{
+	Uint32 i;
+
+	do i = rand() % rows(tbl);
+	while (tbl[i][2] == REGPERM_WRITE_O);
+
+	return (Uint16)tbl[i][0];
+}
+
+static void
+put_pdu(LOAD_REQ* r, Uint8 fxn, Uint16 reg, Uint16 n)
+{
+	Uint8 pdu[5];
+	Uint8 lng[MB_FRAME_SIZE];
+	Uint16 crc;
+
+	pdu[0] = fxn;
+	pdu[1] = (reg - 1) >> 8;	// 0-based on the wire
+	pdu[2] = (reg - 1) & 0xFF;
+	pdu[3] = n >> 8;
+	pdu[4] = n & 0xFF;
+
+	r->fxn = fxn;
+
+	if (TCP_CONNS > 0)
+	{ // MBAP: transaction id, protocol 0, length, unit id, then the PDU
+		r->tid = ++TCP_TID;
+		r->frame[0] = r->tid >> 8;
+		r->frame[1] = r->tid & 0xFF;
+		r->frame[2] = 0;
+		r->frame[3] = 0;
+		r->frame[4] = 0;
+		r->frame[5] = 1 + sizeof(pdu);
+		r->frame[6] = HOST_SLAVE;
+		memcpy(&r->frame[MBTCP_MBAP_SIZE], pdu, sizeof(pdu));
+		r->n = MBTCP_MBAP_SIZE + sizeof(pdu);
+		return;
+	}
+
+	if (!r->long_addr)
+	{
+		r->n = host_frame(r->frame, HOST_SLAVE, pdu, sizeof(pdu));
+		return;
+	}
+
+	// 0xFA, the pipe serial number MSB first, then the PDU
+	lng[0] = 0xFA;
+	lng[1] = (LOAD_SN >> 24) & 0xFF;
+	lng[2] = (LOAD_SN >> 16) & 0xFF;
+	lng[3] = (LOAD_SN >> 8) & 0xFF;
+	lng[4] = LOAD_SN & 0xFF;
+	memcpy(&lng[5], pdu, sizeof(pdu));
+	crc = crc16(lng, 5 + sizeof(pdu));
+	lng[5 + sizeof(pdu)] = crc & 0xFF;
+	lng[6 + sizeof(pdu)] = crc >> 8;
+
+	memcpy(r->frame, lng, 7 + sizeof(pdu));
+	r->n = 7 + sizeof(pdu);
+}
+
+// the workload: one request kind per row, all equally likely
+static const char* const KIND[] = {
+	"float", "float +2000 (CDAB)", "float +4000 (DCBA)", "float +6000 (BADC)",
+	"long int", "long int +2000..6000", "int", "int, 0x04", "coils",
+	"extended doubles", "extended string", "cross-table", "write register", "write coil",
+};
+#define LOAD_KINDS	(sizeof(KIND) / sizeof(KIND[0]))
+
+static Uint32 KIND_SENT[LOAD_KINDS], KIND_EXC[LOAD_KINDS];	// over the whole run
+
+// the next request of the mixed workload
+static void
+next_request(LOAD_REQ* r, Uint32 k)
+{
+	r->long_addr	= ((k & 7) == 7) && (TCP_CONNS == 0);
+	r->kind			= rand() % LOAD_KINDS;
+
+	switch (r->kind)
+	{
+		case 0: case 1: case 2: case 3:	// one float in each byte order
+			put_pdu(r, 0x03, pick(MB_TBL_FLOAT) + 2000 * r->kind, 2);
+			break;
+		case 4:
+			put_pdu(r, 0x03, pick(MB_TBL_LONGINT), 2);
+			break;
+		case 5:
+			put_pdu(r, 0x03, pick(MB_TBL_LONGINT) + 2000 * (1 + rand() % 3), 2);
+			break;
+		case 6:
+			put_pdu(r, 0x03, pick(MB_TBL_INT), 1);
+			break;
+		case 7:
+			put_pdu(r, 0x04, pick(MB_TBL_INT), 1);
+			break;
+		case 8:
+			put_pdu(r, 0x01, 1, 1 + rand() % 27);
+			break;
+		case 9:		// REG_TEMPS_OIL onwards
+			put_pdu(r, 0x03, LOAD_EXTENDED + 3, 2 * (1 + rand() % 10));
+			break;
+		case 10:	// REG_STRING_TAG, one character per register
+			put_pdu(r, 0x03, LOAD_EXTENDED + 2577, 8);
+			break;
+		case 11:	// floats, holes and integers in one read
+			put_pdu(r, 0x03, 183, 21);
+			break;
+		case 12:	// REG_MB_SENTINEL
+			put_pdu(r, 0x06, 280, 0xFFFF);
+			break;
+		default:	// COIL_LOG_ALARMS
+			put_pdu(r, 0x05, 7, (rand() & 1) ? 0xFF00 : 0x0000);
+			break;
+	}
+
+	KIND_SENT[r->kind]++;
+}
+
+static void
+dump(const char* what, const Uint8* frame, Uint32 n)
+{
+	Uint32 i;
+
+	printf("  %-8s", what);
+	for (i=0;i<n;i++)
+		printf(" %02X", frame[i]);
+	printf("\n");
+}
+
+// checks a response against its request
+static void
+check_response(LOAD_STEP* s, const LOAD_REQ* r, const Uint8* rsp, Uint32 n)
+{
+	Uint32 hdr = r->long_addr ? 5 : 1;	// address bytes before the function code
+	Uint32 *count;
+
+	if (TCP_CONNS > 0)
+		hdr = MBTCP_MBAP_SIZE;
+
+	if (n < hdr + 2)
+		count = &s->bad_frames;
+	else if ((TCP_CONNS == 0) && ((n < hdr + 3) || (crc16(rsp, n) != 0)))
+		count = &s->crc_errors;
+	else if ((TCP_CONNS > 0) && ((memcmp(rsp, r->frame, 4) != 0) || ((Uint32)((rsp[4] << 8) | rsp[5]) != n - 6) || (rsp[6] != r->frame[6])))
+		count = &s->bad_frames;	// transaction id, protocol, length or unit id
+	else if (((TCP_CONNS == 0) && (memcmp(rsp, r->frame, hdr) != 0)) || ((rsp[hdr] & 0x7F) != r->fxn))
+		count = &s->bad_frames;
+	else if (rsp[hdr] & 0x80)
+	{
+		count = &s->exceptions;
+		KIND_EXC[r->kind]++;
+	}
+	else
+		return;
+
+	(*count)++;
+	if (VERBOSE)
+	{
+		dump("request", r->frame, r->n);
+		dump("response", rsp, n);
+	}
+}
+
+static int
+cmp_u32(const void* a, const void* b)
+{
+	Uint32 x = *(const Uint32*)a, y = *(const Uint32*)b;
+
+	return (x > y) - (x < y);
+}
+
+static double
+pct_us(const LOAD_STEP* s, Uint32 p)
+{
+	if (s->samples == 0) return 0;
+	return LAT[((Uint64)s->samples * p) / 100 - ((p == 100) ? 1 : 0)] / 1000.0;
+}
+
+// waits for the response to a request sent on fd; -1 if there is none
+static ssize_t
+recv_response(int fd, Uint8* rsp, Uint32 size)
+{
+	struct pollfd	pfd;
+	ssize_t			n, k;
+	Uint32			want;
+
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+
+	if (TCP_CONNS == 0)
+	{ // one datagram per frame
+		if (poll(&pfd, 1, LOAD_TIMEOUT_MS) <= 0)
+			return -1;
+		n = recv(fd, rsp, size, 0);
+		return (n > 0) ? n : -1;
+	}
+
+	// a byte stream: the MBAP header, then as much as its length says
+	for (n=0,want=MBTCP_MBAP_SIZE;(Uint32)n < want;n+=k)
+	{
+		if (poll(&pfd, 1, LOAD_TIMEOUT_MS) <= 0)
+			return -1;
+		k = recv(fd, &rsp[n], want - n, 0);
+		if (k <= 0)
+			return -1;
+
+		if ((n + k == MBTCP_MBAP_SIZE) && (want == MBTCP_MBAP_SIZE))
+		{
+			want = MBTCP_MBAP_SIZE - 1 + ((rsp[4] << 8) | rsp[5]);
+			if ((want > size) || (want < MBTCP_MBAP_SIZE))
+				return MBTCP_MBAP_SIZE;	// check_response() counts it
+		}
+	}
+
+	return n;
+}
+
+// offers rate requests/s for step_ms; one request outstanding per connection
+static void
+run_step(const int* fd, Uint32 conns, Uint32 rate, Uint32 step_ms, LOAD_STEP* s)
+{
+	LOAD_REQ		req[LOAD_MAX_CONNS];
+	Uint64			sent_at[LOAD_MAX_CONNS];
+	Uint8			rsp[MB_FRAME_SIZE + MBTCP_MBAP_SIZE];
+	Uint64			start, due, period, end;
+	ssize_t			n;
+	Uint32			c;
+
+	memset(s, 0, sizeof(*s));
+	period	= 1000000000u / rate;
+	start	= now_ns();
+	end		= start + (Uint64)step_ms * 1000000u;
+	due		= start;
+
+	while (due < end)
+	{
+		while (now_ns() < due);	// pace; a late request goes out at once
+
+		for (c=0;c<conns;c++)
+		{
+			next_request(&req[c], s->sent);
+			sent_at[c] = now_ns();
+			if (send(fd[c], req[c].frame, req[c].n, 0) < 0)
+				break;
+			s->sent++;
+		}
+
+		for (c=0;c<conns;c++)
+		{
+			n = recv_response(fd[c], rsp, sizeof(rsp));
+			if (n < 0)
+			{
+				s->timeouts++;
+				break;
+			}
+
+			if (s->samples < LOAD_MAX_SAMPLES)
+				LAT[s->samples++] = (Uint32)(now_ns() - sent_at[c]);
+			s->answered++;
+			check_response(s, &req[c], rsp, (Uint32)n);
+		}
+
+		if (s->timeouts > 0)
+			break;
+
+		due += period * conns;
+	}
+
+	s->elapsed_ns = now_ns() - start;
+	qsort(LAT, s->samples, sizeof(LAT[0]), cmp_u32);
+}
+
+static Uint32
+arg(int argc, char** argv, const char* name, Uint32 def)
+{
+	int i;
+
+	for (i=1;i<argc-1;i++)
+		if (strcmp(argv[i], name) == 0)
+			return (Uint32)strtoul(argv[i+1], NULL, 0);
+
+	return def;
+}
+
+// the slave in --tcp mode: host_tcp_serve() on a loopback port
+static void
+tcp_slave(int listen_fd)
+{
+	host_init();
+	REG_SN_PIPE			= LOAD_SN;
+	COIL_UNLOCKED.val	= TRUE;	// the workload writes PASSWD registers
+
+	host_tcp_serve(listen_fd);
+	exit(2);
+}
+
+// a listening socket on 127.0.0.1 and an ephemeral port, before the fork
+static int
+tcp_listen(struct sockaddr_in* addr)
+{
+	socklen_t	len = sizeof(*addr);
+	int			fd;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+
+	memset(addr, 0, sizeof(*addr));
+	addr->sin_family		= AF_INET;
+	addr->sin_addr.s_addr	= htonl(INADDR_LOOPBACK);
+	addr->sin_port			= 0;
+
+	if ( (bind(fd, (struct sockaddr*)addr, sizeof(*addr)) < 0) || (listen(fd, LOAD_MAX_CONNS) < 0)
+		|| (getsockname(fd, (struct sockaddr*)addr, &len) < 0) )
+	{
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static int
+tcp_connect(const struct sockaddr_in* addr)
+{
+	int fd, one = 1;
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0)
+		return -1;
+
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	if (connect(fd, (const struct sockaddr*)addr, sizeof(*addr)) < 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+int
+main(int argc, char** argv)
+{
+	Uint32		rate, best, start_rate, max_rate, step_ms, min_rate;
+	LOAD_STEP	s;
+	double		achieved;
+	int			sv[2], fd[LOAD_MAX_CONNS], conns, fail, status;
+	struct sockaddr_in addr;
+	Uint32		k;
+	pid_t		pid;
+
+	start_rate	= arg(argc, argv, "--start", 1000);
+	max_rate	= arg(argc, argv, "--max", 2000000);
+	step_ms		= arg(argc, argv, "--step-ms", 500);
+	min_rate	= arg(argc, argv, "--min-rate", 0);
+	srand(arg(argc, argv, "--seed", 1));
+	VERBOSE		= arg(argc, argv, "--verbose", 0);
+	TCP_CONNS	= arg(argc, argv, "--tcp", 0);
+
+	if ((start_rate == 0) || (step_ms == 0) || (TCP_CONNS > LOAD_MAX_CONNS))
+	{
+		fprintf(stderr, "usage: mb_load [--start N] [--max N] [--step-ms N] [--seed N] [--min-rate N] [--tcp 1..%u]\n", LOAD_MAX_CONNS);
+		return 2;
+	}
+
+	if (TCP_CONNS == 0)
+		fail = socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv);
+	else
+		fail = sv[0] = sv[1] = tcp_listen(&addr);
+
+	if (fail < 0)
+	{
+		perror("socket");
+		return 2;
+	}
+
+	pid = fork();
+	if (pid < 0)
+	{
+		perror("fork");
+		return 2;
+	}
+	if (pid == 0)
+	{
+		if (TCP_CONNS == 0)
+		{
+			close(sv[0]);
+			slave(sv[1]);
+		}
+		tcp_slave(sv[1]);
+	}
+
+	conns = 1;
+	if (TCP_CONNS == 0)
+	{
+		close(sv[1]);
+		fd[0] = sv[0];
+		printf("RTU frames over a SOCK_SEQPACKET socketpair\n");
+	}
+	else
+	{
+		close(sv[0]);
+		for (conns=0;conns<(int)TCP_CONNS;conns++)
+		{
+			fd[conns] = tcp_connect(&addr);
+			if (fd[conns] < 0)
+			{
+				perror("connect");
+				kill(pid, SIGTERM);
+				return 2;
+			}
+		}
+		printf("Modbus TCP over %d loopback connection%s\n", conns, (conns > 1) ? "s" : "");
+	}
+
+	printf("%10s %10s %8s %8s %8s %8s %7s %5s %5s\n",
+		   "offered/s", "achieved/s", "p50 us", "p90 us", "p99 us", "max us", "exc %", "crc", "lost");
+
+	best = 0;
+	fail = 0;
+	for (rate=start_rate;rate<=max_rate;rate*=2)
+	{
+		run_step(fd, conns, rate, step_ms, &s);
+		achieved = s.answered / (s.elapsed_ns / 1e9);
+
+		printf("%10u %10.0f %8.1f %8.1f %8.1f %8.1f %7.2f %5u %5u\n", rate, achieved,
+			   pct_us(&s, 50), pct_us(&s, 90), pct_us(&s, 99), pct_us(&s, 100),
+			   s.answered ? 100.0 * s.exceptions / s.answered : 0.0,
+			   s.crc_errors + s.bad_frames, s.timeouts);
+
+		if ((s.crc_errors > 0) || (s.bad_frames > 0) || (s.timeouts > 0))
+		{
+			fail = 1;
+			break;
+		}
+
+		if (achieved < rate * LOAD_SUSTAINED)
+			break;
+		best = rate;
+	}
+
+	while (conns > 0)
+		close(fd[--conns]);
+	kill(pid, SIGTERM);
+	waitpid(pid, &status, 0);
+
+	printf("\n%-22s %10s %7s\n", "request", "sent", "exc %");
+	for (k=0;k<LOAD_KINDS;k++)
+		printf("%-22s %10u %7.2f\n", KIND[k], KIND_SENT[k], KIND_SENT[k] ? 100.0 * KIND_EXC[k] / KIND_SENT[k] : 0.0);
+
+	printf("\nhighest sustained rate: %u requests/s\n", best);
+
+	if (fail)
+	{
+		printf("FAILED: malformed or missing responses\n");
+		return 1;
+	}
+
+	if (best < min_rate)
+	{
+		printf("FAILED: below --min-rate %u\n", min_rate);
+		return 1;
+	}
+
+	return 0;
+}
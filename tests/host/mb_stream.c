@@ -0,0 +1,70 @@
+/*------------------------------------------------------------------------
+* mb_stream.c
+*-------------------------------------------------------------------------
+* Decodes a capture of the sample stream (PDI function 67) with the cal
+* sw's decoder (stream_master.c): the bytes the analyzer sent from the
+* echo of the arm command on, as a serial capture records them
+* ("-" reads stdin). One CSV line per record goes to stdout; what was
+* missing, and why, to stderr.
+*
+*   mb_stream [--slave N] [--sn N] capture.bin
+*
+* --sn N for a stream armed with the long (0xFA) address of pipe N.
+* Exits 0 if every record was there, 1 if any was dropped or lost.
+*------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+
+int
+main(int argc, char** argv)
+{
+	STREAM_DECODER	d;
+	STREAM_SAMPLE	s;
+	FILE*			f;
+	Uint32			slave, sn;
+	int				i, c;
+
+	slave	= HOST_SLAVE;
+	sn		= 0;
+	for (i=1;i<argc-2;i+=2)
+	{
+		if (strcmp(argv[i], "--slave") == 0)	slave = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--sn") == 0)	sn = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else break;
+	}
+
+	if ( (i != argc-1) || (slave == 0) || (slave > 0xFF) )
+	{
+		fprintf(stderr, "usage: mb_stream [--slave N] [--sn N] capture.bin\n");
+		return 2;
+	}
+
+	f = (strcmp(argv[i], "-") == 0) ? stdin : fopen(argv[i], "rb");
+	if (f == NULL)
+	{
+		perror(argv[i]);
+		return 2;
+	}
+
+	stream_decoder_init(&d, (Uint8)slave, sn);
+	printf("seq,us,pulses,frequency,temperature,rp,watercut_raw\n");
+	while ((c = fgetc(f)) != EOF)
+	{
+		if (stream_decode(&d, (Uint8)c, &s))
+			printf("%u,%u,%u,%.7g,%.7g,%.7g,%.7g\n", s.seq, s.us, s.pulses, s.freq, s.temp, s.rp, s.wc_raw);
+	}
+	if (f != stdin)
+		fclose(f);
+
+	fprintf(stderr, "%u records", d.records);
+	if (d.count == MB_STREAM_FOREVER)
+		fprintf(stderr, " (armed until stopped)");
+	else if (d.count > 0)
+		fprintf(stderr, " of %u armed", d.count);
+	fprintf(stderr, ": %u dropped by the analyzer (line busy), %u lost on the line, "
+			"%u CRC errors, %u bytes skipped\n", d.dropped, d.lost, d.crc_errors, d.skipped);
+
+	return (d.dropped + d.lost > 0) ? 1 : 0;
+}
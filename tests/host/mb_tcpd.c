@@ -0,0 +1,76 @@
+/*------------------------------------------------------------------------
+* mb_tcpd.c
+*-------------------------------------------------------------------------
+* Modbus TCP server on Linux, for trying SCADA integrations without
+* RS-485 hardware: the firmware's own tables and request handling
+* (ModbusRTU.c) behind its MBAP front end (ModbusTCP.c), on the host
+* shim. Any unit id is answered.
+*
+*   mb_tcpd [--port N] [--unlocked 1]
+*
+* The port defaults to MBTCP_PORT (502), which needs root or
+* CAP_NET_BIND_SERVICE; mb_load --tcp uses an ephemeral loopback port.
+* --unlocked 1 starts with COIL_UNLOCKED set, so PASSWD registers can be
+* written without the unlock sequence.
+*------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "host.h"
+
+int
+main(int argc, char** argv)
+{
+	struct sockaddr_in	addr;
+	Uint32				port;
+	int					fd, i, unlocked, one = 1;
+
+	port		= MBTCP_PORT;
+	unlocked	= 0;
+	for (i=1;i<argc-1;i+=2)
+	{
+		if (strcmp(argv[i], "--port") == 0)
+			port = (Uint32)strtoul(argv[i+1], NULL, 0);
+		else if (strcmp(argv[i], "--unlocked") == 0)
+			unlocked = atoi(argv[i+1]);
+		else
+			break;
+	}
+
+	if ((i < argc) || (port == 0) || (port > 0xFFFF))
+	{
+		fprintf(stderr, "usage: mb_tcpd [--port N] [--unlocked 1]\n");
+		return 2;
+	}
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0)
+	{
+		perror("socket");
+		return 2;
+	}
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family			= AF_INET;
+	addr.sin_addr.s_addr	= htonl(INADDR_ANY);
+	addr.sin_port			= htons((Uint16)port);
+
+	if ((bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) || (listen(fd, HOST_TCP_CLIENTS) < 0))
+	{
+		perror("bind/listen");
+		return 2;
+	}
+
+	host_init();
+	COIL_UNLOCKED.val = unlocked ? TRUE : FALSE;
+
+	printf("mb_tcpd: Modbus TCP on port %u, up to %u connections\n", port, HOST_TCP_CLIENTS);
+	fflush(stdout);
+
+	host_tcp_serve(fd);
+	perror("poll");
+	return 1;
+}
@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------
+* stream_master.c
+*-------------------------------------------------------------------------
+* Decodes the sample stream (PDI function 67, MB_Stream_Sample) as the
+* cal sw receives it: a byte at a time off the serial line, with the echo
+* of the arm command first. Records are framed by their fixed length and
+* CRC; after a bad one the decoder slides a byte at a time until a record
+* checks again. Gaps in seq are split into the records the analyzer
+* dropped (its dropped field moved on) and the ones lost on the line.
+* Used by mb_stream and test_stream.c.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+// address, then 67: seq, dropped, time, pulses, 4 floats, CRC
+#define STREAM_RECORD_BYTES(addr)	((addr) + 1 + 2 + 2 + 4*6 + 2)
+#define STREAM_ECHO_BYTES(addr)		((addr) + 1 + 4 + 2)
+
+static Uint32
+stream_get32(const Uint8* p)
+{ // DCBA
+	return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
+static float
+stream_float(const Uint8* p)
+{
+	Uint32	u = stream_get32(p);
+	float	f;
+
+	memcpy(&f, &u, sizeof(f));
+	return f;
+}
+
+// the address and function code a frame from the slave starts with
+static BOOL
+stream_header(const STREAM_DECODER* d)
+{
+	if (d->addr_n == 5)
+		return (d->buf[0] == 0xFA) && (stream_get32(&d->buf[1]) == d->sn) && (d->buf[5] == MB_CMD_PDI_SAMPLE_STREAM);
+
+	return (d->buf[0] == d->slave) && (d->buf[1] == MB_CMD_PDI_SAMPLE_STREAM);
+}
+
+static void
+stream_slide(STREAM_DECODER* d)
+{ // the first byte cannot start a frame
+	if (d->synced)
+		d->crc_errors++;
+	d->synced = FALSE;
+	d->skipped++;
+	d->n--;
+	memmove(d->buf, &d->buf[1], d->n);
+}
+
+/***************************************************************************
+ * stream_decoder_init() - before the arm command goes out
+ * @param sn	- REG_SN_PIPE for a stream armed with a long (0xFA) address,
+ *				  0 for one armed with slave
+ ***************************************************************************/
+void
+stream_decoder_init(STREAM_DECODER* d, Uint8 slave, Uint32 sn)
+{
+	memset(d, 0, sizeof(*d));
+	d->slave	= slave;
+	d->sn		= sn;
+	d->addr_n	= (sn != 0) ? 5 : 1;
+	d->echo		= TRUE;
+}
+
+/***************************************************************************
+ * stream_decode() - one byte off the line
+ * @return	- TRUE if it completed a record, which is in s
+ ***************************************************************************/
+BOOL
+stream_decode(STREAM_DECODER* d, Uint8 b, STREAM_SAMPLE* s)
+{
+	const Uint8*	p;
+	Uint32			len;
+	Uint16			gap, drops;
+
+	d->buf[d->n++] = b;
+	for (;;)
+	{
+		if ( (d->n > 0) && (d->buf[0] != ((d->addr_n == 5) ? 0xFA : d->slave)) )
+		{
+			stream_slide(d);
+			continue;
+		}
+
+		len = (d->echo) ? STREAM_ECHO_BYTES(d->addr_n) : STREAM_RECORD_BYTES(d->addr_n);
+		if (d->n < len)
+			return FALSE;
+
+		if ( stream_header(d) && (Calc_CRC(d->buf, len) == 0) )
+			break;
+
+		if (d->echo && (d->n < STREAM_RECORD_BYTES(d->addr_n)))
+			return FALSE;	// not the echo: see if it is the first record
+		if (d->echo)
+		{ // the echo was lost
+			d->echo = FALSE;
+			continue;
+		}
+		stream_slide(d);
+	}
+
+	p = &d->buf[d->addr_n + 1];
+	if (d->echo)
+	{
+		d->echo = FALSE;
+		d->count = ((Uint32)p[0] << 24) | ((Uint32)p[1] << 16) | ((Uint32)p[2] << 8) | p[3];	// MSB first
+		d->synced = TRUE;
+		d->n -= len;
+		memmove(d->buf, &d->buf[len], d->n);
+		return FALSE;
+	}
+
+	s->seq		= p[0] | (p[1] << 8);
+	s->dropped	= p[2] | (p[3] << 8);
+	s->us		= stream_get32(&p[4]);
+	s->pulses	= stream_get32(&p[8]);
+	s->freq		= stream_float(&p[12]);
+	s->temp		= stream_float(&p[16]);
+	s->rp		= stream_float(&p[20]);
+	s->wc_raw	= stream_float(&p[24]);
+
+	// seq and dropped both count from the arm command and wrap at 0xFFFF
+	gap		= s->seq - d->next_seq;
+	drops	= s->dropped - d->last_dropped;
+	d->dropped	+= drops;
+	d->lost		+= (gap >= drops) ? (gap - drops) : 0;
+	d->next_seq		= s->seq + 1;
+	d->last_dropped	= s->dropped;
+	d->records++;
+	d->synced = TRUE;
+
+	d->n -= len;
+	memmove(d->buf, &d->buf[len], d->n);
+	return TRUE;
+}
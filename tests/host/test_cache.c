@@ -0,0 +1,233 @@
+/*------------------------------------------------------------------------
+* test_cache.c -- the pre-encoded float registers (MB_FLT_CACHE) under
+* preemption: Poll()'s MB_Float_Cache_Refresh() interrupted at arbitrary
+* points by Modbus reads and writes, as the Modbus Swi interrupts it on
+* the target. Every block read must come from one generation of values,
+* never an older one than already seen, and a write must be read back
+* at once whether the refresh it interrupted publishes or not.
+*------------------------------------------------------------------------*/
+
+#include <signal.h>
+#include <sys/time.h>
+#include "host.h"
+
+#define BLOCK_REG	(19)	// REG_FREQ .. REG_TEMP_AVG: six read-only floats, VARs and doubles
+#define BLOCK_N		(6)
+#define WRITE_REG	(31)	// REG_TEMP_ADJUST, PASSWD
+#define REFRESHES	(20000)
+#define SWI_US		(23)	// "Swi" period; not a divisor of anything in the loop
+
+static MB_TBL_CELL BLOCK_TYPE[BLOCK_N];
+static void* BLOCK_PTR[BLOCK_N];
+
+// what the "Swi" found (it cannot call CHECK: printf is not signal safe)
+static volatile sig_atomic_t IN_REFRESH;
+static volatile Uint32 GEN;				// generation of the live values
+static volatile Uint32 SWI_RUNS, SWI_IN_REFRESH, WRITES_IN_REFRESH;
+static volatile Uint32 TORN, BACKWARDS, STALE, FAILED;
+static Uint32 LAST_GEN, WRITE_VAL;
+
+// every register of the block set to generation g
+static void
+set_block(Uint32 g)
+{
+	Uint32 i;
+
+	for (i=0;i<BLOCK_N;i++)
+	{
+		if (BLOCK_TYPE[i] == REGTYPE_VAR)
+			((VAR*)BLOCK_PTR[i])->val = (float)g;
+		else
+			*(double*)BLOCK_PTR[i] = (double)g;
+	}
+}
+
+static float
+rsp_float(Uint32 k)
+{
+	Uint32	u;
+	float	f;
+
+	u = ((Uint32)HOST_RSP.frame[3 + 4*k] << 24) | (HOST_RSP.frame[4 + 4*k] << 16)
+		| (HOST_RSP.frame[5 + 4*k] << 8) | HOST_RSP.frame[6 + 4*k];
+	memcpy(&f, &u, sizeof(f));
+	return f;
+}
+
+// generation of the block as a read returns it; 0xFFFFFFFF if it mixes two
+static Uint32
+read_block(void)
+{
+	Uint8	pdu[5] = { 0x03, 0, BLOCK_REG - 1, 0, BLOCK_N * 2 };
+	Uint32	i, g;
+
+	if ( (host_request(pdu, sizeof(pdu)) != 5 + 4*BLOCK_N) || (HOST_RSP.frame[1] != 0x03) )
+	{
+		FAILED++;
+		return LAST_GEN;
+	}
+
+	g = (Uint32)rsp_float(0);
+	for (i=1;i<BLOCK_N;i++)
+	{
+		if ((Uint32)rsp_float(i) != g)
+			return 0xFFFFFFFF;
+	}
+
+	return g;
+}
+
+static float
+read_written(void)
+{
+	Uint8 pdu[5] = { 0x03, 0, WRITE_REG - 1, 0, 2 };
+
+	if ( (host_request(pdu, sizeof(pdu)) == 0) || (HOST_RSP.frame[1] != 0x03) )
+	{
+		FAILED++;
+		return (float)WRITE_VAL;
+	}
+
+	return rsp_float(0);
+}
+
+// WRITE_REG = v, then read it back
+static float
+write_read(float v)
+{
+	Uint8 pdu[10] = { 0x10, 0, WRITE_REG - 1, 0, 2, 4 };
+	Uint32 u;
+
+	memcpy(&u, &v, sizeof(u));
+	pdu[6] = u >> 24;
+	pdu[7] = u >> 16;
+	pdu[8] = u >> 8;
+	pdu[9] = u;
+
+	if ( (host_request(pdu, sizeof(pdu)) == 0) || (HOST_RSP.frame[1] != 0x10) )
+	{
+		FAILED++;
+		return v;
+	}
+
+	return read_written();
+}
+
+// the Modbus "Swi": the block and the last value written read every time, a write every third time
+static void
+modbus_swi(int sig)
+{
+	Uint32 g;
+
+	(void)sig;
+	SWI_RUNS++;
+	if (IN_REFRESH)
+		SWI_IN_REFRESH++;
+
+	g = read_block();
+	if (g == 0xFFFFFFFF)
+		TORN++;
+	else
+	{
+		if ((g < LAST_GEN) || (g > GEN))
+			BACKWARDS++;
+		LAST_GEN = g;
+	}
+
+	if (read_written() != (float)WRITE_VAL)
+		STALE++;
+
+	if ((SWI_RUNS % 3) == 0)
+	{
+		if (IN_REFRESH)
+			WRITES_IN_REFRESH++;
+		WRITE_VAL++;
+		if (write_read((float)WRITE_VAL) != (float)WRITE_VAL)
+			STALE++;
+	}
+}
+
+void
+test_cache(void)
+{
+	struct itimerval	tick, off;
+	struct sigaction	sa;
+	Uint32				i, k, g;
+
+	for (k=0;k<BLOCK_N;k++)
+	{
+		for (i=0;(MB_TBL_FLOAT[i][0] != 0) && (MB_TBL_FLOAT[i][0] != BLOCK_REG + 2*k);i++);
+		CHECK_EQ(MB_TBL_FLOAT[i][0], BLOCK_REG + 2*k);
+		CHECK((MB_TBL_FLOAT[i][1] == REGTYPE_VAR) || (MB_TBL_FLOAT[i][1] == REGTYPE_DBL));
+		BLOCK_TYPE[k]	= MB_TBL_FLOAT[i][1];
+		BLOCK_PTR[k]	= (void*)MB_TBL_FLOAT[i][3];
+	}
+	COIL_UNLOCKED.val = TRUE;
+
+	///// the reads come from the cache: a change not yet refreshed is not seen /////
+	set_block(1);
+	MB_Float_Cache_Refresh();
+	set_block(2);
+	CHECK_EQ(read_block(), 1);
+	MB_Float_Cache_Refresh();
+	CHECK_EQ(read_block(), 2);
+
+	// a write goes around it until the next refresh
+	CHECK_EQ(write_read(0.5f), 0.5f);
+	set_block(3);
+	CHECK_EQ(read_block(), 3);
+	MB_Float_Cache_Refresh();
+	set_block(4);
+	CHECK_EQ(read_block(), 3);
+
+	///// Poll() with the "Swi" firing every SWI_US /////
+	GEN			= 4;
+	LAST_GEN	= 3;
+	WRITE_VAL	= 0;
+	write_read(0.0f);
+	MB_Float_Cache_Refresh();
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = modbus_swi;
+	sigemptyset(&sa.sa_mask);
+	sigaction(HOST_SWI_SIGNAL, &sa, NULL);
+
+	tick.it_interval.tv_sec		= 0;
+	tick.it_interval.tv_usec	= SWI_US;
+	tick.it_value				= tick.it_interval;
+	setitimer(ITIMER_REAL, &tick, NULL);
+
+	for (k=0;k<REFRESHES;k++)
+	{
+		// the measurements move as one, as Poll() updates them between refreshes
+		i = Swi_disable();
+		GEN++;
+		set_block(GEN);
+		Swi_restore(i);
+
+		IN_REFRESH = 1;
+		MB_Float_Cache_Refresh();
+		IN_REFRESH = 0;
+	}
+
+	memset(&off, 0, sizeof(off));
+	setitimer(ITIMER_REAL, &off, NULL);
+	signal(HOST_SWI_SIGNAL, SIG_DFL);
+
+	printf("cache      %u refreshes, %u Swi runs (%u inside a refresh, %u writes)\n",
+			REFRESHES, SWI_RUNS, SWI_IN_REFRESH, WRITES_IN_REFRESH);
+
+	CHECK(SWI_IN_REFRESH > 0);
+	CHECK(WRITES_IN_REFRESH > 0);
+	CHECK_EQ(FAILED, 0);
+	CHECK_EQ(TORN, 0);
+	CHECK_EQ(BACKWARDS, 0);
+	CHECK_EQ(STALE, 0);
+
+	// and once it stops, the cache catches up
+	MB_Float_Cache_Refresh();
+	g = read_block();
+	CHECK_EQ(g, GEN);
+
+	COIL_UNLOCKED.val = FALSE;
+}
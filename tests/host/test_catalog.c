@@ -0,0 +1,137 @@
+/*------------------------------------------------------------------------
+* test_catalog.c -- the register catalog (MB_FILE_CATALOG) read back the
+* way mb_catalog reads it (cat_master.c), entry by entry against the rows
+* of ModbusTables.h it describes, so an export for a SCADA package cannot
+* drift from the tables the firmware serves. Then the JSON and CSV
+* exports of it.
+*------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include "host.h"
+#include "Variable.h"
+
+#define REGPERM_PASSWD	1
+#define CAT_MAX			(1024)
+
+static CAT_ENTRY CAT[CAT_MAX];
+
+// the catalog's name for a table row: the variable name, cut to fit
+static void
+check_name(const CAT_ENTRY* c, MB_TBL_CELL name)
+{
+	char want[MB_CATALOG_NAME_SIZE + 1];
+
+	strncpy(want, (const char*)name, MB_CATALOG_NAME_SIZE);
+	want[MB_CATALOG_NAME_SIZE] = 0;
+	CHECK(strcmp(c->name, want) == 0);
+}
+
+// entries from *k on describe tbl row by row
+static void
+check_table(const MB_TBL_CELL tbl[][MB_TBL_COLS], Uint8 table, Uint16 span, Uint32* k)
+{
+	const CAT_ENTRY*	c;
+	VAR*				v;
+	Uint32				i;
+
+	for (i=0;tbl[i][0] != 0;i++,(*k)++)
+	{
+		c = &CAT[*k];
+		CHECK_EQ(c->address, tbl[i][0]);
+		CHECK_EQ(c->span, span);
+		CHECK_EQ(c->table, table);
+		CHECK_EQ(c->type, tbl[i][1]);
+		CHECK_EQ(c->perm, tbl[i][2]);
+		check_name(c, tbl[i][4]);
+
+		if (tbl[i][1] != REGTYPE_VAR)
+		{
+			CHECK_EQ(c->unit, 0);
+			CHECK(c->lo == 0 && c->hi == 0);
+			continue;
+		}
+
+		v = (VAR*)tbl[i][3];
+		CHECK_EQ(c->unit, v->unit);
+		CHECK_EQ(c->cls, v->class);
+		if (v->STAT & var_no_bound)
+			CHECK(c->lo == 0 && c->hi == 0);
+		else
+			CHECK(c->lo <= c->hi);
+	}
+}
+
+// no two entries of a table claim the same register
+static void
+check_unique(Uint32 n)
+{
+	Uint32 i, j;
+
+	for (i=0;i<n;i++)
+		for (j=i+1;j<n;j++)
+			if (CAT[i].table == CAT[j].table && CAT[i].address == CAT[j].address)
+				CHECK_EQ(CAT[j].address, 0);
+}
+
+// occurrences of s in text
+static Uint32
+count(const char* text, const char* s)
+{
+	Uint32 n;
+
+	for (n=0;(text = strstr(text, s)) != NULL;n++,text++);
+	return n;
+}
+
+void
+test_catalog(void)
+{
+	Uint32	n, k, i;
+	char*	text;
+	size_t	len;
+	FILE*	f;
+
+	CHECK_EQ(cat_master_read(host_xfer, NULL, CAT, CAT_MAX, &n), CAT_OK);
+	CHECK(n > 0);
+	CHECK_EQ(cat_master_read(host_xfer, NULL, CAT, n - 1, &k), CAT_REFUSED);	// too many for the room given
+	CHECK_EQ(cat_master_read(host_xfer, NULL, CAT, CAT_MAX, &k), CAT_OK);
+
+	///// the tables, in the order MB_Catalog_Entry() walks them /////
+	k = 0;
+	check_table(MB_TBL_FLOAT, REG_TYPE_FLOAT, 2, &k);
+	check_table(MB_TBL_INT, REG_TYPE_INTEGER, 1, &k);
+	check_table(MB_TBL_LONGINT, REG_TYPE_LONG_INT, 2, &k);
+	check_table(MB_TBL_COIL, REG_TYPE_COIL, 1, &k);
+
+	for (i=0;MB_TBL_EXTENDED[i][2] != 0;i++,k++)
+	{
+		CHECK_EQ(CAT[k].address, 60000 + MB_TBL_EXTENDED[i][0]);
+		CHECK_EQ(CAT[k].span, MB_TBL_EXTENDED[i+1][0] - MB_TBL_EXTENDED[i][0]);
+		CHECK_EQ(CAT[k].table, (MB_TBL_EXTENDED[i][1] == REGTYPE_CHAR) ? REG_TYPE_INTEGER : REG_TYPE_FLOAT);
+		CHECK_EQ(CAT[k].type, MB_TBL_EXTENDED[i][1]);
+		CHECK_EQ(CAT[k].perm, REGPERM_PASSWD);
+		check_name(&CAT[k], MB_TBL_EXTENDED[i][3]);
+	}
+	CHECK_EQ(k, n);
+	check_unique(n);
+
+	///// the exports: one object (line) per entry, no bare NaN for a SCADA parser to choke on /////
+	f = open_memstream(&text, &len);
+	cat_write_json(f, CAT, n);
+	fclose(f);
+	CHECK_EQ(text[0], '{');
+	CHECK(strcmp(&text[len - 2], "}\n") == 0);
+	CHECK_EQ(count(text, "\"address\""), n);
+	CHECK_EQ(count(text, "{"), n + 1);
+	CHECK_EQ(count(text, "}"), n + 1);
+	CHECK_EQ(count(text, "nan,") + count(text, "nan }"), 0);
+	CHECK_EQ(count(text, "inf,") + count(text, "inf }"), 0);
+	free(text);
+
+	f = open_memstream(&text, &len);
+	cat_write_csv(f, CAT, n);
+	fclose(f);
+	CHECK_EQ(count(text, "\n"), n + 1);
+	CHECK_EQ(count(text, ",,"), 0);
+	free(text);
+}
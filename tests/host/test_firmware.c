@@ -0,0 +1,123 @@
+/*------------------------------------------------------------------------
+* test_firmware.c -- firmware staging: the received-chunk bitmap across
+* several words, chunk CRC32 checks and firmwareInfo(), and 0x15
+* requests whose record lengths do not fit them
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define CHUNKS	(70)	// spans three FW_HAVE words
+
+static Uint32 LUT[256];
+
+static Uint32
+chunk_crc(const Uint8* data)
+{
+	return UTIL_calcCRC32(LUT, (Uint8*)data, FW_CHUNK_SIZE, 0);
+}
+
+static void
+fill_chunk(Uint8* data, Uint32 chunk)
+{
+	Uint32 i;
+
+	for (i=0;i<FW_CHUNK_SIZE;i++)
+		data[i] = (Uint8)(chunk * 7 + i);
+}
+
+// one 9-byte 0x15 sub-request to MB_FILE_FW_DATA claiming len records
+static void
+check_write_walk(Uint16 len)
+{
+	Uint8	pdu[] = { 0x15, 9, 6, MB_FILE_FW_DATA >> 8, MB_FILE_FW_DATA & 0xFF, 0, 0, len >> 8, len & 0xFF, 0xAA, 0x55 };
+	Uint8	frame[MB_FRAME_SIZE];
+	Uint32	n, count;
+
+	n = host_frame(frame, HOST_SLAVE, pdu, sizeof(pdu));
+	count = HOST_RSP.count;
+	MB_RX_Submit(frame, n, &HOST_DRV, 0);
+
+	CHECK_EQ(MB_PKT_LIST.n, 0);
+	CHECK_EQ(HOST_RSP.count, count + 1);
+	CHECK_EQ(HOST_RSP.frame[1], 0x95);
+	CHECK_EQ(HOST_RSP.frame[2], MB_EXCEP_BAD_VALUE);
+	host_run();
+}
+
+void
+test_firmware(void)
+{
+	Uint8	data[FW_CHUNK_SIZE];
+	Uint16	w[FW_INFO_WORDS];
+	Uint32	size, k, chunk;
+
+	UTIL_buildCRC32Table(LUT, 0x04C11DB7);
+	CHECK_EQ(UTIL_calcCRC32(LUT, (Uint8*)"123456789", 9, 0), 0xCBF43926);
+
+	size = CHUNKS * FW_CHUNK_SIZE - 5;	// short last chunk
+	CHECK(!beginFirmware(0, 0));
+	CHECK(!beginFirmware(FW_MAX_SIZE + 1, 0));
+	CHECK(beginFirmware(size, 0x11223344));
+
+	firmwareInfo(w);
+	CHECK_EQ(w[0], FW_STATE_RECEIVING);
+	CHECK_EQ((w[1] << 16) | w[2], size);
+	CHECK_EQ((w[3] << 16) | w[4], 0x11223344);
+	CHECK_EQ(w[5], CHUNKS);
+	CHECK_EQ(w[6], 0);
+	CHECK_EQ(w[7], 0);
+	CHECK_EQ(w[9], FW_CHUNK_SIZE);
+
+	// backwards, leaving out chunk 40
+	for (k=0;k<CHUNKS;k++)
+	{
+		chunk = CHUNKS - 1 - k;
+		if (chunk == 40) continue;
+		fill_chunk(data, chunk);
+		CHECK_EQ(stageFirmware(chunk, data, chunk_crc(data)), FW_STAGE_OK);
+	}
+
+	// again: already have it, not counted twice
+	fill_chunk(data, 3);
+	CHECK_EQ(stageFirmware(3, data, chunk_crc(data)), FW_STAGE_OK);
+
+	fill_chunk(data, 40);
+	CHECK_EQ(stageFirmware(40, data, chunk_crc(data) ^ 1), FW_STAGE_CRC);
+	CHECK_EQ(stageFirmware(CHUNKS, data, chunk_crc(data)), FW_STAGE_RANGE);
+
+	firmwareInfo(w);
+	CHECK_EQ(w[0], FW_STATE_RECEIVING);
+	CHECK_EQ(w[6], CHUNKS - 1);
+	CHECK_EQ(w[7], 40);
+	CHECK_EQ(w[8], 1);
+	CHECK(!commitFirmware());
+
+	// resuming the same image keeps what was received
+	CHECK(beginFirmware(size, 0x11223344));
+	firmwareInfo(w);
+	CHECK_EQ(w[6], CHUNKS - 1);
+
+	CHECK_EQ(stageFirmware(40, data, chunk_crc(data)), FW_STAGE_OK);
+	firmwareInfo(w);
+	CHECK_EQ(w[0], FW_STATE_COMPLETE);
+	CHECK_EQ(w[6], CHUNKS);
+	CHECK_EQ(w[7], CHUNKS);
+
+	// a different image starts over
+	CHECK(beginFirmware(FW_CHUNK_SIZE * 33, 0));
+	firmwareInfo(w);
+	CHECK_EQ(w[5], 33);
+	CHECK_EQ(w[6], 0);
+	CHECK_EQ(w[7], 0);
+
+	abortFirmware();
+	firmwareInfo(w);
+	CHECK_EQ(w[0], FW_STATE_IDLE);
+	CHECK_EQ(stageFirmware(0, data, chunk_crc(data)), FW_STAGE_RANGE);
+
+	// 0x15 whose record length runs past the request: refused as it is parsed, never queued
+	COIL_UNLOCKED.val = TRUE;
+	check_write_walk(0x8001);	// 7 + 2*0x8001 is 9 again in 16 bits
+	check_write_walk(2);		// 4 bytes of records in a 2-byte tail
+	COIL_UNLOCKED.val = FALSE;
+}
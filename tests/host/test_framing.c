@@ -0,0 +1,172 @@
+/*------------------------------------------------------------------------
+* test_framing.c -- MB_RX_Frame_Byte() and MB_Frame_Timeout() against the
+* virtual clock, one timestamp count either side of t1.5 and t3.5, at the
+* rates Config_Uart() takes REG_BAUD_RATE from; then a fast master's
+* burst at 115200 baud with only the minimum silence between requests,
+* and a request with a bad CRC.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define BURST	(6)	// requests in the 115200 burst; fewer than MB_RX_FRAMES
+
+static Uint32 CHAR_NS, T15_NS, T35_NS;
+static Uint32 NOW;	// timestamp of the last byte fed
+
+// what MB_Set_Frame_Timing() should have made of the rate
+static void
+frame_timing(Uint32 baud)
+{
+	CHAR_NS = (1000000000u / baud) * UART_CHAR_BITS;
+	T15_NS	= CHAR_NS * 3 / 2;
+	T35_NS	= CHAR_NS * 7 / 2;
+	if ( (baud > 19200) && (T35_NS < MB_T35_MIN_US * 1000) )
+		T35_NS = MB_T35_MIN_US * 1000;
+}
+
+// bytes a character time apart, the first one gap after the last byte fed;
+// before byte pause_at the line is silent for pause more
+static void
+feed(const Uint8* f, Uint32 n, Uint32 gap, Uint32 pause_at, Uint32 pause)
+{
+	Uint32 i;
+
+	NOW += gap;
+	for (i=0;i<n;i++)
+	{
+		if (i > 0)
+			NOW += CHAR_NS;
+		if (i == pause_at)
+			NOW += pause;
+		host_uart_byte(f[i], NOW);
+	}
+}
+
+static void
+frame_clock(Uint32 after)
+{
+	HOST_NOW = NOW + after;
+	MB_Frame_Timeout();
+}
+
+static Uint32
+queued(void)
+{
+	return MB_FRAME_LIST.tail - MB_FRAME_LIST.head;
+}
+
+// frame k on MB_FRAME_LIST is n bytes long
+static void
+check_frame(Uint32 k, Uint32 n)
+{
+	MB_RX_FRAME* f = &MB_FRAME_LIST.BFR[(MB_FRAME_LIST.head + k) & (MB_RX_FRAMES - 1)];
+
+	CHECK_EQ(f->end - f->start, n);
+}
+
+// the Swi runs, and the line goes quiet long enough to close anything still open
+static void
+settle(void)
+{
+	frame_clock(T35_NS + 1);
+	Modbus_RX();
+	host_run();
+	NOW += T35_NS + 1;
+	CHECK_EQ(queued(), 0);
+	CHECK_EQ(Ring_Count(&UART_RXBUF), 0);
+}
+
+static void
+check_edges(Uint32 baud, const Uint8* req, Uint32 n)
+{
+	Config_Uart(baud, UART_PARITY_NONE);
+	frame_timing(baud);
+	CHECK_EQ(MB_Frame_Clock->timeout, T15_NS / (150 * 1000) + 2);
+	settle();
+
+	// back to back: t1.5 after a good CRC is one frame, a count more is two
+	feed(req, n, T35_NS, n, 0);
+	feed(req, n, T15_NS, n, 0);
+	frame_clock(T35_NS + 1);
+	CHECK_EQ(queued(), 1);
+	check_frame(0, 2*n);
+	settle();
+
+	feed(req, n, T35_NS, n, 0);
+	feed(req, n, T15_NS + 1, n, 0);
+	frame_clock(T35_NS + 1);
+	CHECK_EQ(queued(), 2);
+	check_frame(0, n);
+	check_frame(1, n);
+	settle();
+
+	// inside a frame, before the CRC is good: t3.5 is waited out, a count more splits it
+	feed(req, n, T35_NS, 3, T35_NS - CHAR_NS);
+	frame_clock(T35_NS + 1);
+	CHECK_EQ(queued(), 1);
+	check_frame(0, n);
+	settle();
+
+	feed(req, n, T35_NS, 3, T35_NS - CHAR_NS + 1);
+	CHECK_EQ(queued(), 1);
+	check_frame(0, 3);
+	settle();
+
+	// MB_Frame_Clock: a good CRC closes after t1.5, anything else after t3.5
+	feed(req, n, T35_NS, n, 0);
+	frame_clock(T15_NS);
+	CHECK_EQ(queued(), 0);
+	frame_clock(T15_NS + 1);
+	CHECK_EQ(queued(), 1);
+	settle();
+
+	feed(req, n - 1, T35_NS, n, 0);
+	frame_clock(T35_NS);
+	CHECK_EQ(queued(), 0);
+	frame_clock(T35_NS + 1);
+	CHECK_EQ(queued(), 1);
+	check_frame(0, n - 1);
+	settle();
+}
+
+void
+test_framing(void)
+{
+	Uint8	pdu[5] = { 0x03, 0, 200, 0, 1 };
+	Uint8	req[MB_FRAME_SIZE];
+	Uint32	n, i, count, frames, served, crc_err;
+
+	n = host_frame(req, HOST_SLAVE, pdu, sizeof(pdu));
+
+	check_edges(9600, req, n);
+	check_edges(19200, req, n);
+	check_edges(115200, req, n);	// t3.5 held at 1.75ms, t1.5 still 1.5 characters
+
+	// a burst at the least silence the standard allows: every request is its own frame
+	count	= HOST_RSP.count;
+	frames	= MB_STAT.frames;
+	served	= MB_STAT.served;
+	crc_err	= MB_STAT.crc_err;
+	feed(req, n, T35_NS, n, 0);
+	for (i=1;i<BURST;i++)
+		feed(req, n, CHAR_NS * 7 / 2, n, 0);
+	frame_clock(T15_NS + 1);
+	CHECK_EQ(queued(), BURST);
+	settle();
+	CHECK_EQ(MB_STAT.frames - frames, BURST);
+	CHECK_EQ(HOST_RSP.count - count, BURST);
+	CHECK_EQ(MB_STAT.served - served, BURST);
+
+	// a bad CRC is counted, not served or answered: off the line, then handed in whole
+	req[n-1] ^= 0x01;
+	feed(req, n, T35_NS, n, 0);
+	settle();
+	MB_RX_Submit(req, n, &HOST_DRV, 0);
+	host_run();
+	CHECK_EQ(MB_STAT.crc_err - crc_err, 2);
+	CHECK_EQ(MB_STAT.served - served, BURST);
+	CHECK_EQ(HOST_RSP.count - count, BURST);
+
+	Init_Uart();
+	HOST_VCLOCK = FALSE;
+}
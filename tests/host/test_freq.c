@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------
+* test_freq.c -- Count_Freq_Pulses() and Read_Freq() against a simulated
+* oscillator: an edge generator drives Timer3's counter (TIM12) off the
+* virtual clock, which every Timestamp_get32() moves on by HOST_STEP_NS
+* so that Freq_Reciprocal_Gate() waits for its edge as on the target.
+* The counter timer fires when its period runs out. Compares the error
+* and the readings per second of FREQ_MODE_COUNT with FREQ_MODE_RECIPROCAL
+* at the longest and the shortest gate.
+*------------------------------------------------------------------------*/
+
+#include <math.h>
+#include "host.h"
+#include "Calculate.h"
+
+#define F_OSC			(173456789.0)	// Hz, before the 80x divider
+#define HOST_STEP_NS	(20)			// one turn of a register polling loop
+#define RUN_MS			(20000)			// per mode
+
+typedef struct
+{
+	Uint32	readings;	// Poll() posts
+	double	err_max;	// Hz, worst reading against F_OSC
+} FREQ_RESULT;
+
+///// the oscillator, out of the 80x divider into TIM12 /////
+static double	EDGES;			// edges since the generator started, and the fraction of the next
+static UInt32	EDGES_AT;		// HOST_NOW EDGES is up to
+static Uint32	ZERO;			// edge count when TIM12 was last zeroed
+static Uint32	SHOWN;			// TIM12 as last set here
+
+static void
+edge_generator(void)
+{
+	// the firmware zeroed the counter since we last looked
+	if (HOST_REGS.TIM12 != SHOWN)
+		ZERO = (Uint32)EDGES - HOST_REGS.TIM12;
+
+	EDGES		+= (double)(HOST_NOW - EDGES_AT) * 1e-9 * (F_OSC / 80);
+	EDGES_AT	= HOST_NOW;
+	SHOWN = HOST_REGS.TIM12 = (Uint32)EDGES - ZERO;
+}
+
+// the counter timer for ms of virtual time: it fires, Poll() reads the frequency if posted
+static void
+run(Uint32 mode, Uint32 gate_ms, FREQ_RESULT* r, Uint32 ms)
+{
+	Uint32	elapsed_us, posts, i;
+	double	err;
+
+	REG_FREQ_MODE		= mode;
+	REG_FREQ_GATE_MS	= gate_ms;
+	memset(r, 0, sizeof(*r));
+
+	for (i=0,elapsed_us=0;elapsed_us < ms*1000;i++)
+	{
+		elapsed_us += counterTimerHandle->period_us;
+		HOST_NOW = counterTimerHandle->at + counterTimerHandle->period_us * 1000;
+		edge_generator();
+
+		posts = HOST_SWI_POSTS;
+		Count_Freq_Pulses(FREQ_COUNT_GATE_US);	// timer0Params.arg
+		CHECK(counterTimerHandle->running);
+		if ( (HOST_SWI_POSTS == posts) || (i == 0) )
+			continue;	// the first gate began before the mode did
+
+		r->readings++;
+		CHECK_EQ(Read_Freq(), 0);
+		err = fabs(REG_FREQ.calc_val * 1e6 - F_OSC);
+		if (err > r->err_max)
+			r->err_max = err;
+	}
+}
+
+static void
+report(const char* what, const FREQ_RESULT* r, Uint32 ms)
+{
+	printf("freq       %-16s %5.1f readings/s, error %6.1f Hz\n", what, r->readings * 1000.0 / ms, r->err_max);
+}
+
+void
+test_freq(void)
+{
+	FREQ_RESULT	count, slow, fast, back;
+	Uint32		posts;
+
+	PDI_FREQ_F0				= 0;
+	PDI_FREQ_F1				= 0;
+	REG_OIL_INDEX.calc_val	= 0;
+
+	HOST_VCLOCK			= TRUE;
+	HOST_VCLOCK_STEP	= HOST_STEP_NS;
+	HOST_VCLOCK_HOOK	= edge_generator;
+	HOST_NOW			= 1000000;
+	EDGES_AT			= HOST_NOW;
+	Timer_setPeriodMicroSecs(counterTimerHandle, FREQ_COUNT_GATE_US);
+	Timer_start(counterTimerHandle);
+
+	run(FREQ_MODE_COUNT, 500, &count, RUN_MS);
+	run(FREQ_MODE_RECIPROCAL, 500, &slow, RUN_MS);
+	CHECK_EQ(counterTimerHandle->period_us, 500000);
+	run(FREQ_MODE_RECIPROCAL, 50, &fast, RUN_MS);
+	CHECK_EQ(counterTimerHandle->period_us, 50000);
+
+	report("count, 500 ms", &count, RUN_MS);
+	report("reciprocal, 500", &slow, RUN_MS);
+	report("reciprocal, 50", &fast, RUN_MS);
+
+	// one pulse per gate against one polling step
+	CHECK(count.err_max > 0);
+	CHECK(slow.err_max < count.err_max / 5);
+	CHECK(fast.err_max < count.err_max);
+	CHECK(fast.readings >= 9 * count.readings);
+	CHECK(slow.readings >= count.readings - 1);
+
+	// back to counting: the first gate holds everything since reciprocal mode began, and is not read
+	REG_FREQ_MODE = FREQ_MODE_COUNT;
+	HOST_NOW = counterTimerHandle->at + counterTimerHandle->period_us * 1000;
+	edge_generator();
+	posts = HOST_SWI_POSTS;
+	Count_Freq_Pulses(FREQ_COUNT_GATE_US);
+	CHECK_EQ(HOST_SWI_POSTS, posts);
+	CHECK_EQ(counterTimerHandle->period_us, FREQ_COUNT_GATE_US);
+
+	run(FREQ_MODE_COUNT, 50, &back, RUN_MS);
+	CHECK(back.err_max <= count.err_max);
+	CHECK_EQ(back.readings, count.readings);
+
+	HOST_VCLOCK_HOOK	= NULL;
+	HOST_VCLOCK_STEP	= 0;
+	HOST_VCLOCK			= FALSE;
+}
@@ -0,0 +1,99 @@
+/*------------------------------------------------------------------------
+* test_history.c -- the logged history read the way mb_history reads it
+* (hist_master.c): a history that has wrapped, read whole across the row
+* files and the end of the rows, every record checked against what was
+* logged; records asked for too late, or overwritten while the master
+* was reading; and the records per second that makes on an RTU line.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define LOGGED	(HIST_RECORDS + 1000)	// wrapped once, part of the way
+
+static HIST_RECORD R[HIST_RECORDS];
+
+// what History_Record() would have logged as record n
+static void
+logged(Uint32 n, Uint32* rtc, Uint32* diag, float* val)
+{
+	Uint32 i;
+
+	*rtc	= ((Uint32)18 << 26) | ((Uint32)(1 + n % 12) << 22) | ((n % 60) << 6) | (n % 60);
+	*diag	= n * 3;
+	for (i=0;i<HIST_VALUES;i++)
+		val[i] = n + i * 0.5f;
+}
+
+static void
+log_records(Uint32 n)
+{
+	Uint32	rtc, diag;
+	float	val[HIST_VALUES];
+
+	while (n-- > 0)
+	{
+		logged(History_Seq(), &rtc, &diag, val);
+		host_history_add(rtc, diag, val);
+	}
+}
+
+static void
+check_record(const HIST_RECORD* r, Uint32 n)
+{
+	Uint32	rtc, diag, i;
+	float	val[HIST_VALUES];
+
+	logged(n, &rtc, &diag, val);
+	CHECK_EQ(r->seq, n);
+	CHECK_EQ(r->rtc, rtc);
+	CHECK_EQ(r->diag, diag);
+	for (i=0;i<HIST_VALUES;i++)
+		CHECK(r->val[i] == val[i]);
+}
+
+void
+test_history(void)
+{
+	HIST_MASTER	m;
+	Uint32		first, i;
+	double		line_us;
+
+	memset(&m, 0, sizeof(m));
+	m.xfer = host_xfer;
+
+	CHECK_EQ(hist_master_info(&m), HIST_OK);
+	log_records(LOGGED - m.info.seq);
+	CHECK_EQ(hist_master_info(&m), HIST_OK);
+	CHECK_EQ(m.info.seq, LOGGED);
+	CHECK_EQ(m.info.depth, HIST_RECORDS);
+	CHECK_EQ(m.info.rows, MB_FILE_HIST_ROWS);
+	CHECK_EQ(m.info.period, REG_LOGGING_PERIOD);
+
+	///// all of it, oldest first: rows 1000 to the end, then 0 to 999 /////
+	first = m.info.seq - m.info.depth;
+	m.requests = m.bytes_in = m.bytes_out = 0;
+	CHECK_EQ(hist_master_read(&m, first, m.info.depth, R), HIST_OK);
+	for (i=0;i<m.info.depth;i++)
+		check_record(&R[i], first + i);
+
+	// full responses but where a file or the rows end
+	CHECK(m.requests <= HIST_RECORDS / HIST_RECS_PER_READ + HIST_RECORDS / MB_FILE_HIST_ROWS + 2);
+
+	line_us = hist_master_line_us(&m, 9600);
+	printf("history    %u records in %u requests: %.1f records/s at 9600 baud, %.1f at 115200\n",
+			m.info.depth, m.requests, m.info.depth * 1e6 / line_us, m.info.depth * 1e6 / hist_master_line_us(&m, 115200));
+
+	///// not in the history: gone already, or not yet logged /////
+	CHECK_EQ(hist_master_read(&m, first - 1, 1, R), HIST_GONE);
+	CHECK_EQ(hist_master_read(&m, m.info.seq - 1, 2, R), HIST_GONE);
+	CHECK_EQ(hist_master_read(&m, m.info.seq - 1, 1, R), HIST_OK);
+	check_record(&R[0], m.info.seq - 1);
+
+	///// the slave logs on while the master is behind: the oldest are overwritten /////
+	log_records(HIST_RECS_PER_READ);
+	CHECK_EQ(hist_master_read(&m, first, HIST_RECS_PER_READ, R), HIST_GONE);
+	CHECK_EQ(m.overwritten, 1);
+	CHECK_EQ(hist_master_info(&m), HIST_OK);
+	CHECK_EQ(hist_master_read(&m, m.info.seq - m.info.depth, HIST_RECS_PER_READ, R), HIST_OK);
+	check_record(&R[0], m.info.seq - m.info.depth);
+}
@@ -0,0 +1,72 @@
+/*------------------------------------------------------------------------
+* test_main.c
+*-------------------------------------------------------------------------
+* Host unit tests for the parts of the firmware that are pure logic:
+* the Modbus CRC, the RING buffers, Modbus TCP reassembly, the register
+* tables, the firmware staging bitmap, a whole firmware transfer, the
+* float register cache under preemption, the register catalog against
+* the tables it describes, a calibration profile round trip, the logged
+* history and the sample stream.
+* Run with "make test"; the exit status is the number of failed checks.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+static int HOST_CHECKS;
+
+void
+host_check(int ok, const char* what, const char* file, int line)
+{
+	HOST_CHECKS++;
+	if (!ok)
+	{
+		HOST_FAILS++;
+		printf("%s:%d: FAILED: %s\n", file, line, what);
+	}
+}
+
+void
+host_check_eq(long a, long b, const char* sa, const char* sb, const char* file, int line)
+{
+	HOST_CHECKS++;
+	if (a != b)
+	{
+		HOST_FAILS++;
+		printf("%s:%d: FAILED: %s == %s (0x%lX != 0x%lX)\n", file, line, sa, sb, a, b);
+	}
+}
+
+int
+main(void)
+{
+	static const struct { const char* name; void (*run)(void); } TESTS[] = {
+		{ "crc",		test_crc },
+		{ "ring",		test_ring },
+		{ "mbtcp",		test_mbtcp },
+		{ "tables",		test_tables },
+		{ "firmware",	test_firmware },
+		{ "transfer",	test_transfer },
+		{ "cache",		test_cache },
+		{ "replay",		test_replay },
+		{ "framing",	test_framing },
+		{ "schedule",	test_schedule },
+		{ "freq",		test_freq },
+		{ "catalog",	test_catalog },
+		{ "profile",	test_profile },
+		{ "history",	test_history },
+		{ "stream",		test_stream },
+	};
+	Uint32 i;
+	int fails;
+
+	for (i=0;i<sizeof(TESTS)/sizeof(TESTS[0]);i++)
+	{
+		fails = HOST_FAILS;
+		host_init();
+		TESTS[i].run();
+		printf("%-10s %s\n", TESTS[i].name, (HOST_FAILS == fails) ? "ok" : "FAILED");
+	}
+
+	printf("%d checks, %d failed\n", HOST_CHECKS, HOST_FAILS);
+	return (HOST_FAILS > 0) ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+/*------------------------------------------------------------------------
+* test_mbtcp.c -- MBTCP_Receive() reassembly: ADUs split anywhere, run
+* together, and non-Modbus headers
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+static MBTCP_CONN	CONN;
+static Uint8		SENT[8][MBTCP_ADU_SIZE];	// ADUs handed to write(), oldest first
+static Uint32		SENT_N[8];
+static Uint32		SENT_COUNT;
+
+static void
+tcp_write(void* sock, const Uint8* adu, Uint32 n)
+{
+	(void)sock;
+
+	if (SENT_COUNT < 8)
+	{
+		memcpy(SENT[SENT_COUNT], adu, n);
+		SENT_N[SENT_COUNT] = n;
+	}
+	SENT_COUNT++;
+}
+
+static void
+tcp_receive(const Uint8* bytes, Uint32 n)
+{
+	MBTCP_Receive(&CONN, bytes, n);
+	host_run();
+}
+
+// read holding registers 280-281 (REG_MB_SENTINEL, REG_FREQ_MODE) as transaction id
+static Uint32
+read_adu(Uint8* adu, Uint16 id)
+{
+	static const Uint8 ADU[] = { 0, 0, 0x00, 0x00, 0x00, 0x06, 0x11, 0x03, 0x01, 0x17, 0x00, 0x02 };
+
+	memcpy(adu, ADU, sizeof(ADU));
+	adu[0] = id >> 8;
+	adu[1] = id & 0xFF;
+	return sizeof(ADU);
+}
+
+// the answer read_adu() should get
+static void
+check_answer(Uint32 k, Uint16 id)
+{
+	static const Uint8 RSP[] = { 0x00, 0x00, 0x00, 0x07, 0x11, 0x03, 0x04, 0x12, 0x34, 0x00, 0x01 };
+
+	CHECK_EQ(SENT_N[k], 2 + sizeof(RSP));
+	CHECK_EQ((SENT[k][0] << 8) | SENT[k][1], id);
+	CHECK(memcmp(&SENT[k][2], RSP, sizeof(RSP)) == 0);
+}
+
+void
+test_mbtcp(void)
+{
+	Uint8	adu[64], bad[16];
+	Uint32	n, k, stat;
+
+	REG_MB_SENTINEL = 0x1234;
+	REG_FREQ_MODE = 1;
+	MBTCP_Open(&CONN, tcp_write, NULL);
+
+	///// whole ADU, then split at every byte /////
+	n = read_adu(adu, 0x0100);
+	SENT_COUNT = 0;
+	tcp_receive(adu, n);
+	CHECK_EQ(SENT_COUNT, 1);
+	check_answer(0, 0x0100);
+
+	for (k=1;k<n;k++)
+	{
+		n = read_adu(adu, 0x0200 + k);
+		SENT_COUNT = 0;
+		tcp_receive(adu, k);
+		CHECK_EQ(SENT_COUNT, 0);
+		tcp_receive(&adu[k], n - k);
+		CHECK_EQ(SENT_COUNT, 1);
+		check_answer(0, 0x0200 + k);
+	}
+
+	///// one byte at a time /////
+	SENT_COUNT = 0;
+	for (k=0;k<n;k++)
+		tcp_receive(&adu[k], 1);
+	CHECK_EQ(SENT_COUNT, 1);
+
+	///// three ADUs in one segment, the last one cut short /////
+	n  = read_adu(&adu[0], 0x0301);
+	n += read_adu(&adu[n], 0x0302);
+	n += read_adu(&adu[n], 0x0303);
+	SENT_COUNT = 0;
+	tcp_receive(adu, n - 5);
+	CHECK_EQ(SENT_COUNT, 2);
+	check_answer(0, 0x0301);
+	check_answer(1, 0x0302);
+	tcp_receive(&adu[n - 5], 5);
+	CHECK_EQ(SENT_COUNT, 3);
+	check_answer(2, 0x0303);
+
+	///// not Modbus: the rest of the segment is thrown away /////
+	n = read_adu(bad, 0x0400);
+	bad[3] = 0x01;									// protocol id 1
+	memcpy(adu, bad, n);
+	n += read_adu(&adu[n], 0x0401);
+	stat = STAT_PKT;
+	SENT_COUNT = 0;
+	tcp_receive(adu, n);
+	CHECK_EQ(SENT_COUNT, 0);
+	CHECK_EQ(STAT_PKT, stat + 1);
+
+	n = read_adu(adu, 0x0402);
+	adu[4] = 0x01;									// length 256 + 6: longer than any PDU
+	tcp_receive(adu, n);
+	CHECK_EQ(SENT_COUNT, 0);
+
+	n = read_adu(adu, 0x0403);						// and back in step
+	tcp_receive(adu, n);
+	CHECK_EQ(SENT_COUNT, 1);
+	check_answer(0, 0x0403);
+
+	///// nothing is written once closed /////
+	MBTCP_Close(&CONN);
+	SENT_COUNT = 0;
+	tcp_receive(adu, n);
+	CHECK_EQ(SENT_COUNT, 0);
+	CHECK_EQ(MB_PKT_LIST.n, 0);
+}
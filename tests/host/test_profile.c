@@ -0,0 +1,188 @@
+/*------------------------------------------------------------------------
+* test_profile.c -- a calibration profile round trip as the calibration
+* software drives it: the live profile read with 0x14 (MB_FILE_PROFILE),
+* a new one staged with 0x15 and applied through MB_FILE_PROFILE_CTRL,
+* then read back and diffed word for word. A profile that fails a check
+* must change nothing; the original goes back in the same way.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define PROF_MAX	(2 + 3*256)	// words; more than MB_PROFILE_WORDS
+#define PROF_CHUNK	(100)		// words per request, under MB_FILE_MAX_RECS and the 0x15 byte count
+
+static Uint16 LIVE[PROF_MAX], NEW[PROF_MAX], BACK[PROF_MAX];
+
+// n words of file from record rec; FALSE on an exception
+static BOOL
+file_read(Uint16 file, Uint32 rec, Uint32 n, Uint16* dst)
+{
+	Uint8	pdu[9] = { 0x14, 7, 6, file >> 8, file & 0xFF, rec >> 8, rec & 0xFF, n >> 8, n & 0xFF };
+	Uint32	i;
+
+	host_request(pdu, sizeof(pdu));
+	if (HOST_RSP.frame[1] != 0x14)
+		return FALSE;
+
+	for (i=0;i<n;i++)
+		dst[i] = (HOST_RSP.frame[5 + 2*i] << 8) | HOST_RSP.frame[6 + 2*i];
+	return TRUE;
+}
+
+// n words to file from record rec; the exception code, 0 if none
+static Uint8
+file_write(Uint16 file, Uint32 rec, Uint32 n, const Uint16* src)
+{
+	Uint8	pdu[2 + 7 + 2*PROF_CHUNK];
+	Uint32	i;
+
+	pdu[0] = 0x15;
+	pdu[1] = 7 + 2*n;
+	pdu[2] = 6;
+	pdu[3] = file >> 8;
+	pdu[4] = file & 0xFF;
+	pdu[5] = rec >> 8;
+	pdu[6] = rec & 0xFF;
+	pdu[7] = n >> 8;
+	pdu[8] = n & 0xFF;
+	for (i=0;i<n;i++)
+	{
+		pdu[9 + 2*i]	= src[i] >> 8;
+		pdu[10 + 2*i]	= src[i] & 0xFF;
+	}
+
+	host_request(pdu, 9 + 2*n);
+	return (HOST_RSP.frame[1] == 0x15) ? 0 : HOST_RSP.frame[2];
+}
+
+// the whole live profile; its length in words
+static Uint32
+profile_read(Uint16* dst)
+{
+	Uint32 rec, n, words;
+
+	CHECK(file_read(MB_FILE_PROFILE, 0, 2, dst));
+	CHECK_EQ(dst[0], MB_PROFILE_VERSION);
+	words = 2 + 3*dst[1];
+	CHECK(words <= PROF_MAX);
+
+	for (rec=2;rec<words;rec+=n)
+	{
+		n = (words - rec < PROF_CHUNK) ? (words - rec) : PROF_CHUNK;
+		CHECK(file_read(MB_FILE_PROFILE, rec, n, &dst[rec]));
+	}
+	return words;
+}
+
+// src staged, then MB_PROFILE_CMD_APPLY; the first exception code, 0 if applied
+static Uint8
+profile_apply(const Uint16* src, Uint32 words)
+{
+	Uint16	cmd = MB_PROFILE_CMD_APPLY;
+	Uint32	rec, n;
+	Uint8	excep;
+
+	for (rec=0;rec<words;rec+=n)
+	{
+		n = (words - rec < PROF_CHUNK) ? (words - rec) : PROF_CHUNK;
+		excep = file_write(MB_FILE_PROFILE, rec, n, &src[rec]);
+		if (excep != 0)
+			return excep;
+	}
+	return file_write(MB_FILE_PROFILE_CTRL, 0, 1, &cmd);
+}
+
+// MB_FILE_PROFILE_CTRL: result, bad item, items, version
+static void
+check_ctrl(Uint16 result, Uint16 bad, Uint16 items)
+{
+	Uint16 ctrl[MB_PROFILE_CTRL_WORDS];
+
+	CHECK(file_read(MB_FILE_PROFILE_CTRL, 0, MB_PROFILE_CTRL_WORDS, ctrl));
+	CHECK_EQ(ctrl[0], result);
+	CHECK_EQ(ctrl[1], bad);
+	CHECK_EQ(ctrl[2], items);
+	CHECK_EQ(ctrl[3], MB_PROFILE_VERSION);
+}
+
+static void
+check_same(const Uint16* a, const Uint16* b, Uint32 words)
+{
+	Uint32 i;
+
+	for (i=0;i<words;i++)
+		if (a[i] != b[i])
+			CHECK_EQ(b[i], a[i]);	// once per word that differs
+}
+
+void
+test_profile(void)
+{
+	Uint32	words, items, i, val;
+	Uint16	id, msw;
+	float	f;
+
+	words = profile_read(LIVE);
+	items = LIVE[1];
+	CHECK(items > 0);
+	check_ctrl(0, 0, items);
+
+	///// a new profile: every item changed, ids in place /////
+	memcpy(NEW, LIVE, sizeof(NEW));
+	for (i=0;i<items;i++)
+	{
+		id = LIVE[2 + 3*i];
+		if (id == 204)
+			continue;	// REG_SLAVE_ADDRESS: the rest of the test talks to HOST_SLAVE
+
+		if ((id > 200) && (id < 401))
+			val = 0x10000 * i + 7;	// int and long int registers, 32 bits as stored
+		else
+		{
+			f = i + 0.25f;			// a float is exact in every register the profile reaches
+			memcpy(&val, &f, sizeof(val));
+		}
+		NEW[2 + 3*i + 1] = val >> 16;
+		NEW[2 + 3*i + 2] = val & 0xFFFF;
+	}
+
+	///// only while unlocked; item 0 (REG_SN_PIPE) needs the factory level too /////
+	CHECK_EQ(profile_apply(NEW, words), MB_EXCEP_BAD_VALUE);
+	check_ctrl(0, 0, items);
+	COIL_UNLOCKED.val = TRUE;
+	CHECK_EQ(profile_apply(NEW, words), MB_EXCEP_BAD_VALUE);
+	check_ctrl(2, 0, items);
+	profile_read(BACK);
+	check_same(LIVE, BACK, words);
+
+	///// a NaN anywhere rejects the whole profile /////
+	COIL_UNLOCKED_FACTORY_DEFAULT.val = TRUE;
+	msw = NEW[2 + 3*(items - 1) + 1];
+	NEW[2 + 3*(items - 1) + 1] = 0x7FC0;
+	CHECK_EQ(profile_apply(NEW, words), MB_EXCEP_BAD_VALUE);
+	check_ctrl(2, items - 1, items);
+	profile_read(BACK);
+	check_same(LIVE, BACK, words);
+
+	///// applied: it reads back as written /////
+	NEW[2 + 3*(items - 1) + 1] = msw;
+	CHECK_EQ(profile_apply(NEW, words), 0);
+	check_ctrl(1, 0, items);
+	CHECK_EQ(profile_read(BACK), words);
+	check_same(NEW, BACK, words);
+	CHECK_EQ(REG_AO_DAMPEN, 0x10000 * 1 + 7);	// item 1: in the register, not only the file
+
+	///// a profile of another version is not looked at /////
+	NEW[0] = MB_PROFILE_VERSION + 1;
+	CHECK_EQ(profile_apply(NEW, words), MB_EXCEP_BAD_VALUE);
+	check_ctrl(2, 0xFFFF, items);
+
+	///// the original goes back the same way /////
+	CHECK_EQ(profile_apply(LIVE, words), 0);
+	check_ctrl(1, 0, items);
+	profile_read(BACK);
+	check_same(LIVE, BACK, words);
+
+	COIL_UNLOCKED_FACTORY_DEFAULT.val	= FALSE;
+	COIL_UNLOCKED.val					= FALSE;
+}
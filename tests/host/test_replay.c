@@ -0,0 +1,252 @@
+/*------------------------------------------------------------------------
+* test_replay.c -- a timed capture of the serial line replayed byte by
+* byte through Uart_ISR(), MB_RX_Frame_Byte() and MB_Frame_Clock, as the
+* receive interrupt and the Clock module would deliver it at 9600 baud:
+* frames for this slave and for others on the party line, 0xFA + serial
+* number long addresses, back-to-back frames split at t1.5, pauses inside
+* a frame, and frames dropped with Ring_Rewind() while others wait in
+* UART_RXBUF for Modbus_RX().
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define CHAR_NS		((1000000000u / 9600) * UART_CHAR_BITS)
+#define T15_NS		(CHAR_NS * 3 / 2)
+#define T35_NS		(CHAR_NS * 7 / 2)
+#define POLL_NS		((T15_NS / (150 * 1000) + 2) * 150 * 1000)	// MB_Frame_Clock, as MB_Set_Frame_Timing() sets it
+#define PIPE_SN		(0x12345678)
+#define TRACE_MAX	(256)
+#define RSP_MAX		(16)
+
+typedef struct
+{ // one byte of the capture
+	Uint32	ts;		// timestamp (ns) the byte was read from RBR
+	Uint8	b;
+} EVENT;
+
+static EVENT	TRACE[TRACE_MAX];
+static Uint32	TRACE_N, TRACE_TS;
+
+static Uint8	RSP[RSP_MAX][MB_FRAME_SIZE];
+static Uint32	RSP_LEN[RSP_MAX];
+static Uint32	RSP_N, SWI_SEEN;
+static BOOL		SWI_HELD;	// Swi_Modbus_RX held off (by a higher priority Swi)
+
+static void
+replay_send(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n)
+{
+	(void)ctx;
+	(void)tag;
+
+	if (RSP_N < RSP_MAX)
+	{
+		memcpy(RSP[RSP_N], frame, n);
+		RSP_LEN[RSP_N] = n;
+	}
+	RSP_N++;
+	MB_TX_IN_PROGRESS = FALSE;
+}
+
+static const MB_TX_DRIVER REPLAY_DRV = { replay_send, NULL };
+
+///// the capture /////
+// a frame whose first byte follows the last one after gap ns of silence;
+// bytes are stamped as they are read, a character time apart, and before
+// byte pause_at the master stops for pause ns more
+static void
+trace_frame(const Uint8* f, Uint32 n, Uint32 gap, Uint32 pause_at, Uint32 pause)
+{
+	Uint32 i;
+
+	TRACE_TS += gap;
+	for (i=0;i<n;i++)
+	{
+		TRACE_TS += CHAR_NS;
+		if (i == pause_at)
+			TRACE_TS += pause;
+		TRACE[TRACE_N].ts	= TRACE_TS;
+		TRACE[TRACE_N].b	= f[i];
+		TRACE_N++;
+	}
+}
+
+// 0xFA, the serial number MSB first, the PDU and the CRC
+static Uint32
+long_frame(Uint8* frame, Uint32 sn, const Uint8* pdu, Uint32 pdu_n)
+{
+	Uint16 CRC;
+
+	frame[0] = 0xFA;
+	frame[1] = sn >> 24;
+	frame[2] = sn >> 16;
+	frame[3] = sn >> 8;
+	frame[4] = sn;
+	memcpy(&frame[5], pdu, pdu_n);
+	CRC = Calc_CRC(frame, pdu_n + 5);
+	frame[pdu_n + 5] = CRC & 0xFF;
+	frame[pdu_n + 6] = CRC >> 8;
+
+	return pdu_n + 7;
+}
+
+///// the replay /////
+// Swi_Modbus_RX, if it was posted and may run, then the responses it queued
+static void
+replay_swi(void)
+{
+	if ( SWI_HELD || (HOST_SWI_POSTS == SWI_SEEN) )
+		return;
+
+	SWI_SEEN = HOST_SWI_POSTS;
+	Modbus_RX();
+	host_run();
+}
+
+// MB_Frame_Clock expiring every POLL_NS after the last byte, up to t
+static void
+replay_clock(Uint32 last, Uint32 t)
+{
+	Uint32 k;
+
+	for (k=1;(Int32)(t - (last + k*POLL_NS)) > 0;k++)
+	{
+		HOST_NOW = last + k*POLL_NS;
+		MB_Frame_Timeout();
+		replay_swi();
+	}
+}
+
+// the capture so far, then the line left silent until the last frame closes
+static void
+replay(void)
+{
+	Uint32 i, last;
+
+	last = TRACE[0].ts;
+	for (i=0;i<TRACE_N;i++)
+	{
+		replay_clock(last, TRACE[i].ts);
+		host_uart_byte(TRACE[i].b, TRACE[i].ts);
+		replay_swi();
+		last = TRACE[i].ts;
+	}
+	replay_clock(last, last + T35_NS + 2*POLL_NS);
+
+	TRACE_TS = HOST_NOW;
+	TRACE_N = 0;
+}
+
+static void
+check_rsp(Uint32 k, Uint8 first)
+{
+	CHECK(RSP_N > k);
+	if (RSP_N <= k)
+		return;
+
+	CHECK_EQ(RSP[k][0], first);
+	CHECK_EQ(Calc_CRC(RSP[k], RSP_LEN[k]), 0);
+	if (first == 0xFA)
+	{
+		CHECK_EQ(RSP[k][1], (PIPE_SN >> 24) & 0xFF);
+		CHECK_EQ(RSP[k][4], PIPE_SN & 0xFF);
+		CHECK_EQ(RSP[k][5], 0x03);
+	}
+	else
+		CHECK_EQ(RSP[k][1], 0x03);
+}
+
+void
+test_replay(void)
+{
+	Uint8	pdu[5] = { 0x03, 0, 200, 0, 1 };	// REG_SN_PIPE
+	Uint8	ours[MB_FRAME_SIZE], other[MB_FRAME_SIZE], ours_la[MB_FRAME_SIZE], other_la[MB_FRAME_SIZE];
+	Uint32	n, n_la, foreign, frames, tail;
+
+	n = host_frame(ours, HOST_SLAVE, pdu, sizeof(pdu));
+	host_frame(other, HOST_SLAVE + 6, pdu, sizeof(pdu));
+	n_la = long_frame(ours_la, PIPE_SN, pdu, sizeof(pdu));
+	long_frame(other_la, PIPE_SN + 1, pdu, sizeof(pdu));	// same up to the last serial number byte
+
+	REG_SN_PIPE = PIPE_SN;
+	MB_TX_Set_Driver(&REPLAY_DRV);
+	host_uart_byte(0, 0);	// the virtual clock on; a lone byte, closed as a short frame
+	TRACE_TS = 0;
+	replay();
+	SWI_SEEN = HOST_SWI_POSTS;
+	foreign = MB_STAT.foreign;
+	frames = MB_STAT.frames;
+	RSP_N = 0;
+
+	///// a party line: ours, another slave's, ours long, another pipe's long /////
+	trace_frame(ours, n, T35_NS, n, 0);
+	trace_frame(other, n, T35_NS, n, 0);
+	trace_frame(ours_la, n_la, T35_NS, n_la, 0);
+	trace_frame(other_la, n_la, T35_NS, n_la, 0);
+	replay();
+
+	CHECK_EQ(RSP_N, 2);
+	check_rsp(0, HOST_SLAVE);
+	check_rsp(1, 0xFA);
+	CHECK_EQ(MB_STAT.foreign - foreign, 2);
+	CHECK_EQ(MB_STAT.frames - frames, 2);	// foreign frames never reach Modbus_RX
+	CHECK_EQ(HOST_SWI_POSTS, SWI_SEEN);
+	CHECK_EQ(Ring_Count(&UART_RXBUF), 0);
+
+	///// back to back: more than t1.5 apart, split once the CRC is good /////
+	RSP_N = 0;
+	trace_frame(ours, n, T35_NS, n, 0);
+	trace_frame(ours, n, T15_NS - CHAR_NS + CHAR_NS/10, n, 0);	// the next byte splits it, before MB_Frame_Clock looks
+	trace_frame(ours_la, n_la, POLL_NS, n_la, 0);					// MB_Frame_Clock does
+	replay();
+
+	CHECK_EQ(RSP_N, 3);
+	check_rsp(0, HOST_SLAVE);
+	check_rsp(1, HOST_SLAVE);
+	check_rsp(2, 0xFA);
+
+	///// pauses inside a frame: over t1.5 is waited out, over t3.5 splits it /////
+	RSP_N = 0;
+	frames = MB_STAT.frames;
+	foreign = MB_STAT.foreign;
+	trace_frame(ours, n, T35_NS, 3, T15_NS);	// MB_Frame_Clock looks, the CRC is not good yet
+	trace_frame(ours, n, T35_NS, 3, T35_NS + CHAR_NS);
+	replay();
+
+	CHECK_EQ(RSP_N, 1);
+	check_rsp(0, HOST_SLAVE);
+	CHECK_EQ(MB_STAT.frames - frames, 2);	// the whole first frame, the 3 bytes before the split
+	CHECK_EQ(MB_STAT.foreign - foreign, 1);	// the rest starts with 200: another slave's address
+	CHECK_EQ(Ring_Count(&UART_RXBUF), 0);
+
+	///// Modbus_RX() held off: a dropped frame rewinds only its own bytes /////
+	RSP_N = 0;
+	foreign = MB_STAT.foreign;
+	SWI_HELD = TRUE;
+	trace_frame(ours, n, T35_NS, n, 0);
+	replay();
+	tail = UART_RXBUF.tail;
+	CHECK_EQ(Ring_Count(&UART_RXBUF), n);
+
+	trace_frame(other_la, n_la, T35_NS, n_la, 0);
+	replay();
+	CHECK_EQ(UART_RXBUF.tail, tail);
+
+	trace_frame(ours_la, n_la, T35_NS, n_la, 0);
+	trace_frame(other, n, T35_NS, n, 0);
+	trace_frame(ours, n, T35_NS, n, 0);
+	replay();
+	CHECK_EQ(Ring_Count(&UART_RXBUF), 2*n + n_la);
+	CHECK_EQ(RSP_N, 0);
+
+	SWI_HELD = FALSE;
+	replay_swi();
+	CHECK_EQ(RSP_N, 3);
+	check_rsp(0, HOST_SLAVE);
+	check_rsp(1, 0xFA);
+	check_rsp(2, HOST_SLAVE);
+	CHECK_EQ(MB_STAT.foreign - foreign, 2);
+	CHECK_EQ(Ring_Count(&UART_RXBUF), 0);
+
+	MB_TX_Set_Driver(&HOST_DRV);
+	HOST_VCLOCK = FALSE;
+}
@@ -0,0 +1,247 @@
+/*------------------------------------------------------------------------
+* test_ring.c -- RING (Buffers.c) against a plain FIFO, across the end of
+* the buffer and across the wrap of the 32-bit head/tail counters, and
+* with the producer and the consumer on two threads
+*------------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <sched.h>
+#include "host.h"
+
+#define STRESS_BYTES	(16u * 1024 * 1024)	// through the ring in the two-thread test
+
+static RING R;
+
+typedef struct
+{ // what the consumer thread found
+	Uint32	bytes;
+	Uint32	bad;		// bytes that were not the ones put there
+	Uint32	first_bad;	// stream offset of the first of them
+} STRESS;
+
+// start both counters 'back' bytes short of the 32-bit wrap
+static void
+ring_at(Uint32 back)
+{
+	Ring_Init(&R);
+	R.head = R.tail = 0u - back;
+}
+
+// byte k of the stream: changes with every lap of the buffer too
+static Uint8
+stress_byte(Uint32 k)
+{
+	return (Uint8)(k * 7 + (k >> 10) * 13);
+}
+
+// producer thread: Ring_Write and Ring_Write_Span/Ring_Commit in turns, odd sizes
+static void*
+stress_producer(void* arg)
+{
+	Uint8	chunk[RING_SIZE], *p;
+	Uint32	k, i, n, seed;
+
+	(void)arg;
+	for (k=0,seed=7;k<STRESS_BYTES;)
+	{
+		seed = seed * 1103515245 + 12345;
+		n = 1 + (seed >> 8) % 300;
+		if (n > STRESS_BYTES - k)
+			n = STRESS_BYTES - k;
+
+		if ((seed >> 4) & 1)
+		{
+			for (i=0;i<n;i++)
+				chunk[i] = stress_byte(k + i);
+			n = Ring_Write(&R, chunk, n);
+		}
+		else
+		{
+			i = Ring_Write_Span(&R, &p);
+			n = (n < i) ? n : i;
+			for (i=0;i<n;i++)
+				p[i] = stress_byte(k + i);
+			Ring_Commit(&R, n);
+		}
+
+		k += n;
+		if (n == 0)
+			sched_yield();	// full
+	}
+
+	return NULL;
+}
+
+// consumer thread: Ring_Read and Ring_Read_Span/Ring_Consume in turns
+static void*
+stress_consumer(void* arg)
+{
+	STRESS*	st = (STRESS*)arg;
+	Uint8	chunk[RING_SIZE], *p, *q;
+	Uint32	i, n, seed;
+
+	for (seed=3;st->bytes<STRESS_BYTES;)
+	{
+		seed = seed * 1103515245 + 12345;
+		n = 1 + (seed >> 8) % 400;
+
+		if ((seed >> 4) & 1)
+		{
+			n = Ring_Read(&R, chunk, n);
+			q = chunk;
+		}
+		else
+		{
+			i = Ring_Read_Span(&R, &p);
+			n = (n < i) ? n : i;
+			q = p;
+		}
+
+		for (i=0;i<n;i++)
+		{
+			if (q[i] != stress_byte(st->bytes + i))
+			{
+				if (st->bad++ == 0)
+					st->first_bad = st->bytes + i;
+			}
+		}
+
+		if (q != chunk)
+			Ring_Consume(&R, n);
+
+		st->bytes += n;
+		if (n == 0)
+			sched_yield();	// empty
+	}
+
+	return NULL;
+}
+
+/***************************************************************************
+ * test_ring_threads() - Ring_Write/Ring_Commit on one thread against
+ * Ring_Read/Ring_Consume on another, STRESS_BYTES through the ring,
+ * the 32-bit counters wrapping halfway
+ ***************************************************************************/
+static void
+test_ring_threads(void)
+{
+	pthread_t	prod, cons;
+	STRESS		st;
+
+	memset(&st, 0, sizeof(st));
+	ring_at(STRESS_BYTES / 2);
+
+	CHECK_EQ(pthread_create(&cons, NULL, stress_consumer, &st), 0);
+	CHECK_EQ(pthread_create(&prod, NULL, stress_producer, NULL), 0);
+	pthread_join(prod, NULL);
+	pthread_join(cons, NULL);
+
+	CHECK_EQ(st.bytes, STRESS_BYTES);
+	CHECK_EQ(st.bad, 0);
+	if (st.bad != 0)
+		printf("first bad byte at %u\n", st.first_bad);
+	CHECK_EQ(Ring_Count(&R), 0);
+	CHECK_EQ(R.tail, 0u - STRESS_BYTES / 2 + STRESS_BYTES);
+}
+
+void
+test_ring(void)
+{
+	static Uint8 model[RING_SIZE * 4];
+	Uint8	in[RING_SIZE], out[RING_SIZE], b, *p;
+	Uint32	i, n, got, put, want, mhead, mtail, seed, tail;
+
+	///// byte at a time: fill, overflow, drain /////
+	ring_at(RING_SIZE / 2 + 3);
+	for (i=0;i<RING_SIZE;i++)
+		CHECK_EQ(Ring_Put(&R, (Uint8)i), 0);
+	CHECK_EQ(Ring_Put(&R, 0xAA), 1);
+	CHECK_EQ(Ring_Count(&R), RING_SIZE);
+	CHECK_EQ(Ring_Space(&R), 0);
+
+	for (i=0;i<RING_SIZE;i++)
+	{
+		CHECK_EQ(Ring_Get(&R, &b), 0);
+		CHECK_EQ(b, (Uint8)i);
+	}
+	CHECK_EQ(Ring_Get(&R, &b), 1);
+	CHECK_EQ(Ring_Count(&R), 0);
+
+	///// bulk writes and reads of every size against a model FIFO /////
+	ring_at(RING_SIZE * 3 + 17);
+	mhead = mtail = 0;
+	seed = 1;
+	for (i=0;i<4000;i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		n = (seed >> 8) % (RING_SIZE + 1);
+
+		if ((seed >> 4) & 1)
+		{
+			for (put=0;put<n;put++)
+				in[put] = (Uint8)(seed + put);
+			want = (n < RING_SIZE - (mtail - mhead)) ? n : RING_SIZE - (mtail - mhead);
+
+			put = Ring_Write(&R, in, n);
+			CHECK_EQ(put, want);
+			for (got=0;got<put;got++)
+				model[(mtail++) % sizeof(model)] = in[got];
+		}
+		else
+		{
+			want = (n < mtail - mhead) ? n : mtail - mhead;
+
+			got = Ring_Read(&R, out, n);
+			CHECK_EQ(got, want);
+			for (put=0;(put<got) && (out[put] == model[(mhead + put) % sizeof(model)]);put++);
+			CHECK_EQ(put, got);
+			mhead += got;
+		}
+
+		CHECK_EQ(Ring_Count(&R), mtail - mhead);
+	}
+
+	///// peek leaves the ring alone /////
+	ring_at(5);
+	for (i=0;i<100;i++)
+		in[i] = (Uint8)(i * 7);
+	Ring_Write(&R, in, 100);
+	CHECK_EQ(Ring_Peek(&R, 90, out, 50), 10);
+	CHECK_EQ(out[0], in[90]);
+	CHECK_EQ(Ring_Peek(&R, 100, out, 1), 0);
+	CHECK_EQ(Ring_Count(&R), 100);
+
+	///// spans stop at the end of the buffer /////
+	ring_at(0);
+	R.head = R.tail = RING_SIZE - 10;
+	CHECK_EQ(Ring_Write_Span(&R, &p), 10);
+	CHECK(p == &R.buff[RING_SIZE - 10]);
+	Ring_Commit(&R, 10);
+	CHECK_EQ(Ring_Write_Span(&R, &p), RING_SIZE - 10);
+	CHECK(p == &R.buff[0]);
+	Ring_Commit(&R, RING_SIZE);					// more than fits
+	CHECK_EQ(Ring_Count(&R), RING_SIZE);
+	CHECK_EQ(Ring_Read_Span(&R, &p), 10);
+	Ring_Consume(&R, 10);
+	CHECK_EQ(Ring_Read_Span(&R, &p), RING_SIZE - 10);
+	CHECK(p == &R.buff[0]);
+	Ring_Consume(&R, RING_SIZE);				// more than is there
+	CHECK_EQ(Ring_Count(&R), 0);
+
+	///// rewind takes back what the producer put since tail /////
+	ring_at(3);
+	Ring_Write(&R, in, 4);
+	tail = R.tail;
+	Ring_Write(&R, in, 6);
+	Ring_Rewind(&R, tail);
+	CHECK_EQ(Ring_Count(&R), 4);
+	Ring_Read(&R, out, 4);
+	Ring_Rewind(&R, tail - 4);					// already consumed: ignored
+	CHECK_EQ(R.tail, tail);
+
+	Ring_Write(&R, in, 8);
+	Ring_Flush(&R);
+	CHECK_EQ(Ring_Count(&R), 0);
+
+	test_ring_threads();
+}
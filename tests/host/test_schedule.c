@@ -0,0 +1,204 @@
+/*------------------------------------------------------------------------
+* test_schedule.c -- response turnaround on the serial line, timed on the
+* virtual clock. MB_Frame_Clock, MB_Start_Clock_Response and the end of
+* each response on the line are played as events in time order, so the
+* request is delimited, parsed, scheduled by MB_Schedule() and answered
+* as on the target. Every response must start 3.5 character times after
+* the request (or after our previous response) and no more than the
+* Clock tick rounding later, at any baud rate, one request or many.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define TICK_NS		(150 * 1000)	// Clock_tickPeriod
+#define OLD_TICKS	(24)			// the fixed MB_Start_Clock_* delay this replaced
+#define QUEUED		(4)				// requests waiting at once
+#define START_NS	(1000000)
+
+static Uint32	CHAR_NS, TURN_NS;
+static Uint32	NOW;			// last byte received
+
+static BOOL		LINE_BUSY;		// a response is going out
+static Uint32	LINE_END;		// when its last byte is on the line
+static Uint32	TX_AT[QUEUED];	// when each response started
+static Uint32	TX_END[QUEUED];
+static Uint32	TX_N;
+
+// the serial driver: the response holds the line for its length in characters
+static void
+line_send(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n)
+{
+	(void)ctx;
+	(void)tag;
+	(void)frame;
+
+	if (TX_N < QUEUED)
+	{
+		TX_AT[TX_N]		= HOST_NOW;
+		TX_END[TX_N]	= HOST_NOW + n * CHAR_NS;
+	}
+	TX_N++;
+
+	LINE_BUSY	= TRUE;
+	LINE_END	= HOST_NOW + n * CHAR_NS;
+}
+
+static const MB_TX_DRIVER LINE_DRV = { line_send, NULL };
+
+// Swi_Modbus_RX, if a frame was queued
+static void
+swi(void)
+{
+	static Uint32 seen;
+
+	if (HOST_SWI_POSTS != seen)
+	{
+		seen = HOST_SWI_POSTS;
+		Modbus_RX();
+	}
+}
+
+static BOOL
+first(BOOL active, Uint32 t, Uint32* next)
+{
+	if ( !active || ((Int32)(t - *next) >= 0) )
+		return FALSE;
+
+	*next = t;
+	return TRUE;
+}
+
+// everything due before t, in time order
+static void
+run_until(Uint32 t)
+{
+	Clock_Handle	clk;
+	Uint32			next;
+
+	for (;;)
+	{
+		next = t;
+		clk = NULL;
+		if (first(MB_Frame_Clock->active, MB_Frame_Clock->at + MB_Frame_Clock->timeout * TICK_NS, &next))
+			clk = MB_Frame_Clock;
+		if (first(MB_Start_Clock_Response->active, MB_Start_Clock_Response->at + MB_Start_Clock_Response->timeout * TICK_NS, &next))
+			clk = MB_Start_Clock_Response;
+		if (first(LINE_BUSY, LINE_END, &next))
+			clk = MB_End_Clock;
+
+		if (next == t)
+			return;
+
+		HOST_NOW = next;
+		if (clk == MB_Frame_Clock)
+		{
+			MB_Frame_Clock->active = FALSE;
+			MB_Frame_Timeout();
+			swi();
+		}
+		else if (clk == MB_Start_Clock_Response)
+		{
+			MB_Start_Clock_Response->active = FALSE;
+			MB_Dispatch();
+		}
+		else
+		{
+			LINE_BUSY = FALSE;
+			MB_PacketDone();
+		}
+	}
+}
+
+static void
+set_baud(Uint32 baud)
+{
+	Config_Uart(baud, UART_PARITY_NONE);
+	CHAR_NS = (1000000000u / baud) * UART_CHAR_BITS;
+	TURN_NS = CHAR_NS * 7 / 2;
+	TX_N	= 0;
+}
+
+// one request from the master; the turnaround it got, in ns
+static Uint32
+transaction(const Uint8* req, Uint32 n, Uint32* total)
+{
+	Uint32 i, t0;
+
+	t0 = NOW + TURN_NS;
+	for (i=0;i<n;i++)
+	{
+		NOW = t0 + i * CHAR_NS;
+		run_until(NOW);
+		host_uart_byte(req[i], NOW);
+	}
+	run_until(NOW + 100 * TURN_NS);
+
+	CHECK_EQ(TX_N, 1);
+	CHECK(!LINE_BUSY);
+	*total = TX_END[0] - (t0 - CHAR_NS);
+	TX_N = 0;
+	NOW = HOST_NOW;
+
+	return TX_AT[0] - (t0 + (n - 1) * CHAR_NS);
+}
+
+// the turnaround is legal, and late by no more than the Clock tick rounding
+static void
+check_turn(Uint32 turn)
+{
+	CHECK(turn >= TURN_NS);
+	CHECK(turn <= TURN_NS + 2 * TICK_NS);
+}
+
+void
+test_schedule(void)
+{
+	static const Uint32 BAUDS[] = { 9600, 19200, 57600, 115200 };
+	Uint8	pdu[5] = { 0x03, 0, 200, 0, 1 };
+	Uint8	req[MB_FRAME_SIZE];
+	Uint32	n, i, k, turn, total, old;
+
+	n = host_frame(req, HOST_SLAVE, pdu, sizeof(pdu));
+	MB_TX_Set_Driver(&LINE_DRV);
+	HOST_VCLOCK = TRUE;
+	HOST_NOW = NOW = START_NS;
+
+	printf("schedule  ");
+	for (k=0;k<sizeof(BAUDS)/sizeof(BAUDS[0]);k++)
+	{
+		set_baud(BAUDS[k]);
+		turn = transaction(req, n, &total);
+		check_turn(turn);
+
+		// request, 24 ticks, response
+		old = total - turn + OLD_TICKS * TICK_NS;
+		printf(" %u: %u/%uus", BAUDS[k], turn / 1000, total / 1000);
+		if (BAUDS[k] == 115200)
+			CHECK(total < old / 2);
+	}
+	printf(" (turnaround/transaction; was %uus + the frames)\n", OLD_TICKS * TICK_NS / 1000);
+
+	// requests waiting together go out back to back, 3.5 characters apart
+	set_baud(115200);
+	HOST_NOW = NOW = NOW + 10 * TURN_NS;
+	for (i=0;i<QUEUED;i++)
+		MB_RX_Submit(req, n, &LINE_DRV, i);
+	CHECK_EQ(MB_PKT_LIST.n, QUEUED);
+	run_until(NOW + 100 * QUEUED * TURN_NS);
+
+	CHECK_EQ(TX_N, QUEUED);
+	CHECK_EQ(MB_PKT_LIST.n, 0);
+	check_turn(TX_AT[0] - NOW);
+	for (i=1;i<QUEUED;i++)
+		check_turn(TX_AT[i] - TX_END[i-1]);
+
+	// a request from another transport does not wait for the serial line
+	HOST_NOW += TURN_NS;
+	MB_RX_Submit(req, n, &HOST_DRV, 0);
+	CHECK_EQ(MB_Start_Clock_Response->timeout, 1);
+	host_run();
+
+	Init_Uart();
+	MB_TX_Set_Driver(&HOST_DRV);
+	HOST_VCLOCK = FALSE;
+}
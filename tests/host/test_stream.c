@@ -0,0 +1,189 @@
+/*------------------------------------------------------------------------
+* test_stream.c -- the sample stream (PDI function 67) from the arm
+* command to the cal sw's decoder (stream_master.c): records sent by
+* MB_Stream_Sample() on the virtual clock, some dropped by the analyzer
+* because a response was going out, one corrupted and one lost on the
+* line and noise between two; every record that arrives decodes to what
+* was measured, and the decoder tells the kinds of gap apart.
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define SAMPLES		(200)
+#define PERIOD_US	(100000)	// between Poll()s
+#define BUSY_EVERY	(25)		// a response is going out at one sample in 25; the last is not one, or
+							// nothing after it would tell the decoder
+#define PIPE_SN		(0x12345678)
+
+static Uint8	LINE[SAMPLES * 40];
+static Uint32	LINE_N;
+
+static void
+line_send(void* ctx, Uint32 tag, const Uint8* frame, Uint32 n)
+{
+	(void)ctx;
+	(void)tag;
+
+	if (LINE_N + n <= sizeof(LINE))
+	{
+		memcpy(&LINE[LINE_N], frame, n);
+		LINE_N += n;
+	}
+	MB_TX_IN_PROGRESS = FALSE;
+}
+
+static const MB_TX_DRIVER LINE_DRV = { line_send, NULL };
+
+// function 67 for count records, addressed to the slave or (sn) by long address
+static void
+arm(Uint32 count, Uint32 sn)
+{
+	Uint8	pdu[5] = { MB_CMD_PDI_SAMPLE_STREAM, count >> 24, count >> 16, count >> 8, count };
+	Uint8	frame[MB_FRAME_SIZE];
+	Uint32	n;
+	Uint16	CRC;
+
+	if (sn == 0)
+		n = host_frame(frame, HOST_SLAVE, pdu, sizeof(pdu));
+	else
+	{
+		frame[0] = 0xFA;
+		frame[1] = sn >> 24;
+		frame[2] = sn >> 16;
+		frame[3] = sn >> 8;
+		frame[4] = sn;
+		memcpy(&frame[5], pdu, sizeof(pdu));
+		CRC = Calc_CRC(frame, sizeof(pdu) + 5);
+		frame[sizeof(pdu) + 5] = CRC & 0xFF;
+		frame[sizeof(pdu) + 6] = CRC >> 8;
+		n = sizeof(pdu) + 7;
+	}
+
+	MB_RX_Submit(frame, n, &LINE_DRV, 0);
+	host_run();
+}
+
+// the measurements at sample k
+static void
+measure(Uint32 k)
+{
+	FREQ_PULSE_COUNT_LO	= 1000 + k;
+	REG_FREQ.val		= 160.0f + k / 8.0f;
+	REG_TEMP_USER.val	= 25.0f + k / 4.0f;
+	REG_OIL_RP			= k / 2.0;
+	REG_WATERCUT_RAW	= 50.0 + k;
+}
+
+static void
+sample(Uint32 k, BOOL busy)
+{
+	HOST_NOW += PERIOD_US * 1000;
+	measure(k);
+	MB_TX_IN_PROGRESS = busy;
+	MB_Stream_Sample();
+	MB_TX_IN_PROGRESS = FALSE;
+}
+
+static void
+check_sample(const STREAM_SAMPLE* s)
+{
+	CHECK_EQ(s->us, (s->seq + 1) * PERIOD_US);
+	CHECK_EQ(s->pulses, 1000 + s->seq);
+	CHECK(s->freq == 160.0f + s->seq / 8.0f);
+	CHECK(s->temp == 25.0f + s->seq / 4.0f);
+	CHECK(s->rp == s->seq / 2.0f);
+	CHECK(s->wc_raw == 50.0f + s->seq);
+}
+
+// the line so far through a fresh decoder; the samples it found
+static Uint32
+decode(STREAM_DECODER* d, Uint32 sn)
+{
+	STREAM_SAMPLE	s;
+	Uint32			i, n;
+
+	stream_decoder_init(d, HOST_SLAVE, sn);
+	for (i=0,n=0;i<LINE_N;i++)
+	{
+		if (!stream_decode(d, LINE[i], &s))
+			continue;
+
+		check_sample(&s);
+		n++;
+	}
+	return n;
+}
+
+void
+test_stream(void)
+{
+	STREAM_DECODER	d;
+	Uint32			k, busy, dropped, echo, rec, n;
+	static const Uint8 NOISE[] = { 0x00, 0x55, 0xAA };
+
+	HOST_VCLOCK	= TRUE;
+	HOST_NOW	= 1000000;
+	LINE_N		= 0;
+	dropped		= MB_STAT.stream_dropped;
+
+	///// SAMPLES records, then no more /////
+	arm(SAMPLES, 0);
+	echo = LINE_N;
+	CHECK_EQ(echo, 8);
+	for (k=0,busy=0;k<SAMPLES;k++)
+	{
+		sample(k, (k % BUSY_EVERY) == BUSY_EVERY / 2);
+		busy += ((k % BUSY_EVERY) == BUSY_EVERY / 2);
+	}
+	n = LINE_N;
+	sample(k, FALSE);
+	CHECK_EQ(LINE_N, n);
+	CHECK_EQ(MB_STAT.stream_dropped - dropped, busy);
+
+	rec = (LINE_N - echo) / (SAMPLES - busy);
+	CHECK_EQ(rec, 32);
+	CHECK_EQ(decode(&d, 0), SAMPLES - busy);
+	CHECK_EQ(d.count, SAMPLES);
+	CHECK_EQ(d.dropped, busy);
+	CHECK_EQ(d.lost + d.crc_errors + d.skipped, 0);
+
+	///// on the line: record 50 corrupted, noise after 100, record 150 missing /////
+	LINE[echo + 50*rec + 10] ^= 0x04;
+	memmove(&LINE[echo + 150*rec], &LINE[echo + 151*rec], LINE_N - (echo + 151*rec));
+	LINE_N -= rec;
+	memmove(&LINE[echo + 101*rec + sizeof(NOISE)], &LINE[echo + 101*rec], LINE_N - (echo + 101*rec));
+	memcpy(&LINE[echo + 101*rec], NOISE, sizeof(NOISE));
+	LINE_N += sizeof(NOISE);
+
+	CHECK_EQ(decode(&d, 0), SAMPLES - busy - 2);
+	CHECK_EQ(d.dropped, busy);
+	CHECK_EQ(d.lost, 2);
+	CHECK_EQ(d.crc_errors, 2);
+	CHECK_EQ(d.skipped, rec + sizeof(NOISE));
+
+	///// the echo missed: the records still decode /////
+	memmove(LINE, &LINE[1], --LINE_N);
+	CHECK_EQ(decode(&d, 0), SAMPLES - busy - 2);
+	CHECK_EQ(d.count, 0);
+
+	///// long address, until stopped /////
+	LINE_N = 0;
+	HOST_NOW = 1000000;
+	REG_SN_PIPE = PIPE_SN;
+	arm(MB_STREAM_FOREVER, PIPE_SN);
+	for (k=0;k<10;k++)
+		sample(k, FALSE);
+	n = LINE_N;
+	arm(0, PIPE_SN);	// stop: the echo, then nothing
+	sample(k, FALSE);
+	CHECK_EQ(LINE_N, n + 12);
+
+	LINE_N = n;
+	CHECK_EQ(decode(&d, PIPE_SN), 10);
+	CHECK_EQ(d.count, MB_STREAM_FOREVER);
+	CHECK_EQ(d.lost + d.dropped + d.crc_errors, 0);
+	CHECK_EQ(decode(&d, PIPE_SN + 1), 0);	// another pipe's stream
+
+	MB_TX_Set_Driver(&HOST_DRV);
+	HOST_VCLOCK = FALSE;
+}
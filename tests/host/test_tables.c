@@ -0,0 +1,269 @@
+/*------------------------------------------------------------------------
+* test_tables.c -- the register tables as the master sees them: every row
+* found through the MB_IDX_* index, cross-table reads walked through
+* MB_Tbl_Resolve(), and the extended string registers
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+// n registers (or coils) from reg; the response is in HOST_RSP
+static Uint32
+read_regs(Uint8 fxn, Uint16 reg, Uint16 n)
+{
+	Uint8 pdu[5];
+
+	pdu[0] = fxn;
+	pdu[1] = (reg - 1) >> 8;	// on the wire, addresses are 0-based
+	pdu[2] = (reg - 1) & 0xFF;
+	pdu[3] = n >> 8;
+	pdu[4] = n & 0xFF;
+
+	return host_request(pdu, sizeof(pdu));
+}
+
+// 16-bit register k of the last read response
+static Uint32
+rsp_word(Uint32 k)
+{
+	return (HOST_RSP.frame[3 + 2*k] << 8) | HOST_RSP.frame[4 + 2*k];
+}
+
+static Uint32
+float_image(float f)
+{
+	Uint32 u;
+
+	memcpy(&u, &f, sizeof(u));
+	return u;
+}
+
+static Uint32
+rows(const MB_TBL_CELL tbl[][MB_TBL_COLS])
+{
+	Uint32 i;
+
+	for (i=0;tbl[i][0] != 0;i++);
+	return i;
+}
+
+// word k of catalog entry e (MB_FILE_CATALOG), read with 0x14
+static Uint32
+catalog_word(Uint32 e, Uint32 k)
+{
+	Uint32	rec = MB_CATALOG_HDR_WORDS + e*MB_CATALOG_ENTRY_WORDS + k;
+	Uint8	pdu[9] = { 0x14, 7, 6, MB_FILE_CATALOG >> 8, MB_FILE_CATALOG & 0xFF, 0, 0, 0, 1 };
+
+	pdu[5] = rec >> 8;
+	pdu[6] = rec & 0xFF;
+	host_request(pdu, sizeof(pdu));
+	CHECK_EQ(HOST_RSP.frame[1], 0x14);
+
+	return (HOST_RSP.frame[5] << 8) | HOST_RSP.frame[6];
+}
+
+// every row of tbl answers a read of its own register, unless it is write-only
+static void
+check_rows(const MB_TBL_CELL tbl[][MB_TBL_COLS], Uint8 fxn, Uint16 n)
+{
+	Uint32 i, rsp_n;
+
+	for (i=0;tbl[i][0] != 0;i++)
+	{
+		rsp_n = read_regs(fxn, (Uint16)tbl[i][0], n);
+
+		if (tbl[i][2] == REGPERM_WRITE_O)
+		{
+			CHECK_EQ(HOST_RSP.frame[1], fxn | 0x80);
+			continue;
+		}
+
+		if (HOST_RSP.frame[1] != fxn)
+			printf("  register %u (%s): exception %u\n", (unsigned)tbl[i][0], (const char*)tbl[i][4], HOST_RSP.frame[2]);
+
+		CHECK_EQ(HOST_RSP.frame[1], fxn);
+		CHECK(rsp_n >= 3u + HOST_RSP.frame[2] + 2);
+	}
+}
+
+void
+test_tables(void)
+{
+	Uint8	pdu[16], rsp[MB_FRAME_SIZE];
+	Uint32	i, n;
+	MB_STATS stat;
+
+	///// every row is indexed /////
+	check_rows(MB_TBL_INT,     0x03, 1);
+	check_rows(MB_TBL_LONGINT, 0x03, 2);
+	check_rows(MB_TBL_FLOAT,   0x03, 2);
+	check_rows(MB_TBL_COIL,    0x01, 1);
+
+	// coils 1-9 packed LSB first, the last byte partly filled
+	for (i=0;i<9;i++)
+		((COIL*)MB_TBL_COIL[i][3])->val = (0x0A5 >> i) & 1;
+
+	read_regs(0x01, 1, 8);
+	CHECK_EQ(HOST_RSP.frame[2], 1);
+	CHECK_EQ(HOST_RSP.frame[3], 0xA5);
+
+	read_regs(0x01, 1, 9);
+	CHECK_EQ(HOST_RSP.frame[2], 2);
+	CHECK_EQ(HOST_RSP.frame[3], 0xA5);
+	CHECK_EQ(HOST_RSP.frame[4], 0x00);
+
+	// not in any table
+	read_regs(0x03, 283, 1);
+	CHECK_EQ(HOST_RSP.frame[1], 0x83);
+	CHECK_EQ(HOST_RSP.frame[2], MB_EXCEP_BAD_ADDRESS);
+
+	///// float -> holes -> int /////
+	REG_OIL_PT			= 1.5;
+	REG_SN_PIPE			= 0x1234;
+	REG_ANALYZER_MODE	= 7;
+	REG_AO_DAMPEN		= 9;
+	REG_MB_SENTINEL		= 0xDEAD;
+
+	read_regs(0x03, 183, 21);
+	CHECK_EQ(HOST_RSP.frame[1], 0x03);
+	CHECK_EQ(HOST_RSP.frame[2], 42);
+	CHECK_EQ((rsp_word(0) << 16) | rsp_word(1), float_image(1.5f));
+	for (i=2;i<18;i++)
+		CHECK_EQ(rsp_word(i), 0xDEAD);
+	CHECK_EQ(rsp_word(18), 0x1234);
+	CHECK_EQ(rsp_word(19), 7);
+	CHECK_EQ(rsp_word(20), 9);
+
+	///// int -> long int, the last one cut in half /////
+	REG_MEASSECTION_SN	= 0x00012345;
+	REG_BACKBOARD_SN	= 0x00067890;
+
+	read_regs(0x03, 299, 5);
+	CHECK_EQ(HOST_RSP.frame[1], 0x03);
+	CHECK_EQ(HOST_RSP.frame[2], 10);
+	CHECK_EQ(rsp_word(0), 0xDEAD);
+	CHECK_EQ(rsp_word(1), 0xDEAD);
+	CHECK_EQ((rsp_word(2) << 16) | rsp_word(3), 0x00012345);
+	CHECK_EQ(rsp_word(4), 0xDEAD);
+
+	///// into the extended arrays /////
+	REG_TEMP_OIL_NUM_CURVES	= 2.0;
+	REG_TEMPS_OIL[0]		= -1.0;
+
+	read_regs(0x03, 59999, 6);
+	CHECK_EQ(HOST_RSP.frame[1], 0x03);
+	CHECK_EQ(HOST_RSP.frame[2], 12);
+	CHECK_EQ(rsp_word(0), 0xDEAD);
+	CHECK_EQ(rsp_word(1), 0xDEAD);
+	CHECK_EQ((rsp_word(2) << 16) | rsp_word(3), float_image(2.0f));
+	CHECK_EQ((rsp_word(4) << 16) | rsp_word(5), float_image(-1.0f));
+
+	///// a write-only register fails the whole read /////
+	read_regs(0x03, 223, 3);
+	CHECK_EQ(HOST_RSP.frame[1], 0x83);
+
+	///// the request queue counters: integer registers, so int fields /////
+	stat = MB_STAT;
+	MB_STAT.queue_max	= 5;
+	MB_STAT.queue_busy	= 0x12345;
+	MB_STAT.queue_drop	= 7;
+	CHECK_EQ(sizeof(MB_STAT.queue_max) + sizeof(MB_STAT.queue_busy) + sizeof(MB_STAT.queue_drop), 3 * sizeof(int));
+
+	read_regs(0x03, 274, 3);
+	CHECK_EQ(HOST_RSP.frame[1], 0x03);
+	CHECK_EQ(rsp_word(0), 5);
+	CHECK_EQ(rsp_word(1), 0x2345);	// low 16 bits
+	CHECK_EQ(rsp_word(2), 7);
+	MB_STAT.queue_max	= stat.queue_max;
+	MB_STAT.queue_busy	= stat.queue_busy;
+	MB_STAT.queue_drop	= stat.queue_drop;
+
+	///// extended strings: one character per register /////
+	n = rows(MB_TBL_FLOAT) + rows(MB_TBL_INT) + rows(MB_TBL_LONGINT) + rows(MB_TBL_COIL);	// first extended catalog entry
+	for (i=0;MB_TBL_EXTENDED[i][2] != 0;i++)
+	{
+		CHECK_EQ(catalog_word(n + i, 0), 60000 + MB_TBL_EXTENDED[i][0]);
+		if (MB_TBL_EXTENDED[i][0] == 2577) CHECK_EQ(MB_TBL_EXTENDED[i][1], REGTYPE_CHAR);
+
+		// the catalog types the rows as the reads serve them
+		if (MB_TBL_EXTENDED[i][1] == REGTYPE_CHAR)
+			CHECK_EQ(catalog_word(n + i, 2), (REG_TYPE_INTEGER << 8) | REGTYPE_CHAR);
+		else
+			CHECK_EQ(catalog_word(n + i, 2) >> 8, REG_TYPE_FLOAT);
+	}
+
+	memcpy(REG_STRING_TAG, "ABC", 4);
+	n = read_regs(0x03, 62577, 4);	// mixed path: MB_Tbl_Resolve() types them as integers
+	CHECK_EQ(HOST_RSP.frame[1], 0x03);
+	CHECK_EQ(HOST_RSP.frame[2], 8);
+	CHECK_EQ(rsp_word(0), 'A');
+	CHECK_EQ(rsp_word(1), 'B');
+	CHECK_EQ(rsp_word(2), 'C');
+	CHECK_EQ(rsp_word(3), 0);
+	memcpy(rsp, HOST_RSP.frame, n);
+
+	COIL_MB_AUX_SELECT_MODE.val = TRUE;	// float table selected: MB_SendPacket_Float()
+	CHECK_EQ(read_regs(0x03, 62577, 4), n);
+	CHECK(memcmp(HOST_RSP.frame, rsp, n) == 0);
+	COIL_MB_AUX_SELECT_MODE.val = FALSE;
+
+	read_regs(0x03, 62579, 1);		// a single character
+	CHECK_EQ(HOST_RSP.frame[2], 2);
+	CHECK_EQ(rsp_word(0), 'C');
+
+	// the last character of STREAM_TIMESTAMP, then STREAM_OIL_ADJUST: the second float is cut in half
+	COIL_MB_AUX_SELECT_MODE.val = TRUE;
+	read_regs(0x03, 63646, 4);
+	CHECK_EQ(HOST_RSP.frame[1], 0x83);
+	CHECK_EQ(HOST_RSP.frame[2], MB_EXCEP_BAD_ADDRESS);
+	COIL_MB_AUX_SELECT_MODE.val = FALSE;
+
+	///// writes take one character per register too /////
+	pdu[0] = 0x10;
+	pdu[1] = (62577 - 1) >> 8;
+	pdu[2] = (62577 - 1) & 0xFF;
+	pdu[3] = 0;
+	pdu[4] = 3;
+	pdu[5] = 6;
+	pdu[6] = 0;		pdu[7] = 'x';
+	pdu[8] = 0;		pdu[9] = 'y';
+	pdu[10] = 0;	pdu[11] = 'z';
+
+	host_request(pdu, 12);		// locked
+	CHECK_EQ(HOST_RSP.frame[1], 0x90);
+	CHECK_EQ(REG_STRING_TAG[0], 'A');
+
+	COIL_UNLOCKED.val = TRUE;
+	host_request(pdu, 12);
+	CHECK_EQ(HOST_RSP.frame[1], 0x10);
+	CHECK_EQ((HOST_RSP.frame[4] << 8) | HOST_RSP.frame[5], 3);
+	CHECK(memcmp(REG_STRING_TAG, "xyz", 4) == 0);
+
+	pdu[4] = 1;					// a single one
+	pdu[5] = 2;
+	pdu[7] = 'C';
+	host_request(pdu, 8);
+	CHECK_EQ(HOST_RSP.frame[1], 0x10);
+	CHECK_EQ((HOST_RSP.frame[4] << 8) | HOST_RSP.frame[5], 1);
+	CHECK(memcmp(REG_STRING_TAG, "Cyz", 4) == 0);
+
+	// 0x17 writes them the same way, and reads them back
+	pdu[0] = 0x17;
+	pdu[1] = (62577 - 1) >> 8;
+	pdu[2] = (62577 - 1) & 0xFF;
+	pdu[3] = 0;
+	pdu[4] = 2;
+	pdu[5] = pdu[1];
+	pdu[6] = pdu[2];
+	pdu[7] = 0;
+	pdu[8] = 2;
+	pdu[9] = 4;
+	pdu[10] = 0;	pdu[11] = 'p';
+	pdu[12] = 0;	pdu[13] = 'q';
+	host_request(pdu, 14);
+	CHECK_EQ(HOST_RSP.frame[1], 0x17);
+	CHECK_EQ(HOST_RSP.frame[2], 4);
+	CHECK_EQ(rsp_word(0), 'p');
+	CHECK_EQ(rsp_word(1), 'q');
+	CHECK(memcmp(REG_STRING_TAG, "pqz", 4) == 0);
+	COIL_UNLOCKED.val = FALSE;
+}
@@ -0,0 +1,127 @@
+/*------------------------------------------------------------------------
+* test_transfer.c -- a whole firmware transfer as fw_master.c drives it,
+* every request an RTU frame through MB_RX_Submit()/MB_RX_Parse(): frames
+* lost to a bad CRC, chunks refused on their CRC32, a link that drops
+* halfway, and the resume from the first chunk still missing
+*------------------------------------------------------------------------*/
+
+#include "host.h"
+
+#define IMAGE_SIZE	(70*FW_CHUNK_SIZE - 37)	// the last chunk only partly used
+
+typedef struct
+{ // the line between fw_master.c and the slave
+	Uint32	requests;
+	Uint32	bad_crc_at;		// this request arrives with its frame CRC broken
+	Uint32	bad_chunk_at;	// this request has a byte of its chunk changed on the way
+	Uint32	down_at;		// from this request on, nothing arrives
+	Uint32	first_chunk;	// record number of the first chunk sent, 0xFFFF: none yet
+} LINE;
+
+static Uint8 IMAGE[IMAGE_SIZE];
+
+static Uint32
+line_xfer(void* ctx, const Uint8* pdu, Uint32 pdu_n, Uint8* rsp)
+{
+	LINE*	line = (LINE*)ctx;
+	Uint8	frame[MB_FRAME_SIZE], bytes[MB_FRAME_SIZE];
+	Uint32	n, count, k;
+
+	k = ++line->requests;
+	if ( (line->down_at != 0) && (k >= line->down_at) )
+		return 0;
+
+	if ( (pdu[0] == 0x15) && (((pdu[3] << 8) | pdu[4]) == MB_FILE_FW_DATA) && (line->first_chunk == 0xFFFF) )
+		line->first_chunk = (pdu[5] << 8) | pdu[6];
+
+	memcpy(bytes, pdu, pdu_n);
+	if (k == line->bad_chunk_at)
+		bytes[20] ^= 0x80;	// in the chunk, past its CRC32; the frame CRC still matches
+
+	n = host_frame(frame, HOST_SLAVE, bytes, pdu_n);
+	if (k == line->bad_crc_at)
+		frame[n - 1] ^= 0x01;
+
+	count = HOST_RSP.count;
+	MB_RX_Submit(frame, n, &HOST_DRV, 0);
+	host_run();
+
+	if (HOST_RSP.count == count)
+		return 0;
+
+	CHECK_EQ(Calc_CRC(HOST_RSP.frame, HOST_RSP.n), 0);	// CRC over the frame and its CRC
+	memcpy(rsp, &HOST_RSP.frame[1], HOST_RSP.n - 3);
+	return HOST_RSP.n - 3;
+}
+
+static void
+line_init(LINE* line, FW_MASTER* m)
+{
+	memset(line, 0, sizeof(*line));
+	line->first_chunk = 0xFFFF;
+
+	memset(m, 0, sizeof(*m));
+	m->xfer	= line_xfer;
+	m->ctx	= line;
+	m->tries = 3;
+}
+
+void
+test_transfer(void)
+{
+	LINE		line;
+	FW_MASTER	m;
+	Uint32		i, chunks, have;
+
+	for (i=0;i<IMAGE_SIZE;i++)
+		IMAGE[i] = (Uint8)(i * 13 + (i >> 8));
+	chunks = (IMAGE_SIZE + FW_CHUNK_SIZE - 1) / FW_CHUNK_SIZE;
+
+	// locked: every write is refused, nothing starts
+	line_init(&line, &m);
+	CHECK_EQ(fw_master_load(&m, IMAGE, IMAGE_SIZE), FW_LOAD_REFUSED);
+	CHECK_EQ(m.excep, MB_EXCEP_BAD_VALUE);
+
+	COIL_UNLOCKED.val = TRUE;
+	abortFirmware();
+
+	// session 1: one frame lost, one chunk mangled, then the link goes down
+	line_init(&line, &m);
+	line.bad_crc_at		= 5;
+	line.bad_chunk_at	= 9;
+	line.down_at		= 30;
+	CHECK_EQ(fw_master_load(&m, IMAGE, IMAGE_SIZE), FW_LOAD_LINK);
+	CHECK_EQ(line.first_chunk, 0);
+	CHECK_EQ(m.lost, 1 + m.tries);	// the bad frame, then the dead link
+	CHECK_EQ(m.rejected, 1);
+
+	// what the slave kept: every chunk up to the link loss, each exactly once
+	line_init(&line, &m);
+	CHECK_EQ(fw_master_info(&m), FW_LOAD_OK);
+	have = m.info[6];
+	CHECK_EQ(m.info[0], FW_STATE_RECEIVING);
+	CHECK_EQ(m.info[5], chunks);
+	CHECK_EQ(m.info[7], have);
+	CHECK_EQ(m.info[8], 1);
+	CHECK(have > 0);
+	CHECK(have < chunks);
+
+	// session 2: resumes at the first missing chunk and commits
+	line_init(&line, &m);
+	CHECK_EQ(fw_master_load(&m, IMAGE, IMAGE_SIZE), FW_LOAD_OK);
+	CHECK_EQ(m.resume, have);
+	CHECK_EQ(line.first_chunk, have);
+	CHECK_EQ(m.sent, chunks - have);
+	CHECK_EQ(m.lost, 0);
+	CHECK_EQ(m.info[0], FW_STATE_COMMITTING);
+	CHECK_EQ(m.info[6], chunks);
+	CHECK_EQ(m.info[7], chunks);
+
+	// nothing restarts a transfer while the image is being written
+	line_init(&line, &m);
+	CHECK_EQ(fw_master_load(&m, IMAGE, IMAGE_SIZE), FW_LOAD_REFUSED);
+	CHECK_EQ(m.excep, MB_EXCEP_BAD_VALUE);
+	CHECK_EQ(line.first_chunk, 0xFFFF);
+
+	COIL_UNLOCKED.val = FALSE;
+}